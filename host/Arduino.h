@@ -0,0 +1,288 @@
+// Arduino-ESP32 core shim for the Linux host build (see host/host_main.cpp).
+// Only the surface the sketch uses; behaviour follows the ESP32 core where it matters
+// (String formatting, millis/micros, recursive mutexes, tasks as threads).
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+#include <ctype.h>
+#include <stdarg.h>
+#include <strings.h>
+#include <algorithm>
+#include <string>
+
+#include "host.h"
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define PROGMEM
+#define PGM_P const char*
+#define F(x) x
+#define IRAM_ATTR
+
+#define HIGH 1
+#define LOW 0
+#define OUTPUT 1
+#define INPUT 0
+#define INPUT_PULLUP 2
+#define HEX 16
+#define DEC 10
+
+using std::min;
+using std::max;
+
+template <class T, class A, class B>
+T constrain(T x, A low, B high) {
+    return x < low ? low : (x > high ? high : x);
+}
+
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+
+// ----- Time (host clock: real or fake, see host.h) -----
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void yield();
+
+// ----- GPIO / PWM (recorded, see host.h) -----
+void pinMode(int pin, int mode);
+void digitalWrite(int pin, int value);
+int digitalRead(int pin);
+int analogRead(int pin);
+void analogWrite(int pin, int value);
+void tone(int pin, unsigned int frequency, unsigned long duration = 0);
+void noTone(int pin);
+void ledcSetup(int channel, int frequency, int resolution);
+void ledcAttachPin(int pin, int channel);
+void ledcWrite(int channel, int duty);
+void ledcWriteTone(int channel, int frequency);
+
+long random(long high);
+long random(long low, long high);
+void randomSeed(unsigned long seed);
+uint32_t esp_random();
+
+bool getLocalTime(struct tm* info, uint32_t ms = 5000);
+void configTime(long gmtOffset, int daylightOffset, const char* server1,
+                const char* server2 = nullptr, const char* server3 = nullptr);
+
+// ----- String -----
+class __FlashStringHelper;
+
+class String {
+public:
+    String(const char* s = "");
+    String(const String& other);
+    String(char c);
+    String(int value, unsigned char base = 10);
+    String(unsigned int value, unsigned char base = 10);
+    String(long value, unsigned char base = 10);
+    String(unsigned long value, unsigned char base = 10);
+    String(long long value, unsigned char base = 10);
+    String(unsigned long long value, unsigned char base = 10);
+    String(float value, unsigned int decimals = 2);
+    String(double value, unsigned int decimals = 2);
+
+    String& operator=(const String& other);
+    String& operator=(const char* s);
+
+    String& operator+=(const String& s) { concat(s); return *this; }
+    String& operator+=(const char* s) { concat(s); return *this; }
+    String& operator+=(char c) { concat(c); return *this; }
+    String& operator+=(int v) { return *this += String(v); }
+    String& operator+=(unsigned int v) { return *this += String(v); }
+    String& operator+=(long v) { return *this += String(v); }
+    String& operator+=(unsigned long v) { return *this += String(v); }
+    String& operator+=(float v) { return *this += String(v); }
+    String& operator+=(double v) { return *this += String(v); }
+
+    bool concat(const String& s);
+    bool concat(const char* s);
+    bool concat(const char* s, unsigned int length);
+    bool concat(char c);
+
+    bool operator==(const String& s) const { return buffer == s.buffer; }
+    bool operator==(const char* s) const { return buffer == (s ? s : ""); }
+    bool operator!=(const String& s) const { return !(*this == s); }
+    bool operator!=(const char* s) const { return !(*this == s); }
+    bool operator<(const String& s) const { return buffer < s.buffer; }
+
+    char operator[](unsigned int index) const { return index < buffer.size() ? buffer[index] : 0; }
+    char& operator[](unsigned int index);
+
+    unsigned int length() const { return (unsigned int)buffer.size(); }
+    const char* c_str() const { return buffer.c_str(); }
+    bool reserve(unsigned int size) { buffer.reserve(size); return true; }
+
+    String substring(unsigned int from) const;
+    String substring(unsigned int from, unsigned int to) const;
+    int indexOf(char c) const { return indexOf(c, 0); }
+    int indexOf(char c, unsigned int from) const;
+    int indexOf(const char* s) const;
+    int indexOf(const String& s) const { return indexOf(s.c_str()); }
+    int lastIndexOf(char c) const;
+    bool startsWith(const String& s) const;
+    bool endsWith(const String& s) const;
+    bool equals(const String& s) const { return *this == s; }
+    bool equalsIgnoreCase(const String& s) const;
+
+    char charAt(unsigned int index) const { return (*this)[index]; }
+    void setCharAt(unsigned int index, char c);
+
+    long toInt() const { return atol(buffer.c_str()); }
+    float toFloat() const { return (float)atof(buffer.c_str()); }
+    double toDouble() const { return atof(buffer.c_str()); }
+
+    void trim();
+    void toLowerCase();
+    void toUpperCase();
+    void replace(const String& find, const String& with);
+    void remove(unsigned int index);
+    void remove(unsigned int index, unsigned int count);
+    bool isEmpty() const { return buffer.empty(); }
+    void clear() { buffer.clear(); }
+
+    void toCharArray(char* out, unsigned int size) const;
+    void getBytes(unsigned char* out, unsigned int size) const;
+
+    explicit operator bool() const { return true; }
+
+private:
+    std::string buffer;
+};
+
+String operator+(const String& a, const String& b);
+String operator+(const String& a, const char* b);
+String operator+(const char* a, const String& b);
+String operator+(const String& a, char b);
+String operator+(const String& a, int b);
+String operator+(const String& a, unsigned int b);
+String operator+(const String& a, long b);
+String operator+(const String& a, unsigned long b);
+String operator+(const String& a, float b);
+String operator+(const String& a, double b);
+
+// ----- Print / Stream / Serial -----
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* data, size_t length);
+    size_t write(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+
+    size_t print(const String& s) { return write((const uint8_t*)s.c_str(), s.length()); }
+    size_t print(const char* s) { return write(s); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int value, int base = 10) { return print((long)value, base); }
+    size_t print(unsigned int value, int base = 10) { return print((unsigned long)value, base); }
+    size_t print(long value, int base = 10);
+    size_t print(unsigned long value, int base = 10);
+    size_t print(double value, int decimals = 2);
+
+    template <class T>
+    size_t println(const T& value) { size_t n = print(value); return n + println(); }
+    template <class T>
+    size_t println(const T& value, int format) { size_t n = print(value, format); return n + println(); }
+    size_t println() { return write((const uint8_t*)"\r\n", 2); }
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+class Stream : public Print {
+public:
+    virtual int available() { return 0; }
+    virtual int read() { return -1; }
+    size_t readBytes(char* buffer, size_t length);
+    String readStringUntil(char terminator);
+    void setTimeout(unsigned long ms) { timeoutMs = ms; }
+
+protected:
+    unsigned long timeoutMs = 1000;
+};
+
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long baud) { (void)baud; }
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* data, size_t length) override;
+    operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+class IPAddress {
+public:
+    IPAddress() : address(0) {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+        : address((uint32_t)a | ((uint32_t)b << 8) | ((uint32_t)c << 16) | ((uint32_t)d << 24)) {}
+    explicit IPAddress(uint32_t raw) : address(raw) {}
+    String toString() const;
+    operator uint32_t() const { return address; }
+
+private:
+    uint32_t address;
+};
+
+// ----- ESP / PSRAM -----
+struct EspClass {
+    uint32_t getFreeHeap();
+    uint32_t getMinFreeHeap();
+    uint32_t getMaxAllocHeap();
+    uint32_t getHeapSize();
+    uint32_t getPsramSize();
+    uint32_t getFreePsram();
+    uint32_t getMinFreePsram();
+    uint32_t getMaxAllocPsram();
+    uint64_t getEfuseMac();
+    uint32_t getCpuFreqMHz();
+    void restart();
+    uint32_t getCycleCount();
+    const char* getSdkVersion();
+    uint32_t getFlashChipSize();
+};
+
+extern EspClass ESP;
+
+bool psramFound();
+void* ps_malloc(size_t size);
+void* ps_calloc(size_t count, size_t size);
+void* ps_realloc(void* ptr, size_t size);
+
+// Heap hooks as in ESP-IDF with CONFIG_HEAP_USE_HOOKS: host_alloc.cpp wraps malloc and
+// reports every allocation to this hook when the sketch defines it.
+#define CONFIG_HEAP_USE_HOOKS 1
+extern "C" void esp_heap_trace_alloc_hook(void* ptr, size_t size, uint32_t caps) __attribute__((weak));
+
+// ----- FreeRTOS (threads and recursive mutexes) -----
+typedef void* SemaphoreHandle_t;
+typedef void* TaskHandle_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define portMAX_DELAY 0xffffffff
+#define portTICK_PERIOD_MS 1
+#define pdPASS 1
+#define pdFAIL 0
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdMS_TO_TICKS(x) (x)
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex();
+SemaphoreHandle_t xSemaphoreCreateMutex();
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t semaphore, TickType_t ticks);
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t semaphore);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore);
+BaseType_t xTaskCreatePinnedToCore(void (*task)(void*), const char* name, uint32_t stackSize, void* parameter,
+                                   UBaseType_t priority, TaskHandle_t* handle, BaseType_t core);
+void vTaskDelay(TickType_t ticks);
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+TaskHandle_t xTaskGetCurrentTaskHandle();
+TickType_t xTaskGetTickCount();
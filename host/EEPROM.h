@@ -0,0 +1,32 @@
+// EEPROM shim backed by <data dir>/eeprom.bin; commit() writes the whole image.
+#pragma once
+
+#include "Arduino.h"
+
+#include <vector>
+
+class EEPROMClass {
+public:
+    bool begin(size_t size);
+    void end();
+    bool commit();
+    uint8_t read(int address);
+    void write(int address, uint8_t value);
+
+    template <class T>
+    T& get(int address, T& value) {
+        if (address >= 0 && address + sizeof(T) <= data.size()) memcpy(&value, &data[address], sizeof(T));
+        return value;
+    }
+
+    template <class T>
+    const T& put(int address, const T& value) {
+        if (address >= 0 && address + sizeof(T) <= data.size()) memcpy(&data[address], &value, sizeof(T));
+        return value;
+    }
+
+private:
+    std::vector<uint8_t> data;
+};
+
+extern EEPROMClass EEPROM;
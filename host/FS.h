@@ -0,0 +1,48 @@
+// File system shim: File wraps a stdio FILE* under the host data directory.
+#pragma once
+
+#include "Arduino.h"
+
+#include <memory>
+
+class File : public Stream {
+public:
+    File() {}
+    File(std::shared_ptr<FILE> handle, const String& path) : handle(handle), path(path) {}
+
+    using Print::write;
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t* data, size_t length) override;
+    size_t read(uint8_t* buffer, size_t length);
+    int read() override;
+    int available() override;
+    bool seek(uint32_t position);
+    size_t position();
+    size_t size();
+    void flush();
+    void close();
+    operator bool() const { return handle != nullptr; }
+    const char* name() { return path.c_str(); }
+
+private:
+    std::shared_ptr<FILE> handle;
+    String path;
+};
+
+namespace fs {
+
+class FS {
+public:
+    File open(const char* path, const char* mode = "r");
+    bool exists(const char* path);
+    bool remove(const char* path);
+    bool rename(const char* from, const char* to);
+    bool mkdir(const char* path);
+
+protected:
+    std::string hostPath(const char* path);
+};
+
+}  // namespace fs
+
+using fs::FS;
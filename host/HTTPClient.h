@@ -0,0 +1,53 @@
+// HTTPClient shim: plain http:// over sockets (no TLS). The whole body is read in GET()
+// and then served from memory by getString()/getStream().
+#pragma once
+
+#include "WiFi.h"
+
+#include <vector>
+
+#define HTTP_CODE_OK 200
+#define HTTP_CODE_NOT_MODIFIED 304
+#define HTTP_CODE_NOT_FOUND 404
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTPC_ERROR_SEND_HEADER_FAILED (-2)
+#define HTTPC_ERROR_CONNECTION_LOST (-5)
+#define HTTPC_ERROR_READ_TIMEOUT (-11)
+
+class HTTPClient {
+public:
+    bool begin(const String& url);
+    void end();
+    void setTimeout(uint16_t ms) { timeoutMs = ms; }
+    void setConnectTimeout(int32_t ms) { (void)ms; }
+    void setReuse(bool reuse) { (void)reuse; }
+    void addHeader(const String& name, const String& value);
+    void collectHeaders(const char* names[], size_t count);
+
+    int GET();
+    int POST(const String& payload);
+
+    String getString();
+    int getSize();
+    WiFiClient* getStreamPtr();
+    WiFiClient& getStream();
+    String header(const char* name);
+    bool hasHeader(const char* name);
+    bool connected();
+
+    static String errorToString(int code);
+
+private:
+    int request(const char* method, const String& payload);
+
+    String host;
+    uint16_t port = 80;
+    String path;
+    bool secure = false;
+    uint16_t timeoutMs = 5000;
+    String requestHeaders;
+    std::vector<String> wantedHeaders;
+    std::vector<String> responseHeaders;   // name, value, name, value...
+    String body;
+    WiFiClient bodyStream;
+};
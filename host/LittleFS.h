@@ -0,0 +1,13 @@
+// LittleFS shim: the tree lives in <data dir>/littlefs.
+#pragma once
+
+#include "FS.h"
+
+class LittleFSFS : public fs::FS {
+public:
+    bool begin(bool formatOnFail = false);
+    size_t totalBytes();
+    size_t usedBytes();
+};
+
+extern LittleFSFS LittleFS;
@@ -0,0 +1,4 @@
+// SPI shim: the display shim records calls instead of driving a bus.
+#pragma once
+
+#include "Arduino.h"
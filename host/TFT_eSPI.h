@@ -0,0 +1,56 @@
+// Recording TFT: nothing is drawn; frames, draw calls and printed text are kept
+// in hostTftRecord() so runs can assert on what the display would show.
+#pragma once
+
+#include "Arduino.h"
+
+#define TFT_BLACK 0x0000
+#define TFT_NAVY 0x000F
+#define TFT_DARKGREEN 0x03E0
+#define TFT_MAROON 0x7800
+#define TFT_BLUE 0x001F
+#define TFT_GREEN 0x07E0
+#define TFT_CYAN 0x07FF
+#define TFT_RED 0xF800
+#define TFT_MAGENTA 0xF81F
+#define TFT_YELLOW 0xFFE0
+#define TFT_WHITE 0xFFFF
+#define TFT_ORANGE 0xFDA0
+#define TFT_DARKGREY 0x7BEF
+#define TFT_LIGHTGREY 0xD69A
+
+class TFT_eSPI : public Print {
+public:
+    TFT_eSPI(int16_t w = 240, int16_t h = 320) : baseWidth(w), baseHeight(h), rotation(0) {}
+
+    void init();
+    void setRotation(uint8_t r);
+    void fillScreen(uint32_t color);
+    void setTextSize(uint8_t size) { (void)size; }
+    void setTextColor(uint16_t color) { (void)color; }
+    void setTextColor(uint16_t color, uint16_t background) { (void)color; (void)background; }
+    void setTextWrap(bool wrapX, bool wrapY = false) { (void)wrapX; (void)wrapY; }
+    void setCursor(int16_t x, int16_t y);
+    void invertDisplay(bool invert) { (void)invert; }
+
+    void drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+    void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+    void drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color);
+    void drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color);
+    void drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color);
+    void drawPixel(int32_t x, int32_t y, uint32_t color);
+    uint16_t color565(uint8_t r, uint8_t g, uint8_t b) {
+        return (uint16_t)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+    }
+
+    using Print::write;
+    size_t write(uint8_t c) override;
+
+    int16_t width() { return rotation & 1 ? baseHeight : baseWidth; }
+    int16_t height() { return rotation & 1 ? baseWidth : baseHeight; }
+
+private:
+    int16_t baseWidth;
+    int16_t baseHeight;
+    uint8_t rotation;
+};
@@ -0,0 +1,85 @@
+// Synchronous WebServer shim over a real listening socket, one request per connection.
+// handleClient() accepts at most one pending connection, like the ESP32 core.
+#pragma once
+
+#include "WiFi.h"
+
+#include <functional>
+#include <vector>
+
+typedef enum { HTTP_ANY, HTTP_GET, HTTP_POST, HTTP_PUT, HTTP_DELETE } HTTPMethod;
+
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+#define CONTENT_LENGTH_NOT_SET ((size_t)-2)
+
+class WebServer {
+public:
+    typedef std::function<void(void)> THandlerFunction;
+
+    WebServer(int port = 80);
+
+    void on(const String& uri, THandlerFunction handler);
+    void on(const String& uri, HTTPMethod method, THandlerFunction handler);
+    void onNotFound(THandlerFunction handler);
+
+    void begin();
+    void handleClient();
+    void stop();
+
+    void send(int code, const char* contentType, const String& content);
+    void send(int code, const String& contentType, const String& content);
+    void send(int code, const char* contentType = "", const char* content = "");
+    void send(int code, const char* contentType, const char* content, size_t length);
+    void send_P(int code, PGM_P contentType, PGM_P content);
+    void send_P(int code, PGM_P contentType, PGM_P content, size_t length);
+
+    void sendHeader(const String& name, const String& value, bool first = false);
+    void setContentLength(size_t length);
+    void sendContent(const String& content);
+    void sendContent(const char* content, size_t length);
+    void sendContent_P(PGM_P content, size_t length);
+
+    String arg(const String& name);
+    String arg(int index);
+    String argName(int index);
+    int args();
+    bool hasArg(const String& name);
+
+    String header(const String& name);
+    bool hasHeader(const String& name);
+    void collectHeaders(const char* names[], size_t count);
+
+    String uri();
+    HTTPMethod method();
+    WiFiClient client();
+
+private:
+    typedef struct {
+        String uri;
+        HTTPMethod method;
+        THandlerFunction handler;
+    } Route;
+
+    typedef struct {
+        String name;
+        String value;
+    } Pair;
+
+    bool readRequest();
+    void parseArgs(const String& query);
+    void sendHeaders(int code, const char* contentType, size_t length);
+
+    WiFiServer listener;
+    std::vector<Route> routes;
+    THandlerFunction notFound;
+
+    WiFiClient current;
+    String currentUri;
+    HTTPMethod currentMethod;
+    std::vector<Pair> currentArgs;
+    std::vector<Pair> currentHeaders;
+    std::vector<String> wantedHeaders;
+    String pendingHeaders;
+    size_t contentLength;
+    bool headersSent;
+};
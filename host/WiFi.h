@@ -0,0 +1,117 @@
+// WiFi shim: the host is always "connected" in STA mode; clients are real TCP sockets.
+#pragma once
+
+#include "Arduino.h"
+
+#include <memory>
+
+typedef enum {
+    WIFI_OFF = 0,
+    WIFI_STA,
+    WIFI_AP,
+    WIFI_AP_STA,
+    WIFI_MODE_NULL = 0,
+    WIFI_MODE_STA = 1,
+    WIFI_MODE_AP = 2,
+    WIFI_MODE_APSTA = 3
+} wifi_mode_t;
+
+typedef enum {
+    WL_IDLE_STATUS,
+    WL_NO_SSID_AVAIL,
+    WL_CONNECTED,
+    WL_CONNECT_FAILED,
+    WL_DISCONNECTED
+} wl_status_t;
+
+// Shared between copies of a WiFiClient, like the ESP32 core: the socket closes
+// when the last copy goes away. rx holds bytes already read (or a canned body).
+struct HostSocket {
+    int fd;
+    std::string rx;
+    size_t rxPos;
+    bool peerClosed;
+    HostSocket(int descriptor) : fd(descriptor), rxPos(0), peerClosed(false) {}
+    ~HostSocket();
+};
+
+class WiFiClient : public Stream {
+public:
+    WiFiClient() {}
+    explicit WiFiClient(std::shared_ptr<HostSocket> socket) : socket(socket) {}
+
+    using Print::write;
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t* data, size_t length) override;
+    int available() override;
+    int read() override;
+
+    bool connect(const char* host, uint16_t port);
+    bool connected();
+    void stop();
+    IPAddress remoteIP();
+    void setNoDelay(bool noDelay);
+    operator bool() { return connected(); }
+
+    // host only: blocks up to timeoutMs for more data; false on close/timeout
+    bool fill(unsigned long timeoutMs);
+
+private:
+    std::shared_ptr<HostSocket> socket;
+};
+
+class WiFiServer {
+public:
+    WiFiServer(uint16_t port) : port(port), fd(-1) {}
+    void begin();
+    void stop();
+    WiFiClient available();
+
+private:
+    uint16_t port;
+    int fd;
+};
+
+struct WiFiClass {
+    bool mode(wifi_mode_t m);
+    wifi_mode_t getMode();
+    int RSSI();
+    int RSSI(int index);
+    String SSID();
+    String SSID(int index);
+    wl_status_t status();
+
+    IPAddress softAPIP();
+    IPAddress localIP();
+    IPAddress gatewayIP();
+    IPAddress subnetMask();
+    IPAddress dnsIP(int index = 0);
+
+    bool disconnect(bool wifiOff = false, bool eraseAp = false);
+    bool softAP(const char* ssid, const char* password = nullptr, int channel = 1, int hidden = 0, int maxConnections = 4);
+    wl_status_t begin(const char* ssid, const char* password = nullptr);
+    int scanNetworks(bool async = false, bool hidden = false, bool passive = false, uint32_t msPerChannel = 300);
+    void scanDelete();
+    int scanComplete();
+
+    int32_t channel();
+    int32_t channel(int index);
+    String macAddress();
+    String softAPmacAddress();
+    bool softAPdisconnect(bool wifiOff = false);
+    bool softAPConfig(IPAddress local, IPAddress gateway, IPAddress subnet);
+    bool setSleep(bool enable);
+    bool setAutoReconnect(bool enable);
+    void persistent(bool enable);
+    int encryptionType(int index);
+    int softAPgetStationNum();
+    bool setHostname(const char* name);
+
+    // host only
+    wifi_mode_t currentMode = WIFI_OFF;
+    wl_status_t currentStatus = WL_DISCONNECTED;
+    String currentSsid;
+    int rssi = -55;
+};
+
+extern WiFiClass WiFi;
@@ -0,0 +1,4 @@
+// Wire shim: no I2C peripherals are used by the sketch.
+#pragma once
+
+#include "Arduino.h"
@@ -0,0 +1,55 @@
+// Host-side controls for the Linux build: clock, data directory, recorded I/O.
+// Benchmarks and regression runs drive the sketch through these instead of hardware.
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+// ----- Clock -----
+// Real clock by default. In fake mode millis()/micros() only move when the harness
+// (or delay() on the loop thread) advances them, so runs are reproducible.
+void hostUseFakeClock(bool fake);
+bool hostFakeClock();
+void hostAdvanceMicros(uint64_t us);
+void hostAdvanceMillis(unsigned long ms);
+
+// ----- Storage -----
+// EEPROM image and LittleFS tree live under this directory (default ./host_data,
+// or $PORTFOLIO_HOST_DATA).
+void hostSetDataDir(const std::string& dir);
+const std::string& hostDataDir();
+
+// ----- Network -----
+// port 80 is privileged on Linux, so WebServer(80) binds to this port instead.
+void hostSetHttpPort(int port);
+int hostHttpPort();
+
+// ----- Serial -----
+// Serial output goes to stdout unless disabled (benchmarks keep it quiet).
+void hostSetSerialEcho(bool echo);
+
+// ----- Recorded peripherals -----
+typedef struct {
+    uint32_t frames;            // fillScreen calls
+    uint32_t drawCalls;         // rect/line/pixel calls since boot
+    uint32_t textBytes;         // characters printed since boot
+    std::vector<std::string> lastFrameText;   // one entry per setCursor() run of text
+} HostTftRecord;
+
+const HostTftRecord& hostTftRecord();
+void hostTftDump(FILE* out);
+
+typedef struct {
+    uint32_t tones;
+    uint32_t lastToneFrequency;
+    int pinState[40];
+    int analogValue[40];        // returned by analogRead(), set by the harness
+} HostGpioRecord;
+
+HostGpioRecord& hostGpio();
+
+// ESP.restart() calls this; the default exits the process.
+extern void (*hostRestartHandler)();
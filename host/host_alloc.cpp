@@ -0,0 +1,37 @@
+// malloc wrapper: forwards to glibc and reports each allocation to the ESP-IDF style
+// heap hook (see Arduino.h), so the benchmark counts bytes allocated the same way on
+// host and device. operator new goes through malloc in libstdc++, so it is covered too.
+
+#include "Arduino.h"
+
+extern "C" {
+
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void __libc_free(void* ptr);
+
+void* malloc(size_t size) {
+    void* ptr = __libc_malloc(size);
+    if (ptr != NULL && esp_heap_trace_alloc_hook != NULL) esp_heap_trace_alloc_hook(ptr, size, 0);
+    return ptr;
+}
+
+void* calloc(size_t count, size_t size) {
+    void* ptr = __libc_calloc(count, size);
+    if (ptr != NULL && esp_heap_trace_alloc_hook != NULL) esp_heap_trace_alloc_hook(ptr, count * size, 0);
+    return ptr;
+}
+
+// a realloc counts as a fresh allocation of the new size, as heap_caps_realloc does
+void* realloc(void* ptr, size_t size) {
+    void* moved = __libc_realloc(ptr, size);
+    if (moved != NULL && esp_heap_trace_alloc_hook != NULL) esp_heap_trace_alloc_hook(moved, size, 0);
+    return moved;
+}
+
+void free(void* ptr) {
+    __libc_free(ptr);
+}
+
+}  // extern "C"
@@ -0,0 +1,560 @@
+// Arduino core shim: clock, String, Print/Serial, GPIO recording, ESP, FreeRTOS.
+
+#include "Arduino.h"
+#include "esp_heap_caps.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <thread>
+
+// ===== CLOCK =====
+static const std::chrono::steady_clock::time_point hostBoot = std::chrono::steady_clock::now();
+static std::atomic<bool> fakeClock(false);
+static std::atomic<uint64_t> fakeMicros(0);
+
+void hostUseFakeClock(bool fake) {
+    fakeMicros = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - hostBoot).count();
+    fakeClock = fake;
+}
+
+bool hostFakeClock() {
+    return fakeClock;
+}
+
+void hostAdvanceMicros(uint64_t us) {
+    fakeMicros += us;
+}
+
+void hostAdvanceMillis(unsigned long ms) {
+    fakeMicros += (uint64_t)ms * 1000;
+}
+
+static uint64_t hostMicros() {
+    if (fakeClock) return fakeMicros;
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - hostBoot).count();
+}
+
+// 32-bit like the ESP32: millis() wraps after ~49 days, micros() after ~71 minutes
+unsigned long millis() {
+    return (uint32_t)(hostMicros() / 1000);
+}
+
+unsigned long micros() {
+    return (uint32_t)hostMicros();
+}
+
+void delay(unsigned long ms) {
+    if (fakeClock) {
+        hostAdvanceMillis(ms);
+        std::this_thread::yield();
+    } else {
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    }
+}
+
+void yield() {
+    std::this_thread::yield();
+}
+
+static long timeZoneOffset = 0;
+
+void configTime(long gmtOffset, int daylightOffset, const char* server1, const char* server2, const char* server3) {
+    (void)server1;
+    (void)server2;
+    (void)server3;
+    timeZoneOffset = gmtOffset + daylightOffset;
+}
+
+bool getLocalTime(struct tm* info, uint32_t ms) {
+    (void)ms;
+    time_t now = time(NULL) + timeZoneOffset;
+    return gmtime_r(&now, info) != NULL;
+}
+
+// ===== GPIO =====
+static HostGpioRecord gpio;
+static int ledcChannelPin[16];
+
+HostGpioRecord& hostGpio() {
+    return gpio;
+}
+
+void pinMode(int pin, int mode) {
+    (void)pin;
+    (void)mode;
+}
+
+void digitalWrite(int pin, int value) {
+    if (pin >= 0 && pin < 40) gpio.pinState[pin] = value;
+}
+
+int digitalRead(int pin) {
+    return (pin >= 0 && pin < 40) ? gpio.pinState[pin] : 0;
+}
+
+int analogRead(int pin) {
+    return (pin >= 0 && pin < 40) ? gpio.analogValue[pin] : 0;
+}
+
+void analogWrite(int pin, int value) {
+    digitalWrite(pin, value);
+}
+
+void tone(int pin, unsigned int frequency, unsigned long duration) {
+    (void)pin;
+    (void)duration;
+    gpio.tones++;
+    gpio.lastToneFrequency = frequency;
+}
+
+void noTone(int pin) {
+    (void)pin;
+}
+
+void ledcSetup(int channel, int frequency, int resolution) {
+    (void)channel;
+    (void)frequency;
+    (void)resolution;
+}
+
+void ledcAttachPin(int pin, int channel) {
+    if (channel >= 0 && channel < 16) ledcChannelPin[channel] = pin;
+}
+
+void ledcWrite(int channel, int duty) {
+    if (channel >= 0 && channel < 16) digitalWrite(ledcChannelPin[channel], duty);
+}
+
+void ledcWriteTone(int channel, int frequency) {
+    if (frequency > 0) tone(channel < 16 ? ledcChannelPin[channel] : -1, frequency);
+}
+
+long map(long x, long inMin, long inMax, long outMin, long outMax) {
+    if (inMax == inMin) return outMin;
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+// ===== RANDOM =====
+static std::mt19937 rng(12345);
+
+uint32_t esp_random() {
+    return rng();
+}
+
+long random(long high) {
+    return high > 0 ? (long)(esp_random() % (uint32_t)high) : 0;
+}
+
+long random(long low, long high) {
+    return high > low ? low + random(high - low) : low;
+}
+
+void randomSeed(unsigned long seed) {
+    rng.seed(seed);
+}
+
+// ===== STRING =====
+static std::string numberToString(unsigned long long value, unsigned char base, bool negative) {
+    if (base < 2 || base > 36) base = 10;
+    char digits[72];
+    int n = 0;
+    do {
+        int d = (int)(value % base);
+        digits[n++] = (char)(d < 10 ? '0' + d : 'a' + d - 10);
+        value /= base;
+    } while (value > 0);
+    std::string text = negative ? "-" : "";
+    while (n > 0) text += digits[--n];
+    return text;
+}
+
+static std::string floatToString(double value, unsigned int decimals) {
+    char text[64];
+    snprintf(text, sizeof(text), "%.*f", (int)decimals, value);
+    return text;
+}
+
+String::String(const char* s) : buffer(s ? s : "") {}
+String::String(const String& other) : buffer(other.buffer) {}
+String::String(char c) : buffer(1, c) {}
+
+// like the ESP32 core, negative values in a non-decimal base print as unsigned
+String::String(int value, unsigned char base)
+    : buffer(base == 10 ? numberToString(value < 0 ? -(long long)value : value, 10, value < 0)
+                        : numberToString((unsigned int)value, base, false)) {}
+String::String(unsigned int value, unsigned char base) : buffer(numberToString(value, base, false)) {}
+String::String(long value, unsigned char base)
+    : buffer(base == 10 ? numberToString(value < 0 ? -(long long)value : value, 10, value < 0)
+                        : numberToString((unsigned long)value, base, false)) {}
+String::String(unsigned long value, unsigned char base) : buffer(numberToString(value, base, false)) {}
+String::String(long long value, unsigned char base)
+    : buffer(base == 10 ? numberToString(value < 0 ? -(unsigned long long)value : value, 10, value < 0)
+                        : numberToString((unsigned long long)value, base, false)) {}
+String::String(unsigned long long value, unsigned char base) : buffer(numberToString(value, base, false)) {}
+String::String(float value, unsigned int decimals) : buffer(floatToString(value, decimals)) {}
+String::String(double value, unsigned int decimals) : buffer(floatToString(value, decimals)) {}
+
+String& String::operator=(const String& other) {
+    buffer = other.buffer;
+    return *this;
+}
+
+String& String::operator=(const char* s) {
+    buffer = s ? s : "";
+    return *this;
+}
+
+bool String::concat(const String& s) {
+    buffer += s.buffer;
+    return true;
+}
+
+bool String::concat(const char* s) {
+    if (s) buffer += s;
+    return true;
+}
+
+bool String::concat(const char* s, unsigned int length) {
+    if (s) buffer.append(s, length);
+    return true;
+}
+
+bool String::concat(char c) {
+    buffer += c;
+    return true;
+}
+
+char& String::operator[](unsigned int index) {
+    static char dummy;
+    if (index >= buffer.size()) {
+        dummy = 0;
+        return dummy;
+    }
+    return buffer[index];
+}
+
+String String::substring(unsigned int from) const {
+    return substring(from, length());
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+    if (from > to) std::swap(from, to);
+    if (from >= buffer.size()) return String();
+    if (to > buffer.size()) to = buffer.size();
+    return String(buffer.substr(from, to - from).c_str());
+}
+
+int String::indexOf(char c, unsigned int from) const {
+    size_t pos = buffer.find(c, from);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::indexOf(const char* s) const {
+    size_t pos = buffer.find(s);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::lastIndexOf(char c) const {
+    size_t pos = buffer.rfind(c);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+bool String::startsWith(const String& s) const {
+    return buffer.compare(0, s.buffer.size(), s.buffer) == 0;
+}
+
+bool String::endsWith(const String& s) const {
+    return buffer.size() >= s.buffer.size() &&
+           buffer.compare(buffer.size() - s.buffer.size(), s.buffer.size(), s.buffer) == 0;
+}
+
+bool String::equalsIgnoreCase(const String& s) const {
+    return strcasecmp(buffer.c_str(), s.buffer.c_str()) == 0 && buffer.size() == s.buffer.size();
+}
+
+void String::setCharAt(unsigned int index, char c) {
+    if (index < buffer.size()) buffer[index] = c;
+}
+
+void String::trim() {
+    size_t begin = 0;
+    size_t end = buffer.size();
+    while (begin < end && isspace((unsigned char)buffer[begin])) begin++;
+    while (end > begin && isspace((unsigned char)buffer[end - 1])) end--;
+    buffer = buffer.substr(begin, end - begin);
+}
+
+void String::toLowerCase() {
+    for (size_t i = 0; i < buffer.size(); i++) buffer[i] = (char)tolower((unsigned char)buffer[i]);
+}
+
+void String::toUpperCase() {
+    for (size_t i = 0; i < buffer.size(); i++) buffer[i] = (char)toupper((unsigned char)buffer[i]);
+}
+
+void String::replace(const String& find, const String& with) {
+    if (find.buffer.empty()) return;
+    size_t pos = 0;
+    while ((pos = buffer.find(find.buffer, pos)) != std::string::npos) {
+        buffer.replace(pos, find.buffer.size(), with.buffer);
+        pos += with.buffer.size();
+    }
+}
+
+void String::remove(unsigned int index) {
+    if (index < buffer.size()) buffer.erase(index);
+}
+
+void String::remove(unsigned int index, unsigned int count) {
+    if (index < buffer.size()) buffer.erase(index, count);
+}
+
+void String::toCharArray(char* out, unsigned int size) const {
+    getBytes((unsigned char*)out, size);
+}
+
+void String::getBytes(unsigned char* out, unsigned int size) const {
+    if (size == 0) return;
+    size_t n = std::min((size_t)size - 1, buffer.size());
+    memcpy(out, buffer.data(), n);
+    out[n] = 0;
+}
+
+String operator+(const String& a, const String& b) { String r(a); r += b; return r; }
+String operator+(const String& a, const char* b) { String r(a); r += b; return r; }
+String operator+(const char* a, const String& b) { String r(a); r += b; return r; }
+String operator+(const String& a, char b) { String r(a); r += b; return r; }
+String operator+(const String& a, int b) { return a + String(b); }
+String operator+(const String& a, unsigned int b) { return a + String(b); }
+String operator+(const String& a, long b) { return a + String(b); }
+String operator+(const String& a, unsigned long b) { return a + String(b); }
+String operator+(const String& a, float b) { return a + String(b); }
+String operator+(const String& a, double b) { return a + String(b); }
+
+String IPAddress::toString() const {
+    char text[16];
+    snprintf(text, sizeof(text), "%u.%u.%u.%u", address & 0xFF, (address >> 8) & 0xFF,
+             (address >> 16) & 0xFF, (address >> 24) & 0xFF);
+    return String(text);
+}
+
+// ===== PRINT / STREAM / SERIAL =====
+size_t Print::write(const uint8_t* data, size_t length) {
+    size_t n = 0;
+    while (length--) n += write(*data++);
+    return n;
+}
+
+size_t Print::print(long value, int base) {
+    return print(String(value, (unsigned char)base));
+}
+
+size_t Print::print(unsigned long value, int base) {
+    return print(String(value, (unsigned char)base));
+}
+
+size_t Print::print(double value, int decimals) {
+    return print(String(value, (unsigned int)decimals));
+}
+
+size_t Print::printf(const char* format, ...) {
+    char small[128];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(small, sizeof(small), format, args);
+    va_end(args);
+    if (length < 0) return 0;
+    if ((size_t)length < sizeof(small)) return write((const uint8_t*)small, length);
+
+    std::string large(length + 1, '\0');
+    va_start(args, format);
+    vsnprintf(&large[0], large.size(), format, args);
+    va_end(args);
+    return write((const uint8_t*)large.data(), length);
+}
+
+size_t Stream::readBytes(char* buffer, size_t length) {
+    size_t count = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (count < length) {
+        int c = read();
+        if (c >= 0) {
+            buffer[count++] = (char)c;
+            continue;
+        }
+        if (std::chrono::steady_clock::now() - start > std::chrono::milliseconds(timeoutMs)) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return count;
+}
+
+String Stream::readStringUntil(char terminator) {
+    String result;
+    auto start = std::chrono::steady_clock::now();
+    for (;;) {
+        int c = read();
+        if (c >= 0) {
+            if (c == terminator) break;
+            result += (char)c;
+            continue;
+        }
+        if (available() == 0 && std::chrono::steady_clock::now() - start > std::chrono::milliseconds(timeoutMs)) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return result;
+}
+
+HardwareSerial Serial;
+static std::atomic<bool> serialEcho(true);
+
+void hostSetSerialEcho(bool echo) {
+    serialEcho = echo;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+    if (serialEcho) fputc(c, stdout);
+    return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t* data, size_t length) {
+    if (serialEcho) fwrite(data, 1, length, stdout);
+    return length;
+}
+
+// ===== ESP =====
+// nominal WROVER figures; the host heap says nothing about the device
+EspClass ESP;
+void (*hostRestartHandler)() = NULL;
+
+uint32_t EspClass::getFreeHeap() { return 180 * 1024; }
+uint32_t EspClass::getMinFreeHeap() { return 150 * 1024; }
+uint32_t EspClass::getMaxAllocHeap() { return 110 * 1024; }
+uint32_t EspClass::getHeapSize() { return 320 * 1024; }
+uint32_t EspClass::getPsramSize() { return 4 * 1024 * 1024; }
+uint32_t EspClass::getFreePsram() { return 3 * 1024 * 1024; }
+uint32_t EspClass::getMinFreePsram() { return 3 * 1024 * 1024; }
+uint32_t EspClass::getMaxAllocPsram() { return 3 * 1024 * 1024; }
+uint64_t EspClass::getEfuseMac() { return 0x0000A4CF12345678ULL; }
+uint32_t EspClass::getCpuFreqMHz() { return 240; }
+uint32_t EspClass::getCycleCount() { return (uint32_t)(hostMicros() * 240); }
+const char* EspClass::getSdkVersion() { return "host"; }
+uint32_t EspClass::getFlashChipSize() { return 4 * 1024 * 1024; }
+
+void EspClass::restart() {
+    fflush(stdout);
+    if (hostRestartHandler != NULL) {
+        hostRestartHandler();
+    }
+    exit(0);
+}
+
+bool psramFound() {
+    return true;
+}
+
+void* ps_malloc(size_t size) {
+    return malloc(size);
+}
+
+void* ps_calloc(size_t count, size_t size) {
+    return calloc(count, size);
+}
+
+void* ps_realloc(void* ptr, size_t size) {
+    return realloc(ptr, size);
+}
+
+void* heap_caps_malloc(size_t size, uint32_t caps) {
+    (void)caps;
+    return malloc(size);
+}
+
+void* heap_caps_realloc(void* ptr, size_t size, uint32_t caps) {
+    (void)caps;
+    return realloc(ptr, size);
+}
+
+void heap_caps_free(void* ptr) {
+    free(ptr);
+}
+
+size_t heap_caps_get_free_size(uint32_t caps) {
+    return (caps & MALLOC_CAP_SPIRAM) ? ESP.getFreePsram() : ESP.getFreeHeap();
+}
+
+// ===== FREERTOS =====
+typedef struct {
+    const char* name;
+    uint32_t stackSize;
+} HostTask;
+
+static HostTask loopTask = { "loopTask", 8192 };
+static thread_local HostTask* currentTask = &loopTask;
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() {
+    return new std::recursive_timed_mutex();
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+    return new std::recursive_timed_mutex();
+}
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t semaphore, TickType_t ticks) {
+    std::recursive_timed_mutex* mutex = (std::recursive_timed_mutex*)semaphore;
+    if (ticks == portMAX_DELAY) {
+        mutex->lock();
+        return pdTRUE;
+    }
+    return mutex->try_lock_for(std::chrono::milliseconds(ticks)) ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t semaphore) {
+    ((std::recursive_timed_mutex*)semaphore)->unlock();
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks) {
+    return xSemaphoreTakeRecursive(semaphore, ticks);
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+    return xSemaphoreGiveRecursive(semaphore);
+}
+
+BaseType_t xTaskCreatePinnedToCore(void (*task)(void*), const char* name, uint32_t stackSize, void* parameter,
+                                   UBaseType_t priority, TaskHandle_t* handle, BaseType_t core) {
+    (void)priority;
+    (void)core;
+    HostTask* info = new HostTask();
+    info->name = name;
+    info->stackSize = stackSize;
+    if (handle != NULL) *handle = info;
+    std::thread([task, parameter, info]() {
+        currentTask = info;
+        task(parameter);
+    }).detach();
+    return pdPASS;
+}
+
+// 1 tick = 1 ms; task delays always sleep in real time so they never move the fake clock
+void vTaskDelay(TickType_t ticks) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
+
+// stack depth cannot be measured on the host; the configured size is reported
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+    HostTask* info = task != NULL ? (HostTask*)task : currentTask;
+    return info->stackSize;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+    return currentTask;
+}
+
+TickType_t xTaskGetTickCount() {
+    return (TickType_t)millis();
+}
@@ -0,0 +1,189 @@
+// Linux host build of the portfolio monitor.
+//
+// The unmodified sketch is compiled against the shims in this directory:
+// the clock can be real or fake, the TFT records instead of drawing,
+// WebServer/HTTPClient use real sockets (plain http only) and EEPROM/LittleFS
+// are files under the data directory. Benchmarks and regression runs build on this.
+//
+// Build (ArduinoJson 6.x is header-only; point -I at its src/ directory):
+//   g++ -std=gnu++17 -O2 -Ihost -I. -I<ArduinoJson>/src host/*.cpp -o portfolio_host -lpthread
+//
+// Usage:  ./portfolio_host [--port 8080] [--data DIR] [--fake-clock] [--step-ms 50]
+//                          [--loops N] [--quiet] [--dump-tft]
+//         ./portfolio_host --replay FILE [--speed 1000] [--expect-digest HEX] [--data DIR]
+//         ./portfolio_host --bench [--baseline FILE] [--save-baseline FILE] [--tolerance 25]
+//
+//   --fake-clock  millis() only advances by --step-ms per loop() (and by delay())
+//   --loops N     run N loop() iterations and exit (default: run forever)
+//   --quiet       do not echo Serial output
+//   --dump-tft    print the last recorded display frame on exit
+//   --replay FILE replay a payload recording on the fake clock (see replay.h) and
+//                 print alerts, per-stage CPU time and peak memory; without --data a
+//                 fresh temporary data directory is used so settings are the defaults
+//   --speed N     replay at N x real time (default 1000, 0 = as fast as possible)
+//   --expect-digest HEX  exit with status 1 if the replay's alert digest differs
+//   --bench       run the micro-benchmarks (BENCHMARKS section of the sketch) on the
+//                 real clock; with --baseline, exit with status 1 on any regression
+//                 beyond --tolerance percent. Baselines use the same format as the
+//                 device's "bench save", but host and device numbers are not interchangeable.
+
+#define ARDUINOJSON_ENABLE_ARDUINO_STRING 1
+#define ARDUINOJSON_ENABLE_ARDUINO_STREAM 1
+#define ARDUINOJSON_ENABLE_ARDUINO_PRINT 1
+
+#include "../portfolio_WROVER_patch_13.ino"
+
+#include "replay.h"
+
+#include <thread>
+
+static int runReplay(const char* path, double speed, const char* expectDigest, bool haveDataDir) {
+    if (!haveDataDir) {
+        char dir[] = "/tmp/portfolio_replay_XXXXXX";
+        if (mkdtemp(dir) == NULL) {
+            perror("mkdtemp");
+            return 2;
+        }
+        hostSetDataDir(dir);
+    }
+    hostUseFakeClock(true);
+    hostSetSerialEcho(false);
+    setup();
+
+    ReplayReport report;
+    if (!replayRun(path, speed, stdout, report)) return 2;
+    replayPrintReport(report, stdout);
+
+    if (expectDigest != NULL && strtoul(expectDigest, NULL, 16) != report.digest) {
+        fprintf(stderr, "replay: alert digest %08x, expected %s\n", report.digest, expectDigest);
+        return 1;
+    }
+    return 0;
+}
+
+static int runBench(const char* baselinePath, const char* savePath, int tolerancePercent, bool haveDataDir) {
+    if (!haveDataDir) {
+        char dir[] = "/tmp/portfolio_bench_XXXXXX";
+        if (mkdtemp(dir) == NULL) {
+            perror("mkdtemp");
+            return 2;
+        }
+        hostSetDataDir(dir);
+    }
+    hostSetSerialEcho(false);
+    setup();
+    hostSetSerialEcho(true);
+
+    BenchResult results[BENCH_MAX_RESULTS];
+    int count = runBenchmarks(results, BENCH_MAX_RESULTS, Serial);
+    if (count == 0) return 2;
+
+    if (savePath != NULL) {
+        FILE* f = fopen(savePath, "w");
+        if (f == NULL) {
+            fprintf(stderr, "bench: cannot write %s: %s\n", savePath, strerror(errno));
+            return 2;
+        }
+        String text = benchBaselineText(results, count);
+        fwrite(text.c_str(), 1, text.length(), f);
+        fclose(f);
+        printf("baseline saved to %s\n", savePath);
+    }
+
+    if (baselinePath != NULL) {
+        FILE* f = fopen(baselinePath, "r");
+        if (f == NULL) {
+            fprintf(stderr, "bench: cannot read %s: %s\n", baselinePath, strerror(errno));
+            return 2;
+        }
+        String baseline;
+        int c;
+        while ((c = fgetc(f)) != EOF) baseline += (char)c;
+        fclose(f);
+        if (benchCompare(results, count, baseline, tolerancePercent, Serial) > 0) return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    unsigned long stepMs = 50;
+    long loops = -1;
+    bool dumpTft = false;
+    const char* replayPath = NULL;
+    const char* expectDigest = NULL;
+    double speed = 1000;
+    bool haveDataDir = false;
+    bool bench = false;
+    const char* baselinePath = NULL;
+    const char* saveBaselinePath = NULL;
+    int tolerancePercent = BENCH_TOLERANCE_PERCENT;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--port" && i + 1 < argc) {
+            hostSetHttpPort(atoi(argv[++i]));
+        } else if (arg == "--data" && i + 1 < argc) {
+            hostSetDataDir(argv[++i]);
+            haveDataDir = true;
+        } else if (arg == "--fake-clock") {
+            hostUseFakeClock(true);
+        } else if (arg == "--step-ms" && i + 1 < argc) {
+            stepMs = strtoul(argv[++i], NULL, 10);
+        } else if (arg == "--loops" && i + 1 < argc) {
+            loops = atol(argv[++i]);
+        } else if (arg == "--quiet") {
+            hostSetSerialEcho(false);
+        } else if (arg == "--dump-tft") {
+            dumpTft = true;
+        } else if (arg == "--replay" && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (arg == "--speed" && i + 1 < argc) {
+            speed = atof(argv[++i]);
+        } else if (arg == "--expect-digest" && i + 1 < argc) {
+            expectDigest = argv[++i];
+        } else if (arg == "--bench") {
+            bench = true;
+        } else if (arg == "--baseline" && i + 1 < argc) {
+            baselinePath = argv[++i];
+        } else if (arg == "--save-baseline" && i + 1 < argc) {
+            saveBaselinePath = argv[++i];
+        } else if (arg == "--tolerance" && i + 1 < argc) {
+            tolerancePercent = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [--port N] [--data DIR] [--fake-clock] [--step-ms MS] "
+                            "[--loops N] [--quiet] [--dump-tft]\n"
+                            "       %s --replay FILE [--speed N] [--expect-digest HEX] [--data DIR]\n"
+                            "       %s --bench [--baseline FILE] [--save-baseline FILE] [--tolerance PCT]\n",
+                    argv[0], argv[0], argv[0]);
+            return 2;
+        }
+    }
+
+    if (bench) {
+        int status = runBench(baselinePath, saveBaselinePath, tolerancePercent, haveDataDir);
+        fflush(stdout);
+        return status;
+    }
+
+    if (replayPath != NULL) {
+        int status = runReplay(replayPath, speed, expectDigest, haveDataDir);
+        fflush(stdout);
+        if (dumpTft) hostTftDump(stdout);
+        return status;
+    }
+
+    setup();
+    for (long n = 0; loops < 0 || n < loops; n++) {
+        loop();
+        if (hostFakeClock()) {
+            hostAdvanceMillis(stepMs);
+        } else {
+            // loop() spins freely on the ESP32; give the host CPU back between iterations
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    fflush(stdout);
+    if (dumpTft) hostTftDump(stdout);
+    return 0;
+}
@@ -0,0 +1,769 @@
+// Network shim: WiFi state, TCP WiFiClient/WiFiServer, WebServer and HTTPClient on POSIX sockets.
+
+#include "WebServer.h"
+#include "HTTPClient.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+static int httpPort = 8080;
+
+void hostSetHttpPort(int port) {
+    httpPort = port;
+}
+
+int hostHttpPort() {
+    return httpPort;
+}
+
+// ===== SOCKETS =====
+HostSocket::~HostSocket() {
+    if (fd >= 0) close(fd);
+}
+
+size_t WiFiClient::write(const uint8_t* data, size_t length) {
+    if (!socket || socket->fd < 0) return 0;
+    size_t sent = 0;
+    while (sent < length) {
+        ssize_t n = send(socket->fd, data + sent, length - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            socket->peerClosed = true;
+            break;
+        }
+        sent += (size_t)n;
+    }
+    return sent;
+}
+
+bool WiFiClient::fill(unsigned long timeoutMs) {
+    if (!socket || socket->fd < 0 || socket->peerClosed) return false;
+    struct pollfd p = { socket->fd, POLLIN, 0 };
+    if (poll(&p, 1, (int)timeoutMs) <= 0) return false;
+
+    char buffer[4096];
+    ssize_t n = recv(socket->fd, buffer, sizeof(buffer), 0);
+    if (n <= 0) {
+        socket->peerClosed = true;
+        return false;
+    }
+    if (socket->rxPos == socket->rx.size()) {
+        socket->rx.clear();
+        socket->rxPos = 0;
+    }
+    socket->rx.append(buffer, (size_t)n);
+    return true;
+}
+
+int WiFiClient::available() {
+    if (!socket) return 0;
+    if (socket->rxPos == socket->rx.size()) fill(0);
+    return (int)(socket->rx.size() - socket->rxPos);
+}
+
+int WiFiClient::read() {
+    if (available() == 0) return -1;
+    return (uint8_t)socket->rx[socket->rxPos++];
+}
+
+bool WiFiClient::connect(const char* host, uint16_t port) {
+    struct addrinfo hints;
+    struct addrinfo* result = NULL;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    char service[8];
+    snprintf(service, sizeof(service), "%u", port);
+    if (getaddrinfo(host, service, &hints, &result) != 0) return false;
+
+    int fd = -1;
+    for (struct addrinfo* ai = result; ai != NULL; ai = ai->ai_next) {
+        fd = ::socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) continue;
+        if (::connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) break;
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(result);
+    if (fd < 0) return false;
+
+    socket = std::make_shared<HostSocket>(fd);
+    return true;
+}
+
+bool WiFiClient::connected() {
+    if (!socket) return false;
+    if (socket->rxPos < socket->rx.size()) return true;
+    if (socket->fd < 0 || socket->peerClosed) return false;
+
+    char probe;
+    ssize_t n = recv(socket->fd, &probe, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+        socket->peerClosed = true;
+        return false;
+    }
+    return true;
+}
+
+void WiFiClient::stop() {
+    if (socket && socket->fd >= 0) {
+        close(socket->fd);
+        socket->fd = -1;
+    }
+    socket.reset();
+}
+
+IPAddress WiFiClient::remoteIP() {
+    struct sockaddr_in address;
+    socklen_t length = sizeof(address);
+    if (!socket || socket->fd < 0 || getpeername(socket->fd, (struct sockaddr*)&address, &length) != 0 ||
+        address.sin_family != AF_INET) {
+        return IPAddress();
+    }
+    return IPAddress((uint32_t)address.sin_addr.s_addr);
+}
+
+void WiFiClient::setNoDelay(bool noDelay) {
+    if (!socket || socket->fd < 0) return;
+    int flag = noDelay ? 1 : 0;
+    setsockopt(socket->fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+}
+
+void WiFiServer::begin() {
+    fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return;
+
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    if (bind(fd, (struct sockaddr*)&address, sizeof(address)) != 0 || listen(fd, 16) != 0) {
+        fprintf(stderr, "host: cannot listen on port %u: %s\n", port, strerror(errno));
+        close(fd);
+        fd = -1;
+        return;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+}
+
+void WiFiServer::stop() {
+    if (fd >= 0) close(fd);
+    fd = -1;
+}
+
+WiFiClient WiFiServer::available() {
+    if (fd < 0) return WiFiClient();
+    int client = accept(fd, NULL, NULL);
+    if (client < 0) return WiFiClient();
+    return WiFiClient(std::make_shared<HostSocket>(client));
+}
+
+// ===== WIFI =====
+WiFiClass WiFi;
+
+bool WiFiClass::mode(wifi_mode_t m) {
+    currentMode = m;
+    return true;
+}
+
+wifi_mode_t WiFiClass::getMode() {
+    return currentMode;
+}
+
+int WiFiClass::RSSI() {
+    return currentStatus == WL_CONNECTED ? rssi : 0;
+}
+
+int WiFiClass::RSSI(int index) {
+    (void)index;
+    return rssi;
+}
+
+String WiFiClass::SSID() {
+    return currentStatus == WL_CONNECTED ? currentSsid : String();
+}
+
+String WiFiClass::SSID(int index) {
+    (void)index;
+    return "host-network";
+}
+
+wl_status_t WiFiClass::status() {
+    return currentStatus;
+}
+
+IPAddress WiFiClass::softAPIP() { return IPAddress(192, 168, 4, 1); }
+IPAddress WiFiClass::localIP() { return currentStatus == WL_CONNECTED ? IPAddress(127, 0, 0, 1) : IPAddress(); }
+IPAddress WiFiClass::gatewayIP() { return IPAddress(127, 0, 0, 1); }
+IPAddress WiFiClass::subnetMask() { return IPAddress(255, 0, 0, 0); }
+IPAddress WiFiClass::dnsIP(int index) { (void)index; return IPAddress(127, 0, 0, 1); }
+
+bool WiFiClass::disconnect(bool wifiOff, bool eraseAp) {
+    (void)eraseAp;
+    currentStatus = WL_DISCONNECTED;
+    if (wifiOff) currentMode = WIFI_OFF;
+    return true;
+}
+
+bool WiFiClass::softAP(const char* ssid, const char* password, int channel, int hidden, int maxConnections) {
+    (void)ssid;
+    (void)password;
+    (void)channel;
+    (void)hidden;
+    (void)maxConnections;
+    return true;
+}
+
+// any SSID connects at once; the real network is the host's
+wl_status_t WiFiClass::begin(const char* ssid, const char* password) {
+    (void)password;
+    currentSsid = ssid;
+    currentStatus = WL_CONNECTED;
+    return currentStatus;
+}
+
+int WiFiClass::scanNetworks(bool async, bool hidden, bool passive, uint32_t msPerChannel) {
+    (void)async;
+    (void)hidden;
+    (void)passive;
+    (void)msPerChannel;
+    return 1;
+}
+
+void WiFiClass::scanDelete() {}
+int WiFiClass::scanComplete() { return 1; }
+int32_t WiFiClass::channel() { return 6; }
+int32_t WiFiClass::channel(int index) { (void)index; return 6; }
+String WiFiClass::macAddress() { return "A4:CF:12:34:56:78"; }
+String WiFiClass::softAPmacAddress() { return "A4:CF:12:34:56:79"; }
+bool WiFiClass::softAPdisconnect(bool wifiOff) { (void)wifiOff; return true; }
+bool WiFiClass::softAPConfig(IPAddress local, IPAddress gateway, IPAddress subnet) {
+    (void)local;
+    (void)gateway;
+    (void)subnet;
+    return true;
+}
+bool WiFiClass::setSleep(bool enable) { (void)enable; return true; }
+bool WiFiClass::setAutoReconnect(bool enable) { (void)enable; return true; }
+void WiFiClass::persistent(bool enable) { (void)enable; }
+int WiFiClass::encryptionType(int index) { (void)index; return 3; }
+int WiFiClass::softAPgetStationNum() { return 0; }
+bool WiFiClass::setHostname(const char* name) { (void)name; return true; }
+
+// ===== WEB SERVER =====
+static const char* statusText(int code) {
+    switch (code) {
+        case 200: return "OK";
+        case 204: return "No Content";
+        case 302: return "Found";
+        case 304: return "Not Modified";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 500: return "Internal Server Error";
+        case 503: return "Service Unavailable";
+        default: return "";
+    }
+}
+
+static String urlDecode(const String& text) {
+    String out;
+    for (unsigned int i = 0; i < text.length(); i++) {
+        char c = text[i];
+        if (c == '+') {
+            out += ' ';
+        } else if (c == '%' && i + 2 < text.length()) {
+            char hex[3] = { text[i + 1], text[i + 2], 0 };
+            out += (char)strtol(hex, NULL, 16);
+            i += 2;
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+// port 80 needs root on Linux, so WebServer(80) listens on hostHttpPort()
+WebServer::WebServer(int port) : listener((uint16_t)(port == 80 ? 0 : port)), currentMethod(HTTP_GET),
+                                 contentLength(CONTENT_LENGTH_NOT_SET), headersSent(false) {}
+
+void WebServer::on(const String& uri, THandlerFunction handler) {
+    on(uri, HTTP_ANY, handler);
+}
+
+void WebServer::on(const String& uri, HTTPMethod method, THandlerFunction handler) {
+    Route route = { uri, method, handler };
+    routes.push_back(route);
+}
+
+void WebServer::onNotFound(THandlerFunction handler) {
+    notFound = handler;
+}
+
+void WebServer::begin() {
+    listener = WiFiServer((uint16_t)hostHttpPort());
+    listener.begin();
+}
+
+void WebServer::stop() {
+    listener.stop();
+}
+
+bool WebServer::readRequest() {
+    std::string head;
+    for (;;) {
+        int c = current.read();
+        if (c < 0) {
+            if (!current.fill(2000)) return false;
+            continue;
+        }
+        head += (char)c;
+        if (head.size() >= 4 && head.compare(head.size() - 4, 4, "\r\n\r\n") == 0) break;
+        if (head.size() > 16384) return false;
+    }
+
+    size_t lineEnd = head.find("\r\n");
+    std::string requestLine = head.substr(0, lineEnd);
+    size_t space1 = requestLine.find(' ');
+    size_t space2 = requestLine.find(' ', space1 + 1);
+    if (space1 == std::string::npos || space2 == std::string::npos) return false;
+
+    std::string methodName = requestLine.substr(0, space1);
+    std::string target = requestLine.substr(space1 + 1, space2 - space1 - 1);
+    currentMethod = methodName == "POST" ? HTTP_POST : methodName == "PUT" ? HTTP_PUT :
+                    methodName == "DELETE" ? HTTP_DELETE : HTTP_GET;
+
+    size_t query = target.find('?');
+    currentUri = String(target.substr(0, query).c_str());
+    currentArgs.clear();
+    if (query != std::string::npos) parseArgs(String(target.substr(query + 1).c_str()));
+
+    currentHeaders.clear();
+    size_t bodyLength = 0;
+    String contentType;
+    size_t pos = lineEnd + 2;
+    while (pos < head.size()) {
+        size_t end = head.find("\r\n", pos);
+        if (end == pos || end == std::string::npos) break;
+        std::string line = head.substr(pos, end - pos);
+        pos = end + 2;
+
+        size_t colon = line.find(':');
+        if (colon == std::string::npos) continue;
+        String name(line.substr(0, colon).c_str());
+        String value(line.substr(colon + 1).c_str());
+        value.trim();
+        if (name.equalsIgnoreCase("Content-Length")) bodyLength = (size_t)value.toInt();
+        if (name.equalsIgnoreCase("Content-Type")) contentType = value;
+        Pair header = { name, value };
+        currentHeaders.push_back(header);
+    }
+
+    if (bodyLength > 0) {
+        String body;
+        while (body.length() < bodyLength) {
+            int c = current.read();
+            if (c < 0) {
+                if (!current.fill(2000)) return false;
+                continue;
+            }
+            body += (char)c;
+        }
+        if (contentType.startsWith("application/x-www-form-urlencoded")) {
+            parseArgs(body);
+        } else {
+            Pair plain = { "plain", body };
+            currentArgs.push_back(plain);
+        }
+    }
+    return true;
+}
+
+void WebServer::parseArgs(const String& query) {
+    int start = 0;
+    while (start < (int)query.length()) {
+        int end = query.indexOf('&', start);
+        if (end < 0) end = query.length();
+        String pair = query.substring(start, end);
+        int equals = pair.indexOf('=');
+        Pair arg;
+        arg.name = urlDecode(equals < 0 ? pair : pair.substring(0, equals));
+        arg.value = equals < 0 ? String() : urlDecode(pair.substring(equals + 1));
+        if (arg.name.length() > 0) currentArgs.push_back(arg);
+        start = end + 1;
+    }
+}
+
+void WebServer::handleClient() {
+    current = listener.available();
+    if (!current) {
+        current = WiFiClient();
+        return;
+    }
+
+    contentLength = CONTENT_LENGTH_NOT_SET;
+    headersSent = false;
+    pendingHeaders = "";
+
+    if (readRequest()) {
+        bool handled = false;
+        for (size_t i = 0; i < routes.size(); i++) {
+            if (routes[i].uri == currentUri && (routes[i].method == HTTP_ANY || routes[i].method == currentMethod)) {
+                routes[i].handler();
+                handled = true;
+                break;
+            }
+        }
+        if (!handled) {
+            if (notFound) {
+                notFound();
+            } else {
+                send(404, "text/plain", "Not found");
+            }
+        }
+    }
+
+    // a copy kept by the handler (an SSE client) keeps the connection open
+    current = WiFiClient();
+}
+
+void WebServer::sendHeaders(int code, const char* contentType, size_t length) {
+    String head = "HTTP/1.1 " + String(code) + " " + statusText(code) + "\r\n";
+    if (contentType != NULL && contentType[0] != '\0') {
+        head += "Content-Type: ";
+        head += contentType;
+        head += "\r\n";
+    }
+    if (length == CONTENT_LENGTH_UNKNOWN) {
+        head += "Transfer-Encoding: chunked\r\n";
+    } else {
+        head += "Content-Length: " + String((unsigned long)length) + "\r\n";
+    }
+    head += "Connection: close\r\n";
+    head += pendingHeaders;
+    head += "\r\n";
+    current.write((const uint8_t*)head.c_str(), head.length());
+    pendingHeaders = "";
+    headersSent = true;
+}
+
+void WebServer::send(int code, const char* contentType, const String& content) {
+    send(code, contentType, content.c_str(), content.length());
+}
+
+void WebServer::send(int code, const String& contentType, const String& content) {
+    send(code, contentType.c_str(), content.c_str(), content.length());
+}
+
+void WebServer::send(int code, const char* contentType, const char* content) {
+    send(code, contentType, content, strlen(content));
+}
+
+void WebServer::send(int code, const char* contentType, const char* content, size_t length) {
+    bool chunked = contentLength == CONTENT_LENGTH_UNKNOWN;
+    sendHeaders(code, contentType, chunked ? CONTENT_LENGTH_UNKNOWN :
+                                   contentLength != CONTENT_LENGTH_NOT_SET ? contentLength : length);
+    if (chunked) {
+        if (length > 0) sendContent(content, length);
+    } else {
+        current.write((const uint8_t*)content, length);
+    }
+}
+
+void WebServer::send_P(int code, PGM_P contentType, PGM_P content) {
+    send(code, contentType, content);
+}
+
+void WebServer::send_P(int code, PGM_P contentType, PGM_P content, size_t length) {
+    send(code, contentType, content, length);
+}
+
+void WebServer::sendHeader(const String& name, const String& value, bool first) {
+    String line = name + ": " + value + "\r\n";
+    pendingHeaders = first ? line + pendingHeaders : pendingHeaders + line;
+}
+
+void WebServer::setContentLength(size_t length) {
+    contentLength = length;
+}
+
+void WebServer::sendContent(const String& content) {
+    sendContent(content.c_str(), content.length());
+}
+
+// with CONTENT_LENGTH_UNKNOWN every call is one chunk and sendContent("") ends the response
+void WebServer::sendContent(const char* content, size_t length) {
+    if (contentLength != CONTENT_LENGTH_UNKNOWN) {
+        current.write((const uint8_t*)content, length);
+        return;
+    }
+    char size[16];
+    snprintf(size, sizeof(size), "%zx\r\n", length);
+    current.write((const uint8_t*)size, strlen(size));
+    current.write((const uint8_t*)content, length);
+    current.write((const uint8_t*)"\r\n", 2);
+}
+
+void WebServer::sendContent_P(PGM_P content, size_t length) {
+    sendContent(content, length);
+}
+
+String WebServer::arg(const String& name) {
+    for (size_t i = 0; i < currentArgs.size(); i++) {
+        if (currentArgs[i].name == name) return currentArgs[i].value;
+    }
+    return String();
+}
+
+String WebServer::arg(int index) {
+    return index >= 0 && index < (int)currentArgs.size() ? currentArgs[index].value : String();
+}
+
+String WebServer::argName(int index) {
+    return index >= 0 && index < (int)currentArgs.size() ? currentArgs[index].name : String();
+}
+
+int WebServer::args() {
+    return (int)currentArgs.size();
+}
+
+bool WebServer::hasArg(const String& name) {
+    for (size_t i = 0; i < currentArgs.size(); i++) {
+        if (currentArgs[i].name == name) return true;
+    }
+    return false;
+}
+
+String WebServer::header(const String& name) {
+    for (size_t i = 0; i < currentHeaders.size(); i++) {
+        if (currentHeaders[i].name.equalsIgnoreCase(name)) return currentHeaders[i].value;
+    }
+    return String();
+}
+
+bool WebServer::hasHeader(const String& name) {
+    for (size_t i = 0; i < currentHeaders.size(); i++) {
+        if (currentHeaders[i].name.equalsIgnoreCase(name)) return true;
+    }
+    return false;
+}
+
+// every header is kept; the list only exists for API compatibility
+void WebServer::collectHeaders(const char* names[], size_t count) {
+    wantedHeaders.clear();
+    for (size_t i = 0; i < count; i++) wantedHeaders.push_back(names[i]);
+}
+
+String WebServer::uri() {
+    return currentUri;
+}
+
+HTTPMethod WebServer::method() {
+    return currentMethod;
+}
+
+WiFiClient WebServer::client() {
+    return current;
+}
+
+// ===== HTTP CLIENT =====
+bool HTTPClient::begin(const String& url) {
+    end();
+    String rest;
+    if (url.startsWith("http://")) {
+        secure = false;
+        port = 80;
+        rest = url.substring(7);
+    } else if (url.startsWith("https://")) {
+        secure = true;
+        port = 443;
+        rest = url.substring(8);
+    } else {
+        return false;
+    }
+
+    int slash = rest.indexOf('/');
+    String authority = slash < 0 ? rest : rest.substring(0, slash);
+    path = slash < 0 ? String("/") : rest.substring(slash);
+
+    int colon = authority.indexOf(':');
+    if (colon >= 0) {
+        port = (uint16_t)authority.substring(colon + 1).toInt();
+        authority = authority.substring(0, colon);
+    }
+    host = authority;
+    return true;
+}
+
+void HTTPClient::end() {
+    requestHeaders = "";
+    responseHeaders.clear();
+    body = "";
+    bodyStream = WiFiClient();
+}
+
+void HTTPClient::addHeader(const String& name, const String& value) {
+    requestHeaders += name + ": " + value + "\r\n";
+}
+
+void HTTPClient::collectHeaders(const char* names[], size_t count) {
+    wantedHeaders.clear();
+    for (size_t i = 0; i < count; i++) wantedHeaders.push_back(names[i]);
+}
+
+int HTTPClient::GET() {
+    return request("GET", "");
+}
+
+int HTTPClient::POST(const String& payload) {
+    return request("POST", payload);
+}
+
+// the whole body is read (and de-chunked) so getString()/getStream() serve it from memory
+int HTTPClient::request(const char* method, const String& payload) {
+    responseHeaders.clear();
+    body = "";
+    if (secure) {
+        Serial.println("host: https is not supported, point the server setting at an http:// URL");
+        return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+
+    WiFiClient client;
+    if (!client.connect(host.c_str(), port)) return HTTPC_ERROR_CONNECTION_REFUSED;
+
+    String head = String(method) + " " + path + " HTTP/1.1\r\n";
+    head += "Host: " + host + "\r\n";
+    head += "User-Agent: ESP32HTTPClient\r\n";
+    head += "Connection: close\r\n";
+    head += requestHeaders;
+    if (payload.length() > 0 || strcmp(method, "POST") == 0) {
+        head += "Content-Length: " + String(payload.length()) + "\r\n";
+    }
+    head += "\r\n";
+    head += payload;
+    if (client.write((const uint8_t*)head.c_str(), head.length()) != head.length()) {
+        return HTTPC_ERROR_SEND_HEADER_FAILED;
+    }
+
+    std::string raw;
+    size_t headerEnd = std::string::npos;
+    while (headerEnd == std::string::npos) {
+        int c = client.read();
+        if (c < 0) {
+            if (!client.fill(timeoutMs)) return raw.empty() ? HTTPC_ERROR_READ_TIMEOUT : HTTPC_ERROR_CONNECTION_LOST;
+            continue;
+        }
+        raw += (char)c;
+        if (raw.size() >= 4 && raw.compare(raw.size() - 4, 4, "\r\n\r\n") == 0) headerEnd = raw.size();
+    }
+
+    int code = 0;
+    size_t space = raw.find(' ');
+    if (space != std::string::npos) code = atoi(raw.c_str() + space + 1);
+
+    long contentLength = -1;
+    bool chunked = false;
+    size_t pos = raw.find("\r\n") + 2;
+    while (pos < headerEnd - 2) {
+        size_t end = raw.find("\r\n", pos);
+        std::string line = raw.substr(pos, end - pos);
+        pos = end + 2;
+        size_t colon = line.find(':');
+        if (colon == std::string::npos) continue;
+        String name(line.substr(0, colon).c_str());
+        String value(line.substr(colon + 1).c_str());
+        value.trim();
+        if (name.equalsIgnoreCase("Content-Length")) contentLength = value.toInt();
+        if (name.equalsIgnoreCase("Transfer-Encoding") && value.equalsIgnoreCase("chunked")) chunked = true;
+        responseHeaders.push_back(name);
+        responseHeaders.push_back(value);
+    }
+
+    std::string content;
+    for (;;) {
+        int c = client.read();
+        if (c < 0) {
+            if (contentLength >= 0 && (long)content.size() >= contentLength) break;
+            if (!client.fill(timeoutMs)) break;
+            continue;
+        }
+        content += (char)c;
+        if (contentLength >= 0 && (long)content.size() >= contentLength) break;
+    }
+
+    if (chunked) {
+        std::string decoded;
+        size_t at = 0;
+        while (at < content.size()) {
+            size_t lineEnd = content.find("\r\n", at);
+            if (lineEnd == std::string::npos) break;
+            size_t chunkSize = strtoul(content.c_str() + at, NULL, 16);
+            at = lineEnd + 2;
+            if (chunkSize == 0 || at + chunkSize > content.size()) break;
+            decoded.append(content, at, chunkSize);
+            at += chunkSize + 2;
+        }
+        content = decoded;
+    }
+
+    body = String(content.c_str());
+    std::shared_ptr<HostSocket> memory = std::make_shared<HostSocket>(-1);
+    memory->rx = content;
+    bodyStream = WiFiClient(memory);
+    return code;
+}
+
+String HTTPClient::getString() {
+    return body;
+}
+
+int HTTPClient::getSize() {
+    return (int)body.length();
+}
+
+WiFiClient* HTTPClient::getStreamPtr() {
+    return &bodyStream;
+}
+
+WiFiClient& HTTPClient::getStream() {
+    return bodyStream;
+}
+
+String HTTPClient::header(const char* name) {
+    for (size_t i = 0; i + 1 < responseHeaders.size(); i += 2) {
+        if (responseHeaders[i].equalsIgnoreCase(name)) return responseHeaders[i + 1];
+    }
+    return String();
+}
+
+bool HTTPClient::hasHeader(const char* name) {
+    for (size_t i = 0; i + 1 < responseHeaders.size(); i += 2) {
+        if (responseHeaders[i].equalsIgnoreCase(name)) return true;
+    }
+    return false;
+}
+
+bool HTTPClient::connected() {
+    return bodyStream.connected();
+}
+
+String HTTPClient::errorToString(int code) {
+    switch (code) {
+        case HTTPC_ERROR_CONNECTION_REFUSED: return "connection refused";
+        case HTTPC_ERROR_SEND_HEADER_FAILED: return "send header failed";
+        case HTTPC_ERROR_CONNECTION_LOST: return "connection lost";
+        case HTTPC_ERROR_READ_TIMEOUT: return "read Timeout";
+        default: return String();
+    }
+}
@@ -0,0 +1,195 @@
+// Storage shim: EEPROM image and LittleFS tree under the host data directory.
+
+#include "EEPROM.h"
+#include "LittleFS.h"
+
+#include <errno.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+static std::string dataDir;
+
+void hostSetDataDir(const std::string& dir) {
+    dataDir = dir;
+}
+
+const std::string& hostDataDir() {
+    if (dataDir.empty()) {
+        const char* env = getenv("PORTFOLIO_HOST_DATA");
+        dataDir = env != NULL && env[0] != '\0' ? env : "host_data";
+    }
+    return dataDir;
+}
+
+static void makeDirs(const std::string& path) {
+    for (size_t pos = 1; pos <= path.size(); pos++) {
+        if (pos == path.size() || path[pos] == '/') {
+            ::mkdir(path.substr(0, pos).c_str(), 0755);
+        }
+    }
+}
+
+// ===== EEPROM =====
+EEPROMClass EEPROM;
+
+static std::string eepromPath() {
+    return hostDataDir() + "/eeprom.bin";
+}
+
+// a fresh image reads as 0xFF, like erased flash
+bool EEPROMClass::begin(size_t size) {
+    data.assign(size, 0xFF);
+    FILE* f = fopen(eepromPath().c_str(), "rb");
+    if (f != NULL) {
+        size_t n = fread(data.data(), 1, size, f);
+        (void)n;
+        fclose(f);
+    }
+    return true;
+}
+
+void EEPROMClass::end() {
+    commit();
+    data.clear();
+}
+
+bool EEPROMClass::commit() {
+    if (data.empty()) return false;
+    makeDirs(hostDataDir());
+    FILE* f = fopen(eepromPath().c_str(), "wb");
+    if (f == NULL) return false;
+    bool ok = fwrite(data.data(), 1, data.size(), f) == data.size();
+    fclose(f);
+    return ok;
+}
+
+uint8_t EEPROMClass::read(int address) {
+    return address >= 0 && (size_t)address < data.size() ? data[address] : 0xFF;
+}
+
+void EEPROMClass::write(int address, uint8_t value) {
+    if (address >= 0 && (size_t)address < data.size()) data[address] = value;
+}
+
+// ===== FILE =====
+size_t File::write(const uint8_t* data, size_t length) {
+    if (!handle) return 0;
+    return fwrite(data, 1, length, handle.get());
+}
+
+size_t File::read(uint8_t* buffer, size_t length) {
+    if (!handle) return 0;
+    return fread(buffer, 1, length, handle.get());
+}
+
+int File::read() {
+    if (!handle) return -1;
+    int c = fgetc(handle.get());
+    return c == EOF ? -1 : c;
+}
+
+int File::available() {
+    if (!handle) return 0;
+    long here = ftell(handle.get());
+    return here < 0 ? 0 : (int)(size() - (size_t)here);
+}
+
+bool File::seek(uint32_t position) {
+    return handle && fseek(handle.get(), (long)position, SEEK_SET) == 0;
+}
+
+size_t File::position() {
+    if (!handle) return 0;
+    long here = ftell(handle.get());
+    return here < 0 ? 0 : (size_t)here;
+}
+
+size_t File::size() {
+    if (!handle) return 0;
+    fflush(handle.get());
+    struct stat info;
+    return fstat(fileno(handle.get()), &info) == 0 ? (size_t)info.st_size : 0;
+}
+
+void File::flush() {
+    if (handle) fflush(handle.get());
+}
+
+void File::close() {
+    handle.reset();
+}
+
+// ===== FS =====
+namespace fs {
+
+std::string FS::hostPath(const char* path) {
+    std::string full = hostDataDir() + "/littlefs";
+    if (path[0] != '/') full += '/';
+    return full + path;
+}
+
+File FS::open(const char* path, const char* mode) {
+    std::string full = hostPath(path);
+    makeDirs(full.substr(0, full.rfind('/')));
+
+    const char* stdioMode = "rb";
+    if (strcmp(mode, "w") == 0) stdioMode = "wb";
+    else if (strcmp(mode, "a") == 0) stdioMode = "ab";
+    else if (strcmp(mode, "r+") == 0) stdioMode = "r+b";
+    else if (strcmp(mode, "w+") == 0) stdioMode = "w+b";
+    else if (strcmp(mode, "a+") == 0) stdioMode = "a+b";
+
+    FILE* f = fopen(full.c_str(), stdioMode);
+    if (f == NULL) return File();
+    return File(std::shared_ptr<FILE>(f, fclose), String(path));
+}
+
+bool FS::exists(const char* path) {
+    struct stat info;
+    return stat(hostPath(path).c_str(), &info) == 0;
+}
+
+bool FS::remove(const char* path) {
+    return ::remove(hostPath(path).c_str()) == 0;
+}
+
+bool FS::rename(const char* from, const char* to) {
+    return ::rename(hostPath(from).c_str(), hostPath(to).c_str()) == 0;
+}
+
+bool FS::mkdir(const char* path) {
+    makeDirs(hostPath(path));
+    return true;
+}
+
+}  // namespace fs
+
+// ===== LITTLEFS =====
+LittleFSFS LittleFS;
+
+#define HOST_LITTLEFS_SIZE (1536 * 1024)   // default WROVER partition
+
+bool LittleFSFS::begin(bool formatOnFail) {
+    (void)formatOnFail;
+    makeDirs(hostDataDir() + "/littlefs");
+    return true;
+}
+
+size_t LittleFSFS::totalBytes() {
+    return HOST_LITTLEFS_SIZE;
+}
+
+size_t LittleFSFS::usedBytes() {
+    std::string root = hostDataDir() + "/littlefs";
+    DIR* dir = opendir(root.c_str());
+    if (dir == NULL) return 0;
+    size_t used = 0;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        struct stat info;
+        std::string path = root + "/" + entry->d_name;
+        if (stat(path.c_str(), &info) == 0 && S_ISREG(info.st_mode)) used += (size_t)info.st_size;
+    }
+    closedir(dir);
+    return used;
+}
@@ -0,0 +1,85 @@
+// Recording display for TFT_eSPI.h.
+
+#include "TFT_eSPI.h"
+
+static HostTftRecord record;
+static bool textRunOpen = false;
+
+const HostTftRecord& hostTftRecord() {
+    return record;
+}
+
+void hostTftDump(FILE* out) {
+    fprintf(out, "--- frame %u (%u draw calls, %u text bytes total) ---\n",
+            record.frames, record.drawCalls, record.textBytes);
+    for (size_t i = 0; i < record.lastFrameText.size(); i++) {
+        fprintf(out, "%s\n", record.lastFrameText[i].c_str());
+    }
+}
+
+void TFT_eSPI::init() {
+    record.lastFrameText.clear();
+    textRunOpen = false;
+}
+
+void TFT_eSPI::setRotation(uint8_t r) {
+    rotation = r & 3;
+}
+
+void TFT_eSPI::fillScreen(uint32_t color) {
+    (void)color;
+    record.frames++;
+    record.lastFrameText.clear();
+    textRunOpen = false;
+}
+
+void TFT_eSPI::setCursor(int16_t x, int16_t y) {
+    (void)x;
+    (void)y;
+    textRunOpen = false;
+}
+
+void TFT_eSPI::drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+    (void)x; (void)y; (void)w; (void)h; (void)color;
+    record.drawCalls++;
+}
+
+void TFT_eSPI::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+    (void)x; (void)y; (void)w; (void)h; (void)color;
+    record.drawCalls++;
+}
+
+void TFT_eSPI::drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color) {
+    (void)x; (void)y; (void)w; (void)color;
+    record.drawCalls++;
+}
+
+void TFT_eSPI::drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color) {
+    (void)x; (void)y; (void)h; (void)color;
+    record.drawCalls++;
+}
+
+void TFT_eSPI::drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color) {
+    (void)x0; (void)y0; (void)x1; (void)y1; (void)color;
+    record.drawCalls++;
+}
+
+void TFT_eSPI::drawPixel(int32_t x, int32_t y, uint32_t color) {
+    (void)x; (void)y; (void)color;
+    record.drawCalls++;
+}
+
+size_t TFT_eSPI::write(uint8_t c) {
+    record.textBytes++;
+    if (c == '\r') return 1;
+    if (c == '\n') {
+        textRunOpen = false;
+        return 1;
+    }
+    if (!textRunOpen) {
+        record.lastFrameText.push_back(std::string());
+        textRunOpen = true;
+    }
+    record.lastFrameText.back() += (char)c;
+    return 1;
+}
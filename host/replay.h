@@ -0,0 +1,203 @@
+// Replay driver: feeds a payload recording (GET /api/v1/recording/download) through
+// parseCryptoData -> calculatePortfolioSummary -> checkAlerts -> updateDisplay on the
+// fake clock, and reports the alerts fired, per-stage CPU time and peak memory.
+//
+// Included by host_main.cpp after the sketch, so it sees the sketch's globals.
+//
+// Record format (written by recordPayload()):
+//   #REC <epoch> <millis> <mode> <length>\n<length bytes of JSON>\n
+//
+// Virtual time follows the recorded millis(); when millis() goes backwards (the
+// device rebooted between records) the epoch difference is used instead. With
+// --speed N every gap is also slept for gap/N of real time; --speed 0 runs flat out.
+//
+// The alert digest covers everything that does not depend on wall-clock time
+// (virtual offset, mode, symbol, type, flags, rounded P/L and price), so the same
+// recording and settings always give the same digest.
+#pragma once
+
+#include <malloc.h>
+#include <sys/resource.h>
+#include <time.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+enum ReplayStage { REPLAY_PARSE, REPLAY_SUMMARY, REPLAY_ALERTS, REPLAY_DISPLAY, REPLAY_STAGE_COUNT };
+
+static const char* const replayStageNames[REPLAY_STAGE_COUNT] = { "parse", "summary", "alerts", "display" };
+
+struct ReplayStageStats {
+    unsigned long calls = 0;
+    uint64_t totalNanos = 0;
+    uint64_t maxNanos = 0;
+};
+
+struct ReplayRecord {
+    unsigned long epoch;
+    unsigned long millis;
+    byte mode;
+    String payload;
+};
+
+struct ReplayReport {
+    unsigned long records = 0;
+    unsigned long alerts = 0;
+    uint64_t virtualMillis = 0;
+    ReplayStageStats stages[REPLAY_STAGE_COUNT];
+    size_t peakHeapBytes = 0;
+    long peakRssKb = 0;
+    uint32_t digest = 2166136261u;
+};
+
+static uint64_t replayThreadNanos() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void replayDigest(ReplayReport& report, const void* data, size_t length) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    for (size_t i = 0; i < length; i++) {
+        report.digest = (report.digest ^ bytes[i]) * 16777619u;
+    }
+}
+
+static void replaySampleHeap(ReplayReport& report) {
+    struct mallinfo2 info = mallinfo2();
+    if (info.uordblks > report.peakHeapBytes) report.peakHeapBytes = info.uordblks;
+}
+
+// returns false at end of file; a truncated or malformed record ends the replay with a warning
+static bool replayReadRecord(FILE* f, ReplayRecord& record) {
+    char header[96];
+    if (fgets(header, sizeof(header), f) == NULL) return false;
+
+    unsigned mode = 0;
+    unsigned long length = 0;
+    if (sscanf(header, "#REC %lu %lu %u %lu", &record.epoch, &record.millis, &mode, &length) != 4 || mode >= MAX_PORTFOLIOS) {
+        fprintf(stderr, "replay: bad record header: %s", header);
+        return false;
+    }
+
+    std::string body(length, '\0');
+    if (fread(&body[0], 1, length, f) != length) {
+        fprintf(stderr, "replay: truncated record (%lu bytes expected)\n", length);
+        return false;
+    }
+    fgetc(f);   // trailing newline
+    record.mode = (byte)mode;
+    record.payload = String(body.c_str());
+    return true;
+}
+
+template <typename Fn>
+static void replayTimed(ReplayReport& report, ReplayStage stage, Fn fn) {
+    uint64_t start = replayThreadNanos();
+    fn();
+    uint64_t elapsed = replayThreadNanos() - start;
+
+    ReplayStageStats& stats = report.stages[stage];
+    stats.calls++;
+    stats.totalNanos += elapsed;
+    if (elapsed > stats.maxNanos) stats.maxNanos = elapsed;
+    replaySampleHeap(report);
+}
+
+// new alerts are found from the history ring heads, oldest first
+static void replayCollectAlerts(ReplayReport& report, byte mode, int headBefore, FILE* out) {
+    int headAfter = portfolios[mode].historyHead;
+    int added = (headAfter - headBefore + MAX_ALERT_HISTORY) % MAX_ALERT_HISTORY;
+
+    for (int n = added - 1; n >= 0; n--) {
+        const AlertRecord* alert = getAlertRecord(mode, n);
+        if (alert == NULL) continue;
+
+        const char* symbol = alertSymbolName(alert->symbolId);
+        int32_t pnlCents = (int32_t)lroundf(alert->pnlPercent * 100.0f);
+        float price = alert->alertPrice;
+        report.alerts++;
+
+        replayDigest(report, &report.virtualMillis, sizeof(report.virtualMillis));
+        replayDigest(report, &mode, sizeof(mode));
+        replayDigest(report, symbol, strlen(symbol));
+        replayDigest(report, &alert->alertType, sizeof(alert->alertType));
+        replayDigest(report, &alert->flags, sizeof(alert->flags));
+        replayDigest(report, &pnlCents, sizeof(pnlCents));
+        replayDigest(report, &price, sizeof(price));
+
+        if (out != NULL) {
+            fprintf(out, "  t+%9.3fs  %-5s %-12s %+8.2f%%  @ %-14.8g %s%s%s\n",
+                    report.virtualMillis / 1000.0, portfolioKey(mode), symbol,
+                    alert->pnlPercent, price,
+                    (alert->flags & ALERT_FLAG_PROFIT) ? "profit " : "",
+                    (alert->flags & ALERT_FLAG_SEVERE) ? "severe " : "",
+                    (alert->flags & ALERT_FLAG_LONG) ? "long" : "short");
+        }
+    }
+}
+
+// setup() must already have run on the fake clock
+static bool replayRun(const char* path, double speed, FILE* out, ReplayReport& report) {
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) {
+        fprintf(stderr, "replay: cannot open %s: %s\n", path, strerror(errno));
+        return false;
+    }
+
+    ReplayRecord record;
+    bool first = true;
+    unsigned long lastEpoch = 0;
+    unsigned long lastMillis = 0;
+
+    if (out != NULL) fprintf(out, "alerts:\n");
+    while (replayReadRecord(f, record)) {
+        if (!first) {
+            uint64_t gap;
+            if (record.millis >= lastMillis) {
+                gap = record.millis - lastMillis;
+            } else {
+                gap = record.epoch > lastEpoch ? (uint64_t)(record.epoch - lastEpoch) * 1000 : 0;
+            }
+            hostAdvanceMillis((unsigned long)gap);
+            report.virtualMillis += gap;
+            if (speed > 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds((uint64_t)(gap * 1000 / speed)));
+            }
+        }
+        first = false;
+        lastEpoch = record.epoch;
+        lastMillis = record.millis;
+
+        byte mode = record.mode;
+        int headBefore = portfolios[mode].historyHead;
+
+        replayTimed(report, REPLAY_PARSE, [&] { parseCryptoData(record.payload, mode); });
+        replayTimed(report, REPLAY_SUMMARY, [&] { calculatePortfolioSummary(mode); });
+        replayTimed(report, REPLAY_ALERTS, [&] { checkAlerts(mode); });
+        replayTimed(report, REPLAY_DISPLAY, [&] { updateDisplay(); });
+
+        replayCollectAlerts(report, mode, headBefore, out);
+        report.records++;
+    }
+    fclose(f);
+
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) report.peakRssKb = usage.ru_maxrss;
+    return true;
+}
+
+static void replayPrintReport(const ReplayReport& report, FILE* out) {
+    fprintf(out, "records: %lu  alerts: %lu  virtual time: %.1fs\n",
+            report.records, report.alerts, report.virtualMillis / 1000.0);
+    fprintf(out, "%-8s %8s %12s %10s %10s\n", "stage", "calls", "total ms", "avg us", "max us");
+    for (int i = 0; i < REPLAY_STAGE_COUNT; i++) {
+        const ReplayStageStats& stats = report.stages[i];
+        fprintf(out, "%-8s %8lu %12.3f %10.1f %10.1f\n", replayStageNames[i], stats.calls,
+                stats.totalNanos / 1e6, stats.calls > 0 ? stats.totalNanos / 1e3 / stats.calls : 0.0,
+                stats.maxNanos / 1e3);
+    }
+    fprintf(out, "peak heap in use: %zu KB  peak RSS: %ld KB\n", report.peakHeapBytes / 1024, report.peakRssKb);
+    fprintf(out, "alert digest: %08x\n", report.digest);
+}
@@ -0,0 +1,188 @@
+// ===== FIXED-POINT MONEY =====
+// مقادیر پولی (قیمت، تعداد، P/L و مجموع‌ها) به صورت عدد صحیح 64 بیتی با 8 رقم اعشار.
+// پارس رشته دقیق است و جمع/ضرب فقط با عملیات صحیح انجام می‌شود، پس نتیجه
+// روی ESP32 و PC یکسان است. بدون وابستگی به Arduino تا tools/money_bench.cpp هم از آن استفاده کند.
+#ifndef MONEY_H
+#define MONEY_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef int64_t Money;
+
+#define MONEY_DECIMALS 8
+#define MONEY_SCALE 100000000LL
+#define MONEY_MAX_DIGITS 20     // بیشتر از این در int64 جا نمی‌شود
+
+static inline Money moneyFromInt(int64_t units) {
+    return units * MONEY_SCALE;
+}
+
+// برای اعدادی که ArduinoJson به double تبدیل کرده؛ تا 15 رقم معنی‌دار دقیق است
+static inline Money moneyFromDouble(double value) {
+    double scaled = value * (double)MONEY_SCALE;
+    return (Money)(scaled >= 0 ? scaled + 0.5 : scaled - 0.5);
+}
+
+static inline double moneyToDouble(Money value) {
+    return (double)(value / MONEY_SCALE) + (double)(value % MONEY_SCALE) / (double)MONEY_SCALE;
+}
+
+static inline float moneyToFloat(Money value) {
+    return (float)moneyToDouble(value);
+}
+
+// نسبت دو مقدار (برای درصدها)؛ خود نسبت پول نیست و float کافی است
+static inline float moneyRatio(Money numerator, Money denominator) {
+    if (denominator == 0) return 0;
+    return (float)((double)numerator / (double)denominator);
+}
+
+// پارس دقیق رشته اعشاری ("-123.456", "1e-5", "  42"). بیشتر از 8 رقم اعشار
+// به نزدیک‌ترین مقدار (نیمه به دور از صفر) گرد می‌شود. false اگر نامعتبر یا خارج از محدوده باشد.
+static inline bool moneyParse(const char* text, Money* out) {
+    const char* p = text;
+    while (*p == ' ' || *p == '\t') p++;
+
+    bool negative = false;
+    if (*p == '-' || *p == '+') {
+        negative = (*p == '-');
+        p++;
+    }
+
+    char digits[MONEY_MAX_DIGITS + 1];
+    int digitCount = 0;
+    int pointPos = 0;          // تعداد ارقام معنی‌دار قبل از ممیز (ممکن است منفی شود)
+    bool anyDigit = false;
+    bool seenPoint = false;
+
+    for (;; p++) {
+        if (*p >= '0' && *p <= '9') {
+            anyDigit = true;
+            if (digitCount == 0 && *p == '0') {
+                // صفرهای ابتدایی: بعد از ممیز فقط مکان را جابجا می‌کنند
+                if (seenPoint) pointPos--;
+                continue;
+            }
+            if (digitCount < MONEY_MAX_DIGITS) {
+                digits[digitCount++] = *p - '0';
+            } else if (!seenPoint) {
+                return false;  // بزرگتر از محدوده
+            }
+            if (!seenPoint) pointPos++;
+        } else if (*p == '.' && !seenPoint) {
+            seenPoint = true;
+        } else {
+            break;
+        }
+    }
+    if (!anyDigit) return false;
+
+    if (*p == 'e' || *p == 'E') {
+        p++;
+        bool expNegative = false;
+        if (*p == '-' || *p == '+') {
+            expNegative = (*p == '-');
+            p++;
+        }
+        if (*p < '0' || *p > '9') return false;
+        int exponent = 0;
+        while (*p >= '0' && *p <= '9') {
+            if (exponent < 1000) exponent = exponent * 10 + (*p - '0');
+            p++;
+        }
+        pointPos += expNegative ? -exponent : exponent;
+    }
+
+    while (*p == ' ' || *p == '\t') p++;
+    if (*p != '\0') return false;
+
+    // ارقام تا مکان 10^-8 جمع و رقم بعدی برای گرد کردن استفاده می‌شود
+    int wanted = pointPos + MONEY_DECIMALS;
+    if (digitCount == 0 || wanted < 0) {
+        *out = 0;
+        return true;
+    }
+    if (wanted > MONEY_MAX_DIGITS - 1) return false;
+
+    uint64_t value = 0;
+    for (int i = 0; i < wanted; i++) {
+        value = value * 10 + (i < digitCount ? digits[i] : 0);
+    }
+    if (wanted < digitCount && digits[wanted] >= 5) value++;
+    if (value > (uint64_t)INT64_MAX) return false;
+
+    *out = negative ? -(Money)value : (Money)value;
+    return true;
+}
+
+// ضرب دو مقدار 8 رقمی بدون حاصل‌ضرب 128 بیتی: هر طرف به بخش صحیح و اعشار شکسته می‌شود
+static inline Money moneyMul(Money a, Money b) {
+    bool negative = (a < 0) != (b < 0);
+    uint64_t ua = a < 0 ? (uint64_t)(-a) : (uint64_t)a;
+    uint64_t ub = b < 0 ? (uint64_t)(-b) : (uint64_t)b;
+
+    uint64_t aHigh = ua / MONEY_SCALE, aLow = ua % MONEY_SCALE;
+    uint64_t bHigh = ub / MONEY_SCALE, bLow = ub % MONEY_SCALE;
+
+    uint64_t result = aHigh * bHigh * MONEY_SCALE + aHigh * bLow + aLow * bHigh +
+                      (aLow * bLow + MONEY_SCALE / 2) / MONEY_SCALE;
+    return negative ? -(Money)result : (Money)result;
+}
+
+// تقسیم بر عدد صحیح با گرد کردن نیمه به دور از صفر
+static inline Money moneyDivInt(Money value, int64_t divisor) {
+    if (divisor == 0) return 0;
+    bool negative = (value < 0) != (divisor < 0);
+    uint64_t uv = value < 0 ? (uint64_t)(-value) : (uint64_t)value;
+    uint64_t ud = divisor < 0 ? (uint64_t)(-divisor) : (uint64_t)divisor;
+    uint64_t result = (uint64_t)((uv + ud / 2) / ud);
+    return negative ? -(Money)result : (Money)result;
+}
+
+// نوشتن با decimals رقم اعشار (0 تا 8)، فقط با عملیات صحیح. طول نوشته شده را برمی‌گرداند.
+static inline int moneyFormat(Money value, int decimals, char* buffer, size_t size) {
+    if (size == 0) return 0;
+    if (decimals < 0) decimals = 0;
+    if (decimals > MONEY_DECIMALS) decimals = MONEY_DECIMALS;
+
+    uint64_t unit = 1;
+    for (int i = decimals; i < MONEY_DECIMALS; i++) unit *= 10;
+    uint64_t fracScale = (uint64_t)MONEY_SCALE / unit;
+
+    bool negative = value < 0;
+    uint64_t magnitude = negative ? (uint64_t)(-value) : (uint64_t)value;
+    uint64_t rounded = (magnitude + unit / 2) / unit;
+    uint64_t intPart = rounded / fracScale;
+    uint64_t fracPart = rounded % fracScale;
+
+    char temp[32];
+    int n = 0;
+
+    for (int i = 0; i < decimals; i++) {
+        temp[n++] = '0' + (char)(fracPart % 10);
+        fracPart /= 10;
+    }
+    if (decimals > 0) temp[n++] = '.';
+    do {
+        temp[n++] = '0' + (char)(intPart % 10);
+        intPart /= 10;
+    } while (intPart > 0);
+    if (negative && rounded > 0) temp[n++] = '-';
+
+    int length = 0;
+    while (n > 0 && length < (int)size - 1) buffer[length++] = temp[--n];
+    buffer[length] = '\0';
+    return length;
+}
+
+// کامل‌ترین شکل بدون صفرهای انتهایی ("0.015", "42")؛ برای JSON
+static inline int moneyFormatTrim(Money value, char* buffer, size_t size) {
+    int length = moneyFormat(value, MONEY_DECIMALS, buffer, size);
+    while (length > 0 && buffer[length - 1] == '0') length--;
+    if (length > 0 && buffer[length - 1] == '.') length--;
+    if (length > 0) buffer[length] = '\0';
+    return length;
+}
+
+#endif
@@ -20,6 +20,12 @@
 #include <TFT_eSPI.h>
 #include <time.h>
 #include <Wire.h>
+#include <FS.h>
+#include <LittleFS.h>
+#include <esp_heap_caps.h>
+#include "web_assets.h"   // generated by tools/gen_web_assets.py
+#include "ts_codec.h"
+#include "money.h"
 
 // ===== TFT CONFIGURATION =====
 // Edit User_Setup.h in TFT_eSPI library:
@@ -42,8 +48,11 @@
 
 // ===== DEFINES =====
 #define MAX_ALERT_HISTORY 50
-// تغییر: افزایش از 40 به 100 موقعیت
-#define MAX_POSITIONS_PER_MODE 100
+// سقف قابل تنظیم پوزیشن هر مود؛ حافظه به اندازه payload از PSRAM رشد می‌کند (بخش POSITION STORE)
+#define MAX_POSITIONS_PER_MODE 1000
+#define POSITION_STORE_MIN_CAPACITY 16
+#define POSITION_POOL_CAPACITY 2000      // سقف مشترک همه slot های پورتفوی
+#define LEGACY_POSITIONS_PER_MODE 100   // اندازه آرایه‌های ثابت قبلی؛ فقط برای گزارش DRAM آزاد شده
 #define MAX_WIFI_NETWORKS 5
 #define EEPROM_SIZE 4096
 // تغییر: افزایش بافر JSON از 3072 به 8192
@@ -141,58 +150,512 @@ typedef struct {
 typedef struct {
     char symbol[16];
     float changePercent;
-    float pnlValue;
-    float quantity;
-    float entryPrice;
-    float currentPrice;
+    Money pnlValue;         // fixed-point (money.h)
+    Money quantity;
+    Money entryPrice;
+    Money currentPrice;
     bool isLong;
     bool alerted;
     bool severeAlerted;
     unsigned long lastAlertTime;
-    float lastAlertPrice;
+    Money lastAlertPrice;
     float alertThreshold;
     float severeThreshold;
     char positionSide[12];
     char marginType[12];
     
     bool exitAlerted;
-    float exitAlertLastPrice;
+    Money exitAlertLastPrice;
     unsigned long exitAlertTime;
     bool hasAlerted; // فیلد جدید برای پیگیری آلرت
     float lastAlertPercent; // فیلد جدید
+    float percentScale;     // pnl_percent سرور / درصد حرکت قیمت (اهرم)؛ برای محاسبه محلی (بخش PRICE TICKER)
+    uint32_t ruleLatch;     // بیت قوانین زده شده (بخش ALERT RULES)؛ با پوزیشن در merge منتقل می‌شود
+    unsigned long lossSince;    // millis شروع زیان پیوسته؛ 0 = در سود
+    bool ruleDirty;         // از آخرین ارزیابی قوانین تغییر کرده
 } CryptoPosition;
 
+// شاخص داغ هر پوزیشن در RAM داخلی؛ رکورد کامل CryptoPosition در PSRAM است (بخش POSITION STORE)
+typedef struct {
+    uint32_t key;           // hash نماد + جهت، برای تطبیق ردیف‌ها بدون خواندن PSRAM
+    float changePercent;
+    uint32_t sseHash;       // آخرین hash ارسال شده با SSE
+    uint16_t symbolId;      // ردیف جدول قیمت نمادها (بخش SYMBOL PRICE TABLE)
+    bool matched;           // فقط داخل aggregateMerge
+} PositionHot;
+
+// جدول مشترک قیمت نمادها (بخش SYMBOL PRICE TABLE): هر نماد یک بار، با فهرست پوزیشن‌های وابسته در همه slot ها
+#define SYMBOL_TABLE_CAPACITY 512
+#define SYMBOL_INDEX_SIZE 1024      // open addressing، توان 2 و حداقل دو برابر ظرفیت
+#define SYMBOL_NONE 0xFFFF
+
 typedef struct {
     char symbol[16];
-    unsigned long alertTime;
+    uint32_t hash;
+    Money price;                // آخرین قیمت از هر منبع (parse کامل، tier قیمت، stream)
+    unsigned long updatedAt;    // millis زمان مشاهده قیمت (ارسال درخواست poll یا دریافت تیک)
+    uint16_t firstDependent;    // اندیس در symbolDependents
+    uint16_t dependentCount;
+} SymbolPrice;
+
+// نمونه تاریخچه قیمت / ریسک؛ زیر قفل داده کپی و بیرون از آن ثبت می‌شود (priceSamplesRecord)
+typedef struct {
+    char symbol[16];
+    float price;
+    float changePercent;
+    bool isLong;
+} PriceSample;
+
+typedef struct {
+    uint8_t mode;
+    uint16_t row;
+} SymbolDependent;
+
+// سند JSON بزرگ (payload پورتفوی) در PSRAM ساخته می‌شود
+struct SpiRamAllocator {
+    void* allocate(size_t size) { return psramFound() ? ps_malloc(size) : malloc(size); }
+    void deallocate(void* pointer) { free(pointer); }
+    void* reallocate(void* pointer, size_t size) { return psramFound() ? ps_realloc(pointer, size) : realloc(pointer, size); }
+};
+typedef BasicJsonDocument<SpiRamAllocator> SpiRamJsonDocument;
+
+// رکورد فشرده آلرت (16 بایت) - همین ساختار در فایل لاگ LittleFS هم نوشته می‌شود.
+// نماد با شناسه از جدول نمادها ذخیره و رشته زمان هنگام نمایش ساخته می‌شود.
+typedef struct {
+    uint32_t timestamp;     // epoch seconds (یا ثانیه uptime اگر ALERT_FLAG_EPOCH نباشد)
     float pnlPercent;
     float alertPrice;
-    bool isLong;
-    bool isSevere;
-    bool isProfit;
-    byte alertType;
-    char message[64];
-    bool acknowledged;
-    char timeString[20];
-    byte alertMode;
-} AlertHistory;
+    uint16_t symbolId;
+    uint8_t flags;
+    uint8_t alertType;
+} AlertRecord;
+
+#define ALERT_FLAG_LONG      0x01
+#define ALERT_FLAG_SEVERE    0x02
+#define ALERT_FLAG_PROFIT    0x04
+#define ALERT_FLAG_ACKED     0x08
+#define ALERT_FLAG_EXIT_MODE 0x10
+#define ALERT_FLAG_EPOCH     0x20
+
+// slot پورتفوی در نیمه بالای alertType (رکوردهای قدیمی: 0 و مود از ALERT_FLAG_EXIT_MODE)
+#define ALERT_TYPE_MASK      0x0F
+#define ALERT_SLOT_SHIFT     4
 
 typedef struct {
-    float totalInvestment;
-    float totalCurrentValue;
-    float totalPnl;
+    Money totalInvestment;
+    Money totalCurrentValue;
+    Money totalPnl;
     float totalPnlPercent;
     int totalPositions;
     int longPositions;
     int shortPositions;
     int winningPositions;
     int losingPositions;
-    float maxDrawdown;
+    float maxDrawdown;      // بدترین افت از قله از زمان reset (بخش RISK STATISTICS)
     float sharpeRatio;
     float avgPositionSize;
     float riskExposure;
+    float currentDrawdown;
+    float volatility;       // سالانه، درصد
+    float sortinoRatio;
+    float worstChangePercent;
+    char worstSymbol[16];
 } PortfolioSummary;
 
+// مجموع‌های جاری هر مود (بخش INCREMENTAL SUMMARY) - با تفاضل ردیف‌های تغییر کرده به‌روز می‌شوند
+typedef struct {
+    Money totalValue;       // مجموع صحیح؛ مسیر تفاضلی drift ندارد
+    Money totalPnl;
+    int longCount;
+    int shortCount;
+    int winningCount;
+    int losingCount;
+    float worstPercent;
+    char worstSymbol[16];
+    bool worstIsLong;
+    bool valid;
+    uint16_t updatesSinceFull;
+    uint16_t lastChangedRows;
+} PortfolioAggregate;
+
+// آمار ریسک آنلاین (بخش RISK STATISTICS): هر به‌روزرسانی O(1)، بدون نگهداری تاریخچه
+#define RISK_MAX_SYMBOLS 64         // ردیف‌های (نماد، جهت)
+#define RISK_ROLLING_WINDOW 240     // ~1h با poll هر 15 ثانیه
+#define RISK_EW_ALPHA (2.0f / (RISK_ROLLING_WINDOW + 1))
+#define RISK_MIN_SAMPLES 20
+#define RISK_SECONDS_PER_YEAR 31536000.0f
+
+typedef struct {
+    uint32_t samples;
+    float mean;             // Welford: میانگین بازده هر refresh
+    float m2;               // Welford: مجموع مربعات انحراف
+    float ewMean;           // پنجره نمایی برای Sharpe/Sortino غلتان
+    float ewVar;
+    float ewDownside;
+    float ewInterval;       // فاصله میانگین نمونه‌ها (ثانیه)
+    float index;            // شاخص بازده تجمعی، از 1.0
+    float peakIndex;
+    float drawdown;         // افت فعلی از قله (درصد، منفی)
+    float maxDrawdown;
+    float lastValue;
+    Money lastPnl;          // فقط برای مودها
+    uint16_t lastCount;
+    uint32_t lastTime;
+    uint32_t resetTime;
+} RiskStats;
+
+typedef struct {
+    char symbol[16];
+    bool isLong;
+    RiskStats stats;
+} SymbolRisk;
+
+// رجیستری پورتفوی (بخش PORTFOLIO REGISTRY): slot 0 همان Entry و slot 1 همان Exit قبلی است.
+// در همه کد، پارامتر mode اندیس slot است.
+#define MAX_PORTFOLIOS 6
+#define PORTFOLIO_MIN_INTERVAL 5000UL
+
+// tier قیمت (بخش PRICE TICKER): بین sync های کامل فقط قیمت‌ها گرفته می‌شوند
+#define PRICE_FULL_SYNC_INTERVAL 120000UL   // باز/بسته شدن پوزیشن‌ها حداکثر با این تاخیر دیده می‌شود
+#define PRICE_POLL_DIVISOR 3                // فاصله poll قیمت = فاصله تطبیقی / 3
+#define PRICE_POLL_MIN_INTERVAL 2000UL
+#define PRICE_PROBE_INTERVAL 3600000UL      // بعد از 404 سرور، هر ساعت دوباره امتحان می‌شود
+#define PRICE_SYMBOLS_MAX_LENGTH 512        // طولانی‌تر: فقط portfolio_name فرستاده می‌شود
+#define PRICE_SCALE_MIN_MOVE 0.05f          // درصد؛ حرکت کمتر برای تخمین اهرم قابل اعتماد نیست
+#define PRICE_SCALE_MAX 125.0f
+
+typedef enum {
+    FETCH_TIER_FULL = 0,
+    FETCH_TIER_PRICE,
+    FETCH_TIER_COUNT
+} FetchTier;
+
+typedef enum {
+    ALERT_POLICY_DRAWDOWN = 0,      // مثل Entry: P/L زیر آستانه
+    ALERT_POLICY_PRICE_MOVE = 1     // مثل Exit: حرکت قیمت از آخرین آلرت
+} AlertPolicy;
+
+// دلیل فاصله fetch فعلی هر slot (بخش ADAPTIVE POLLING)
+typedef enum {
+    POLL_REASON_BASE = 0,
+    POLL_REASON_CALM,
+    POLL_REASON_VOLATILE,
+    POLL_REASON_NEAR_ALERT,
+    POLL_REASON_BACKOFF,
+    POLL_REASON_RETRY_AFTER,
+    POLL_REASON_COUNT
+} PollReason;
+
+typedef struct {
+    char name[32];                  // slot 0/1: settings.entryPortfolio / exitPortfolio
+    uint8_t policy;                 // AlertPolicy
+    bool enabled;
+    uint32_t fetchInterval;         // ms، فاصله پایه
+    uint32_t effectiveInterval;     // ms، بعد از تطبیق با نوسان / خطا
+    uint8_t pollReason;             // PollReason
+    uint8_t errorStreak;            // خطاهای پشت سر هم HTTP
+    unsigned long nextFetch;        // زمان‌بند fetch (millis)
+    unsigned long lastFetch;
+    unsigned long lastFullSync;     // آخرین fetch کامل پورتفولیو؛ بین آن‌ها فقط قیمت (بخش PRICE TICKER)
+    
+    // داده؛ آرایه‌ها از مخزن مشترک PSRAM (بخش POSITION STORE)
+    CryptoPosition* data;
+    PositionHot* hot;               // RAM داخلی
+    int capacity;
+    int count;
+    PortfolioSummary summary;
+    PortfolioAggregate aggregate;
+    RiskStats risk;
+    AlertRecord* history;           // ring buffer (MAX_ALERT_HISTORY)
+    int historyCount;
+    int historyHead;                // اسلات نوشتن بعدی
+} PortfolioSlot;
+
+// تغییر slot از POST /api/v1/portfolios؛ loop آن را روی slot زنده اعمال می‌کند (portfolioApplyChanges)
+typedef struct {
+    bool pending;
+    bool remove;
+    bool hasName;
+    char name[32];
+    bool hasPolicy;
+    uint8_t policy;
+    bool hasInterval;
+    uint32_t interval;
+    bool hasEnabled;
+    bool enabled;
+} PortfolioChange;
+
+// سرورهای API با circuit breaker (بخش API ENDPOINTS)
+#define API_MAX_ENDPOINTS 4
+#define API_LATENCY_WINDOW 32
+
+typedef enum {
+    BREAKER_CLOSED = 0,     // سالم
+    BREAKER_OPEN,           // رد می‌شود تا cooldown تمام شود
+    BREAKER_HALF_OPEN       // یک درخواست آزمایشی
+} BreakerState;
+
+typedef struct {
+    char url[128];          // endpoint 0 همان settings.server است
+    uint16_t latency[API_LATENCY_WINDOW];   // ms، فقط پاسخ‌های موفق، برای p95
+    uint8_t latencyCount;
+    uint8_t latencyHead;
+    float ewLatency;        // ms
+    float ewFailure;        // 0..1
+    uint32_t successes;
+    uint32_t failures;
+    uint32_t hedges;        // بعد از مهلت p95 سراغ سرور بعدی رفتیم
+    uint32_t rejected;      // پاسخ 4xx (جز 429): نه موفق نه خطای سرور، بیرون از پنجره تأخیر
+    uint8_t consecutiveFailures;
+    uint8_t breaker;        // BreakerState
+    unsigned long openedAt;
+    uint32_t cooldown;      // ms، با هر شکست half-open دو برابر
+} ApiEndpoint;
+
+// درخواست‌های سخت‌افزاری صفحه وب (بخش WEB SERVER TASK - webRequestsService)
+typedef enum {
+    HW_TEST_NONE = 0,
+    HW_TEST_LEDS,           // همه LED ها 1 ثانیه
+    HW_TEST_RGB,            // قرمز/سبز سپس سبز/آبی، هر کدام 1 ثانیه
+    HW_TEST_DISPLAY         // پیام آزمایشی 3 ثانیه
+} HardwareTest;
+
+typedef enum {
+    WIFI_ACTION_NONE = 0,
+    WIFI_ACTION_CONNECT,    // شبکه ذخیره شده با SSID درخواست
+    WIFI_ACTION_REMOVE,
+    WIFI_ACTION_RESCAN,
+    WIFI_ACTION_DISCONNECT,
+    WIFI_ACTION_RECONNECT   // بهترین شبکه ذخیره شده
+} WiFiAction;
+
+// جریان قیمت WebSocket (بخش PRICE STREAM)
+#define STREAM_LATENCY_WINDOW 32
+
+typedef enum {
+    STREAM_OFF = 0,         // غیرفعال یا بدون WiFi
+    STREAM_HANDSHAKE,       // TCP وصل، منتظر 101
+    STREAM_OPEN,
+    STREAM_BACKOFF,         // منتظر اتصال دوباره
+    STREAM_STATE_COUNT
+} StreamState;
+
+typedef struct {
+    unsigned long ticks;            // پیام‌های قیمت دریافتی
+    unsigned long matched;          // تیک‌هایی که حداقل یک پوزیشن را تغییر دادند
+    unsigned long alerts;           // آلرت‌های ناشی از تیک
+    unsigned long connects;
+    unsigned long dropped;          // frame های نامعتبر / تکه‌تکه
+    uint32_t latencyUs[STREAM_LATENCY_WINDOW];  // دریافت تیک تا شروع بازر
+    uint8_t latencyCount;
+    uint8_t latencyHead;
+    long lastAlertTickId;           // فیلد "id" تیک آخرین آلرت (برای سرور آزمایشی)
+} StreamStats;
+
+// قوانین آلرت برای هر نماد / slot (بخش ALERT RULES)
+#define RULE_MAX_RULES 1024
+#define RULE_MAX_PER_POSITION 32    // بیت‌های CryptoPosition.ruleLatch
+#define RULE_SLOT_ANY 0xFF
+
+typedef enum {
+    RULE_METRIC_THRESHOLD = 0,      // آستانه آلرت/شدید Entry را برای نماد یا slot عوض می‌کند
+    RULE_METRIC_PNL_PERCENT,
+    RULE_METRIC_MOVE_PERCENT,       // حرکت قیمت از ورود، در جهت پوزیشن
+    RULE_METRIC_PRICE,
+    RULE_METRIC_PNL_VALUE,
+    RULE_METRIC_LOSS_MINUTES,       // مدت پیوسته در زیان
+    RULE_METRIC_COUNT
+} RuleMetric;
+
+#define RULE_FLAG_ABOVE  0x01       // metric >= value (در غیر این صورت <=)
+#define RULE_FLAG_SEVERE 0x02
+
+typedef struct {
+    char symbol[16];        // خالی = همه نمادها
+    uint8_t slotMask;       // بیت هر slot یا RULE_SLOT_ANY
+    uint8_t metric;         // RuleMetric
+    uint8_t flags;
+    float value;            // THRESHOLD: آستانه آلرت
+    float rearm;            // فاصله برگشت برای مسلح شدن دوباره؛ THRESHOLD: آستانه شدید
+} AlertRule;
+
+// جدول کامپایل شده: قوانین همه نمادها در ابتدا، سپس قوانین هر نماد پشت سر هم
+typedef struct {
+    float value;
+    float rearmValue;       // value -/+ rearm
+    uint16_t source;        // اندیس در alertRules
+    uint8_t metric;
+    uint8_t flags;
+    uint8_t slotMask;
+} CompiledRule;
+
+typedef struct {
+    char symbol[16];
+    uint32_t hash;
+    uint16_t first;
+    uint16_t count;
+} RuleBucket;
+
+// صف آلرت هر دو mode (بخش ALERT DISPATCHER)
+#define ALERT_QUEUE_SIZE 32
+
+typedef enum {
+    ALERT_STYLE_ENTRY = 0,      // افت P/L: LED های مود 1، صدای لانگ/شورت
+    ALERT_STYLE_SLOT_EXIT,      // showAlert در slot با سیاست Exit: LED های مود 2، صدای سود/زیان
+    ALERT_STYLE_PRICE           // showExitAlert (حرکت قیمت)
+} AlertStyle;
+
+typedef struct {
+    char title[32];
+    char symbol[16];
+    char message[64];
+    float price;
+    float percent;          // P/L یا حرکت قیمت (زیان منفی)؛ کمتر = بدتر
+    float threshold;        // آستانه افت پوزیشن؛ NAN برای آلرت‌های دیگر
+    uint32_t seq;           // ترتیب ورود، برای اولویت برابر
+    byte mode;
+    uint8_t style;          // AlertStyle
+    bool isLong;
+    bool isSevere;
+    bool isProfit;
+} AlertEvent;
+
+// نت الگوهای بازر غیرمسدود (بخش BUZZER FUNCTIONS)
+typedef struct {
+    uint16_t frequency;
+    uint16_t duration;      // ms
+    uint16_t pause;         // سکوت پس از نت، ms
+} BuzzerNote;
+
+// هیستوگرام زمان مراحل loop برای /metrics (بخش RUNTIME METRICS)
+typedef enum {
+    STAGE_WEB,          // server.handleClient در تسک وب
+    STAGE_SSE,
+    STAGE_WIFI,
+    STAGE_FETCH,
+    STAGE_PARSE,
+    STAGE_ALERTS,
+    STAGE_DISPLAY,
+    STAGE_LEDS,
+    STAGE_COUNT
+} LoopStage;
+
+#define METRIC_BUCKET_COUNT 16
+
+typedef struct {
+    uint64_t buckets[METRIC_BUCKET_COUNT + 1];   // آخری: +Inf
+    uint64_t count;
+    uint64_t sumMicros;
+    uint32_t maxMicros;
+} LatencyHistogram;
+
+void metricsObserve(LoopStage stage, uint32_t elapsedMicros);
+
+// زمان از سازنده تا پایان scope در هیستوگرام مرحله ثبت می‌شود
+struct StageTimer {
+    LoopStage stage;
+    unsigned long startMicros;
+    StageTimer(LoopStage s) : stage(s), startMicros(micros()) {}
+    ~StageTimer() { metricsObserve(stage, micros() - startMicros); }
+};
+
+#define METRIC_CONCAT_(a, b) a##b
+#define METRIC_CONCAT(a, b) METRIC_CONCAT_(a, b)
+#define TIME_STAGE(stage) StageTimer METRIC_CONCAT(stageTimer, __LINE__)(stage)
+
+// نتیجه یک micro-benchmark (بخش BENCHMARKS)
+typedef struct {
+    char name[16];
+    int size;               // تعداد پوزیشن واقعاً بارگذاری شده
+    uint32_t iterations;
+    float nsPerOp;
+    float bytesPerOp;       // -1 اگر شمارش allocation در دسترس نباشد
+} BenchResult;
+
+// Server-Sent Events (بخش SERVER-SENT EVENTS)
+#define SSE_EVENT_SIZE 384
+
+typedef struct {
+    unsigned long id;
+    char type[12];
+    char data[SSE_EVENT_SIZE];
+} SSEEvent;
+
+typedef struct {
+    WiFiClient client;
+    bool active;
+    unsigned long nextEventId;
+    unsigned long connectedAt;
+    unsigned long lastWrite;
+    unsigned long sentCount;
+    unsigned long droppedCount;
+    unsigned long bytesSent;
+    int maxQueueDepth;
+    int writeFailures;
+} SSEClient;
+
+// Rendered Page Cache (بخش RENDERED PAGE CACHE)
+typedef struct {
+    char route[32];
+    byte variant;
+    unsigned long dataVer;
+    unsigned long alertVer;
+    unsigned long settingsVer;
+    char* html;
+    size_t length;
+    size_t capacity;
+    unsigned long lastUsed;
+} PageCacheEntry;
+
+// نسخه‌هایی که صفحه با آن‌ها رندر شد (زیر همان قفل رندر گرفته می‌شوند)
+typedef struct {
+    unsigned long dataVer;
+    unsigned long alertVer;
+    unsigned long settingsVer;
+} PageVersions;
+
+// Price Time-Series (بخش PRICE TIME-SERIES STORE)
+#define TS_TIER_COUNT 3      // 1m, 15m, 1h
+#define TS_RES_RAW 0
+#define TS_RES_1M  1
+#define TS_RES_15M 2
+#define TS_RES_1H  3
+
+typedef struct {
+    uint32_t time;          // شروع بازه
+    float open;
+    float high;
+    float low;
+    float close;
+    uint16_t samples;
+} TSBar;
+
+typedef struct {
+    TSBar* bars;            // ring buffer در PSRAM
+    uint16_t capacity;
+    uint16_t head;
+    uint16_t count;
+    uint32_t period;        // ثانیه
+    TSBar current;          // کندل در حال ساخت
+    bool hasCurrent;
+} TSTier;
+
+typedef struct {
+    char symbol[16];
+    TSBlock* blocks;        // نمونه‌های خام فشرده (ts_codec.h)، ring از بلوک‌ها
+    uint16_t blockHead;     // بلوک باز
+    uint16_t blockCount;
+    TSSample pending;       // آخرین نمونه، تا زمان بعدی کد نمی‌شود
+    bool hasPending;
+    TSTier tiers[TS_TIER_COUNT];
+} TSSeries;
+
+// متن فرمت شده با اندازه ثابت (بخش UTILITY FUNCTIONS) - روی stack، بدون تخصیص heap
+typedef char PercentText[16];     // "+12345.67%"
+typedef char NumberText[24];      // قیمت، عدد و مقدار Money
+typedef char SymbolText[12];      // نماد کوتاه (حداکثر 8 کاراکتر)
+typedef char DurationText[24];    // "123d 23h 59m 59s"
+
 // متغیرهای جدید برای اسکن شبکه
 WiFiNetwork scannedNetworks[20];  // شبکه‌های اسکن شده
 int scannedNetworkCount = 0;
@@ -256,30 +719,48 @@ typedef struct {
     unsigned long totalUptime;
 } SystemSettings;
 
+// ===== WEB SERVER TASK =====
+// وب سرور در تسک جداگانه روی core 0 اجرا می‌شود تا fetch/رندر در loop() آن را متوقف نکند
+#define WEB_TASK_STACK_SIZE 8192
+#define WEB_TASK_PRIORITY 1
+#define WEB_TASK_CORE 0
+
 // ===== GLOBAL OBJECTS =====
 TFT_eSPI tft = TFT_eSPI();
 WebServer server(80);
 HTTPClient http;
+SemaphoreHandle_t dataMutex = NULL;   // محافظت از داده منتشر شده بین loop و تسک وب
+TaskHandle_t webTaskHandle = NULL;
+TaskHandle_t loopTaskHandle = NULL;
 
 // ===== GLOBAL VARIABLES =====
 SystemSettings settings;
 byte powerSource = POWER_SOURCE_USB; // پیش‌فرض USB
 
-// Mode Data
-// تغییر: افزایش اندازه آرایه از 40 به 100
-CryptoPosition cryptoDataMode1[MAX_POSITIONS_PER_MODE];
-PortfolioSummary portfolioMode1;
-AlertHistory alertHistoryMode1[MAX_ALERT_HISTORY];
-int cryptoCountMode1 = 0;
-int alertHistoryCountMode1 = 0;
-
-// تغییر: افزایش اندازه آرایه از 40 به 100
-CryptoPosition cryptoDataMode2[MAX_POSITIONS_PER_MODE];
-PortfolioSummary portfolioMode2;
-AlertHistory alertHistoryMode2[MAX_ALERT_HISTORY];
-int cryptoCountMode2 = 0;
-int alertHistoryCountMode2 = 0;
+// Portfolio Data - همه slot ها (بخش PORTFOLIO REGISTRY)؛ آرایه‌ها از مخزن PSRAM
+PortfolioSlot portfolios[MAX_PORTFOLIOS];
+int portfolioCount = 2;                 // slot های فعال 0..portfolioCount-1
+PortfolioChange portfolioChanges[MAX_PORTFOLIOS];   // از تسک وب، زیر lockData
+
+// جمع همه slot ها برای نمایشگر
+Money combinedValue = 0;
+Money combinedInvestment = 0;
+float combinedPnlPercent = 0;
+#define SUMMARY_FULL_RECOMPUTE_EVERY 40   // ~10 دقیقه با poll هر 15 ثانیه
+unsigned long summaryFullRecomputes = 0;
+unsigned long summaryMismatches = 0;
+float summaryMaxDrift = 0;
+
+// وضعیت heap: تکه‌تکه شدن = 1 - (بزرگترین بلوک آزاد / کل حافظه آزاد)
+#define HEAP_STATS_INTERVAL 5000
+unsigned long lastHeapStats = 0;
+uint32_t heapFreeBytes = 0;
+uint32_t heapLargestBlock = 0;
+uint32_t heapMinFree = 0;
+float heapFragmentation = 0;
+float heapWorstFragmentation = 0;
 unsigned long lastAlertTime = 0;
+unsigned long buzzerStartMicros = 0;    // شروع آخرین صدای بازر؛ تأخیر تیک تا بازر (بخش PRICE STREAM)
 #define ALERT_AUTO_RETURN_TIME 8000  // 8 seconds
 
 // System State
@@ -307,9 +788,9 @@ unsigned long lastReconnectAttempt = 0;
 
 // Current State
 String currentDateTime = "";
-String alertTitle = "";
-String alertMessage = "";
-String alertSymbol = "";
+char alertTitle[32] = "";
+char alertMessage[64] = "";
+char alertSymbol[16] = "";
 float alertPrice = 0.0;
 bool alertIsLong = false;
 bool alertIsSevere = false;
@@ -323,8 +804,8 @@ bool mode2RedActive = false;
 bool blinkState = false;
 unsigned long ledTimeout = 0;
 
-String mode1AlertSymbol = "";
-String mode2AlertSymbol = "";
+char mode1AlertSymbol[16] = "";
+char mode2AlertSymbol[16] = "";
 float mode1AlertPercent = 0.0;
 float mode2AlertPercent = 0.0;
 
@@ -349,9 +830,47 @@ bool batteryLow = false;
 // API Statistics
 int apiSuccessCount = 0;
 int apiErrorCount = 0;
+int lastFetchHttpCode = 0;              // نتیجه آخرین apiFetch (بخش ADAPTIVE POLLING)
+uint32_t lastFetchRetryAfter = 0;       // ثانیه، از هدر Retry-After
+unsigned long lastFetchSentAt = 0;      // millis ارسال آخرین درخواست موفق؛ fetchObservedAt آن را مصرف می‌کند
+bool priceTickerSupported = true;       // false بعد از 404 روی endpoint قیمت (بخش PRICE TICKER)
+unsigned long priceTickerRetryAt = 0;
+uint8_t symbolDirtySlots = 0;           // slot هایی که قیمتشان بیرون از parse خودشان عوض شد (بخش SYMBOL PRICE TABLE)
 unsigned long lastApiCallTime = 0;
 float apiAverageResponseTime = 0.0;
 
+// Data Versions (برای ETag در API - با هر parse / آلرت جدید افزایش می‌یابند)
+unsigned long dataVersion = 0;
+unsigned long alertVersion = 0;
+unsigned long settingsVersion = 0;
+
+// درخواست‌های تسک وب؛ loop آن‌ها را اجرا می‌کند (بخش WEB SERVER TASK - webRequestsService)
+volatile bool refreshRequested = false;
+volatile bool resetAlertsRequested = false;
+volatile bool testAlertRequested = false;
+volatile int testVolumeRequested = 0;   // /testvolume؛ 0 = بدون درخواست
+volatile bool displayConfigChanged = false;
+volatile bool apiConfigChanged = false;
+volatile uint8_t hardwareTestRequested = HW_TEST_NONE;
+volatile int8_t ledStateRequested = -1;     // /ledcontrol on/off؛ -1 = بدون درخواست
+volatile int8_t backlightRequested = -1;    // /displaycontrol on/off
+volatile bool rgbOffRequested = false;
+volatile int volumeRequested = -1;          // /setvolume
+volatile bool apToggleRequested = false;
+volatile uint8_t wifiActionRequested = WIFI_ACTION_NONE;
+char wifiActionSsid[32] = "";               // همراه wifiActionRequested، زیر قفل داده
+uint8_t hardwareTestActive = HW_TEST_NONE;  // فقط loop
+uint8_t hardwareTestStep = 0;
+unsigned long hardwareTestStart = 0;
+
+// Benchmark (بخش BENCHMARKS) - در طول اجرا آلرت‌ها فقط شمرده می‌شوند
+bool benchmarkRunning = false;
+unsigned long benchmarkAlerts = 0;
+
+// Page Cache Statistics
+unsigned long pageCacheHits = 0;
+unsigned long pageCacheMisses = 0;
+
 // Connection Statistics
 int connectionLostCount = 0;
 int reconnectSuccessCount = 0;
@@ -381,12 +900,16 @@ void increaseVolume(int step = 10);
 void decreaseVolume(int step = 10);
 void toggleBuzzer();
 void playTone(int frequency, int duration);
+void buzzerPlaySequence(const BuzzerNote* notes, int count);
+void buzzerService(unsigned long now);
+bool buzzerBusy();
 void playVolumeFeedback();
 void playLongPositionAlert(bool isSevere);
 void playShortPositionAlert(bool isSevere);
 void playExitAlertTone(bool isProfit);
 void playPortfolioAlert();
 void playTestAlertSequence();
+void playVolumeTest(int volume);
 void playResetAlertTone();
 void playSuccessTone();
 void playErrorTone();
@@ -410,27 +933,172 @@ void blinkLEDs();
 void setAllLEDs(bool state);
 
 // Alert Functions
-void showAlert(String title, String symbol, String message, bool isLong, bool isSevere, float price, byte mode);
-void showExitAlert(String title, String symbol, String message, bool isProfit, float changePercent, float price);
+void showAlert(const char* title, const char* symbol, const char* message, bool isLong, bool isSevere, float price, byte mode,
+               float percent, float threshold);
+void showExitAlert(const char* title, const char* symbol, const char* message, bool isProfit, float changePercent, float price, byte mode);
 void checkAlerts(byte mode);
-void processEntryAlerts();
-void processExitAlerts();
+void processEntryAlerts(byte mode);
+void processExitAlerts(byte mode);
+bool processEntryPositionAlert(byte mode, CryptoPosition* pos, unsigned long currentTime);
+bool processExitPositionAlert(byte mode, CryptoPosition* pos);
+bool checkPositionAlert(byte mode, int index);
+
+// Alert Dispatcher
+void alertDispatch(const AlertEvent* event);
+void alertDispatchService(unsigned long now);
+
+// Alert Rules
+void rulesBegin();
+bool rulesSave();
+void rulesService();
+bool rulesCompile(const AlertRule* rules, int count);
+void rulesThresholds(byte mode, const char* symbol, float* alert, float* severe);
+int rulesEvaluatePosition(byte mode, CryptoPosition* pos, unsigned long now, bool fire);
+void rulesEvaluate(byte mode);
+void handleApiRules();
+void handleApiRulesUpdate();
 void resetAllAlerts();
 void addToAlertHistory(const char* symbol, float pnlPercent, float price, bool isLong, bool isSevere, bool isProfit, byte alertType, byte mode);
+const AlertRecord* getAlertRecord(byte mode, int newestIndex);
+byte alertRecordSlot(const AlertRecord* record);
+void formatAlertTime(const AlertRecord* record, char* buffer, size_t size);
+
+// Alert Log (LittleFS)
+void setupAlertLog();
+uint16_t internAlertSymbol(const char* symbol);
+const char* alertSymbolName(uint16_t symbolId);
+void appendAlertLog(const AlertRecord* record);
+void compactAlertLog(bool force);
+void restoreAlertHistory();
+void handleAlertHistory();
+
+// Payload Recorder (LittleFS)
+void recordPayload(byte mode, const String& payload);
+void handleApiRecording();
+void handleApiRecordingControl();
+void handleApiRecordingDownload();
+
+// Portfolio Registry
+const char* portfolioKey(byte mode);
+const char* portfolioLabel(byte mode);
+int portfolioFromArg(const String& arg, int fallback);
+bool portfolioIsExitStyle(byte mode);
+void portfolioSyncNames();
+void portfolioSpread(unsigned long now);
+void portfolioRecount();
+void portfolioRegistryBegin();
+void portfolioLoadConfig();
+bool portfolioSaveConfig();
+bool portfolioSchedule(unsigned long now);
+void handleApiPortfolios();
+void handleApiPortfoliosUpdate();
+void portfolioApplyChanges();
+
+// Adaptive Polling
+float pollAlertDistance(byte mode);
+float pollVolatility(byte mode);
+void pollRecordResult(byte mode, bool success, uint32_t retryAfterSeconds);
+void pollUpdateInterval(byte mode);
+
+// Position Store (PSRAM)
+void positionStoreBegin();
+bool positionStoreReserve(byte mode, int count);
+void positionHotRebuild(byte mode);
+uint32_t positionKey(const CryptoPosition* pos);
+size_t positionStoreBytes(bool internal);
+size_t positionStoreDramFreed();
+
+// Symbol Price Table
+void symbolTableBegin();
+uint16_t symbolFind(const char* symbol);
+void symbolTableRebuild();
+int symbolPriceSet(uint16_t id, Money price, unsigned long observedAt, int sourceMode);
+void symbolPublishSlot(byte mode, unsigned long observedAt);
+bool symbolPricesFresh(byte mode, unsigned long maxAge, unsigned long now);
+void symbolFlushDirty();
+
+// API Endpoints
+void apiEndpointsSync();
+void apiEndpointsBegin();
+bool apiEndpointsSave();
+int apiEndpointCount();
+uint32_t apiEndpointP95(const ApiEndpoint* endpoint);
+float apiEndpointScore(const ApiEndpoint* endpoint);
+int apiEndpointOrder(int* order, unsigned long now);
+uint32_t apiEndpointTimeout(const ApiEndpoint* endpoint, bool hedge);
+void apiEndpointRecord(int index, bool success, uint32_t latencyMs);
+void handleApiServers();
+void handleApiServersUpdate();
+
+// Price Ticker
+bool priceTickerUsable(unsigned long now);
+String getPriceData(byte mode);
+bool applyPriceData(const String& jsonData, byte mode);
+void priceTickerRecord(FetchTier tier, size_t bytes, uint32_t parseMicros);
+void positionApplyPrice(CryptoPosition* pos, Money price);
+
+// Price Stream (WebSocket)
+void streamBegin();
+bool streamSave();
+bool streamLive();
+void streamService(unsigned long now);
+void streamApplyTick(const char* symbol, Money price, long tickId, unsigned long rxMicros);
+uint32_t streamLatencyPercentile(int percentile);
+void handleApiStream();
+void handleApiStreamUpdate();
 
 // Data Processing Functions
 void parseCryptoData(String jsonData, byte mode);
+void publishPositions(byte mode, CryptoPosition* staged, int count, const PortfolioSummary* summary);
+unsigned long fetchObservedAt();
+bool priceSamplesReserve(int count);
+void priceSampleCopy(PriceSample* sample, const CryptoPosition* pos);
+void priceSamplesRecord(int count, uint32_t sampleTime);
+String apiFetch(const String& path, const String& label);
 String getPortfolioData(byte mode);
 String base64Encode(String data);
 void sortPositionsByLoss(CryptoPosition* data, int count);
 void calculatePortfolioSummary(byte mode);
 void clearCryptoData(byte mode);
 
+// Incremental Summary
+void aggregateApply(PortfolioAggregate* agg, const CryptoPosition* pos, int sign);
+void aggregateRebuild(PortfolioAggregate* agg, const CryptoPosition* data, int count);
+void aggregateFindWorst(PortfolioAggregate* agg, const CryptoPosition* data, int count);
+int aggregateMerge(byte mode, CryptoPosition* newData, int newCount);
+void aggregateUpdatePrice(byte mode, int row, Money price);
+bool isWorstPosition(const PortfolioAggregate* agg, const CryptoPosition* pos);
+void updateCombinedTotals();
+
+// Risk Statistics
+void riskReset(RiskStats* stats, uint32_t time);
+void riskUpdate(RiskStats* stats, float ret, uint32_t time);
+RiskStats* riskUpdatePortfolio(byte mode, const PortfolioSummary* summary, uint32_t time);
+void riskRecordSymbol(const char* symbol, float price, bool isLong, uint32_t time);
+float riskVolatility(const RiskStats* stats);
+float riskSharpe(const RiskStats* stats);
+float riskSortino(const RiskStats* stats);
+void handleApiRisk();
+void handleApiRiskReset();
+
 // Utility Functions
+const char* fmtShortSymbol(SymbolText& out, const char* symbol);
+const char* fmtPercent(PercentText& out, float percent);
+const char* fmtNumber(NumberText& out, float number);
+const char* fmtPrice(NumberText& out, float price);
+const char* fmtMoneyPrice(NumberText& out, Money price);
+const char* fmtMoneyNumber(NumberText& out, Money value);
+const char* fmtDuration(DurationText& out, unsigned long milliseconds);
+const char* fmtUptime(DurationText& out);
+void updateHeapStats();
 String getShortSymbol(const char* symbol);
 String formatPercent(float percent);
 String formatNumber(float number);
 String formatPrice(float price);
+String formatMoneyPrice(Money price);
+String formatMoneyNumber(Money value);
+String moneyJson(Money value);
+Money moneyFromJson(JsonVariantConst value);
 String formatTime(unsigned long timestamp);
 String formatDateTime(unsigned long timestamp);
 String getTimeString(unsigned long timestamp);
@@ -502,7 +1170,13 @@ void handlePositions();
 void handleToggleAP();
 void handleSetVolume();
 void handleTestVolume();
-String generateDashboardHTML();
+void handleStaticAsset(int index);
+void handleDashboardData();
+void handleApiPositions();
+void handleApiSummary();
+void handleApiAlerts();
+void handleEvents();
+void handleEventStats();
 String generateSystemInfoHTML();
 String generateAlertHistoryHTML(byte mode);
 String generatePositionListHTML(byte mode);
@@ -519,6 +1193,46 @@ void makeAPICall(byte mode);
 void handleAPIResponse(String response, byte mode);
 void updateAPIStatistics(bool success, unsigned long responseTime);
 
+// Price Time-Series
+void setupTimeSeries();
+uint32_t tsNow();
+void tsRecord(const char* symbol, float price, float changePercent, uint32_t time);
+int tsQuery(const char* symbol, byte resolution, uint32_t from, uint32_t to, TSBar* out, int maxOut);
+int tsSparkline(const char* symbol, uint32_t span, float* out, int points);
+void handleApiHistory();
+
+// Page Cache
+bool pageCacheServe(const char* route, byte variant);
+void pageCacheVersions(PageVersions* versions);
+void pageCacheStore(const char* route, byte variant, const String& html, const PageVersions* versions);
+float pageCacheHitRatio();
+size_t pageCacheMemory();
+
+// Web Task & Data Lock
+void startWebServerTask();
+void webServerTask(void* parameter);
+void lockData();
+void unlockData();
+void webRequestsService();
+void webQueueWiFiAction(uint8_t action, const char* ssid);
+
+// Server-Sent Events
+void ssePublish(const char* type, const char* json);
+void ssePublishPortfolio(byte mode);
+void ssePublishAlert(const char* title, const char* symbol, const char* message, float price, bool isSevere, byte mode);
+void ssePump();
+int sseActiveClients();
+
+// Runtime Metrics
+void handleMetrics();
+
+// Benchmarks
+int runBenchmarks(BenchResult* results, int maxResults, Print& out);
+int benchCompare(const BenchResult* results, int count, const String& baseline, int tolerancePercent, Print& out);
+String benchBaselineText(const BenchResult* results, int count);
+void runSerialBenchmark(bool saveBaseline);
+void handleSerialCommands();
+
 // Battery Functions
 void checkBattery();
 float readBatteryVoltage();
@@ -637,8 +1351,8 @@ void updateDisplay() {
     if (showingAlert) {
         if (now - alertDisplayStart > ALERT_AUTO_RETURN_TIME) {
             showingAlert = false;
-            alertTitle = "";
-            alertMessage = "";
+            alertTitle[0] = '\0';
+            alertMessage[0] = '\0';
             lastAlertTime = 0;
             showMainDisplay();
             return;
@@ -696,9 +1410,10 @@ void showAlertDisplay() {
     tft.print(alertSymbol);
     
     tft.setTextSize(3);
+    NumberText priceText;
     tft.setCursor(30, 120);
     tft.print("$");
-    tft.print(formatPrice(alertPrice));
+    tft.print(fmtPrice(priceText, alertPrice));
     
     tft.setTextSize(2);
     tft.setCursor(30, 160);
@@ -722,6 +1437,10 @@ void showMainDisplay() {
         return;
     }
     
+    // بافرهای متن روی stack؛ این تابع هر ثانیه اجرا می‌شود و نباید heap را تکه‌تکه کند
+    PercentText pnlText;
+    NumberText valueText;
+    
     tft.fillScreen(TFT_BLACK);
     
     // نمایش هدر
@@ -778,11 +1497,12 @@ void showMainDisplay() {
     
     tft.setTextColor(TFT_WHITE, TFT_BLACK);
     tft.setCursor(60, 90);
-    tft.print(String(cryptoCountMode1) + " pos");
+    tft.print(portfolios[0].count);
+    tft.print(" pos");
     
-    tft.setTextColor(portfolioMode1.totalPnlPercent >= 0 ? TFT_GREEN : TFT_RED, TFT_BLACK);
+    tft.setTextColor(portfolios[0].summary.totalPnlPercent >= 0 ? TFT_GREEN : TFT_RED, TFT_BLACK);
     tft.setCursor(120, 90);
-    tft.print(formatPercent(portfolioMode1.totalPnlPercent));
+    tft.print(fmtPercent(pnlText, portfolios[0].summary.totalPnlPercent));
     
     // Exit Mode
     tft.setTextColor(TFT_ORANGE, TFT_BLACK);
@@ -791,23 +1511,19 @@ void showMainDisplay() {
     
     tft.setTextColor(TFT_WHITE, TFT_BLACK);
     tft.setCursor(60, 110);
-    tft.print(String(cryptoCountMode2) + " pos");
+    tft.print(portfolios[1].count);
+    tft.print(" pos");
     
-    tft.setTextColor(portfolioMode2.totalPnlPercent >= 0 ? TFT_GREEN : TFT_RED, TFT_BLACK);
+    tft.setTextColor(portfolios[1].summary.totalPnlPercent >= 0 ? TFT_GREEN : TFT_RED, TFT_BLACK);
     tft.setCursor(120, 110);
-    tft.print(formatPercent(portfolioMode2.totalPnlPercent));
+    tft.print(fmtPercent(pnlText, portfolios[1].summary.totalPnlPercent));
     
     // Separator
     tft.drawFastHLine(0, 130, 240, TFT_DARKGREY);
     
-    // نمایش مجموع
-    float totalValue = portfolioMode1.totalCurrentValue + portfolioMode2.totalCurrentValue;
-    float totalInvestment = portfolioMode1.totalInvestment + portfolioMode2.totalInvestment;
-    float totalPnlPercent = 0;
-    
-    if (totalInvestment > 0) {
-        totalPnlPercent = ((totalValue - totalInvestment) / totalInvestment) * 100;
-    }
+    // نمایش مجموع (از پیش محاسبه شده در calculatePortfolioSummary)
+    Money totalValue = combinedValue;
+    float totalPnlPercent = combinedPnlPercent;
     
     tft.setTextColor(TFT_CYAN, TFT_BLACK);
     tft.setCursor(5, 145);
@@ -816,11 +1532,24 @@ void showMainDisplay() {
     tft.setTextColor(TFT_YELLOW, TFT_BLACK);
     tft.setCursor(60, 145);
     tft.print("$");
-    tft.print(formatNumber(totalValue));
+    tft.print(fmtMoneyNumber(valueText, totalValue));
     
     tft.setTextColor(totalPnlPercent >= 0 ? TFT_GREEN : TFT_RED, TFT_BLACK);
     tft.setCursor(150, 145);
-    tft.print(formatPercent(totalPnlPercent));
+    tft.print(fmtPercent(pnlText, totalPnlPercent));
+    
+    // ریسک Entry Mode: drawdown از قله و Sharpe غلتان
+    tft.setTextColor(TFT_DARKGREY, TFT_BLACK);
+    tft.setCursor(5, 157);
+    tft.print("RISK:");
+    tft.setTextColor(portfolios[0].summary.currentDrawdown < -5 ? TFT_RED : TFT_WHITE, TFT_BLACK);
+    tft.setCursor(60, 157);
+    tft.print("DD ");
+    tft.print(fmtPercent(pnlText, portfolios[0].summary.maxDrawdown));
+    tft.setTextColor(portfolios[0].summary.sharpeRatio >= 0 ? TFT_GREEN : TFT_RED, TFT_BLACK);
+    tft.setCursor(150, 157);
+    tft.print("SR ");
+    tft.print(portfolios[0].summary.sharpeRatio, 2);
     
     // نمایش وضعیت سیستم در پایین
     tft.drawFastHLine(0, 170, 240, TFT_DARKGREY);
@@ -882,6 +1611,10 @@ void showMainDisplayAlt() {
         digitalWrite(TFT_BL_PIN, LOW);
     }
     
+    PercentText pnlText;
+    NumberText valueText;
+    SymbolText symbolText;
+    
     tft.fillScreen(TFT_BLACK);
     
     // تقسیم صفحه به دو بخش
@@ -898,13 +1631,13 @@ void showMainDisplayAlt() {
     tft.setCursor(10, 40);
     tft.print("Positions:");
     tft.setCursor(80, 40);
-    tft.print(cryptoCountMode1);
+    tft.print(portfolios[0].count);
     
     tft.setCursor(10, 60);
     tft.print("P/L Total:");
-    tft.setTextColor(portfolioMode1.totalPnlPercent >= 0 ? TFT_GREEN : TFT_RED, TFT_BLACK);
+    tft.setTextColor(portfolios[0].summary.totalPnlPercent >= 0 ? TFT_GREEN : TFT_RED, TFT_BLACK);
     tft.setCursor(80, 60);
-    tft.print(formatPercent(portfolioMode1.totalPnlPercent));
+    tft.print(fmtPercent(pnlText, portfolios[0].summary.totalPnlPercent));
     
     tft.setTextColor(TFT_WHITE, TFT_BLACK);
     tft.setCursor(10, 80);
@@ -912,20 +1645,20 @@ void showMainDisplayAlt() {
     tft.setTextColor(TFT_YELLOW, TFT_BLACK);
     tft.setCursor(80, 80);
     tft.print("$");
-    tft.print(formatNumber(portfolioMode1.totalCurrentValue));
+    tft.print(fmtMoneyNumber(valueText, portfolios[0].summary.totalCurrentValue));
     
     // نمایش بهترین و بدترین موقعیت Entry
-    if (cryptoCountMode1 > 0) {
+    if (portfolios[0].count > 0) {
         float bestPnl = -9999, worstPnl = 9999;
         int bestIdx = -1, worstIdx = -1;
         
-        for (int i = 0; i < cryptoCountMode1; i++) {
-            if (cryptoDataMode1[i].changePercent > bestPnl) {
-                bestPnl = cryptoDataMode1[i].changePercent;
+        for (int i = 0; i < portfolios[0].count; i++) {
+            if (portfolios[0].hot[i].changePercent > bestPnl) {
+                bestPnl = portfolios[0].hot[i].changePercent;
                 bestIdx = i;
             }
-            if (cryptoDataMode1[i].changePercent < worstPnl) {
-                worstPnl = cryptoDataMode1[i].changePercent;
+            if (portfolios[0].hot[i].changePercent < worstPnl) {
+                worstPnl = portfolios[0].hot[i].changePercent;
                 worstIdx = i;
             }
         }
@@ -937,10 +1670,10 @@ void showMainDisplayAlt() {
         
         if (bestIdx >= 0) {
             tft.setCursor(50, 100);
-            tft.print(getShortSymbol(cryptoDataMode1[bestIdx].symbol));
+            tft.print(fmtShortSymbol(symbolText, portfolios[0].data[bestIdx].symbol));
             tft.setTextColor(TFT_GREEN, TFT_BLACK);
             tft.setCursor(100, 100);
-            tft.print(formatPercent(bestPnl));
+            tft.print(fmtPercent(pnlText, bestPnl));
         }
     }
     
@@ -955,13 +1688,13 @@ void showMainDisplayAlt() {
     tft.setCursor(10, 160);
     tft.print("Positions:");
     tft.setCursor(80, 160);
-    tft.print(cryptoCountMode2);
+    tft.print(portfolios[1].count);
     
     tft.setCursor(10, 180);
     tft.print("P/L Total:");
-    tft.setTextColor(portfolioMode2.totalPnlPercent >= 0 ? TFT_GREEN : TFT_RED, TFT_BLACK);
+    tft.setTextColor(portfolios[1].summary.totalPnlPercent >= 0 ? TFT_GREEN : TFT_RED, TFT_BLACK);
     tft.setCursor(80, 180);
-    tft.print(formatPercent(portfolioMode2.totalPnlPercent));
+    tft.print(fmtPercent(pnlText, portfolios[1].summary.totalPnlPercent));
     
     tft.setTextColor(TFT_WHITE, TFT_BLACK);
     tft.setCursor(10, 200);
@@ -969,7 +1702,7 @@ void showMainDisplayAlt() {
     tft.setTextColor(TFT_YELLOW, TFT_BLACK);
     tft.setCursor(80, 200);
     tft.print("$");
-    tft.print(formatNumber(portfolioMode2.totalCurrentValue));
+    tft.print(fmtMoneyNumber(valueText, portfolios[1].summary.totalCurrentValue));
     
     // نمایش وضعیت WiFi و زمان در گوشه
     tft.setTextSize(1);
@@ -1108,7 +1841,8 @@ void drawBatteryIcon(int x, int y, int percent) {
     tft.setTextColor(TFT_WHITE, TFT_BLACK);
     tft.setTextSize(1);
     tft.setCursor(x + 35, y + 4);
-    tft.print(String(percent) + "%");
+    tft.print(percent);
+    tft.print("%");
 }
 
 void showDisplayMessage(String line1, String line2, String line3, String line4) {
@@ -1213,6 +1947,7 @@ void playTone(int frequency, int durationMs) {
     if (actualDuration <= 0) {
         return;
     }
+    buzzerStartMicros = micros();
     
     // روش 1: برای حجم‌های پایین - پالس‌های کوتاه
     if (settings.buzzerVolume < 30) {
@@ -1250,20 +1985,90 @@ void playVolumeFeedback() {
     delay(duration + 20);
 }
 
+// الگوهای آلرت؛ بخش ALERT DISPATCHER آن‌ها را غیرمسدود پخش می‌کند و توابع play* زیر منتظر می‌مانند
+static const BuzzerNote longAlertNotes[] = { { LONG_NORMAL_TONE, 300, 350 } };
+static const BuzzerNote longSevereNotes[] = { { LONG_SEVERE_TONE, 200, 250 }, { 349, 250, 300 } };
+static const BuzzerNote shortAlertNotes[] = { { SHORT_NORMAL_TONE, 250, 300 } };
+static const BuzzerNote shortSevereNotes[] = {
+    { SHORT_SEVERE_TONE, 100, 120 }, { SHORT_SEVERE_TONE, 100, 120 }, { SHORT_SEVERE_TONE, 100, 120 }
+};
+static const BuzzerNote exitProfitNotes[] = { { 1047, 200, 250 }, { 1319, 250, 300 } };
+static const BuzzerNote exitLossNotes[] = { { 349, 300, 350 } };
+
+#define BUZZER_NOTES(notes) notes, (int)(sizeof(notes) / sizeof(notes[0]))
+
+// هر نت با حجم فعلی مثل playTone به قدم‌های tone() باز می‌شود (حجم پایین: پالس‌های 20ms)
+#define BUZZER_SEQUENCE_MAX 32
+BuzzerNote buzzerSequence[BUZZER_SEQUENCE_MAX];
+int buzzerSequenceLength = 0;
+int buzzerSequenceIndex = 0;
+unsigned long buzzerNextNoteAt = 0;
+
+static void buzzerAppend(uint16_t frequency, uint16_t duration, uint16_t pause) {
+    if (buzzerSequenceLength >= BUZZER_SEQUENCE_MAX) return;
+    buzzerSequence[buzzerSequenceLength].frequency = frequency;
+    buzzerSequence[buzzerSequenceLength].duration = duration;
+    buzzerSequence[buzzerSequenceLength].pause = pause;
+    buzzerSequenceLength++;
+}
+
+// الگوی در حال پخش را جایگزین می‌کند؛ نت اول همین‌جا شروع می‌شود (tone() روی ESP32 منتظر نمی‌ماند)
+void buzzerPlaySequence(const BuzzerNote* notes, int count) {
+    buzzerSequenceLength = 0;
+    buzzerSequenceIndex = 0;
+    if (!settings.buzzerEnabled || settings.buzzerVolume == 0) return;
+    
+    for (int i = 0; i < count; i++) {
+        int actualDuration = map(settings.buzzerVolume, 0, 100, 0, notes[i].duration);
+        if (settings.buzzerVolume < 30) {
+            int pulseCount = actualDuration / 30;
+            for (int p = 0; p < pulseCount; p++) {
+                buzzerAppend(notes[i].frequency, 20, p == pulseCount - 1 ? 10 + notes[i].pause : 10);
+            }
+        } else if (settings.buzzerVolume < 70) {
+            if (actualDuration > 0) buzzerAppend(notes[i].frequency, actualDuration, 10 + notes[i].pause);
+        } else {
+            buzzerAppend(notes[i].frequency, notes[i].duration, 10 + notes[i].pause);
+        }
+    }
+    if (buzzerSequenceLength == 0) return;
+    
+    buzzerStartMicros = micros();
+    buzzerService(millis());
+}
+
+void buzzerService(unsigned long now) {
+    if (buzzerSequenceIndex >= buzzerSequenceLength) return;
+    if (buzzerSequenceIndex > 0 && (long)(now - buzzerNextNoteAt) < 0) return;
+    
+    const BuzzerNote* note = &buzzerSequence[buzzerSequenceIndex++];
+    tone(BUZZER_PIN, note->frequency, note->duration);
+    buzzerNextNoteAt = now + note->duration + note->pause;
+}
+
+bool buzzerBusy() {
+    return buzzerSequenceIndex < buzzerSequenceLength || (long)(millis() - buzzerNextNoteAt) < 0;
+}
+
+// برای صداهای آزمایشی که پشت سر هم پخش می‌شوند
+static void buzzerWait() {
+    while (buzzerBusy()) {
+        buzzerService(millis());
+        delay(5);
+    }
+}
+
 void playLongPositionAlert(bool isSevere) {
     if (!settings.buzzerEnabled || settings.buzzerVolume == 0) return;
     
     Serial.println("Playing LONG alert" + String(isSevere ? " (SEVERE)" : ""));
     
     if (isSevere) {
-        playTone(440, 200);
-        delay(250);
-        playTone(349, 250);
-        delay(300);
+        buzzerPlaySequence(BUZZER_NOTES(longSevereNotes));
     } else {
-        playTone(523, 300);
-        delay(350);
+        buzzerPlaySequence(BUZZER_NOTES(longAlertNotes));
     }
+    buzzerWait();
 }
 
 void playShortPositionAlert(bool isSevere) {
@@ -1272,14 +2077,11 @@ void playShortPositionAlert(bool isSevere) {
     Serial.println("Playing SHORT alert" + String(isSevere ? " (SEVERE)" : ""));
     
     if (isSevere) {
-        for (int i = 0; i < 3; i++) {
-            playTone(784, 100);
-            delay(120);
-        }
+        buzzerPlaySequence(BUZZER_NOTES(shortSevereNotes));
     } else {
-        playTone(659, 250);
-        delay(300);
+        buzzerPlaySequence(BUZZER_NOTES(shortAlertNotes));
     }
+    buzzerWait();
 }
 
 void playExitAlertTone(bool isProfit) {
@@ -1288,14 +2090,11 @@ void playExitAlertTone(bool isProfit) {
     Serial.println("Playing EXIT alert for " + String(isProfit ? "PROFIT" : "LOSS"));
     
     if (isProfit) {
-        playTone(1047, 200);
-        delay(250);
-        playTone(1319, 250);
-        delay(300);
+        buzzerPlaySequence(BUZZER_NOTES(exitProfitNotes));
     } else {
-        playTone(349, 300);
-        delay(350);
+        buzzerPlaySequence(BUZZER_NOTES(exitLossNotes));
     }
+    buzzerWait();
 }
 
 void playPortfolioAlert() {
@@ -1309,6 +2108,17 @@ void playPortfolioAlert() {
     }
 }
 
+// لانگ، شورت، سود و زیان Exit و دو نت پایانی پشت سر هم؛ مکث‌ها جزء الگو هستند تا از loop
+// (webRequestsService) بدون delay پخش شود و آلرت واقعی بعدی فقط آن را قطع کند
+static const BuzzerNote testAlertNotes[] = {
+    { LONG_NORMAL_TONE, 300, 1150 },
+    { SHORT_NORMAL_TONE, 250, 1100 },
+    { 1047, 200, 250 }, { 1319, 250, 1100 },
+    { 349, 300, 1150 },
+    { 1047, 100, 120 }, { 1319, 150, 200 }
+};
+static const BuzzerNote testVolumeNotes[] = { { LONG_NORMAL_TONE, 300, 850 }, { SHORT_NORMAL_TONE, 250, 300 } };
+
 void playTestAlertSequence() {
     if (!settings.buzzerEnabled) {
         Serial.println("Buzzer disabled, skipping test");
@@ -1316,22 +2126,15 @@ void playTestAlertSequence() {
     }
     
     Serial.println("Playing test sequence...");
-    
-    playLongPositionAlert(false);
-    delay(800);
-    playShortPositionAlert(false);
-    delay(800);
-    playExitAlertTone(true);
-    delay(800);
-    playExitAlertTone(false);
-    delay(800);
-    
-    playTone(1047, 100);
-    delay(120);
-    playTone(1319, 150);
-    delay(200);
-    
-    Serial.println("Test sequence complete");
+    buzzerPlaySequence(BUZZER_NOTES(testAlertNotes));
+}
+
+// الگو با حجم آزمایشی ساخته می‌شود (buzzerPlaySequence حجم را هنگام ساخت اعمال می‌کند) و حجم ذخیره شده دست نمی‌خورد
+void playVolumeTest(int volume) {
+    int savedVolume = settings.buzzerVolume;
+    settings.buzzerVolume = constrain(volume, VOLUME_MIN, VOLUME_MAX);
+    buzzerPlaySequence(BUZZER_NOTES(testVolumeNotes));
+    settings.buzzerVolume = savedVolume;
 }
 
 void playResetAlertTone() {
@@ -1640,7 +2443,8 @@ void displayHistoryOnRGB1() {
         return;
     }
     
-    int totalAlerts = alertHistoryCountMode1 + alertHistoryCountMode2;
+    int totalAlerts = 0;
+    for (int i = 0; i < portfolioCount; i++) totalAlerts += portfolios[i].historyCount;
     
     if (totalAlerts == 0) {
         static uint8_t breathValue = 0;
@@ -1697,270 +2501,535 @@ void setAllLEDs(bool state) {
     digitalWrite(LED_MODE2_RED, state ? HIGH : LOW);
 }
 
-// ===== ALERT FUNCTIONS =====
-void showAlert(String title, String symbol, String message, bool isLong, bool isSevere, float price, byte mode) {
-    alertTitle = title;
-    alertSymbol = symbol;
-    alertMessage = message;
-    alertPrice = price;
-    alertIsLong = isLong;
-    alertIsSevere = isSevere;
-    alertMode = mode;
-    showingAlert = true;
-    alertDisplayStart = millis();
+// ===== ALERT DISPATCHER =====
+// آلرت‌های هر دو mode در یک صف اولویت (heap) جمع می‌شوند: شدید اول، سپس P/L بدتر، سپس قدیمی‌تر.
+// تاریخچه، لاگ و SSE هر آلرت فوراً ثبت می‌شوند؛ فقط نمایش، بازر و LED ها از صف و با نرخ محدود:
+// آلرت تنها وقتی نمایشگر آزاد است همان لحظه نمایش داده می‌شود، و هر چه در این فاصله جمع شود
+// از ALERT_COALESCE_MIN به بالا در یک آلرت خلاصه ("7 positions < -5.0%, worst SOL -12.0%") می‌آید.
+#define ALERT_COALESCE_MIN 3
+#define ALERT_DISPLAY_INTERVAL 4000     // حداقل فاصله دو صفحه آلرت
+#define ALERT_PREEMPT_TIME 1000         // آلرت شدید بعد از این مدت جای صفحه غیرشدید را می‌گیرد
+#define ALERT_BUZZER_INTERVAL 8000      // حداقل فاصله دو الگوی بازر (آلرت شدید بعد از غیرشدید: بدون انتظار)
+#define ALERT_LED_INTERVAL 1000
+
+AlertEvent alertQueue[ALERT_QUEUE_SIZE];
+int alertQueueCount = 0;
+uint32_t alertEventSeq = 0;
+
+// آلرت‌هایی که صف پر بیرون انداخت؛ فقط در شمارش خلاصه بعدی
+int alertDroppedPending = 0;
+float alertDroppedThreshold = NAN;
+bool alertDroppedMixed = false;
+
+unsigned long alertShownAt = 0;         // 0 = هنوز چیزی نمایش داده نشده
+unsigned long alertSoundAt = 0;
+unsigned long alertLedAt = 0;
+bool alertShownSevere = false;
+bool alertSoundSevere = false;
+
+unsigned long alertEventsTotal = 0;
+unsigned long alertPresentedTotal = 0;
+unsigned long alertSummariesTotal = 0;
+unsigned long alertCoalescedTotal = 0;  // آلرت‌هایی که در خلاصه ادغام شدند
+unsigned long alertDroppedTotal = 0;
+unsigned long alertMutedTotal = 0;      // نمایش بدون صدا به خاطر محدودیت بازر
+
+static bool alertEventBefore(const AlertEvent* a, const AlertEvent* b) {
+    if (a->isSevere != b->isSevere) return a->isSevere;
+    if (a->percent != b->percent) return a->percent < b->percent;
+    return (int32_t)(a->seq - b->seq) < 0;
+}
+
+static bool alertChannelReady(unsigned long last, unsigned long interval, unsigned long now) {
+    return last == 0 || now - last >= interval;
+}
+
+static void alertQueueSwap(int a, int b) {
+    AlertEvent tmp = alertQueue[a];
+    alertQueue[a] = alertQueue[b];
+    alertQueue[b] = tmp;
+}
+
+static void alertQueueSiftUp(int i) {
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!alertEventBefore(&alertQueue[i], &alertQueue[parent])) break;
+        alertQueueSwap(i, parent);
+        i = parent;
+    }
+}
+
+static void alertQueueSiftDown(int i) {
+    while (true) {
+        int best = i;
+        int left = 2 * i + 1;
+        int right = left + 1;
+        if (left < alertQueueCount && alertEventBefore(&alertQueue[left], &alertQueue[best])) best = left;
+        if (right < alertQueueCount && alertEventBefore(&alertQueue[right], &alertQueue[best])) best = right;
+        if (best == i) break;
+        alertQueueSwap(i, best);
+        i = best;
+    }
+}
+
+static void alertQueueRemove(int i) {
+    alertQueueCount--;
+    if (i == alertQueueCount) return;
+    alertQueue[i] = alertQueue[alertQueueCount];
+    alertQueueSiftDown(i);
+    alertQueueSiftUp(i);
+}
+
+static void alertNoteDropped(const AlertEvent* event) {
+    alertDroppedPending++;
+    alertDroppedTotal++;
+    if (isnan(event->threshold)) {
+        alertDroppedMixed = true;
+    } else if (isnan(alertDroppedThreshold) || event->threshold > alertDroppedThreshold) {
+        alertDroppedThreshold = event->threshold;
+    }
+}
+
+// صف پر: کم‌اهمیت‌ترین (یکی از برگ‌ها) بیرون می‌رود، شاید خود آلرت جدید
+static void alertQueuePush(const AlertEvent* event) {
+    if (alertQueueCount == ALERT_QUEUE_SIZE) {
+        int last = ALERT_QUEUE_SIZE / 2;
+        for (int i = last + 1; i < alertQueueCount; i++) {
+            if (alertEventBefore(&alertQueue[last], &alertQueue[i])) last = i;
+        }
+        if (alertEventBefore(&alertQueue[last], event)) {
+            alertNoteDropped(event);
+            return;
+        }
+        alertNoteDropped(&alertQueue[last]);
+        alertQueueRemove(last);
+    }
+    alertQueue[alertQueueCount] = *event;
+    alertQueueSiftUp(alertQueueCount++);
+}
+
+static void alertPresentLeds(const AlertEvent* event) {
+    // فقط slot 0 و 1 جفت LED دارند؛ slot های اضافه روی نمایشگر و بازر اعلام می‌شوند
+    if (event->mode >= 2) return;
     
-    Serial.println("\n🚨 ALERT TRIGGERED 🚨");
-    Serial.println("Title: " + title);
-    Serial.println("Symbol: " + symbol);
-    Serial.println("Message: " + message);
-    Serial.println("Price: " + formatPrice(price));
-    Serial.println("Type: " + String(isLong ? "LONG" : "SHORT"));
-    Serial.println("Severe: " + String(isSevere ? "YES" : "NO"));
-    Serial.println("Mode: " + String(mode == 0 ? "ENTRY" : "EXIT"));
+    if (event->style == ALERT_STYLE_ENTRY) {
+        snprintf(mode1AlertSymbol, sizeof(mode1AlertSymbol), "%s", event->symbol);
+        mode1AlertPercent = portfolios[event->mode].summary.totalPnlPercent;
+        mode1GreenActive = event->isLong;
+        mode1RedActive = !event->isLong;
+        ledTimeout = millis() + 30000;
+        return;
+    }
     
-    if (settings.buzzerEnabled && settings.buzzerVolume > 0) {
-        if (mode == 0) {
-            if (isLong) {
-                playLongPositionAlert(isSevere);
+    snprintf(mode2AlertSymbol, sizeof(mode2AlertSymbol), "%s", event->symbol);
+    mode2GreenActive = event->isProfit;
+    mode2RedActive = !event->isProfit;
+    if (event->style == ALERT_STYLE_PRICE) {
+        mode2AlertPercent = event->percent;
+    } else {
+        float total = abs(portfolios[event->mode].summary.totalPnlPercent);
+        mode2AlertPercent = event->isProfit ? total : -total;
+        ledTimeout = millis() + 30000;
+    }
+    rgb2CurrentPercent = mode2AlertPercent;
+    rgb2AlertActive = true;
+}
+
+static void alertPresentSound(const AlertEvent* event) {
+    if (event->style == ALERT_STYLE_ENTRY) {
+        if (event->isLong) {
+            if (event->isSevere) {
+                buzzerPlaySequence(BUZZER_NOTES(longSevereNotes));
             } else {
-                playShortPositionAlert(isSevere);
+                buzzerPlaySequence(BUZZER_NOTES(longAlertNotes));
             }
         } else {
-            bool isProfit = message.indexOf("PROFIT") != -1;
-            playExitAlertTone(isProfit);
+            if (event->isSevere) {
+                buzzerPlaySequence(BUZZER_NOTES(shortSevereNotes));
+            } else {
+                buzzerPlaySequence(BUZZER_NOTES(shortAlertNotes));
+            }
         }
+    } else if (event->isProfit) {
+        buzzerPlaySequence(BUZZER_NOTES(exitProfitNotes));
+    } else {
+        buzzerPlaySequence(BUZZER_NOTES(exitLossNotes));
+    }
+}
+
+// صفحه همیشه؛ بازر و LED ها فقط اگر کانال خودشان آزاد باشد
+static void alertPresent(const AlertEvent* event, unsigned long now) {
+    snprintf(alertTitle, sizeof(alertTitle), "%s", event->title);
+    snprintf(alertSymbol, sizeof(alertSymbol), "%s", event->symbol);
+    snprintf(alertMessage, sizeof(alertMessage), "%s", event->message);
+    alertPrice = event->price;
+    alertIsLong = event->style == ALERT_STYLE_PRICE ? event->isProfit : event->isLong;
+    if (event->style != ALERT_STYLE_PRICE) alertIsSevere = event->isSevere;
+    alertMode = event->mode;
+    showingAlert = true;
+    alertDisplayStart = now;
+    displayNeedsUpdate = true;
+    lastAlertTime = now;
+    alertShownAt = now;
+    alertShownSevere = event->isSevere;
+    alertPresentedTotal++;
+    
+    if (alertChannelReady(alertLedAt, ALERT_LED_INTERVAL, now)) {
+        alertLedAt = now;
+        alertPresentLeds(event);
     }
     
-    if (mode == 0) {
-        mode1AlertSymbol = symbol;
-        mode1AlertPercent = portfolioMode1.totalPnlPercent;
-        
-        if (isLong) {
-            mode1GreenActive = true;
-            mode1RedActive = false;
+    if (settings.buzzerEnabled && settings.buzzerVolume > 0) {
+        if (alertChannelReady(alertSoundAt, ALERT_BUZZER_INTERVAL, now) || (event->isSevere && !alertSoundSevere)) {
+            alertSoundAt = now;
+            alertSoundSevere = event->isSevere;
+            alertPresentSound(event);
         } else {
-            mode1GreenActive = false;
-            mode1RedActive = true;
+            alertMutedTotal++;
         }
-        
-        ledTimeout = millis() + 30000;
-    } else {
-        mode2AlertSymbol = symbol;
-        
-        bool isProfit = message.indexOf("PROFIT") != -1;
-        if (isProfit) {
-            mode2GreenActive = true;
-            mode2RedActive = false;
-            mode2AlertPercent = abs(portfolioMode2.totalPnlPercent);
-        } else {
-            mode2GreenActive = false;
-            mode2RedActive = true;
-            mode2AlertPercent = -abs(portfolioMode2.totalPnlPercent);
+    }
+}
+
+// همه صف (و بیرون‌افتاده‌ها) در یک آلرت؛ ظاهر (LED / صدا / mode) از سر صف (شدیدها اول)،
+// ولی نماد و درصد «worst» از کمترین درصد صف
+static void alertPresentSummary(unsigned long now) {
+    AlertEvent summary = alertQueue[0];
+    const AlertEvent* worst = &alertQueue[0];
+    int count = alertQueueCount + alertDroppedPending;
+    bool severe = false;
+    bool drawdown = !alertDroppedMixed;
+    float threshold = alertDroppedThreshold;
+    
+    for (int i = 0; i < alertQueueCount; i++) {
+        const AlertEvent* event = &alertQueue[i];
+        if (event->percent < worst->percent) worst = event;
+        severe = severe || event->isSevere;
+        if (isnan(event->threshold)) {
+            drawdown = false;
+        } else if (isnan(threshold) || event->threshold > threshold) {
+            threshold = event->threshold;
         }
-        
-        rgb2CurrentPercent = mode2AlertPercent;
-        rgb2AlertActive = true;
-        ledTimeout = millis() + 30000;
     }
     
-    addToAlertHistory(symbol.c_str(), 
-                     mode == 0 ? portfolioMode1.totalPnlPercent : portfolioMode2.totalPnlPercent,
-                     price, 
-                     isLong, 
-                     isSevere, 
-                     message.indexOf("PROFIT") != -1,
-                     isSevere ? 2 : 1,
-                     mode);
+    memcpy(summary.symbol, worst->symbol, sizeof(summary.symbol));
+    summary.percent = worst->percent;
+    summary.price = worst->price;
     
-    displayNeedsUpdate = true;
+    snprintf(summary.title, sizeof(summary.title), severe ? "%d SEVERE ALERTS" : "%d ALERTS", count);
+    if (drawdown) {
+        snprintf(summary.message, sizeof(summary.message), "%d positions < %.1f%%, worst %s %.1f%%",
+                 count, threshold, summary.symbol, summary.percent);
+    } else {
+        snprintf(summary.message, sizeof(summary.message), "%d alerts, worst %s %.1f%%",
+                 count, summary.symbol, summary.percent);
+    }
+    Serial.printf("Alert summary: %s\n", summary.message);
     
-    lastAlertTime = millis();
+    alertSummariesTotal++;
+    alertCoalescedTotal += count;
+    alertQueueCount = 0;
+    alertDroppedPending = 0;
+    alertDroppedThreshold = NAN;
+    alertDroppedMixed = false;
+    alertPresent(&summary, now);
 }
 
-void showExitAlert(String title, String symbol, String message, bool isProfit, float changePercent, float price) {
-    alertTitle = title;
-    alertSymbol = symbol;
-    alertMessage = message;
-    alertPrice = price;
-    alertIsLong = isProfit;
-    alertMode = 1;
-    showingAlert = true;
-    alertDisplayStart = millis();
+// از showAlert / showExitAlert؛ نمایش در alertDispatchService (همان تسک loop)
+void alertDispatch(const AlertEvent* event) {
+    AlertEvent queued = *event;
+    queued.seq = alertEventSeq++;
+    alertEventsTotal++;
+    alertQueuePush(&queued);
+}
+
+// بعد از هر دور بررسی آلرت و هر تیک، و در هر loop
+void alertDispatchService(unsigned long now) {
+    buzzerService(now);
+    if (alertQueueCount == 0) return;
     
-    Serial.println("\n💰 EXIT ALERT 💰");
-    Serial.println("Title: " + title);
-    Serial.println("Symbol: " + symbol);
-    Serial.println("Message: " + message);
-    Serial.println("Price: " + formatPrice(price));
-    Serial.println("Change: " + String(changePercent, 1) + "%");
-    Serial.println("Profit: " + String(isProfit ? "YES" : "NO"));
+    if (!alertChannelReady(alertShownAt, ALERT_DISPLAY_INTERVAL, now)) {
+        bool preempt = alertQueue[0].isSevere && !alertShownSevere && now - alertShownAt >= ALERT_PREEMPT_TIME;
+        if (!preempt) return;
+    }
     
-    if (settings.buzzerEnabled) {
-        playExitAlertTone(isProfit);
+    if (alertQueueCount + alertDroppedPending >= ALERT_COALESCE_MIN) {
+        alertPresentSummary(now);
+        return;
     }
     
-    mode2AlertSymbol = symbol;
-    mode2AlertPercent = isProfit ? changePercent : -changePercent;
+    AlertEvent top = alertQueue[0];
+    alertQueueRemove(0);
+    alertPresent(&top, now);
+}
+
+// ===== ALERT FUNCTIONS =====
+void showAlert(const char* title, const char* symbol, const char* message, bool isLong, bool isSevere, float price, byte mode,
+               float percent, float threshold) {
+    if (benchmarkRunning) {
+        benchmarkAlerts++;
+        return;
+    }
     
-    if (isProfit) {
-        mode2GreenActive = true;
-        mode2RedActive = false;
-    } else {
-        mode2GreenActive = false;
-        mode2RedActive = true;
+    NumberText priceText;
+    Serial.println("\n🚨 ALERT TRIGGERED 🚨");
+    Serial.printf("Title: %s\nSymbol: %s\nMessage: %s\nPrice: %s\n", title, symbol, message, fmtPrice(priceText, price));
+    Serial.printf("Type: %s\nSevere: %s\nMode: %s\n", isLong ? "LONG" : "SHORT",
+                  isSevere ? "YES" : "NO", portfolioLabel(mode));
+    
+    bool isProfit = strstr(message, "PROFIT") != NULL;
+    addToAlertHistory(symbol, 
+                     portfolios[mode].summary.totalPnlPercent,
+                     price, 
+                     isLong, 
+                     isSevere, 
+                     isProfit,
+                     isSevere ? 2 : 1,
+                     mode);
+    
+    ssePublishAlert(title, symbol, message, price, isSevere, mode);
+    
+    // بازر و LED ها بر اساس سیاست slot: LED های مود 1 برای افت P/L، مود 2 برای حرکت قیمت
+    AlertEvent event;
+    snprintf(event.title, sizeof(event.title), "%s", title);
+    snprintf(event.symbol, sizeof(event.symbol), "%s", symbol);
+    snprintf(event.message, sizeof(event.message), "%s", message);
+    event.price = price;
+    event.percent = percent;
+    event.threshold = threshold;
+    event.mode = mode;
+    event.style = portfolioIsExitStyle(mode) ? ALERT_STYLE_SLOT_EXIT : ALERT_STYLE_ENTRY;
+    event.isLong = isLong;
+    event.isSevere = isSevere;
+    event.isProfit = isProfit;
+    alertDispatch(&event);
+}
+
+void showExitAlert(const char* title, const char* symbol, const char* message, bool isProfit, float changePercent, float price, byte mode) {
+    if (benchmarkRunning) {
+        benchmarkAlerts++;
+        return;
     }
     
-    rgb2CurrentPercent = mode2AlertPercent;
-    rgb2AlertActive = true;
+    NumberText priceText;
+    Serial.println("\n💰 EXIT ALERT 💰");
+    Serial.printf("Title: %s\nSymbol: %s\nMessage: %s\nPrice: %s\n", title, symbol, message, fmtPrice(priceText, price));
+    Serial.printf("Change: %.1f%%\nProfit: %s\n", changePercent, isProfit ? "YES" : "NO");
     
-    addToAlertHistory(symbol.c_str(), 
+    addToAlertHistory(symbol, 
                      isProfit ? changePercent : -changePercent,
                      price, 
                      true,
                      false, 
                      isProfit,
                      isProfit ? 3 : 4,
-                     1);
+                     mode);
     
-    displayNeedsUpdate = true;
-}
-
+    ssePublishAlert(title, symbol, message, price, false, mode);
+    
+    AlertEvent event;
+    snprintf(event.title, sizeof(event.title), "%s", title);
+    snprintf(event.symbol, sizeof(event.symbol), "%s", symbol);
+    snprintf(event.message, sizeof(event.message), "%s", message);
+    event.price = price;
+    event.percent = isProfit ? changePercent : -changePercent;
+    event.threshold = NAN;
+    event.mode = mode;
+    event.style = ALERT_STYLE_PRICE;
+    event.isLong = isProfit;
+    event.isSevere = false;
+    event.isProfit = isProfit;
+    alertDispatch(&event);
+}
+
+// سیاست آلرت هر slot: افت P/L (مثل Entry) یا حرکت قیمت (مثل Exit)، سپس قوانین (بخش ALERT RULES).
+// فقط ردیف‌هایی که از ارزیابی قبلی تغییر کرده‌اند (ruleDirty) بررسی می‌شوند
 void checkAlerts(byte mode) {
-    if (mode == 0) {
-        processEntryAlerts();
+    if (portfolioIsExitStyle(mode)) {
+        processExitAlerts(mode);
     } else {
-        processExitAlerts();
+        processEntryAlerts(mode);
     }
+    rulesEvaluate(mode);
 }
 
-void processEntryAlerts() {
-    if (cryptoCountMode1 == 0) return;
+void processEntryAlerts(byte mode) {
+    PortfolioSlot* slot = &portfolios[mode];
+    if (slot->count == 0) return;
     
-    if (portfolioMode1.totalPnlPercent <= settings.portfolioAlertThreshold) {
-        bool isSevere = portfolioMode1.totalPnlPercent <= (settings.portfolioAlertThreshold * 1.5);
+    if (slot->summary.totalPnlPercent <= settings.portfolioAlertThreshold) {
+        bool isSevere = slot->summary.totalPnlPercent <= (settings.portfolioAlertThreshold * 1.5);
         
         if (!showingAlert) {
+            PercentText pnlText;
+            char message[32];
+            snprintf(message, sizeof(message), "Total P/L: %s", fmtPercent(pnlText, slot->summary.totalPnlPercent));
             showAlert("PORTFOLIO ALERT",
                      "PORTFOLIO",
-                     "Total P/L: " + formatPercent(portfolioMode1.totalPnlPercent),
+                     message,
                      true,
                      isSevere,
-                     portfolioMode1.totalCurrentValue,
-                     0);
+                     moneyToFloat(slot->summary.totalCurrentValue),
+                     mode,
+                     slot->summary.totalPnlPercent,
+                     NAN);
         }
     }
     
     unsigned long currentTime = millis();
+    for (int i = 0; i < slot->count; i++) {
+        if (slot->data[i].ruleDirty) processEntryPositionAlert(mode, &slot->data[i], currentTime);
+    }
+}
+
+// قانون آلرت یک پوزیشن؛ true اگر آلرت جدید داده شد
+bool processEntryPositionAlert(byte mode, CryptoPosition* pos, unsigned long currentTime) {
     unsigned long cooldownPeriod = 300000; // 5 دقیقه خنک‌سازی
     
-    for (int i = 0; i < cryptoCountMode1; i++) {
-        CryptoPosition* pos = &cryptoDataMode1[i];
-        
-        // بررسی زمان خنک‌سازی
-        if (pos->lastAlertTime > 0 && (currentTime - pos->lastAlertTime) < cooldownPeriod) {
-            continue; // در دوره خنک‌سازی هستیم
-        }
-        
-        if (!pos->alerted && pos->changePercent <= settings.alertThreshold) {
-            bool isSevere = pos->changePercent <= settings.severeAlertThreshold;
-            
-            showAlert(isSevere ? "SEVERE ALERT" : "POSITION ALERT",
-                     getShortSymbol(pos->symbol),
-                     "P/L: " + formatPercent(pos->changePercent),
-                     pos->isLong,
-                     isSevere,
-                     pos->currentPrice,
-                     0);
-            
-            pos->alerted = true;
-            pos->severeAlerted = isSevere;
-            pos->hasAlerted = true;
-            pos->lastAlertTime = currentTime;
-            pos->lastAlertPrice = pos->currentPrice;
-            pos->lastAlertPercent = pos->changePercent;
-        }
-        
-        // ریست اتوماتیک اگر بهبود یافت
-        float resetThreshold = settings.alertThreshold + 2.0; // 2% بالاتر از آستانه
-        if (pos->alerted && pos->changePercent > resetThreshold) {
-            pos->alerted = false;
-            pos->severeAlerted = false;
-            pos->hasAlerted = false;
-            pos->lastAlertTime = 0;
-            Serial.println("Alert auto-reset for " + getShortSymbol(pos->symbol) + 
-                          " (P/L improved to " + formatPercent(pos->changePercent) + ")");
-        }
+    // بررسی زمان خنک‌سازی
+    if (pos->lastAlertTime > 0 && (currentTime - pos->lastAlertTime) < cooldownPeriod) {
+        return false; // در دوره خنک‌سازی هستیم
+    }
+    
+    bool fired = false;
+    // آستانه‌ها در parse از تنظیمات یا قانون THRESHOLD نماد / slot پر می‌شوند
+    if (!pos->alerted && pos->changePercent <= pos->alertThreshold) {
+        bool isSevere = pos->changePercent <= pos->severeThreshold;
+        SymbolText symbol;
+        PercentText pnlText;
+        char message[32];
+        snprintf(message, sizeof(message), "P/L: %s", fmtPercent(pnlText, pos->changePercent));
+        
+        showAlert(isSevere ? "SEVERE ALERT" : "POSITION ALERT",
+                 fmtShortSymbol(symbol, pos->symbol),
+                 message,
+                 pos->isLong,
+                 isSevere,
+                 moneyToFloat(pos->currentPrice),
+                 mode,
+                 pos->changePercent,
+                 pos->alertThreshold);
+        
+        pos->alerted = true;
+        pos->severeAlerted = isSevere;
+        pos->hasAlerted = true;
+        pos->lastAlertTime = currentTime;
+        pos->lastAlertPrice = pos->currentPrice;
+        pos->lastAlertPercent = pos->changePercent;
+        fired = true;
+    }
+    
+    // ریست اتوماتیک اگر بهبود یافت
+    float resetThreshold = pos->alertThreshold + 2.0; // 2% بالاتر از آستانه
+    if (pos->alerted && pos->changePercent > resetThreshold) {
+        pos->alerted = false;
+        pos->severeAlerted = false;
+        pos->hasAlerted = false;
+        pos->lastAlertTime = 0;
+        SymbolText symbol;
+        PercentText pnlText;
+        Serial.printf("Alert auto-reset for %s (P/L improved to %s)\n",
+                      fmtShortSymbol(symbol, pos->symbol), fmtPercent(pnlText, pos->changePercent));
     }
+    return fired;
 }
 
-void processExitAlerts() {
-    if (cryptoCountMode2 == 0 || !settings.exitAlertEnabled) return;
+void processExitAlerts(byte mode) {
+    PortfolioSlot* slot = &portfolios[mode];
+    if (slot->count == 0 || !settings.exitAlertEnabled) return;
     
-    for (int i = 0; i < cryptoCountMode2; i++) {
-        CryptoPosition* pos = &cryptoDataMode2[i];
-        
-        if (pos->exitAlertLastPrice == 0) {
-            pos->exitAlertLastPrice = pos->currentPrice;
-            continue;
-        }
-        
-        float priceChangePercent = fabs((pos->currentPrice - pos->exitAlertLastPrice) / 
-                                      pos->exitAlertLastPrice * 100);
-        
-        if (priceChangePercent >= settings.exitAlertPercent) {
-            bool isProfit = (pos->currentPrice > pos->exitAlertLastPrice);
-            float changeFromEntry = 0.0;
-            
-            if (pos->entryPrice > 0) {
-                if (pos->isLong) {
-                    changeFromEntry = ((pos->currentPrice - pos->entryPrice) / pos->entryPrice) * 100;
-                } else {
-                    changeFromEntry = ((pos->entryPrice - pos->currentPrice) / pos->entryPrice) * 100;
-                }
-            }
-            
-            String message = "Change: " + String(priceChangePercent, 1) + "%";
-            if (changeFromEntry != 0.0) {
-                message += " | Total: " + formatPercent(changeFromEntry);
-            }
-            
-            showExitAlert("PRICE ALERT",
-                         getShortSymbol(pos->symbol),
-                         message,
-                         isProfit,
-                         priceChangePercent,
-                         pos->currentPrice);
-            
-            pos->exitAlerted = true;
-            pos->exitAlertTime = millis();
-            pos->exitAlertLastPrice = pos->currentPrice;
-        }
+    for (int i = 0; i < slot->count; i++) {
+        if (slot->data[i].ruleDirty) processExitPositionAlert(mode, &slot->data[i]);
     }
 }
 
-void resetAllAlerts() {
-    Serial.println("Resetting all alerts...");
-    
-    for (int i = 0; i < cryptoCountMode1; i++) {
-        cryptoDataMode1[i].alerted = false;
-        cryptoDataMode1[i].severeAlerted = false;
-        cryptoDataMode1[i].hasAlerted = false;
-        cryptoDataMode1[i].lastAlertTime = 0;
+bool processExitPositionAlert(byte mode, CryptoPosition* pos) {
+    if (pos->exitAlertLastPrice == 0) {
+        pos->exitAlertLastPrice = pos->currentPrice;
+        return false;
     }
     
-    for (int i = 0; i < cryptoCountMode2; i++) {
-        cryptoDataMode2[i].exitAlerted = false;
-        cryptoDataMode2[i].exitAlertLastPrice = cryptoDataMode2[i].currentPrice;
-        cryptoDataMode2[i].exitAlertTime = 0;
+    float priceChangePercent = fabs(moneyRatio(pos->currentPrice - pos->exitAlertLastPrice,
+                                               pos->exitAlertLastPrice) * 100);
+    if (priceChangePercent < settings.exitAlertPercent) return false;
+    
+    bool isProfit = (pos->currentPrice > pos->exitAlertLastPrice);
+    float changeFromEntry = 0.0;
+    
+    if (pos->entryPrice > 0) {
+        if (pos->isLong) {
+            changeFromEntry = moneyRatio(pos->currentPrice - pos->entryPrice, pos->entryPrice) * 100;
+        } else {
+            changeFromEntry = moneyRatio(pos->entryPrice - pos->currentPrice, pos->entryPrice) * 100;
+        }
+    }
+    
+    char message[48];
+    int used = snprintf(message, sizeof(message), "Change: %.1f%%", priceChangePercent);
+    if (changeFromEntry != 0.0) {
+        PercentText totalText;
+        snprintf(message + used, sizeof(message) - used, " | Total: %s", fmtPercent(totalText, changeFromEntry));
+    }
+    
+    SymbolText symbol;
+    showExitAlert("PRICE ALERT",
+                 fmtShortSymbol(symbol, pos->symbol),
+                 message,
+                 isProfit,
+                 priceChangePercent,
+                 moneyToFloat(pos->currentPrice),
+                 mode);
+    
+    pos->exitAlerted = true;
+    pos->exitAlertTime = millis();
+    pos->exitAlertLastPrice = pos->currentPrice;
+    return true;
+}
+
+// فقط قانون پوزیشن index طبق سیاست slot (تیک‌های PRICE STREAM)؛ آلرت کل پورتفوی در checkAlerts می‌ماند
+bool checkPositionAlert(byte mode, int index) {
+    CryptoPosition* pos = &portfolios[mode].data[index];
+    unsigned long now = millis();
+    bool fired;
+    if (portfolioIsExitStyle(mode)) {
+        fired = settings.exitAlertEnabled && processExitPositionAlert(mode, pos);
+    } else {
+        fired = processEntryPositionAlert(mode, pos, now);
+    }
+    if (rulesEvaluatePosition(mode, pos, now, true) > 0) fired = true;
+    pos->ruleDirty = false;
+    return fired;
+}
+
+void resetAllAlerts() {
+    Serial.println("Resetting all alerts...");
+    
+    lockData();
+    for (int m = 0; m < portfolioCount; m++) {
+        PortfolioSlot* slot = &portfolios[m];
+        for (int i = 0; i < slot->count; i++) {
+            CryptoPosition* pos = &slot->data[i];
+            pos->alerted = false;
+            pos->severeAlerted = false;
+            pos->hasAlerted = false;
+            pos->lastAlertTime = 0;
+            pos->exitAlerted = false;
+            pos->exitAlertLastPrice = pos->currentPrice;
+            pos->exitAlertTime = 0;
+            // قوانین آلرت دوباره مسلح و در ارزیابی بعدی برای همه ردیف‌ها بررسی می‌شوند
+            pos->ruleLatch = 0;
+            pos->ruleDirty = true;
+        }
     }
+    alertVersion++;
+    unlockData();
     
     mode1GreenActive = false;
     mode1RedActive = false;
     mode2GreenActive = false;
     mode2RedActive = false;
     
-    mode1AlertSymbol = "";
-    mode2AlertSymbol = "";
+    mode1AlertSymbol[0] = '\0';
+    mode2AlertSymbol[0] = '\0';
     mode1AlertPercent = 0.0;
     mode2AlertPercent = 0.0;
     
@@ -1977,382 +3046,3793 @@ void resetAllAlerts() {
 }
 
 void addToAlertHistory(const char* symbol, float pnlPercent, float price, bool isLong, bool isSevere, bool isProfit, byte alertType, byte mode) {
-    AlertHistory* history;
-    int* count;
+    AlertRecord record;
+    time_t now = time(nullptr);
     
-    if (mode == 0) {
-        history = alertHistoryMode1;
-        count = &alertHistoryCountMode1;
+    // بدون NTP زمان واقعی نداریم؛ ثانیه uptime ذخیره می‌شود
+    if (now > 1600000000) {
+        record.timestamp = (uint32_t)now;
+        record.flags = ALERT_FLAG_EPOCH;
     } else {
-        history = alertHistoryMode2;
-        count = &alertHistoryCountMode2;
-    }
-    
-    if (*count >= MAX_ALERT_HISTORY) {
-        for (int i = 0; i < MAX_ALERT_HISTORY - 1; i++) {
-            history[i] = history[i + 1];
-        }
-        (*count)--;
+        record.timestamp = millis() / 1000;
+        record.flags = 0;
     }
     
-    AlertHistory* newAlert = &history[*count];
+    record.pnlPercent = pnlPercent;
+    record.alertPrice = price;
+    record.symbolId = internAlertSymbol(symbol);
+    record.alertType = (alertType & ALERT_TYPE_MASK) | (mode << ALERT_SLOT_SHIFT);
+    if (isLong) record.flags |= ALERT_FLAG_LONG;
+    if (isSevere) record.flags |= ALERT_FLAG_SEVERE;
+    if (isProfit) record.flags |= ALERT_FLAG_PROFIT;
+    if (portfolioIsExitStyle(mode)) record.flags |= ALERT_FLAG_EXIT_MODE;
     
-    strncpy(newAlert->symbol, symbol, 15);
-    newAlert->symbol[15] = '\0';
+    AlertRecord* history = portfolios[mode].history;
+    int* count = &portfolios[mode].historyCount;
+    int* head = &portfolios[mode].historyHead;
     
-    newAlert->pnlPercent = pnlPercent;
-    newAlert->alertPrice = price;
-    newAlert->alertTime = millis();
-    newAlert->isLong = isLong;
-    newAlert->isSevere = isSevere;
-    newAlert->isProfit = isProfit;
-    newAlert->alertType = alertType;
-    newAlert->alertMode = mode;
-    newAlert->acknowledged = false;
-    
-    struct tm timeinfo;
-    if (getLocalTime(&timeinfo, 100)) {
-        strftime(newAlert->timeString, 20, "%m/%d %H:%M:%S", &timeinfo);
-    } else {
-        snprintf(newAlert->timeString, 20, "%lu", millis() / 1000);
-    }
+    // O(1): روی قدیمی‌ترین رکورد نوشته می‌شود، بدون جابجایی
+    lockData();
+    history[*head] = record;
+    *head = (*head + 1) % MAX_ALERT_HISTORY;
+    if (*count < MAX_ALERT_HISTORY) (*count)++;
+    alertVersion++;
+    unlockData();
     
-    (*count)++;
+    appendAlertLog(&record);
     
-    Serial.println("Alert added to history: " + String(symbol) + " (" + String(mode == 0 ? "ENTRY" : "EXIT") + ")");
+    Serial.println("Alert added to history: " + String(symbol) + " (" + String(portfolioLabel(mode)) + ")");
 }
 
-// ===== DATA PROCESSING FUNCTIONS =====
-void parseCryptoData(String jsonData, byte mode) {
-    if (jsonData.length() < 10 || jsonData == "{}") {
-        Serial.println("Empty or invalid JSON data for mode " + String(mode));
-        return;
-    }
-    
-    // تغییر: استفاده از بافر بزرگتر 8192 بایت
-    DynamicJsonDocument doc(JSON_BUFFER_SIZE);
-    DeserializationError error = deserializeJson(doc, jsonData);
+// newestIndex = 0 → جدیدترین آلرت
+byte alertRecordSlot(const AlertRecord* record) {
+    byte slot = record->alertType >> ALERT_SLOT_SHIFT;
+    if (slot == 0 && (record->flags & ALERT_FLAG_EXIT_MODE)) slot = 1;
+    return slot < MAX_PORTFOLIOS ? slot : 0;
+}
+
+const AlertRecord* getAlertRecord(byte mode, int newestIndex) {
+    AlertRecord* history = portfolios[mode].history;
+    int count = portfolios[mode].historyCount;
+    int head = portfolios[mode].historyHead;
     
-    if (error) {
-        Serial.println("JSON Parse Error for mode " + String(mode) + ": " + String(error.c_str()));
+    if (newestIndex < 0 || newestIndex >= count) return NULL;
+    return &history[(head - 1 - newestIndex + MAX_ALERT_HISTORY) % MAX_ALERT_HISTORY];
+}
+
+void formatAlertTime(const AlertRecord* record, char* buffer, size_t size) {
+    if (record->flags & ALERT_FLAG_EPOCH) {
+        time_t t = record->timestamp;
+        struct tm timeinfo;
+        localtime_r(&t, &timeinfo);
+        strftime(buffer, size, "%m/%d %H:%M:%S", &timeinfo);
+    } else {
+        snprintf(buffer, size, "+%lus", (unsigned long)record->timestamp);
+    }
+}
+
+// ===== ALERT LOG (LittleFS) =====
+// هر آلرت به انتهای /alerts.log اضافه می‌شود (append-only، رکورد 16 بایتی).
+// وقتی فایل از ALERT_LOG_MAX_RECORDS بزرگ‌تر شود، فقط ALERT_LOG_KEEP_RECORDS رکورد آخر نگه داشته می‌شود.
+// جدول نمادها در /alertsym.txt (هر خط یک نماد، شماره خط = شناسه) نگه داشته می‌شود.
+#define ALERT_LOG_FILE "/alerts.log"
+#define ALERT_LOG_TMP_FILE "/alerts.tmp"
+#define ALERT_SYMBOL_FILE "/alertsym.txt"
+#define ALERT_LOG_MAX_RECORDS 8192           // ~128KB
+#define ALERT_LOG_KEEP_RECORDS 4096
+#define ALERT_LOG_COMPACT_INTERVAL 3600000   // 1 hour
+#define ALERT_LOG_CHUNK 32
+#define MAX_ALERT_SYMBOLS 256
+#define ALERT_SYMBOL_UNKNOWN 0xFFFF
+
+char alertSymbolTable[MAX_ALERT_SYMBOLS][16];
+int alertSymbolCount = 0;
+bool alertLogReady = false;
+unsigned long lastAlertLogCompact = 0;
+
+void setupAlertLog() {
+    if (!LittleFS.begin(true)) {
+        Serial.println("❌ LittleFS mount failed - alert log disabled");
         return;
     }
+    alertLogReady = true;
     
-    if (!doc.containsKey("portfolio")) {
-        Serial.println("No 'portfolio' field in JSON for mode " + String(mode));
-        return;
+    File symbols = LittleFS.open(ALERT_SYMBOL_FILE, "r");
+    if (symbols) {
+        while (symbols.available() && alertSymbolCount < MAX_ALERT_SYMBOLS) {
+            String line = symbols.readStringUntil('\n');
+            line.trim();
+            strncpy(alertSymbolTable[alertSymbolCount], line.c_str(), 15);
+            alertSymbolTable[alertSymbolCount][15] = '\0';
+            alertSymbolCount++;
+        }
+        symbols.close();
     }
     
-    JsonArray portfolio = doc["portfolio"];
-    int itemCount = portfolio.size();
-    
-    CryptoPosition* targetData;
-    int* targetCount;
-    PortfolioSummary* targetSummary;
+    compactAlertLog(false);
+    restoreAlertHistory();
     
-    if (mode == 0) {
-        targetData = cryptoDataMode1;
-        targetCount = &cryptoCountMode1;
-        targetSummary = &portfolioMode1;
-    } else {
-        targetData = cryptoDataMode2;
-        targetCount = &cryptoCountMode2;
-        targetSummary = &portfolioMode2;
+    Serial.println("Alert log ready: " + String(alertSymbolCount) + " symbols");
+}
+
+uint16_t internAlertSymbol(const char* symbol) {
+    for (int i = 0; i < alertSymbolCount; i++) {
+        if (strncmp(alertSymbolTable[i], symbol, 15) == 0) return i;
     }
     
-    *targetCount = min(itemCount, MAX_POSITIONS_PER_MODE);
+    if (alertSymbolCount >= MAX_ALERT_SYMBOLS) return ALERT_SYMBOL_UNKNOWN;
     
-    memset(targetData, 0, sizeof(CryptoPosition) * MAX_POSITIONS_PER_MODE);
+    strncpy(alertSymbolTable[alertSymbolCount], symbol, 15);
+    alertSymbolTable[alertSymbolCount][15] = '\0';
     
-    for (int i = 0; i < *targetCount; i++) {
-        JsonObject item = portfolio[i];
-        CryptoPosition* pos = &targetData[i];
-        
-        const char* symbol = item["symbol"] | "UNKNOWN";
-        strncpy(pos->symbol, symbol, 15);
-        pos->symbol[15] = '\0';
-        
-        pos->changePercent = item["pnl_percent"] | 0.0;
-        pos->currentPrice = item["current_price"] | 0.0;
-        pos->entryPrice = item["entry_price"] | 0.0;
-        pos->quantity = item["quantity"] | 0.0;
-        pos->pnlValue = item["pnl"] | 0.0;
-        
-        pos->isLong = true;
-        
-        if (item.containsKey("position")) {
-            const char* position = item["position"];
-            if (strcasecmp(position, "short") == 0) pos->isLong = false;
-        } else if (item.containsKey("position_side")) {
-            const char* positionSide = item["position_side"];
-            if (strcasecmp(positionSide, "short") == 0) pos->isLong = false;
-        } else if (item.containsKey("side")) {
-            const char* side = item["side"];
-            if (strcasecmp(side, "sell") == 0) pos->isLong = false;
-        }
-        
-        pos->alertThreshold = settings.alertThreshold;
-        pos->severeThreshold = settings.severeAlertThreshold;
-        pos->hasAlerted = false;
-        pos->lastAlertPercent = 0.0;
-        
-        if (mode == 1) {
-            pos->exitAlertLastPrice = pos->currentPrice;
+    if (alertLogReady) {
+        File symbols = LittleFS.open(ALERT_SYMBOL_FILE, "a");
+        if (symbols) {
+            symbols.println(alertSymbolTable[alertSymbolCount]);
+            symbols.close();
         }
     }
     
-    if (doc.containsKey("summary")) {
-        JsonObject summary = doc["summary"];
-        
-        targetSummary->totalInvestment = summary["total_investment"] | 0.0;
-        targetSummary->totalCurrentValue = summary["total_current_value"] | 0.0;
-        targetSummary->totalPnl = summary["total_pnl"] | 0.0;
+    return alertSymbolCount++;
+}
+
+const char* alertSymbolName(uint16_t symbolId) {
+    if (symbolId >= alertSymbolCount) return "?";
+    return alertSymbolTable[symbolId];
+}
+
+void appendAlertLog(const AlertRecord* record) {
+    if (!alertLogReady) return;
+    
+    lockData();
+    File log = LittleFS.open(ALERT_LOG_FILE, "a");
+    if (log) {
+        log.write((const uint8_t*)record, sizeof(AlertRecord));
+        size_t records = log.size() / sizeof(AlertRecord);
+        log.close();
         
-        if (targetSummary->totalInvestment > 0) {
-            targetSummary->totalPnlPercent = ((targetSummary->totalCurrentValue - targetSummary->totalInvestment) / 
-                                            targetSummary->totalInvestment) * 100;
-        } else {
-            targetSummary->totalPnlPercent = 0.0;
+        if (records > ALERT_LOG_MAX_RECORDS) {
+            compactAlertLog(true);
         }
-        
-        targetSummary->totalPositions = *targetCount;
-        targetSummary->longPositions = summary["long_positions"] | 0;
-        targetSummary->shortPositions = summary["short_positions"] | 0;
-        targetSummary->winningPositions = summary["winning_positions"] | 0;
-        targetSummary->losingPositions = summary["losing_positions"] | 0;
-        targetSummary->maxDrawdown = summary["max_drawdown"] | 0.0;
-        targetSummary->sharpeRatio = summary["sharpe_ratio"] | 0.0;
     }
-    
-    Serial.println("Mode " + String(mode) + " data parsed: " + String(*targetCount) + " positions");
+    unlockData();
 }
 
-String getPortfolioData(byte mode) {
-    if (!isConnectedToWiFi) {
-        Serial.println("Cannot fetch data: WiFi not connected");
-        return "{}";
+void compactAlertLog(bool force) {
+    if (!alertLogReady) return;
+    lastAlertLogCompact = millis();
+    
+    lockData();
+    File source = LittleFS.open(ALERT_LOG_FILE, "r");
+    if (!source) {
+        unlockData();
+        return;
     }
     
-    if (strlen(settings.server) == 0 || strlen(settings.username) == 0) {
-        Serial.println("Cannot fetch data: API not configured");
-        return "{}";
+    size_t records = source.size() / sizeof(AlertRecord);
+    if (records <= ALERT_LOG_KEEP_RECORDS || (!force && records <= ALERT_LOG_MAX_RECORDS)) {
+        source.close();
+        unlockData();
+        return;
+    }
+    
+    File target = LittleFS.open(ALERT_LOG_TMP_FILE, "w");
+    if (!target) {
+        source.close();
+        unlockData();
+        return;
     }
     
-    String portfolioName = (mode == 0) ? String(settings.entryPortfolio) : String(settings.exitPortfolio);
-    String url = String(settings.server) + "/api/device/portfolio/" + 
-                String(settings.username) + "?portfolio_name=" + portfolioName;
+    source.seek((records - ALERT_LOG_KEEP_RECORDS) * sizeof(AlertRecord));
+    AlertRecord chunk[ALERT_LOG_CHUNK];
+    size_t bytes;
+    while ((bytes = source.read((uint8_t*)chunk, sizeof(chunk))) > 0) {
+        target.write((const uint8_t*)chunk, bytes);
+    }
+    source.close();
+    target.close();
     
-    Serial.println("Fetching data for " + portfolioName + " from: " + url);
+    LittleFS.remove(ALERT_LOG_FILE);
+    LittleFS.rename(ALERT_LOG_TMP_FILE, ALERT_LOG_FILE);
+    unlockData();
     
-    unsigned long startTime = millis();
+    Serial.println("Alert log compacted: " + String(records) + " → " + String(ALERT_LOG_KEEP_RECORDS) + " records");
+}
+
+// بعد از بوت، آخرین آلرت‌های هر مود از لاگ به ring buffer برمی‌گردند
+void restoreAlertHistory() {
+    File log = LittleFS.open(ALERT_LOG_FILE, "r");
+    if (!log) return;
     
-    http.begin(url);
-    http.setTimeout(10000);
+    size_t records = log.size() / sizeof(AlertRecord);
+    size_t start = records > 4 * MAX_ALERT_HISTORY ? records - 4 * MAX_ALERT_HISTORY : 0;
+    log.seek(start * sizeof(AlertRecord));
     
-    String auth = base64Encode(String(settings.username) + ":" + String(settings.userpass));
-    http.addHeader("Authorization", "Basic " + auth);
-    http.addHeader("Content-Type", "application/json");
+    AlertRecord record;
+    while (log.read((uint8_t*)&record, sizeof(record)) == sizeof(record)) {
+        byte mode = alertRecordSlot(&record);
+        AlertRecord* history = portfolios[mode].history;
+        if (history == NULL) continue;
+        int* count = &portfolios[mode].historyCount;
+        int* head = &portfolios[mode].historyHead;
+        
+        history[*head] = record;
+        *head = (*head + 1) % MAX_ALERT_HISTORY;
+        if (*count < MAX_ALERT_HISTORY) (*count)++;
+    }
+    log.close();
+    alertVersion++;
+    
+    Serial.print("Alert history restored:");
+    for (int i = 0; i < MAX_PORTFOLIOS; i++) {
+        if (portfolios[i].historyCount > 0) Serial.printf(" %d %s", portfolios[i].historyCount, portfolioKey(i));
+    }
+    Serial.println();
+}
+
+// ===== PAYLOAD RECORDER (LittleFS) =====
+// پاسخ‌های خام getPortfolioData برای بازپخش روی host (host/replay.h) ذخیره می‌شوند.
+// هر رکورد: "#REC <epoch> <millis> <mode> <length>\n" + بدنه + "\n".
+// فقط با درخواست صریح فعال می‌شود و با رسیدن به RECORD_MAX_BYTES خودکار متوقف می‌شود.
+#define RECORD_FILE "/record.log"
+#define RECORD_MAX_BYTES (768 * 1024)
+#define RECORD_CHUNK 1024
+
+bool recordingEnabled = false;
+size_t recordingBytes = 0;
+unsigned long recordingCount = 0;
+
+void recordPayload(byte mode, const String& payload) {
+    if (!recordingEnabled || !alertLogReady) return;
     
-    int httpCode = http.GET();
-    String response = "{}";
+    char header[64];
+    int headerLength = snprintf(header, sizeof(header), "#REC %lu %lu %u %u\n",
+                                (unsigned long)time(nullptr), millis(), mode, payload.length());
+    if (recordingBytes + headerLength + payload.length() + 1 > RECORD_MAX_BYTES) {
+        recordingEnabled = false;
+        Serial.println("Recording stopped: " + String(RECORD_MAX_BYTES / 1024) + " KB limit reached");
+        return;
+    }
     
-    unsigned long responseTime = millis() - startTime;
+    lockData();
+    File file = LittleFS.open(RECORD_FILE, "a");
+    if (file) {
+        file.write((const uint8_t*)header, headerLength);
+        file.write((const uint8_t*)payload.c_str(), payload.length());
+        file.write((const uint8_t*)"\n", 1);
+        recordingBytes = file.size();
+        recordingCount++;
+        file.close();
+    }
+    unlockData();
+}
+
+// GET /api/v1/recording - وضعیت ضبط
+void handleApiRecording() {
+    char json[128];
+    snprintf(json, sizeof(json), "{\"enabled\":%s,\"records\":%lu,\"bytes\":%u,\"maxBytes\":%u}",
+             recordingEnabled ? "true" : "false", recordingCount, (unsigned)recordingBytes, (unsigned)RECORD_MAX_BYTES);
+    server.send(200, "application/json", json);
+}
+
+// POST /api/v1/recording?action=start|stop|clear
+void handleApiRecordingControl() {
+    String action = server.arg("action");
     
-    if (httpCode == HTTP_CODE_OK) {
-        response = http.getString();
-        updateAPIStatistics(true, responseTime);
-        Serial.println("Data fetched successfully for " + portfolioName + " (" + String(response.length()) + " bytes)");
+    if (action == "start") {
+        lockData();
+        File file = LittleFS.open(RECORD_FILE, "a");
+        recordingBytes = file ? file.size() : 0;
+        if (file) file.close();
+        unlockData();
+        recordingEnabled = alertLogReady;
+    } else if (action == "stop") {
+        recordingEnabled = false;
+    } else if (action == "clear") {
+        lockData();
+        LittleFS.remove(RECORD_FILE);
+        recordingBytes = 0;
+        recordingCount = 0;
+        unlockData();
     } else {
-        updateAPIStatistics(false, responseTime);
-        Serial.println("HTTP Error: " + String(httpCode) + " for " + portfolioName);
+        server.send(400, "text/plain", "action must be start, stop or clear");
+        return;
     }
     
-    http.end();
-    return response;
+    Serial.println("Recording " + action);
+    handleApiRecording();
 }
 
-String base64Encode(String data) {
-    const char* base64_chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-    String encoded = "";
-    int i = 0;
-    int len = data.length();
+// GET /api/v1/recording/download - فایل ضبط، تکه به تکه تا loop فقط کوتاه قفل شود
+void handleApiRecordingDownload() {
+    uint8_t chunk[RECORD_CHUNK];
+    size_t position = 0;
     
-    while (i < len) {
-        uint32_t octet_a = i < len ? (unsigned char)data[i++] : 0;
-        uint32_t octet_b = i < len ? (unsigned char)data[i++] : 0;
-        uint32_t octet_c = i < len ? (unsigned char)data[i++] : 0;
-        
-        uint32_t triple = (octet_a << 0x10) + (octet_b << 0x08) + octet_c;
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server.sendHeader("Content-Disposition", "attachment; filename=record.log");
+    server.send(200, "application/octet-stream", "");
+    
+    for (;;) {
+        size_t bytes = 0;
+        lockData();
+        File file = LittleFS.open(RECORD_FILE, "r");
+        if (file) {
+            file.seek(position);
+            bytes = file.read(chunk, sizeof(chunk));
+            file.close();
+        }
+        unlockData();
         
-        encoded += base64_chars[(triple >> 3 * 6) & 0x3F];
-        encoded += base64_chars[(triple >> 2 * 6) & 0x3F];
-        encoded += base64_chars[(triple >> 1 * 6) & 0x3F];
-        encoded += base64_chars[(triple >> 0 * 6) & 0x3F];
+        if (bytes == 0) break;
+        server.sendContent((const char*)chunk, bytes);
+        position += bytes;
     }
+    server.sendContent("");
+}
+
+// ===== ADAPTIVE POLLING =====
+// فاصله fetch هر slot حول فاصله پایه (fetchInterval) تنظیم می‌شود:
+//   - نزدیک آستانه آلرت یا نوسان بالا: کوتاه‌تر، تا آلرت دیر نرسد
+//   - بازار آرام: بلندتر، تا درخواست و CPU کمتری مصرف شود
+//   - خطای HTTP: backoff نمایی با jitter، و حداقل به اندازه Retry-After سرور
+// نوسان از آمار ریسک slot (بخش RISK STATISTICS) خوانده و به انحراف معیار بازده در دقیقه
+// نرمال می‌شود تا خود تغییر فاصله روی آن اثر نگذارد. نتیجه در /metrics و /api/v1/portfolios.
+#define POLL_MAX_INTERVAL 120000UL
+#define POLL_CALM_FACTOR 3              // بازار آرام: پایه × 3
+#define POLL_VOLATILE_DIVISOR 2         // نوسان بالا: پایه ÷ 2
+#define POLL_NEAR_ALERT_DIVISOR 3       // نزدیک آستانه: پایه ÷ 3
+#define POLL_VOLATILE_STDDEV 0.30f      // درصد بازده در دقیقه
+#define POLL_CALM_STDDEV 0.03f
+#define POLL_NEAR_ALERT_MARGIN 1.0f     // واحد درصد تا آستانه آلرت
+#define POLL_MIN_SAMPLES 5
+#define POLL_BACKOFF_MAX 300000UL
+#define POLL_RETRY_AFTER_MAX 900000UL
+#define POLL_JITTER_PERCENT 20
+
+const char* const pollReasonNames[POLL_REASON_COUNT] = {
+    "base", "calm", "volatile", "near_alert", "backoff", "retry_after"
+};
+
+// کمترین فاصله (واحد درصد) تا آلرت بعدی slot؛ آلرت‌های فعال شمرده نمی‌شوند. داخل lockData
+float pollAlertDistance(byte mode) {
+    PortfolioSlot* slot = &portfolios[mode];
+    float nearest = 1e9f;
     
-    if (len % 3 == 1) {
-        encoded[encoded.length() - 1] = '=';
-        encoded[encoded.length() - 2] = '=';
-    } else if (len % 3 == 2) {
-        encoded[encoded.length() - 1] = '=';
+    if (portfolioIsExitStyle(mode)) {
+        if (!settings.exitAlertEnabled) return nearest;
+        for (int i = 0; i < slot->count; i++) {
+            const CryptoPosition* pos = &slot->data[i];
+            if (pos->exitAlertLastPrice == 0) continue;
+            float moved = fabs(moneyRatio(pos->currentPrice - pos->exitAlertLastPrice, pos->exitAlertLastPrice) * 100);
+            float distance = settings.exitAlertPercent - moved;
+            if (distance >= 0 && distance < nearest) nearest = distance;
+        }
+        return nearest;
     }
     
-    return encoded;
+    // شاخص داغ در RAM داخلی؛ نیازی به خواندن PSRAM نیست
+    for (int i = 0; i < slot->count; i++) {
+        float distance = slot->hot[i].changePercent - settings.alertThreshold;
+        if (distance >= 0 && distance < nearest) nearest = distance;
+    }
+    if (slot->count > 0) {
+        float distance = slot->summary.totalPnlPercent - settings.portfolioAlertThreshold;
+        if (distance >= 0 && distance < nearest) nearest = distance;
+    }
+    return nearest;
 }
 
-void sortPositionsByLoss(CryptoPosition* data, int count) {
-    for (int i = 0; i < count - 1; i++) {
-        for (int j = 0; j < count - i - 1; j++) {
-            if (data[j].changePercent > data[j + 1].changePercent) {
-                CryptoPosition temp = data[j];
-                data[j] = data[j + 1];
-                data[j + 1] = temp;
-            }
-        }
-    }
+// انحراف معیار بازده پورتفوی در دقیقه (درصد)؛ -1 اگر نمونه کافی نباشد
+float pollVolatility(byte mode) {
+    const RiskStats* stats = &portfolios[mode].risk;
+    if (stats->samples < POLL_MIN_SAMPLES || stats->ewInterval <= 0) return -1;
+    return sqrtf(stats->ewVar * 60.0f / stats->ewInterval) * 100.0f;
 }
 
-void calculatePortfolioSummary(byte mode) {
-    PortfolioSummary* summary = (mode == 0) ? &portfolioMode1 : &portfolioMode2;
-    CryptoPosition* data = (mode == 0) ? cryptoDataMode1 : cryptoDataMode2;
-    int count = (mode == 0) ? cryptoCountMode1 : cryptoCountMode2;
-    
-    if (count == 0) {
-        memset(summary, 0, sizeof(PortfolioSummary));
+// نتیجه fetch: موفق → صفر شدن شمارنده خطا؛ ناموفق → backoff تا fetch بعدی
+void pollRecordResult(byte mode, bool success, uint32_t retryAfterSeconds) {
+    PortfolioSlot* slot = &portfolios[mode];
+    if (success) {
+        slot->errorStreak = 0;
         return;
     }
+    if (slot->errorStreak < 16) slot->errorStreak++;
     
-    float totalValue = 0;
-    float totalPnl = 0;
-    int longCount = 0;
-    int shortCount = 0;
-    int winningCount = 0;
-    int losingCount = 0;
-    float maxLoss = 0;
+    uint32_t base = max(slot->fetchInterval, (uint32_t)PORTFOLIO_MIN_INTERVAL);
+    uint32_t backoff = base << min((int)slot->errorStreak - 1, 6);
+    if (backoff > POLL_BACKOFF_MAX) backoff = POLL_BACKOFF_MAX;
+    // jitter متقارن تا چند دستگاه هم‌زمان به سرور برنگردند
+    backoff = backoff / 100 * (100 - POLL_JITTER_PERCENT + random(2 * POLL_JITTER_PERCENT + 1));
+    slot->effectiveInterval = backoff;
+    slot->pollReason = POLL_REASON_BACKOFF;
     
-    for (int i = 0; i < count; i++) {
-        totalValue += data[i].currentPrice * data[i].quantity;
-        totalPnl += data[i].pnlValue;
-        
-        if (data[i].isLong) longCount++;
-        else shortCount++;
-        
-        if (data[i].changePercent >= 0) winningCount++;
-        else losingCount++;
-        
-        if (data[i].changePercent < maxLoss) maxLoss = data[i].changePercent;
+    if (retryAfterSeconds > 0) {
+        uint32_t retryAfter = min(retryAfterSeconds * 1000UL, (unsigned long)POLL_RETRY_AFTER_MAX);
+        if (retryAfter >= slot->effectiveInterval) {
+            // فقط jitter مثبت: زودتر از Retry-After برنمی‌گردیم
+            slot->effectiveInterval = retryAfter + retryAfter / 100 * random(POLL_JITTER_PERCENT / 2 + 1);
+            slot->pollReason = POLL_REASON_RETRY_AFTER;
+        }
     }
     
-    summary->totalCurrentValue = totalValue;
-    summary->totalPnl = totalPnl;
-    summary->totalPositions = count;
-    summary->longPositions = longCount;
-    summary->shortPositions = shortCount;
-    summary->winningPositions = winningCount;
-    summary->losingPositions = losingCount;
-    summary->maxDrawdown = maxLoss;
+    Serial.printf("Poll %s: error #%d, next try in %lu ms (%s)\n", portfolioKey(mode), slot->errorStreak,
+                  (unsigned long)slot->effectiveInterval, pollReasonNames[slot->pollReason]);
+}
+
+// effectiveInterval و pollReason را از وضعیت فعلی slot حساب می‌کند؛ در حالت خطا backoff دست نمی‌خورد
+void pollUpdateInterval(byte mode) {
+    PortfolioSlot* slot = &portfolios[mode];
+    if (slot->errorStreak > 0) return;
     
-    summary->totalInvestment = totalValue - totalPnl;
+    uint32_t base = max(slot->fetchInterval, (uint32_t)PORTFOLIO_MIN_INTERVAL);
+    uint32_t interval = base;
+    uint8_t reason = POLL_REASON_BASE;
     
-    if (summary->totalInvestment > 0) {
-        summary->totalPnlPercent = (totalPnl / summary->totalInvestment) * 100;
-    } else {
-        summary->totalPnlPercent = 0.0;
+    lockData();
+    float distance = pollAlertDistance(mode);
+    unlockData();
+    float volatility = pollVolatility(mode);
+    
+    if (distance <= POLL_NEAR_ALERT_MARGIN) {
+        interval = base / POLL_NEAR_ALERT_DIVISOR;
+        reason = POLL_REASON_NEAR_ALERT;
+    } else if (volatility >= POLL_VOLATILE_STDDEV) {
+        interval = base / POLL_VOLATILE_DIVISOR;
+        reason = POLL_REASON_VOLATILE;
+    } else if (volatility >= 0 && volatility <= POLL_CALM_STDDEV) {
+        interval = base * POLL_CALM_FACTOR;
+        reason = POLL_REASON_CALM;
+    }
+    
+    if (interval < PORTFOLIO_MIN_INTERVAL) interval = PORTFOLIO_MIN_INTERVAL;
+    if (interval > max(base, (uint32_t)POLL_MAX_INTERVAL)) interval = max(base, (uint32_t)POLL_MAX_INTERVAL);
+    
+    if (reason != slot->pollReason) {
+        Serial.printf("Poll %s: %lu ms (%s)\n", portfolioKey(mode), (unsigned long)interval, pollReasonNames[reason]);
     }
+    slot->effectiveInterval = interval;
+    slot->pollReason = reason;
 }
 
-void clearCryptoData(byte mode) {
-    if (mode == 0) {
-        memset(cryptoDataMode1, 0, sizeof(CryptoPosition) * MAX_POSITIONS_PER_MODE);
-        cryptoCountMode1 = 0;
-    } else {
-        memset(cryptoDataMode2, 0, sizeof(CryptoPosition) * MAX_POSITIONS_PER_MODE);
-        cryptoCountMode2 = 0;
+// ===== PORTFOLIO REGISTRY =====
+// هر slot یک پورتفوی با نام، سیاست آلرت و فاصله fetch مستقل است. slot 0 و 1 همان
+// Entry/Exit قبلی هستند و نامشان در EEPROM (settings) می‌ماند؛ بقیه تنظیمات در
+// /portfolios.json ذخیره می‌شود تا ساختار EEPROM تغییر نکند.
+// زمان‌بند در هر فراخوانی حداکثر یک fetch انجام می‌دهد و fetch ها را با فاصله
+// PORTFOLIO_FETCH_SPACING پخش می‌کند تا loop پشت سر هم برای همه slot ها بلاک نشود.
+#define PORTFOLIO_CONFIG_FILE "/portfolios.json"
+#define PORTFOLIO_FETCH_SPACING 2000UL
+
+const char* const portfolioKeys[MAX_PORTFOLIOS] = { "entry", "exit", "p2", "p3", "p4", "p5" };
+const char* const portfolioLabels[MAX_PORTFOLIOS] = { "ENTRY", "EXIT", "P2", "P3", "P4", "P5" };
+unsigned long lastPortfolioFetch = 0;
+
+const char* portfolioKey(byte mode) {
+    return mode < MAX_PORTFOLIOS ? portfolioKeys[mode] : "?";
+}
+
+const char* portfolioLabel(byte mode) {
+    return mode < MAX_PORTFOLIOS ? portfolioLabels[mode] : "?";
+}
+
+// "entry" / "exit" / "p2".. یا اندیس عددی؛ در غیر این صورت fallback
+int portfolioFromArg(const String& arg, int fallback) {
+    for (int i = 0; i < MAX_PORTFOLIOS; i++) {
+        if (arg == portfolioKeys[i]) return i;
     }
+    if (arg.length() == 1 && isdigit(arg[0]) && arg[0] - '0' < MAX_PORTFOLIOS) return arg[0] - '0';
+    return fallback;
 }
 
-// ===== UTILITY FUNCTIONS =====
-String getShortSymbol(const char* symbol) {
-    String s = String(symbol);
-    
-    if (s.endsWith("USDT")) {
-        s = s.substring(0, s.length() - 4);
-    } else if (s.endsWith("_USDT")) {
-        s = s.substring(0, s.length() - 5);
-    } else if (s.endsWith("PERP")) {
-        s = s.substring(0, s.length() - 4);
+bool portfolioIsExitStyle(byte mode) {
+    return mode < MAX_PORTFOLIOS && portfolios[mode].policy == ALERT_POLICY_PRICE_MOVE;
+}
+
+// نام slot 0/1 از تنظیمات EEPROM
+void portfolioSyncNames() {
+    strncpy(portfolios[0].name, settings.entryPortfolio, sizeof(portfolios[0].name) - 1);
+    portfolios[0].name[sizeof(portfolios[0].name) - 1] = '\0';
+    strncpy(portfolios[1].name, settings.exitPortfolio, sizeof(portfolios[1].name) - 1);
+    portfolios[1].name[sizeof(portfolios[1].name) - 1] = '\0';
+}
+
+// همه slot ها از همین الان due می‌شوند، با فاصله تا یکجا fetch نشوند
+void portfolioSpread(unsigned long now) {
+    for (int i = 0; i < MAX_PORTFOLIOS; i++) {
+        portfolios[i].nextFetch = now + i * PORTFOLIO_FETCH_SPACING;
     }
-    
-    if (s.length() > 8) {
-        s = s.substring(0, 8);
+    lastPortfolioFetch = now - PORTFOLIO_FETCH_SPACING;
+}
+
+void portfolioRecount() {
+    portfolioCount = 2;
+    for (int i = 2; i < MAX_PORTFOLIOS; i++) {
+        if (portfolios[i].name[0] != '\0') portfolioCount = i + 1;
     }
-    
-    return s;
 }
 
-String formatPercent(float percent) {
-    if (percent > 0) {
-        return "+" + String(percent, 2) + "%";
-    } else if (percent < 0) {
-        return String(percent, 2) + "%";
-    } else {
-        return "0.00%";
+// بعد از positionStoreBegin و سوار شدن LittleFS
+void portfolioRegistryBegin() {
+    for (int i = 0; i < MAX_PORTFOLIOS; i++) {
+        portfolios[i].name[0] = '\0';
+        portfolios[i].policy = (i == 1) ? ALERT_POLICY_PRICE_MOVE : ALERT_POLICY_DRAWDOWN;
+        portfolios[i].enabled = true;
+        portfolios[i].fetchInterval = DATA_UPDATE_INTERVAL;
+        portfolios[i].effectiveInterval = DATA_UPDATE_INTERVAL;
+        portfolios[i].pollReason = POLL_REASON_BASE;
+        portfolios[i].errorStreak = 0;
     }
+    portfolioLoadConfig();
+    portfolioSyncNames();
+    portfolioRecount();
+    portfolioSpread(millis());
+    
+    Serial.printf("Portfolio registry: %d slots\n", portfolioCount);
 }
 
-String formatNumber(float number) {
-    if (number == 0) return "0";
+void portfolioLoadConfig() {
+    if (!alertLogReady || !LittleFS.exists(PORTFOLIO_CONFIG_FILE)) return;
     
-    float absNumber = fabs(number);
+    File file = LittleFS.open(PORTFOLIO_CONFIG_FILE, "r");
+    if (!file) return;
+    DynamicJsonDocument doc(256 + 160 * MAX_PORTFOLIOS);
+    DeserializationError error = deserializeJson(doc, file);
+    file.close();
+    if (error) {
+        Serial.println("Portfolio config parse error: " + String(error.c_str()));
+        return;
+    }
     
-    if (absNumber >= 1000000) {
-        return String(number / 1000000, 2) + "M";
-    } else if (absNumber >= 10000) {
-        return String(number / 1000, 1) + "K";
-    } else if (absNumber >= 1000) {
-        return String(number / 1000, 2) + "K";
-    } else if (absNumber >= 1) {
-        return String(number, 2);
-    } else if (absNumber >= 0.01) {
-        return String(number, 4);
-    } else if (absNumber >= 0.0001) {
-        return String(number, 6);
-    } else {
-        return String(number, 8);
+    JsonArray slots = doc["slots"];
+    for (int i = 0; i < MAX_PORTFOLIOS && i < (int)slots.size(); i++) {
+        JsonObject slot = slots[i];
+        if (i >= 2) {
+            strncpy(portfolios[i].name, slot["name"] | "", sizeof(portfolios[i].name) - 1);
+            portfolios[i].name[sizeof(portfolios[i].name) - 1] = '\0';
+        }
+        portfolios[i].policy = (slot["policy"] | (int)portfolios[i].policy) == ALERT_POLICY_PRICE_MOVE ?
+                               ALERT_POLICY_PRICE_MOVE : ALERT_POLICY_DRAWDOWN;
+        portfolios[i].enabled = slot["enabled"] | true;
+        portfolios[i].fetchInterval = max((uint32_t)(slot["interval"] | (uint32_t)DATA_UPDATE_INTERVAL),
+                                          (uint32_t)PORTFOLIO_MIN_INTERVAL);
     }
 }
 
-String formatPrice(float price) {
-    if (price <= 0) return "0.00";
+bool portfolioSaveConfig() {
+    if (!alertLogReady) return false;
     
-    if (price >= 1000) {
-        return String(price, 2);
-    } else if (price >= 1) {
-        return String(price, 4);
-    } else if (price >= 0.01) {
-        return String(price, 6);
-    } else if (price >= 0.0001) {
-        return String(price, 8);
-    } else {
-        return String(price, 10);
+    DynamicJsonDocument doc(256 + 160 * MAX_PORTFOLIOS);
+    JsonArray slots = doc.createNestedArray("slots");
+    for (int i = 0; i < portfolioCount; i++) {
+        JsonObject slot = slots.createNestedObject();
+        slot["name"] = portfolios[i].name;
+        slot["policy"] = portfolios[i].policy;
+        slot["interval"] = portfolios[i].fetchInterval;
+        slot["enabled"] = portfolios[i].enabled;
+    }
+    
+    File file = LittleFS.open(PORTFOLIO_CONFIG_FILE, "w");
+    if (!file) return false;
+    bool ok = serializeJson(doc, file) > 0;
+    file.close();
+    return ok;
+}
+
+// از loop؛ زودترین slot سررسید شده را fetch/parse می‌کند. true اگر fetch انجام شد
+bool portfolioSchedule(unsigned long now) {
+    if (now - lastPortfolioFetch < PORTFOLIO_FETCH_SPACING) return false;
+    
+    int due = -1;
+    long mostOverdue = -1;
+    for (int i = 0; i < portfolioCount; i++) {
+        PortfolioSlot* slot = &portfolios[i];
+        if (!slot->enabled || slot->name[0] == '\0') continue;
+        long overdue = (long)(now - slot->nextFetch);
+        if (overdue >= 0 && overdue > mostOverdue) {
+            mostOverdue = overdue;
+            due = i;
+        }
+    }
+    if (due < 0) return false;
+    
+    PortfolioSlot* slot = &portfolios[due];
+    
+    // sync کامل برای دیدن پوزیشن‌های باز/بسته شده؛ بین آن‌ها فقط قیمت (بخش PRICE TICKER)
+    FetchTier tier = FETCH_TIER_PRICE;
+    if (slot->count == 0 || !priceTickerUsable(now) || now - slot->lastFullSync >= PRICE_FULL_SYNC_INTERVAL) {
+        tier = FETCH_TIER_FULL;
+    }
+    
+    // stream باز قیمت‌ها را زودتر از هر poll می‌آورد (بخش PRICE STREAM)
+    if (tier == FETCH_TIER_PRICE && streamLive()) {
+        slot->nextFetch = slot->lastFullSync + PRICE_FULL_SYNC_INTERVAL;
+        return false;
+    }
+    
+    // همه نمادها را fetch یک slot دیگر همین تازگی آورده (بخش SYMBOL PRICE TABLE)
+    uint32_t priceInterval = max(slot->effectiveInterval / PRICE_POLL_DIVISOR, (uint32_t)PRICE_POLL_MIN_INTERVAL);
+    if (tier == FETCH_TIER_PRICE && symbolPricesFresh(due, priceInterval, now)) {
+        slot->nextFetch = now + priceInterval;
+        return false;
+    }
+    
+    slot->lastFetch = now;
+    lastPortfolioFetch = now;
+    lastDataUpdate = now;
+    
+    String data;
+    {
+        TIME_STAGE(STAGE_FETCH);
+        data = tier == FETCH_TIER_FULL ? getPortfolioData(due) : getPriceData(due);
+    }
+    
+    // سرور endpoint قیمت ندارد: خطا حساب نمی‌شود و sync کامل بلافاصله در نوبت بعد
+    if (tier == FETCH_TIER_PRICE && !priceTickerSupported) {
+        slot->nextFetch = now;
+        return true;
+    }
+    
+    bool fetched = lastFetchHttpCode == HTTP_CODE_OK;
+    if (fetched && data != "{}") {
+        TIME_STAGE(STAGE_PARSE);
+        unsigned long parseStart = micros();
+        if (tier == FETCH_TIER_FULL) {
+            parseCryptoData(data, due);
+            slot->lastFullSync = now;
+        } else if (!applyPriceData(data, due)) {
+            slot->lastFullSync = now - PRICE_FULL_SYNC_INTERVAL;   // پاسخ قیمت نامعتبر: sync کامل بعدی
+        }
+        priceTickerRecord(tier, data.length(), micros() - parseStart);
+        lastFetchSentAt = 0;   // پاسخ رد شده در parse به payload بعدی نمی‌چسبد
+        // slot های دیگری که همین نمادها را دارند هم از قیمت تازه جمع‌بندی می‌شوند
+        symbolDirtySlots |= 1 << due;
+        symbolFlushDirty();
+    }
+    
+    // سررسید بعدی از فاصله تطبیقی؛ بدون اتصال یا تنظیمات API خطای سرور حساب نمی‌شود
+    if (lastFetchHttpCode != 0) pollRecordResult(due, fetched, lastFetchRetryAfter);
+    pollUpdateInterval(due);
+    uint32_t interval = slot->effectiveInterval;
+    if (priceTickerSupported && slot->errorStreak == 0 && slot->count > 0) {
+        interval = max(interval / PRICE_POLL_DIVISOR, (uint32_t)PRICE_POLL_MIN_INTERVAL);
+    }
+    slot->nextFetch = now + interval;
+    return true;
+}
+
+// GET /api/v1/portfolios - فهرست slot ها و زمان‌بندی
+void handleApiPortfolios() {
+    DynamicJsonDocument doc(256 + 256 * MAX_PORTFOLIOS);
+    unsigned long now = millis();
+    
+    lockData();
+    doc["max"] = MAX_PORTFOLIOS;
+    doc["poolCapacity"] = POSITION_POOL_CAPACITY;
+    JsonArray slots = doc.createNestedArray("portfolios");
+    for (int i = 0; i < portfolioCount; i++) {
+        PortfolioSlot* slot = &portfolios[i];
+        JsonObject obj = slots.createNestedObject();
+        obj["slot"] = i;
+        obj["key"] = portfolioKey(i);
+        obj["name"] = slot->name;
+        obj["policy"] = slot->policy == ALERT_POLICY_PRICE_MOVE ? "price_move" : "drawdown";
+        obj["enabled"] = slot->enabled;
+        obj["interval"] = slot->fetchInterval;
+        obj["effectiveInterval"] = slot->effectiveInterval;
+        obj["pollReason"] = pollReasonNames[slot->pollReason];
+        obj["errorStreak"] = slot->errorStreak;
+        obj["fullSyncAgo"] = slot->lastFullSync > 0 ? (long)(now - slot->lastFullSync) : -1;
+        obj["nextFetchIn"] = (long)(slot->nextFetch - now) > 0 ? (long)(slot->nextFetch - now) : 0;
+        obj["lastFetchAgo"] = slot->lastFetch > 0 ? (long)(now - slot->lastFetch) : -1;
+        obj["positions"] = slot->count;
+        obj["capacity"] = slot->capacity;
+        obj["alerts"] = slot->historyCount;
+    }
+    unlockData();
+    
+    String json;
+    serializeJson(doc, json);
+    server.send(200, "application/json", json);
+}
+
+// POST /api/v1/portfolios?slot=p2&name=..&policy=drawdown|price_move&interval=ms&enabled=0|1
+// action=remove یک slot اضافه را پاک می‌کند. نام slot 0/1 از صفحه تنظیمات تغییر می‌کند.
+// فقط ورودی بررسی و در portfolioChanges صف می‌شود؛ parse در حال اجرای loop ممکن است از داده slot استفاده کند.
+void handleApiPortfoliosUpdate() {
+    int mode = portfolioFromArg(server.arg("slot"), -1);
+    if (mode < 0) {
+        server.send(400, "application/json", "{\"success\":false,\"error\":\"bad slot\"}");
+        return;
+    }
+    if (mode > portfolioCount) {
+        server.send(400, "application/json", "{\"success\":false,\"error\":\"slots must be added in order\"}");
+        return;
+    }
+    
+    PortfolioChange change;
+    memset(&change, 0, sizeof(change));
+    
+    if (server.arg("action") == "remove") {
+        if (mode < 2) {
+            server.send(400, "application/json", "{\"success\":false,\"error\":\"entry/exit cannot be removed\"}");
+            return;
+        }
+        change.remove = true;
+    } else {
+        if (server.hasArg("name") && mode >= 2) {
+            String name = server.arg("name");
+            name.trim();
+            if (name.length() == 0 || name.length() >= sizeof(change.name)) {
+                server.send(400, "application/json", "{\"success\":false,\"error\":\"bad name\"}");
+                return;
+            }
+            change.hasName = true;
+            strncpy(change.name, name.c_str(), sizeof(change.name) - 1);
+        }
+        
+        lockData();
+        bool named = portfolios[mode].name[0] != '\0' ||
+                     (portfolioChanges[mode].pending && portfolioChanges[mode].hasName);
+        unlockData();
+        if (!change.hasName && !named) {
+            server.send(400, "application/json", "{\"success\":false,\"error\":\"name required\"}");
+            return;
+        }
+        
+        if (server.hasArg("policy")) {
+            change.hasPolicy = true;
+            change.policy = server.arg("policy") == "price_move" ? ALERT_POLICY_PRICE_MOVE : ALERT_POLICY_DRAWDOWN;
+        }
+        if (server.hasArg("interval")) {
+            change.hasInterval = true;
+            change.interval = max((uint32_t)server.arg("interval").toInt(), (uint32_t)PORTFOLIO_MIN_INTERVAL);
+        }
+        if (server.hasArg("enabled")) {
+            change.hasEnabled = true;
+            change.enabled = server.arg("enabled") != "0" && server.arg("enabled") != "false";
+        }
+    }
+    
+    // درخواست‌های پشت سر هم قبل از اجرای loop با هم ادغام می‌شوند
+    lockData();
+    PortfolioChange* pending = &portfolioChanges[mode];
+    if (!pending->pending || pending->remove || change.remove) {
+        *pending = change;
+    } else {
+        if (change.hasName) {
+            pending->hasName = true;
+            memcpy(pending->name, change.name, sizeof(pending->name));
+        }
+        if (change.hasPolicy) {
+            pending->hasPolicy = true;
+            pending->policy = change.policy;
+        }
+        if (change.hasInterval) {
+            pending->hasInterval = true;
+            pending->interval = change.interval;
+        }
+        if (change.hasEnabled) {
+            pending->hasEnabled = true;
+            pending->enabled = change.enabled;
+        }
+    }
+    pending->pending = true;
+    unlockData();
+    
+    server.send(200, "application/json", "{\"success\":true,\"pending\":true}");
+}
+
+// از loop (webRequestsService): تغییرات صف شده slot ها
+void portfolioApplyChanges() {
+    for (int mode = 0; mode < MAX_PORTFOLIOS; mode++) {
+        if (!portfolioChanges[mode].pending) continue;
+        
+        lockData();
+        PortfolioChange change = portfolioChanges[mode];
+        portfolioChanges[mode].pending = false;
+        unlockData();
+        
+        PortfolioSlot* slot = &portfolios[mode];
+        if (change.remove) {
+            clearCryptoData(mode);
+            lockData();
+            // ظرفیت به مخزن مشترک برمی‌گردد
+            free(slot->data);
+            free(slot->hot);
+            slot->data = NULL;
+            slot->hot = NULL;
+            slot->capacity = 0;
+            slot->name[0] = '\0';
+            slot->historyCount = 0;
+            slot->historyHead = 0;
+            memset(&slot->summary, 0, sizeof(PortfolioSummary));
+            portfolioRecount();
+            dataVersion++;
+            unlockData();
+        } else {
+            if (change.hasName) {
+                bool renamed = strcmp(slot->name, change.name) != 0;
+                if (renamed) clearCryptoData(mode);
+                lockData();
+                strncpy(slot->name, change.name, sizeof(slot->name) - 1);
+                slot->name[sizeof(slot->name) - 1] = '\0';
+                portfolioRecount();
+                unlockData();
+                if (renamed) slot->nextFetch = millis();
+            }
+            // slot بین صف شدن و اجرا حذف شده است
+            if (slot->name[0] == '\0') continue;
+            
+            lockData();
+            if (change.hasPolicy) slot->policy = change.policy;
+            if (change.hasInterval) {
+                slot->fetchInterval = change.interval;
+                pollUpdateInterval(mode);
+                slot->nextFetch = millis() + slot->effectiveInterval;
+            }
+            if (change.hasEnabled) slot->enabled = change.enabled;
+            unlockData();
+        }
+        
+        if (!portfolioSaveConfig()) Serial.println("❌ Failed to save portfolio config");
+        settingsVersion++;
+        Serial.printf("Portfolio slot %s updated\n", portfolioKey(mode));
+    }
+}
+
+// ===== POSITION STORE (PSRAM) =====
+// رکوردهای پوزیشن و تاریخچه آلرت در PSRAM نگه داشته می‌شوند و ظرفیت هر slot تا اندازه
+// payload (حداکثر MAX_POSITIONS_PER_MODE، و مجموعاً POSITION_POOL_CAPACITY) دو برابر می‌شود. شاخص داغ (PositionHot: کلید، درصد،
+// hash SSE) در RAM داخلی می‌ماند تا تطبیق ردیف‌ها و اسکن‌های هر ثانیه به PSRAM کند نروند.
+// بدون PSRAM همه چیز از heap داخلی گرفته می‌شود.
+CryptoPosition* parseStaging = NULL;   // بافر staging در parseCryptoData (فقط تسک loop)
+int parseStagingCapacity = 0;
+
+static void* positionStoreAlloc(void* pointer, size_t bytes, bool internal) {
+    uint32_t caps = (internal || !psramFound()) ? (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)
+                                                : (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    return heap_caps_realloc(pointer, bytes, caps);
+}
+
+void positionStoreBegin() {
+    for (int i = 0; i < MAX_PORTFOLIOS; i++) {
+        portfolios[i].history = (AlertRecord*)positionStoreAlloc(NULL, sizeof(AlertRecord) * MAX_ALERT_HISTORY, false);
+        if (portfolios[i].history == NULL) {
+            Serial.println("Position store: alert history allocation failed");
+            return;
+        }
+        memset(portfolios[i].history, 0, sizeof(AlertRecord) * MAX_ALERT_HISTORY);
+    }
+    
+    positionStoreReserve(0, POSITION_STORE_MIN_CAPACITY);
+    positionStoreReserve(1, POSITION_STORE_MIN_CAPACITY);
+    Serial.printf("Position store: %s, up to %d positions per portfolio, %d in total\n",
+                  psramFound() ? "PSRAM" : "internal heap", MAX_POSITIONS_PER_MODE, POSITION_POOL_CAPACITY);
+    symbolTableBegin();
+}
+
+// داخل lockData (تسک وب همین اشاره‌گرها را می‌خواند)؛ false اگر count جا نشود
+bool positionStoreReserve(byte mode, int count) {
+    CryptoPosition** data = &portfolios[mode].data;
+    PositionHot** hot = &portfolios[mode].hot;
+    int* capacity = &portfolios[mode].capacity;
+    
+    if (count <= *capacity) return true;
+    
+    // مخزن بین همه slot ها مشترک است؛ اگر جا نشود تا حد مجاز رشد می‌کند و false برمی‌گرداند
+    int others = 0;
+    for (int i = 0; i < MAX_PORTFOLIOS; i++) {
+        if (i != mode) others += portfolios[i].capacity;
+    }
+    int limit = min(MAX_POSITIONS_PER_MODE, POSITION_POOL_CAPACITY - others);
+    bool fits = count <= limit;
+    if (!fits) count = limit;
+    if (count <= *capacity) return fits;
+    
+    int grown = *capacity * 2;
+    if (grown < POSITION_STORE_MIN_CAPACITY) grown = POSITION_STORE_MIN_CAPACITY;
+    if (grown < count) grown = count;
+    if (grown > limit) grown = limit;
+    
+    CryptoPosition* newData = (CryptoPosition*)positionStoreAlloc(*data, sizeof(CryptoPosition) * grown, false);
+    if (newData == NULL) return false;
+    *data = newData;
+    
+    PositionHot* newHot = (PositionHot*)positionStoreAlloc(*hot, sizeof(PositionHot) * grown, true);
+    if (newHot == NULL) return false;
+    *hot = newHot;
+    
+    memset(newData + *capacity, 0, sizeof(CryptoPosition) * (grown - *capacity));
+    memset(newHot + *capacity, 0, sizeof(PositionHot) * (grown - *capacity));
+    *capacity = grown;
+    return fits;
+}
+
+uint32_t positionKey(const CryptoPosition* pos) {
+    uint32_t hash = 2166136261UL;
+    for (int i = 0; i < 16 && pos->symbol[i]; i++) {
+        hash = (hash ^ (uint8_t)pos->symbol[i]) * 16777619UL;
+    }
+    return (hash ^ (pos->isLong ? 1 : 0)) * 16777619UL;
+}
+
+// بعد از هر تغییر آرایه زنده، داخل lockData
+void positionHotRebuild(byte mode) {
+    const CryptoPosition* data = portfolios[mode].data;
+    PositionHot* hot = portfolios[mode].hot;
+    int count = portfolios[mode].count;
+    
+    for (int i = 0; i < count; i++) {
+        hot[i].key = positionKey(&data[i]);
+        hot[i].changePercent = data[i].changePercent;
+    }
+}
+
+// حافظه فعلی مخزن؛ internal = شاخص داغ در RAM داخلی، در غیر این صورت PSRAM (یا heap بدون PSRAM)
+size_t positionStoreBytes(bool internal) {
+    int capacity = 0;
+    for (int i = 0; i < MAX_PORTFOLIOS; i++) capacity += portfolios[i].capacity;
+    if (internal) return sizeof(PositionHot) * capacity + sizeof(uint16_t) * SYMBOL_INDEX_SIZE;
+    return sizeof(CryptoPosition) * (capacity + parseStagingCapacity) + sizeof(AlertRecord) * MAX_ALERT_HISTORY * MAX_PORTFOLIOS +
+           sizeof(SymbolPrice) * SYMBOL_TABLE_CAPACITY + sizeof(SymbolDependent) * POSITION_POOL_CAPACITY;
+}
+
+// DRAM ثابتی که آرایه‌های قبلی (دو مود + staging + تاریخچه + hash SSE) می‌گرفتند منهای مصرف فعلی در DRAM
+size_t positionStoreDramFreed() {
+    size_t legacy = sizeof(CryptoPosition) * LEGACY_POSITIONS_PER_MODE * 3 +
+                    sizeof(AlertRecord) * MAX_ALERT_HISTORY * 2 +
+                    sizeof(uint32_t) * LEGACY_POSITIONS_PER_MODE * 2 + LEGACY_POSITIONS_PER_MODE;
+    size_t used = positionStoreBytes(true) + (psramFound() ? 0 : positionStoreBytes(false));
+    return legacy > used ? legacy - used : 0;
+}
+
+// ===== SYMBOL PRICE TABLE =====
+// یک نماد (مثلاً BTCUSDT) می‌تواند در چند slot باز باشد. قیمت هر نماد فقط یک بار اینجا نوشته
+// می‌شود و از فهرست وابسته‌ها (firstDependent/dependentCount روی symbolDependents) به همه
+// پوزیشن‌های آن نماد در همه slot ها می‌رسد؛ پس همه پورتفوی‌ها روی آخرین قیمت توافق دارند و
+// tier قیمت یک slot برای نمادی که slot دیگر تازه گرفته دوباره fetch نمی‌کند.
+// شناسه نماد در PositionHot.symbolId است و جدول بعد از هر تغییر ردیف‌ها داخل lockData از نو
+// ساخته می‌شود. اگر جدول پر شود، فقط نمادهای فعلی نگه داشته می‌شوند.
+SymbolPrice* symbolTable = NULL;            // PSRAM، SYMBOL_TABLE_CAPACITY
+SymbolDependent* symbolDependents = NULL;   // PSRAM، POSITION_POOL_CAPACITY
+uint16_t symbolIndex[SYMBOL_INDEX_SIZE];    // RAM داخلی
+int symbolCount = 0;
+unsigned long symbolFanouts = 0;            // ردیف‌هایی که قیمت را از fetch یک slot دیگر گرفتند
+
+static uint32_t symbolHash(const char* symbol) {
+    uint32_t hash = 2166136261UL;
+    for (int i = 0; i < 16 && symbol[i]; i++) {
+        hash = (hash ^ (uint8_t)symbol[i]) * 16777619UL;
+    }
+    return hash;
+}
+
+void symbolTableBegin() {
+    symbolTable = (SymbolPrice*)positionStoreAlloc(NULL, sizeof(SymbolPrice) * SYMBOL_TABLE_CAPACITY, false);
+    symbolDependents = (SymbolDependent*)positionStoreAlloc(NULL, sizeof(SymbolDependent) * POSITION_POOL_CAPACITY, false);
+    if (symbolTable == NULL || symbolDependents == NULL) {
+        Serial.println("Symbol table: allocation failed, prices stay per portfolio");
+        symbolTable = NULL;
+    }
+    symbolCount = 0;
+    memset(symbolIndex, 0xFF, sizeof(symbolIndex));
+}
+
+// خانه نماد در symbolIndex (یا اولین خانه خالی)؛ جدول هیچ وقت پر نیست چون اندازه آن دو برابر ظرفیت است
+static int symbolProbe(const char* symbol, uint32_t hash) {
+    int probe = hash & (SYMBOL_INDEX_SIZE - 1);
+    while (symbolIndex[probe] != SYMBOL_NONE) {
+        const SymbolPrice* entry = &symbolTable[symbolIndex[probe]];
+        if (entry->hash == hash && strncmp(entry->symbol, symbol, sizeof(entry->symbol)) == 0) break;
+        probe = (probe + 1) & (SYMBOL_INDEX_SIZE - 1);
+    }
+    return probe;
+}
+
+uint16_t symbolFind(const char* symbol) {
+    if (symbolTable == NULL) return SYMBOL_NONE;
+    return symbolIndex[symbolProbe(symbol, symbolHash(symbol))];
+}
+
+static uint16_t symbolIntern(const char* symbol) {
+    uint32_t hash = symbolHash(symbol);
+    int probe = symbolProbe(symbol, hash);
+    if (symbolIndex[probe] != SYMBOL_NONE) return symbolIndex[probe];
+    if (symbolCount >= SYMBOL_TABLE_CAPACITY) return SYMBOL_NONE;
+    
+    SymbolPrice* entry = &symbolTable[symbolCount];
+    memset(entry, 0, sizeof(SymbolPrice));
+    strncpy(entry->symbol, symbol, sizeof(entry->symbol) - 1);
+    entry->hash = hash;
+    symbolIndex[probe] = symbolCount;
+    return symbolCount++;
+}
+
+// بعد از هر تغییر ردیف‌ها، داخل lockData. نمادهای بی‌وابسته قیمتشان را نگه می‌دارند تا
+// پوزیشن دوباره باز شده فوراً قیمت تازه داشته باشد
+void symbolTableRebuild() {
+    if (symbolTable == NULL || benchmarkRunning) return;
+    
+    for (int pass = 0; pass < 2; pass++) {
+        bool full = false;
+        for (int id = 0; id < symbolCount; id++) symbolTable[id].dependentCount = 0;
+        for (int m = 0; m < portfolioCount; m++) {
+            PortfolioSlot* slot = &portfolios[m];
+            for (int i = 0; i < slot->count; i++) {
+                uint16_t id = symbolIntern(slot->data[i].symbol);
+                slot->hot[i].symbolId = id;
+                if (id == SYMBOL_NONE) {
+                    full = true;
+                    continue;
+                }
+                symbolTable[id].dependentCount++;
+            }
+        }
+        if (!full || pass == 1) {
+            // بیش از SYMBOL_TABLE_CAPACITY نماد فعلی: بقیه فقط قیمت fetch خودشان را می‌گیرند
+            if (full) Serial.printf("Symbol table: more than %d symbols, the rest are not shared\n", SYMBOL_TABLE_CAPACITY);
+            break;
+        }
+        symbolCount = 0;
+        memset(symbolIndex, 0xFF, sizeof(symbolIndex));
+    }
+    
+    int offset = 0;
+    for (int id = 0; id < symbolCount; id++) {
+        symbolTable[id].firstDependent = offset;
+        offset += symbolTable[id].dependentCount;
+        symbolTable[id].dependentCount = 0;
+    }
+    for (int m = 0; m < portfolioCount; m++) {
+        PortfolioSlot* slot = &portfolios[m];
+        for (int i = 0; i < slot->count; i++) {
+            uint16_t id = slot->hot[i].symbolId;
+            if (id == SYMBOL_NONE) continue;
+            SymbolPrice* entry = &symbolTable[id];
+            SymbolDependent* dependent = &symbolDependents[entry->firstDependent + entry->dependentCount++];
+            dependent->mode = m;
+            dependent->row = i;
+        }
+    }
+}
+
+// داخل lockData؛ ردیف‌های sourceMode قیمت را از قبل دارند (-1 = هیچ slot). تعداد ردیف‌های تغییر کرده.
+// پاسخ pollی که قبل از آخرین تیک stream فرستاده شده کهنه است: قیمت جدیدتر جدول می‌ماند و
+// به ردیف‌های خود slot منبع (که از payload کپی شده‌اند) هم برمی‌گردد
+int symbolPriceSet(uint16_t id, Money price, unsigned long observedAt, int sourceMode) {
+    if (symbolTable == NULL || id >= symbolCount) return 0;
+    SymbolPrice* entry = &symbolTable[id];
+    if (entry->updatedAt != 0 && (long)(entry->updatedAt - observedAt) > 0) {
+        price = entry->price;
+        sourceMode = -1;
+    } else {
+        entry->price = price;
+        entry->updatedAt = observedAt;
+    }
+    
+    int changed = 0;
+    for (int d = 0; d < entry->dependentCount; d++) {
+        const SymbolDependent* dependent = &symbolDependents[entry->firstDependent + d];
+        if (dependent->mode == sourceMode) continue;
+        if (portfolios[dependent->mode].data[dependent->row].currentPrice == price) continue;
+        aggregateUpdatePrice(dependent->mode, dependent->row, price);
+        symbolDirtySlots |= 1 << dependent->mode;
+        if (sourceMode >= 0) symbolFanouts++;
+        changed++;
+    }
+    return changed;
+}
+
+// بعد از parse کامل slot، داخل lockData (publishPositions)
+void symbolPublishSlot(byte mode, unsigned long observedAt) {
+    symbolTableRebuild();
+    PortfolioSlot* slot = &portfolios[mode];
+    for (int i = 0; i < slot->count; i++) {
+        symbolPriceSet(slot->hot[i].symbolId, slot->data[i].currentPrice, observedAt, mode);
+    }
+}
+
+// همه نمادهای slot در maxAge اخیر از هر منبعی قیمت گرفته‌اند
+bool symbolPricesFresh(byte mode, unsigned long maxAge, unsigned long now) {
+    const PortfolioSlot* slot = &portfolios[mode];
+    if (symbolTable == NULL || slot->count == 0) return false;
+    for (int i = 0; i < slot->count; i++) {
+        uint16_t id = slot->hot[i].symbolId;
+        if (id == SYMBOL_NONE || symbolTable[id].updatedAt == 0 || now - symbolTable[id].updatedAt > maxAge) return false;
+    }
+    return true;
+}
+
+// جمع‌بندی و SSE برای slot هایی که قیمتشان عوض شد (تسک loop)
+void symbolFlushDirty() {
+    uint8_t dirty = symbolDirtySlots;
+    symbolDirtySlots = 0;
+    for (int m = 0; m < portfolioCount; m++) {
+        if (!(dirty & (1 << m)) || portfolios[m].count == 0) continue;
+        calculatePortfolioSummary(m);
+        ssePublishPortfolio(m);
+    }
+}
+
+// ===== ALERT RULES =====
+// قوانین آلرت برای هر نماد و/یا slot در /rules.json، کنار آستانه‌های سراسری تنظیمات:
+//   {"rules":[{"symbol":"BTCUSDT","metric":"price","above":70000},
+//             {"slot":"exit","metric":"pnl_value","below":-250,"severe":true},
+//             {"metric":"loss_minutes","above":60},
+//             {"symbol":"ETHUSDT","metric":"threshold","alert":-8,"severe":-12}]}
+// metric: pnl_percent، move_percent (حرکت قیمت از ورود در جهت پوزیشن)، price، pnl_value، loss_minutes؛
+// threshold قانون لبه‌ای نیست و آستانه آلرت/شدید Entry را برای آن نماد / slot عوض می‌کند.
+// هر قانون وقتی شرطش برقرار شود یک بار آلرت می‌دهد و بعد از برگشت به اندازه rearm دوباره مسلح می‌شود
+// (بیت آن در CryptoPosition.ruleLatch). قوانین در جدولی فشرده کامپایل می‌شوند: قوانین همه نمادها در
+// ابتدا و قوانین هر نماد پشت سر هم با یک شاخص hash روی نماد؛ هر ردیف فقط قوانین خودش را می‌بیند و
+// فقط ردیف‌هایی که merge / tier قیمت / stream تغییرشان داده (ruleDirty) ارزیابی می‌شوند.
+// ردیف‌های در زیان برای loss_minutes در هر دور checkAlerts هم بررسی می‌شوند.
+// کامپایل فقط در تسک loop انجام می‌شود (rulesService)؛ تسک وب قوانین را جایگزین و پرچم می‌گذارد.
+#define RULES_CONFIG_FILE "/rules.json"
+#define RULE_DEFAULT_REARM_PERCENT 2.0f     // مثل ریست خودکار آلرت Entry
+#define RULE_DEFAULT_REARM_FRACTION 0.01f   // price / pnl_value: یک درصد مقدار
+
+const char* const ruleMetricNames[RULE_METRIC_COUNT] = {
+    "threshold", "pnl_percent", "move_percent", "price", "pnl_value", "loss_minutes"
+};
+
+AlertRule* alertRules = NULL;           // PSRAM، فرم منبع
+int alertRuleCount = 0;
+volatile bool ruleConfigChanged = false;
+CompiledRule* ruleTable = NULL;         // PSRAM
+RuleBucket* ruleBuckets = NULL;         // PSRAM
+uint16_t* ruleIndex = NULL;             // RAM داخلی، open addressing روی ruleBuckets
+int ruleIndexSize = 0;
+int ruleCompiledCount = 0;
+int ruleBucketCount = 0;
+int ruleWildcardCount = 0;              // ruleTable[0..ruleWildcardCount) برای همه نمادها
+int ruleMaxPerPosition = 0;             // بیشترین قانون لبه‌ای که یک ردیف می‌بیند
+bool ruleHasLossRules = false;
+unsigned long ruleEvaluated = 0;        // ردیف‌های ارزیابی شده
+unsigned long ruleFired = 0;
+uint32_t ruleLastPassMicros = 0;
+
+// خانه نماد در ruleIndex (یا اولین خانه خالی)
+static int ruleProbe(const char* symbol, uint32_t hash) {
+    int probe = hash & (ruleIndexSize - 1);
+    while (ruleIndex[probe] != 0xFFFF) {
+        const RuleBucket* bucket = &ruleBuckets[ruleIndex[probe]];
+        if (bucket->hash == hash && strncmp(bucket->symbol, symbol, sizeof(bucket->symbol)) == 0) break;
+        probe = (probe + 1) & (ruleIndexSize - 1);
+    }
+    return probe;
+}
+
+// بازه قوانین مخصوص نماد در ruleTable
+static void ruleLookup(const char* symbol, int* first, int* count) {
+    *first = 0;
+    *count = 0;
+    if (ruleBucketCount == 0) return;
+    uint16_t id = ruleIndex[ruleProbe(symbol, symbolHash(symbol))];
+    if (id == 0xFFFF) return;
+    *first = ruleBuckets[id].first;
+    *count = ruleBuckets[id].count;
+}
+
+static float ruleMetric(uint8_t metric, const CryptoPosition* pos, unsigned long now) {
+    switch (metric) {
+        case RULE_METRIC_PNL_PERCENT:
+            return pos->changePercent;
+        case RULE_METRIC_MOVE_PERCENT:
+            if (pos->entryPrice <= 0) return 0;
+            return moneyRatio(pos->currentPrice - pos->entryPrice, pos->entryPrice) * 100 * (pos->isLong ? 1 : -1);
+        case RULE_METRIC_PRICE:
+            return moneyToFloat(pos->currentPrice);
+        case RULE_METRIC_PNL_VALUE:
+            return moneyToFloat(pos->pnlValue);
+        case RULE_METRIC_LOSS_MINUTES:
+            return pos->lossSince > 0 ? (now - pos->lossSince) / 60000.0f : 0;
+    }
+    return 0;
+}
+
+static void ruleFire(byte mode, const CryptoPosition* pos, const CompiledRule* rule, float metric) {
+    bool severe = rule->flags & RULE_FLAG_SEVERE;
+    SymbolText symbol;
+    char message[32];
+    snprintf(message, sizeof(message), "%s %.2f %s %.2f", ruleMetricNames[rule->metric], metric,
+             (rule->flags & RULE_FLAG_ABOVE) ? ">=" : "<=", rule->value);
+    showAlert(severe ? "SEVERE RULE" : "RULE ALERT",
+             fmtShortSymbol(symbol, pos->symbol),
+             message,
+             pos->isLong,
+             severe,
+             moneyToFloat(pos->currentPrice),
+             mode,
+             pos->changePercent,
+             NAN);
+    ruleFired++;
+}
+
+// قوانین لبه‌ای بازه [begin, end)؛ bit شماره بیت ruleLatch اولین قانون بازه است.
+// timedOnly: ردیف تغییر نکرده، فقط loss_minutes با گذشت زمان عوض می‌شود
+static int ruleEvaluateRange(byte mode, CryptoPosition* pos, unsigned long now, bool fire, bool timedOnly,
+                             int begin, int end, int* bit) {
+    int fired = 0;
+    for (int r = begin; r < end && *bit < RULE_MAX_PER_POSITION; r++) {
+        const CompiledRule* rule = &ruleTable[r];
+        if (rule->metric == RULE_METRIC_THRESHOLD) continue;
+        uint32_t mask = 1UL << (*bit)++;
+        if (!(rule->slotMask & (1 << mode))) continue;
+        if (timedOnly && rule->metric != RULE_METRIC_LOSS_MINUTES) continue;
+        
+        float metric = ruleMetric(rule->metric, pos, now);
+        bool above = rule->flags & RULE_FLAG_ABOVE;
+        if (pos->ruleLatch & mask) {
+            if (above ? metric < rule->rearmValue : metric > rule->rearmValue) pos->ruleLatch &= ~mask;
+            continue;
+        }
+        if (above ? metric < rule->value : metric > rule->value) continue;
+        
+        pos->ruleLatch |= mask;
+        if (fire) {
+            ruleFire(mode, pos, rule, metric);
+            fired++;
+        }
+    }
+    return fired;
+}
+
+static int ruleEvaluate(byte mode, CryptoPosition* pos, unsigned long now, bool fire, bool timedOnly) {
+    if (pos->changePercent < 0) {
+        if (pos->lossSince == 0) pos->lossSince = now > 0 ? now : 1;
+    } else {
+        pos->lossSince = 0;
+    }
+    if (ruleCompiledCount == 0) return 0;
+    
+    int first, count;
+    ruleLookup(pos->symbol, &first, &count);
+    int bit = 0;
+    int fired = ruleEvaluateRange(mode, pos, now, fire, timedOnly, 0, ruleWildcardCount, &bit);
+    fired += ruleEvaluateRange(mode, pos, now, fire, timedOnly, first, first + count, &bit);
+    return fired;
+}
+
+// قوانین یک ردیف؛ fire=false فقط بیت‌ها را با وضعیت فعلی هماهنگ می‌کند. تعداد آلرت‌ها
+int rulesEvaluatePosition(byte mode, CryptoPosition* pos, unsigned long now, bool fire) {
+    return ruleEvaluate(mode, pos, now, fire, false);
+}
+
+// ردیف‌های تغییر کرده slot (و ردیف‌های در زیان اگر قانون loss_minutes هست)؛ از checkAlerts
+void rulesEvaluate(byte mode) {
+    PortfolioSlot* slot = &portfolios[mode];
+    unsigned long start = micros();
+    unsigned long now = millis();
+    int evaluated = 0;
+    
+    for (int i = 0; i < slot->count; i++) {
+        CryptoPosition* pos = &slot->data[i];
+        if (!pos->ruleDirty && !(ruleHasLossRules && pos->lossSince > 0)) continue;
+        ruleEvaluate(mode, pos, now, true, !pos->ruleDirty);
+        pos->ruleDirty = false;
+        evaluated++;
+    }
+    ruleEvaluated += evaluated;
+    if (evaluated > 0) ruleLastPassMicros = micros() - start;
+}
+
+// آستانه آلرت/شدید Entry برای نماد؛ خاص‌ترین قانون threshold (نماد + slot > نماد > slot > همه)
+void rulesThresholds(byte mode, const char* symbol, float* alert, float* severe) {
+    *alert = settings.alertThreshold;
+    *severe = settings.severeAlertThreshold;
+    if (ruleCompiledCount == 0) return;
+    
+    int first, count;
+    ruleLookup(symbol, &first, &count);
+    int best = -1;
+    for (int pass = 0; pass < 2; pass++) {
+        int begin = pass == 0 ? 0 : first;
+        int end = pass == 0 ? ruleWildcardCount : first + count;
+        for (int r = begin; r < end; r++) {
+            const CompiledRule* rule = &ruleTable[r];
+            if (rule->metric != RULE_METRIC_THRESHOLD || !(rule->slotMask & (1 << mode))) continue;
+            int rank = pass * 2 + (rule->slotMask != RULE_SLOT_ANY ? 1 : 0);
+            if (rank < best) continue;
+            best = rank;
+            *alert = rule->value;
+            *severe = rule->rearmValue;
+        }
+    }
+}
+
+// داخل lockData، فقط از تسک loop (ارزیابی بدون قفل همین جدول را می‌خواند)
+bool rulesCompile(const AlertRule* rules, int count) {
+    if (count > RULE_MAX_RULES) return false;
+    int capacity = count > 0 ? count : 1;
+    int indexSize = 16;
+    while (indexSize < capacity * 2) indexSize *= 2;
+    
+    CompiledRule* table = (CompiledRule*)positionStoreAlloc(ruleTable, sizeof(CompiledRule) * capacity, false);
+    if (table == NULL) return false;
+    ruleTable = table;
+    RuleBucket* buckets = (RuleBucket*)positionStoreAlloc(ruleBuckets, sizeof(RuleBucket) * capacity, false);
+    if (buckets == NULL) return false;
+    ruleBuckets = buckets;
+    uint16_t* index = (uint16_t*)positionStoreAlloc(ruleIndex, sizeof(uint16_t) * indexSize, true);
+    if (index == NULL) return false;
+    ruleIndex = index;
+    ruleIndexSize = indexSize;
+    memset(ruleIndex, 0xFF, sizeof(uint16_t) * indexSize);
+    
+    // شمارش: قوانین همه نمادها و تعداد قوانین هر نماد
+    int wildcard = 0;
+    ruleBucketCount = 0;
+    for (int i = 0; i < count; i++) {
+        if (rules[i].symbol[0] == '\0') {
+            wildcard++;
+            continue;
+        }
+        uint32_t hash = symbolHash(rules[i].symbol);
+        int probe = ruleProbe(rules[i].symbol, hash);
+        if (ruleIndex[probe] == 0xFFFF) {
+            RuleBucket* bucket = &ruleBuckets[ruleBucketCount];
+            memset(bucket, 0, sizeof(RuleBucket));
+            strncpy(bucket->symbol, rules[i].symbol, sizeof(bucket->symbol) - 1);
+            bucket->hash = hash;
+            ruleIndex[probe] = ruleBucketCount++;
+        }
+        ruleBuckets[ruleIndex[probe]].count++;
+    }
+    
+    int offset = wildcard;
+    for (int b = 0; b < ruleBucketCount; b++) {
+        ruleBuckets[b].first = offset;
+        offset += ruleBuckets[b].count;
+        ruleBuckets[b].count = 0;
+    }
+    
+    // پر کردن با همان ترتیب فایل در هر گروه
+    int wildcardEdge = 0;
+    int placedWildcard = 0;
+    ruleHasLossRules = false;
+    for (int i = 0; i < count; i++) {
+        const AlertRule* rule = &rules[i];
+        CompiledRule* compiled;
+        if (rule->symbol[0] == '\0') {
+            compiled = &ruleTable[placedWildcard++];
+            if (rule->metric != RULE_METRIC_THRESHOLD) wildcardEdge++;
+        } else {
+            RuleBucket* bucket = &ruleBuckets[ruleIndex[ruleProbe(rule->symbol, symbolHash(rule->symbol))]];
+            compiled = &ruleTable[bucket->first + bucket->count++];
+        }
+        compiled->metric = rule->metric;
+        compiled->flags = rule->flags;
+        compiled->slotMask = rule->slotMask;
+        compiled->value = rule->value;
+        compiled->source = i;
+        if (rule->metric == RULE_METRIC_THRESHOLD) {
+            compiled->rearmValue = rule->rearm;   // آستانه شدید
+        } else {
+            compiled->rearmValue = (rule->flags & RULE_FLAG_ABOVE) ? rule->value - rule->rearm : rule->value + rule->rearm;
+        }
+        if (rule->metric == RULE_METRIC_LOSS_MINUTES) ruleHasLossRules = true;
+    }
+    ruleWildcardCount = wildcard;
+    ruleCompiledCount = count;
+    
+    ruleMaxPerPosition = wildcardEdge;
+    for (int b = 0; b < ruleBucketCount; b++) {
+        int edge = 0;
+        for (int r = ruleBuckets[b].first; r < ruleBuckets[b].first + ruleBuckets[b].count; r++) {
+            if (ruleTable[r].metric != RULE_METRIC_THRESHOLD) edge++;
+        }
+        if (wildcardEdge + edge > ruleMaxPerPosition) ruleMaxPerPosition = wildcardEdge + edge;
+    }
+    if (ruleMaxPerPosition > RULE_MAX_PER_POSITION && !benchmarkRunning) {
+        Serial.printf("Alert rules: up to %d rules apply to one symbol, only the first %d are checked\n",
+                      ruleMaxPerPosition, RULE_MAX_PER_POSITION);
+    }
+    
+    // بیت‌ها به ترتیب جدید اشاره می‌کنند: شرط‌های همین الان برقرار بدون آلرت علامت می‌خورند
+    unsigned long now = millis();
+    for (int m = 0; m < portfolioCount; m++) {
+        PortfolioSlot* slot = &portfolios[m];
+        for (int i = 0; i < slot->count; i++) {
+            CryptoPosition* pos = &slot->data[i];
+            pos->ruleLatch = 0;
+            rulesEvaluatePosition(m, pos, now, false);
+            rulesThresholds(m, pos->symbol, &pos->alertThreshold, &pos->severeThreshold);
+        }
+    }
+    return true;
+}
+
+static int ruleSlotFromJson(JsonVariantConst value) {
+    if (value.is<int>()) {
+        int slot = value.as<int>();
+        return slot >= 0 && slot < MAX_PORTFOLIOS ? slot : -1;
+    }
+    const char* key = value.as<const char*>();
+    return key != NULL ? portfolioFromArg(String(key), -1) : -1;
+}
+
+// یک قانون از JSON؛ false و error برای ورودی نامعتبر
+static bool ruleFromJson(JsonObjectConst obj, AlertRule* rule, String& error) {
+    memset(rule, 0, sizeof(AlertRule));
+    
+    const char* symbol = obj["symbol"] | "";
+    if (strlen(symbol) >= sizeof(rule->symbol)) {
+        error = "symbol too long";
+        return false;
+    }
+    strncpy(rule->symbol, symbol, sizeof(rule->symbol) - 1);
+    
+    rule->slotMask = RULE_SLOT_ANY;
+    JsonVariantConst slot = obj["slot"];
+    if (!slot.isNull()) {
+        rule->slotMask = 0;
+        if (slot.is<JsonArrayConst>()) {
+            for (JsonVariantConst item : slot.as<JsonArrayConst>()) {
+                int index = ruleSlotFromJson(item);
+                if (index < 0) {
+                    error = "unknown slot";
+                    return false;
+                }
+                rule->slotMask |= 1 << index;
+            }
+        } else {
+            int index = ruleSlotFromJson(slot);
+            if (index < 0) {
+                error = "unknown slot";
+                return false;
+            }
+            rule->slotMask = 1 << index;
+        }
+    }
+    
+    const char* metric = obj["metric"] | "pnl_percent";
+    rule->metric = RULE_METRIC_COUNT;
+    for (int m = 0; m < RULE_METRIC_COUNT; m++) {
+        if (strcmp(metric, ruleMetricNames[m]) == 0) rule->metric = m;
+    }
+    if (rule->metric == RULE_METRIC_COUNT) {
+        error = "unknown metric";
+        return false;
+    }
+    
+    if (rule->metric == RULE_METRIC_THRESHOLD) {
+        if (obj["alert"].isNull()) {
+            error = "threshold needs alert";
+            return false;
+        }
+        rule->value = obj["alert"].as<float>();
+        rule->rearm = obj["severe"].isNull() ? rule->value * 2 : obj["severe"].as<float>();
+        return true;
+    }
+    
+    if (obj["above"].isNull() == obj["below"].isNull()) {
+        error = "give exactly one of above / below";
+        return false;
+    }
+    bool above = !obj["above"].isNull();
+    rule->value = above ? obj["above"].as<float>() : obj["below"].as<float>();
+    if (above) rule->flags |= RULE_FLAG_ABOVE;
+    if (obj["severe"] | false) rule->flags |= RULE_FLAG_SEVERE;
+    
+    float rearm = (rule->metric == RULE_METRIC_PRICE || rule->metric == RULE_METRIC_PNL_VALUE)
+        ? fabs(rule->value) * RULE_DEFAULT_REARM_FRACTION : RULE_DEFAULT_REARM_PERCENT;
+    if (rule->metric == RULE_METRIC_LOSS_MINUTES) rearm = 0;
+    rule->rearm = obj["rearm"].isNull() ? rearm : fabs(obj["rearm"].as<float>());
+    return true;
+}
+
+static void ruleToJson(const AlertRule* rule, JsonObject obj) {
+    if (rule->symbol[0] != '\0') obj["symbol"] = rule->symbol;
+    if (rule->slotMask != RULE_SLOT_ANY) {
+        JsonArray slots = obj.createNestedArray("slot");
+        for (int m = 0; m < MAX_PORTFOLIOS; m++) {
+            if (rule->slotMask & (1 << m)) slots.add(portfolioKey(m));
+        }
+    }
+    obj["metric"] = ruleMetricNames[rule->metric];
+    if (rule->metric == RULE_METRIC_THRESHOLD) {
+        obj["alert"] = rule->value;
+        obj["severe"] = rule->rearm;
+        return;
+    }
+    obj[(rule->flags & RULE_FLAG_ABOVE) ? "above" : "below"] = rule->value;
+    if (rule->flags & RULE_FLAG_SEVERE) obj["severe"] = true;
+    obj["rearm"] = rule->rearm;
+}
+
+// آرایه "rules" را در بافر تازه PSRAM می‌خواند؛ NULL و error برای ورودی نامعتبر
+static AlertRule* rulesParse(JsonArrayConst list, int* count, String& error) {
+    *count = list.size();
+    if (*count > RULE_MAX_RULES) {
+        error = "too many rules";
+        return NULL;
+    }
+    AlertRule* rules = (AlertRule*)positionStoreAlloc(NULL, sizeof(AlertRule) * (*count > 0 ? *count : 1), false);
+    if (rules == NULL) {
+        error = "out of memory";
+        return NULL;
+    }
+    int i = 0;
+    for (JsonObjectConst obj : list) {
+        if (!ruleFromJson(obj, &rules[i], error)) {
+            error = "rule " + String(i) + ": " + error;
+            free(rules);
+            return NULL;
+        }
+        i++;
+    }
+    return rules;
+}
+
+void rulesBegin() {
+    if (alertLogReady && LittleFS.exists(RULES_CONFIG_FILE)) {
+        File file = LittleFS.open(RULES_CONFIG_FILE, "r");
+        SpiRamJsonDocument doc(file ? file.size() * 2 + 1024 : 1024);
+        if (file && !deserializeJson(doc, file)) {
+            String error;
+            int count = 0;
+            AlertRule* rules = rulesParse(doc["rules"], &count, error);
+            if (rules != NULL) {
+                alertRules = rules;
+                alertRuleCount = count;
+            } else {
+                Serial.println("Alert rules: " + error);
+            }
+        }
+        if (file) file.close();
+    }
+    
+    lockData();
+    rulesCompile(alertRules, alertRuleCount);
+    unlockData();
+    Serial.printf("Alert rules: %d (%d symbols, %d for all symbols)\n", alertRuleCount, ruleBucketCount, ruleWildcardCount);
+}
+
+bool rulesSave() {
+    if (!alertLogReady) return false;
+    
+    SpiRamJsonDocument doc(512 + 160 * alertRuleCount);
+    JsonArray list = doc.createNestedArray("rules");
+    for (int i = 0; i < alertRuleCount; i++) ruleToJson(&alertRules[i], list.createNestedObject());
+    
+    File file = LittleFS.open(RULES_CONFIG_FILE, "w");
+    if (!file) return false;
+    bool ok = serializeJson(doc, file) > 0;
+    file.close();
+    return ok;
+}
+
+// از loop: قوانین یا آستانه‌های تنظیمات عوض شده‌اند
+void rulesService() {
+    if (!ruleConfigChanged) return;
+    ruleConfigChanged = false;
+    lockData();
+    if (!rulesCompile(alertRules, alertRuleCount)) Serial.println("Alert rules: compile failed (out of memory)");
+    unlockData();
+}
+
+// GET /api/v1/rules - قوانین و آمار ارزیابی
+void handleApiRules() {
+    lockData();
+    SpiRamJsonDocument doc(1024 + 160 * alertRuleCount);
+    JsonArray list = doc.createNestedArray("rules");
+    for (int i = 0; i < alertRuleCount; i++) ruleToJson(&alertRules[i], list.createNestedObject());
+    JsonObject compiled = doc.createNestedObject("compiled");
+    compiled["rules"] = ruleCompiledCount;
+    compiled["symbols"] = ruleBucketCount;
+    compiled["allSymbols"] = ruleWildcardCount;
+    compiled["maxPerPosition"] = ruleMaxPerPosition;
+    compiled["pending"] = (bool)ruleConfigChanged;
+    JsonObject stats = doc.createNestedObject("stats");
+    stats["evaluated"] = ruleEvaluated;
+    stats["fired"] = ruleFired;
+    stats["lastPassMicros"] = ruleLastPassMicros;
+    unlockData();
+    
+    String json;
+    serializeJson(doc, json);
+    server.send(200, "application/json", json);
+}
+
+// POST /api/v1/rules - rules=<JSON> (یا بدنه JSON خام): کل فهرست جایگزین می‌شود
+void handleApiRulesUpdate() {
+    String body = server.hasArg("rules") ? server.arg("rules") : server.arg("plain");
+    SpiRamJsonDocument doc(body.length() * 2 + 1024);
+    if (deserializeJson(doc, body)) {
+        server.send(400, "application/json", "{\"success\":false,\"error\":\"bad json\"}");
+        return;
+    }
+    JsonArrayConst list = doc.is<JsonArray>() ? doc.as<JsonArrayConst>() : doc["rules"].as<JsonArrayConst>();
+    if (list.isNull()) {
+        server.send(400, "application/json", "{\"success\":false,\"error\":\"rules array missing\"}");
+        return;
+    }
+    
+    String error;
+    int count = 0;
+    AlertRule* rules = rulesParse(list, &count, error);
+    if (rules == NULL) {
+        DynamicJsonDocument reply(256);
+        reply["success"] = false;
+        reply["error"] = error;
+        String json;
+        serializeJson(reply, json);
+        server.send(400, "application/json", json);
+        return;
+    }
+    
+    lockData();
+    AlertRule* old = alertRules;
+    alertRules = rules;
+    alertRuleCount = count;
+    ruleConfigChanged = true;
+    unlockData();
+    free(old);
+    
+    bool saved = rulesSave();
+    server.send(saved ? 200 : 500, "application/json", saved ? "{\"success\":true}" : "{\"success\":false,\"error\":\"save failed\"}");
+}
+
+// ===== API ENDPOINTS =====
+// چند سرور API: endpoint 0 همان settings.server (EEPROM) است و بقیه در /servers.json.
+// برای هر سرور تأخیر (میانگین نمایی و p95 روی API_LATENCY_WINDOW پاسخ آخر) و نرخ خطا
+// نگه داشته می‌شود و سرورها به ترتیب امتیاز سلامت امتحان می‌شوند.
+// circuit breaker: بعد از API_BREAKER_THRESHOLD خطای پشت سر هم سرور برای cooldown کنار
+// گذاشته می‌شود، سپس یک درخواست آزمایشی (half-open) می‌گیرد؛ شکست دوباره cooldown را دو برابر می‌کند.
+// hedge: HTTPClient همزمان نیست، پس درخواست دوم موازی فرستاده نمی‌شود؛ در عوض وقتی سرور
+// دیگری در دسترس است مهلت درخواست اول به p95 همان سرور (×1.5) محدود می‌شود و بعد از آن
+// سرور بعدی امتحان می‌شود تا loop تمام 10 ثانیه timeout را پشت یک سرور کند نسوزاند.
+#define API_ENDPOINTS_FILE "/servers.json"
+#define API_FETCH_TIMEOUT 10000
+#define API_HEDGE_MIN_TIMEOUT 1000
+#define API_HEDGE_MIN_SAMPLES 5
+#define API_BREAKER_THRESHOLD 3
+#define API_BREAKER_COOLDOWN 30000UL
+#define API_BREAKER_MAX_COOLDOWN 600000UL
+#define API_EW_ALPHA 0.2f
+
+ApiEndpoint apiEndpoints[API_MAX_ENDPOINTS];
+bool apiHedgeEnabled = true;
+
+const char* const breakerStateNames[] = { "closed", "open", "half_open" };
+
+static void apiEndpointInit(ApiEndpoint* endpoint, const char* url) {
+    memset(endpoint, 0, sizeof(ApiEndpoint));
+    strncpy(endpoint->url, url, sizeof(endpoint->url) - 1);
+    // "/" انتهایی حذف می‌شود تا مسیر API دو بار / نگیرد
+    size_t length = strlen(endpoint->url);
+    while (length > 0 && endpoint->url[length - 1] == '/') endpoint->url[--length] = '\0';
+    endpoint->cooldown = API_BREAKER_COOLDOWN;
+}
+
+// endpoint 0 از تنظیمات؛ آمار فقط اگر آدرس عوض شده باشد پاک می‌شود
+void apiEndpointsSync() {
+    ApiEndpoint probe;
+    apiEndpointInit(&probe, settings.server);
+    if (strcmp(probe.url, apiEndpoints[0].url) != 0) apiEndpoints[0] = probe;
+}
+
+// بعد از سوار شدن LittleFS
+void apiEndpointsBegin() {
+    for (int i = 0; i < API_MAX_ENDPOINTS; i++) apiEndpointInit(&apiEndpoints[i], "");
+    apiEndpointsSync();
+    
+    if (alertLogReady && LittleFS.exists(API_ENDPOINTS_FILE)) {
+        File file = LittleFS.open(API_ENDPOINTS_FILE, "r");
+        DynamicJsonDocument doc(256 + 160 * API_MAX_ENDPOINTS);
+        if (file && !deserializeJson(doc, file)) {
+            apiHedgeEnabled = doc["hedge"] | true;
+            JsonArray servers = doc["servers"];
+            for (int i = 1; i < API_MAX_ENDPOINTS && i - 1 < (int)servers.size(); i++) {
+                apiEndpointInit(&apiEndpoints[i], servers[i - 1] | "");
+            }
+        }
+        if (file) file.close();
+    }
+    
+    Serial.printf("API endpoints: %d configured, hedge %s\n", apiEndpointCount(), apiHedgeEnabled ? "on" : "off");
+}
+
+bool apiEndpointsSave() {
+    if (!alertLogReady) return false;
+    
+    DynamicJsonDocument doc(256 + 160 * API_MAX_ENDPOINTS);
+    doc["hedge"] = apiHedgeEnabled;
+    JsonArray servers = doc.createNestedArray("servers");
+    for (int i = 1; i < API_MAX_ENDPOINTS; i++) {
+        if (apiEndpoints[i].url[0] != '\0') servers.add(apiEndpoints[i].url);
+    }
+    
+    File file = LittleFS.open(API_ENDPOINTS_FILE, "w");
+    if (!file) return false;
+    bool ok = serializeJson(doc, file) > 0;
+    file.close();
+    return ok;
+}
+
+int apiEndpointCount() {
+    int count = 0;
+    for (int i = 0; i < API_MAX_ENDPOINTS; i++) {
+        if (apiEndpoints[i].url[0] != '\0') count++;
+    }
+    return count;
+}
+
+// ms؛ 0 اگر نمونه کافی نباشد
+uint32_t apiEndpointP95(const ApiEndpoint* endpoint) {
+    int count = endpoint->latencyCount;
+    if (count < API_HEDGE_MIN_SAMPLES) return 0;
+    
+    uint16_t sorted[API_LATENCY_WINDOW];
+    memcpy(sorted, endpoint->latency, sizeof(uint16_t) * count);
+    for (int i = 1; i < count; i++) {
+        uint16_t value = sorted[i];
+        int j = i - 1;
+        while (j >= 0 && sorted[j] > value) {
+            sorted[j + 1] = sorted[j];
+            j--;
+        }
+        sorted[j + 1] = value;
+    }
+    return sorted[(count * 95 + 99) / 100 - 1];
+}
+
+// کمتر بهتر: تأخیر میانگین + جریمه خطا؛ سرور اندازه‌گیری نشده امتیاز 0 دارد و یک بار امتحان می‌شود
+float apiEndpointScore(const ApiEndpoint* endpoint) {
+    return endpoint->ewLatency + endpoint->ewFailure * API_FETCH_TIMEOUT;
+}
+
+// سرورهای قابل استفاده به ترتیب امتحان؛ breaker باز با پایان cooldown به half-open می‌رود
+int apiEndpointOrder(int* order, unsigned long now) {
+    int count = 0;
+    for (int i = 0; i < API_MAX_ENDPOINTS; i++) {
+        ApiEndpoint* endpoint = &apiEndpoints[i];
+        if (endpoint->url[0] == '\0') continue;
+        if (endpoint->breaker == BREAKER_OPEN && now - endpoint->openedAt >= endpoint->cooldown) {
+            endpoint->breaker = BREAKER_HALF_OPEN;
+            Serial.printf("API endpoint %d half-open (trial request)\n", i);
+        }
+        if (endpoint->breaker == BREAKER_OPEN) continue;
+        order[count++] = i;
+    }
+    
+    // half-open بعد از همه سالم‌ها، بقیه بر اساس امتیاز
+    for (int i = 1; i < count; i++) {
+        int value = order[i];
+        int j = i - 1;
+        while (j >= 0) {
+            const ApiEndpoint* a = &apiEndpoints[order[j]];
+            const ApiEndpoint* b = &apiEndpoints[value];
+            bool after = (a->breaker == BREAKER_HALF_OPEN) != (b->breaker == BREAKER_HALF_OPEN) ?
+                         a->breaker == BREAKER_HALF_OPEN : apiEndpointScore(a) > apiEndpointScore(b);
+            if (!after) break;
+            order[j + 1] = order[j];
+            j--;
+        }
+        order[j + 1] = value;
+    }
+    return count;
+}
+
+// مهلت درخواست: کامل، یا p95×1.5 وقتی سرور دیگری برای hedge هست
+uint32_t apiEndpointTimeout(const ApiEndpoint* endpoint, bool hedge) {
+    if (!hedge) return API_FETCH_TIMEOUT;
+    uint32_t p95 = apiEndpointP95(endpoint);
+    if (p95 == 0) return API_FETCH_TIMEOUT;
+    return constrain(p95 * 3 / 2, (uint32_t)API_HEDGE_MIN_TIMEOUT, (uint32_t)API_FETCH_TIMEOUT);
+}
+
+void apiEndpointRecord(int index, bool success, uint32_t latencyMs) {
+    ApiEndpoint* endpoint = &apiEndpoints[index];
+    endpoint->ewFailure += API_EW_ALPHA * ((success ? 0.0f : 1.0f) - endpoint->ewFailure);
+    
+    if (success) {
+        endpoint->successes++;
+        endpoint->latency[endpoint->latencyHead] = (uint16_t)min(latencyMs, (uint32_t)0xFFFF);
+        endpoint->latencyHead = (endpoint->latencyHead + 1) % API_LATENCY_WINDOW;
+        if (endpoint->latencyCount < API_LATENCY_WINDOW) endpoint->latencyCount++;
+        endpoint->ewLatency = endpoint->successes == 1 ? latencyMs :
+                              endpoint->ewLatency + API_EW_ALPHA * (latencyMs - endpoint->ewLatency);
+        endpoint->consecutiveFailures = 0;
+        if (endpoint->breaker != BREAKER_CLOSED) {
+            Serial.printf("API endpoint %d recovered, breaker closed\n", index);
+            endpoint->breaker = BREAKER_CLOSED;
+            endpoint->cooldown = API_BREAKER_COOLDOWN;
+        }
+        return;
+    }
+    
+    endpoint->failures++;
+    if (endpoint->consecutiveFailures < 255) endpoint->consecutiveFailures++;
+    if (endpoint->breaker == BREAKER_HALF_OPEN) {
+        endpoint->cooldown = min(endpoint->cooldown * 2, (uint32_t)API_BREAKER_MAX_COOLDOWN);
+    } else if (endpoint->breaker != BREAKER_CLOSED || endpoint->consecutiveFailures < API_BREAKER_THRESHOLD) {
+        return;
+    }
+    endpoint->breaker = BREAKER_OPEN;
+    endpoint->openedAt = millis();
+    Serial.printf("API endpoint %d breaker open for %lu s\n", index, (unsigned long)endpoint->cooldown / 1000);
+}
+
+// GET /api/v1/servers - سرورها، سلامت و وضعیت breaker
+void handleApiServers() {
+    DynamicJsonDocument doc(256 + 384 * API_MAX_ENDPOINTS);
+    unsigned long now = millis();
+    
+    lockData();
+    doc["hedge"] = apiHedgeEnabled;
+    JsonArray servers = doc.createNestedArray("servers");
+    for (int i = 0; i < API_MAX_ENDPOINTS; i++) {
+        const ApiEndpoint* endpoint = &apiEndpoints[i];
+        if (endpoint->url[0] == '\0') continue;
+        JsonObject obj = servers.createNestedObject();
+        obj["index"] = i;
+        obj["url"] = endpoint->url;
+        obj["breaker"] = breakerStateNames[endpoint->breaker];
+        obj["score"] = apiEndpointScore(endpoint);
+        obj["latencyMs"] = endpoint->ewLatency;
+        obj["p95Ms"] = apiEndpointP95(endpoint);
+        obj["failureRate"] = endpoint->ewFailure;
+        obj["successes"] = endpoint->successes;
+        obj["failures"] = endpoint->failures;
+        obj["rejected"] = endpoint->rejected;
+        obj["hedges"] = endpoint->hedges;
+        obj["consecutiveFailures"] = endpoint->consecutiveFailures;
+        if (endpoint->breaker == BREAKER_OPEN) {
+            long remaining = (long)endpoint->cooldown - (long)(now - endpoint->openedAt);
+            obj["retryIn"] = remaining > 0 ? remaining : 0;
+        }
+    }
+    unlockData();
+    
+    String json;
+    serializeJson(doc, json);
+    server.send(200, "application/json", json);
+}
+
+// POST /api/v1/servers?servers=http://a,http://b&hedge=0|1  (سرورهای اضافه بعد از settings.server)
+// action=reset همه breaker ها را می‌بندد
+void handleApiServersUpdate() {
+    if (server.arg("action") == "reset") {
+        lockData();
+        for (int i = 0; i < API_MAX_ENDPOINTS; i++) {
+            apiEndpoints[i].breaker = BREAKER_CLOSED;
+            apiEndpoints[i].consecutiveFailures = 0;
+            apiEndpoints[i].cooldown = API_BREAKER_COOLDOWN;
+        }
+        unlockData();
+        server.send(200, "application/json", "{\"success\":true}");
+        return;
+    }
+    
+    // فهرست اول کامل بررسی می‌شود؛ apiFetch در loop فقط زیر قفل سرورها را می‌خواند
+    String urls[API_MAX_ENDPOINTS];
+    int urlCount = 0;
+    bool hasServers = server.hasArg("servers");
+    if (hasServers) {
+        String list = server.arg("servers");
+        int start = 0;
+        while (start <= (int)list.length() && urlCount < API_MAX_ENDPOINTS - 1) {
+            int comma = list.indexOf(',', start);
+            if (comma < 0) comma = list.length();
+            String url = list.substring(start, comma);
+            url.trim();
+            if (url.length() > 0) {
+                if (!url.startsWith("http://") && !url.startsWith("https://")) {
+                    server.send(400, "application/json", "{\"success\":false,\"error\":\"bad url\"}");
+                    return;
+                }
+                urls[urlCount++] = url;
+            }
+            start = comma + 1;
+        }
+    }
+    
+    lockData();
+    if (server.hasArg("hedge")) {
+        apiHedgeEnabled = server.arg("hedge") != "0" && server.arg("hedge") != "false";
+    }
+    if (hasServers) {
+        for (int index = 1; index < API_MAX_ENDPOINTS; index++) {
+            const char* url = index <= urlCount ? urls[index - 1].c_str() : "";
+            if (strcmp(apiEndpoints[index].url, url) != 0) apiEndpointInit(&apiEndpoints[index], url);
+        }
+    }
+    bool saved = apiEndpointsSave();
+    unlockData();
+    
+    server.send(saved ? 200 : 500, "application/json", saved ? "{\"success\":true}" : "{\"success\":false,\"error\":\"save failed\"}");
+}
+
+// ===== DATA PROCESSING FUNCTIONS =====
+void parseCryptoData(String jsonData, byte mode) {
+    if (jsonData.length() < 10 || jsonData == "{}") {
+        Serial.println("Empty or invalid JSON data for mode " + String(mode));
+        return;
+    }
+    
+    // ظرفیت سند متناسب با payload و در PSRAM؛ 8KB فقط برای حدود 50 پوزیشن کافی است
+    size_t docCapacity = jsonData.length() * 2;
+    if (docCapacity < JSON_BUFFER_SIZE) docCapacity = JSON_BUFFER_SIZE;
+    SpiRamJsonDocument doc(docCapacity);
+    DeserializationError error = deserializeJson(doc, jsonData);
+    
+    if (error) {
+        Serial.println("JSON Parse Error for mode " + String(mode) + ": " + String(error.c_str()));
+        return;
+    }
+    
+    if (!doc.containsKey("portfolio")) {
+        Serial.println("No 'portfolio' field in JSON for mode " + String(mode));
+        return;
+    }
+    
+    JsonArray portfolio = doc["portfolio"];
+    int itemCount = portfolio.size();
+    
+    // ابتدا در بافر staging پارس می‌شود و فقط در انتها (با قفل) منتشر می‌شود
+    // تا تسک وب هیچ‌وقت داده نیمه‌کاره نبیند. staging و مخزن زنده تا اندازه payload رشد می‌کنند.
+    PortfolioSummary stagingSummary = portfolios[mode].summary;
+    int stagingCount = min(itemCount, MAX_POSITIONS_PER_MODE);
+    
+    if (stagingCount > parseStagingCapacity) {
+        CryptoPosition* grown = (CryptoPosition*)positionStoreAlloc(parseStaging, sizeof(CryptoPosition) * stagingCount, false);
+        if (grown != NULL) {
+            parseStaging = grown;
+            parseStagingCapacity = stagingCount;
+        }
+    }
+    
+    lockData();
+    if (!positionStoreReserve(mode, stagingCount)) {
+        int capacity = portfolios[mode].capacity;
+        if (capacity < stagingCount) stagingCount = capacity;
+    }
+    unlockData();
+    
+    if (stagingCount > parseStagingCapacity) stagingCount = parseStagingCapacity;
+    if (stagingCount < min(itemCount, MAX_POSITIONS_PER_MODE)) {
+        Serial.printf("Position store out of memory: keeping %d of %d positions (mode %d)\n", stagingCount, itemCount, mode);
+    }
+    
+    CryptoPosition* stagingData = parseStaging;
+    CryptoPosition* targetData = stagingData;
+    int* targetCount = &stagingCount;
+    PortfolioSummary* targetSummary = &stagingSummary;
+    
+    memset(targetData, 0, sizeof(CryptoPosition) * stagingCount);
+    
+    for (int i = 0; i < *targetCount; i++) {
+        JsonObject item = portfolio[i];
+        CryptoPosition* pos = &targetData[i];
+        
+        const char* symbol = item["symbol"] | "UNKNOWN";
+        strncpy(pos->symbol, symbol, 15);
+        pos->symbol[15] = '\0';
+        
+        pos->changePercent = item["pnl_percent"] | 0.0;
+        pos->currentPrice = moneyFromJson(item["current_price"]);
+        pos->entryPrice = moneyFromJson(item["entry_price"]);
+        pos->quantity = moneyFromJson(item["quantity"]);
+        pos->pnlValue = moneyFromJson(item["pnl"]);
+        
+        pos->isLong = true;
+        
+        if (item.containsKey("position")) {
+            const char* position = item["position"];
+            if (strcasecmp(position, "short") == 0) pos->isLong = false;
+        } else if (item.containsKey("position_side")) {
+            const char* positionSide = item["position_side"];
+            if (strcasecmp(positionSide, "short") == 0) pos->isLong = false;
+        } else if (item.containsKey("side")) {
+            const char* side = item["side"];
+            if (strcasecmp(side, "sell") == 0) pos->isLong = false;
+        }
+        
+        // ضریب درصد سرور نسبت به حرکت قیمت (اهرم / ROE) تا tier قیمت همان معنای pnl_percent را نگه دارد
+        float leverage = item["leverage"] | 0.0f;
+        float priceMove = pos->entryPrice > 0
+            ? moneyRatio(pos->currentPrice - pos->entryPrice, pos->entryPrice) * 100 * (pos->isLong ? 1 : -1) : 0.0f;
+        if (leverage > 0) {
+            pos->percentScale = leverage;
+        } else if (fabs(priceMove) >= PRICE_SCALE_MIN_MOVE && pos->changePercent * priceMove > 0) {
+            pos->percentScale = constrain(pos->changePercent / priceMove, 1.0f, PRICE_SCALE_MAX);
+        } else {
+            pos->percentScale = 1.0f;
+        }
+        
+        rulesThresholds(mode, pos->symbol, &pos->alertThreshold, &pos->severeThreshold);
+        pos->hasAlerted = false;
+        pos->lastAlertPercent = 0.0;
+        
+        if (portfolioIsExitStyle(mode)) {
+            pos->exitAlertLastPrice = pos->currentPrice;
+        }
+    }
+    
+    if (doc.containsKey("summary")) {
+        JsonObject summary = doc["summary"];
+        
+        targetSummary->totalInvestment = moneyFromJson(summary["total_investment"]);
+        targetSummary->totalCurrentValue = moneyFromJson(summary["total_current_value"]);
+        targetSummary->totalPnl = moneyFromJson(summary["total_pnl"]);
+        
+        if (targetSummary->totalInvestment > 0) {
+            targetSummary->totalPnlPercent = moneyRatio(targetSummary->totalCurrentValue - targetSummary->totalInvestment,
+                                                        targetSummary->totalInvestment) * 100;
+        } else {
+            targetSummary->totalPnlPercent = 0.0;
+        }
+        
+        targetSummary->totalPositions = *targetCount;
+        targetSummary->longPositions = summary["long_positions"] | 0;
+        targetSummary->shortPositions = summary["short_positions"] | 0;
+        targetSummary->winningPositions = summary["winning_positions"] | 0;
+        targetSummary->losingPositions = summary["losing_positions"] | 0;
+        targetSummary->maxDrawdown = summary["max_drawdown"] | 0.0;
+        targetSummary->sharpeRatio = summary["sharpe_ratio"] | 0.0;
+    }
+    
+    publishPositions(mode, stagingData, stagingCount, &stagingSummary);
+    
+    if (!benchmarkRunning) {
+        Serial.println("Mode " + String(mode) + " data parsed: " + String(*targetCount) + " positions");
+    }
+}
+
+// زمان مشاهده payload ای که الان parse می‌شود: ارسال درخواست apiFetch، یا الان برای payload های
+// بازپخش / benchmark که از apiFetch نیامده‌اند
+unsigned long fetchObservedAt() {
+    unsigned long observedAt = lastFetchSentAt != 0 ? lastFetchSentAt : millis();
+    lastFetchSentAt = 0;
+    return observedAt;
+}
+
+// نمونه‌های تاریخچه قیمت / ریسک (فقط تسک loop). ثبت آن‌ها بلوک‌ها را فشرده می‌کند، پس به جای
+// نگه داشتن قفل داده برای همه ردیف‌ها، هر نماد با یک قفل کوتاه جدا ثبت می‌شود
+PriceSample* priceSamples = NULL;
+int priceSampleCapacity = 0;
+
+bool priceSamplesReserve(int count) {
+    if (count <= priceSampleCapacity) return true;
+    PriceSample* grown = (PriceSample*)positionStoreAlloc(priceSamples, sizeof(PriceSample) * count, false);
+    if (grown == NULL) return false;
+    priceSamples = grown;
+    priceSampleCapacity = count;
+    return true;
+}
+
+// داخل lockData
+void priceSampleCopy(PriceSample* sample, const CryptoPosition* pos) {
+    memcpy(sample->symbol, pos->symbol, sizeof(sample->symbol));
+    sample->price = moneyToFloat(pos->currentPrice);
+    sample->changePercent = pos->changePercent;
+    sample->isLong = pos->isLong;
+}
+
+// بیرون از lockData
+void priceSamplesRecord(int count, uint32_t sampleTime) {
+    for (int i = 0; i < count; i++) {
+        const PriceSample* sample = &priceSamples[i];
+        lockData();
+        tsRecord(sample->symbol, sample->price, sample->changePercent, sampleTime);
+        riskRecordSymbol(sample->symbol, sample->price, sample->isLong, sampleTime);
+        unlockData();
+    }
+}
+
+// انتشار staging در slot زنده (parseCryptoData)
+void publishPositions(byte mode, CryptoPosition* staged, int count, const PortfolioSummary* summary) {
+    unsigned long observedAt = fetchObservedAt();
+    bool sampling = !benchmarkRunning && priceSamplesReserve(count);
+    int samples = 0;
+    
+    lockData();
+    // فقط ردیف‌های تغییر کرده در مجموع‌ها اعمال می‌شوند (قبل از جایگزینی داده قدیمی)
+    aggregateMerge(mode, staged, count);
+    
+    PortfolioSlot* slot = &portfolios[mode];
+    memcpy(slot->data, staged, sizeof(CryptoPosition) * count);
+    slot->count = count;
+    slot->summary = *summary;
+    positionHotRebuild(mode);
+    dataVersion++;
+    
+    // تاریخچه قیمت (نمادهای مصنوعی benchmark وارد تاریخچه نمی‌شوند)؛ از ردیف‌های زنده، چون تیک
+    // جدیدتر stream ممکن است قیمت payload را جایگزین کرده باشد
+    if (!benchmarkRunning) {
+        symbolPublishSlot(mode, observedAt);
+        if (sampling) {
+            for (int i = 0; i < count; i++) priceSampleCopy(&priceSamples[samples++], &slot->data[i]);
+        }
+    }
+    unlockData();
+    
+    priceSamplesRecord(samples, tsNow());
+}
+
+String getPortfolioData(byte mode) {
+    lockData();
+    String portfolioName = String(portfolios[mode].name);
+    String path = "/api/device/portfolio/" + String(settings.username) + "?portfolio_name=" + portfolioName;
+    unlockData();
+    
+    String response = apiFetch(path, portfolioName);
+    if (lastFetchHttpCode == HTTP_CODE_OK) recordPayload(mode, response);
+    return response;
+}
+
+// GET روی سرورهای API به ترتیب سلامت (بخش API ENDPOINTS)؛ lastFetchHttpCode / lastFetchRetryAfter را تنظیم می‌کند
+String apiFetch(const String& path, const String& label) {
+    if (!isConnectedToWiFi) {
+        Serial.println("Cannot fetch data: WiFi not connected");
+        lastFetchHttpCode = 0;
+        return "{}";
+    }
+    
+    // تسک وب ممکن است همزمان /saveapi را بنویسد
+    lockData();
+    String username = String(settings.username);
+    String userpass = String(settings.userpass);
+    unlockData();
+    
+    if (apiEndpointCount() == 0 || username.length() == 0) {
+        Serial.println("Cannot fetch data: API not configured");
+        lastFetchHttpCode = 0;
+        return "{}";
+    }
+    
+    String auth = base64Encode(username + ":" + userpass);
+    const char* headerKeys[] = { "Retry-After" };
+    
+    // سرورها و آمارشان از /api/v1/servers در تسک وب هم عوض می‌شوند؛ فقط حین HTTP قفل آزاد است
+    int order[API_MAX_ENDPOINTS];
+    lockData();
+    int candidates = apiEndpointOrder(order, millis());
+    unlockData();
+    if (candidates == 0) {
+        Serial.println("Cannot fetch data: all API endpoints are open (circuit breaker)");
+        lastFetchHttpCode = HTTPC_ERROR_CONNECTION_REFUSED;
+        lastFetchRetryAfter = 0;
+        return "{}";
+    }
+    
+    // سرورها به ترتیب سلامت؛ اولین پاسخ موفق برگردانده می‌شود
+    uint32_t retryAfter = 0;
+    for (int n = 0; n < candidates; n++) {
+        int index = order[n];
+        ApiEndpoint* endpoint = &apiEndpoints[index];
+        lockData();
+        bool hedge = apiHedgeEnabled && n + 1 < candidates;
+        uint32_t timeout = apiEndpointTimeout(endpoint, hedge);
+        String url = String(endpoint->url) + path;
+        unlockData();
+        
+        Serial.println("Fetching data for " + label + " from: " + url);
+        
+        unsigned long startTime = millis();
+        
+        http.begin(url);
+        http.setConnectTimeout(timeout);
+        http.setTimeout(timeout);
+        http.addHeader("Authorization", "Basic " + auth);
+        http.addHeader("Content-Type", "application/json");
+        http.collectHeaders(headerKeys, 1);
+        
+        int httpCode = http.GET();
+        unsigned long responseTime = millis() - startTime;
+        lastFetchHttpCode = httpCode;
+        
+        if (httpCode == HTTP_CODE_OK) {
+            String response = http.getString();
+            http.end();
+            lastFetchSentAt = startTime;
+            lockData();
+            apiEndpointRecord(index, true, responseTime);
+            unlockData();
+            updateAPIStatistics(true, responseTime);
+            lastFetchRetryAfter = 0;
+            Serial.println("Data fetched successfully for " + label + " (" + String(response.length()) + " bytes)");
+            return response;
+        }
+        
+        updateAPIStatistics(false, responseTime);
+        // فقط شکل delta-seconds؛ شکل HTTP-date نادیده گرفته می‌شود (backoff عادی)
+        if (httpCode > 0) retryAfter = max(retryAfter, (uint32_t)max(0L, http.header("Retry-After").toInt()));
+        http.end();
+        Serial.println("HTTP Error: " + String(httpCode) + " for " + label + " (endpoint " + String(index) + ")");
+        
+        // 4xx (جز 429) خطای درخواست است نه سرور؛ سرور بعدی هم همین را می‌گوید.
+        // breaker را باز نمی‌کند، ولی پاسخ رد شده موفقیت هم نیست و وارد p95 نمی‌شود
+        lockData();
+        if (httpCode >= 400 && httpCode < 500 && httpCode != 429) {
+            endpoint->rejected++;
+            unlockData();
+            break;
+        }
+        apiEndpointRecord(index, false, responseTime);
+        if (hedge && timeout < API_FETCH_TIMEOUT && responseTime >= timeout) endpoint->hedges++;
+        unlockData();
+    }
+    
+    lastFetchRetryAfter = retryAfter;
+    return "{}";
+}
+
+String base64Encode(String data) {
+    const char* base64_chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    String encoded = "";
+    int i = 0;
+    int len = data.length();
+    
+    while (i < len) {
+        uint32_t octet_a = i < len ? (unsigned char)data[i++] : 0;
+        uint32_t octet_b = i < len ? (unsigned char)data[i++] : 0;
+        uint32_t octet_c = i < len ? (unsigned char)data[i++] : 0;
+        
+        uint32_t triple = (octet_a << 0x10) + (octet_b << 0x08) + octet_c;
+        
+        encoded += base64_chars[(triple >> 3 * 6) & 0x3F];
+        encoded += base64_chars[(triple >> 2 * 6) & 0x3F];
+        encoded += base64_chars[(triple >> 1 * 6) & 0x3F];
+        encoded += base64_chars[(triple >> 0 * 6) & 0x3F];
+    }
+    
+    if (len % 3 == 1) {
+        encoded[encoded.length() - 1] = '=';
+        encoded[encoded.length() - 2] = '=';
+    } else if (len % 3 == 2) {
+        encoded[encoded.length() - 1] = '=';
+    }
+    
+    return encoded;
+}
+
+void sortPositionsByLoss(CryptoPosition* data, int count) {
+    for (int i = 0; i < count - 1; i++) {
+        for (int j = 0; j < count - i - 1; j++) {
+            if (data[j].changePercent > data[j + 1].changePercent) {
+                CryptoPosition temp = data[j];
+                data[j] = data[j + 1];
+                data[j + 1] = temp;
+            }
+        }
+    }
+}
+
+void calculatePortfolioSummary(byte mode) {
+    PortfolioSummary* target = &portfolios[mode].summary;
+    PortfolioAggregate* agg = &portfolios[mode].aggregate;
+    CryptoPosition* data = portfolios[mode].data;
+    int count = portfolios[mode].count;
+    
+    // محاسبه روی کپی محلی، انتشار با قفل
+    PortfolioSummary result = *target;
+    PortfolioSummary* summary = &result;
+    
+    if (count == 0) {
+        lockData();
+        memset(target, 0, sizeof(PortfolioSummary));
+        updateCombinedTotals();
+        unlockData();
+        return;
+    }
+    
+    // مجموع‌ها از aggregateMerge می‌آیند؛ هر چند وقت یک بار اسکن کامل
+    // هم خطای انباشته float را صفر می‌کند و هم درستی مسیر تفاضلی را بررسی می‌کند
+    if (!agg->valid || agg->updatesSinceFull >= SUMMARY_FULL_RECOMPUTE_EVERY) {
+        PortfolioAggregate full;
+        aggregateRebuild(&full, data, count);
+        
+        if (agg->valid) {
+            // با جمع صحیح انتظار drift صفر است؛ هر اختلافی خطای منطق تفاضلی است
+            float drift = moneyToFloat(llabs(full.totalValue - agg->totalValue) + llabs(full.totalPnl - agg->totalPnl));
+            if (drift > summaryMaxDrift) summaryMaxDrift = drift;
+            if (drift > 0 || full.longCount != agg->longCount || full.shortCount != agg->shortCount ||
+                full.winningCount != agg->winningCount || full.losingCount != agg->losingCount ||
+                full.worstPercent != agg->worstPercent) {
+                summaryMismatches++;
+                Serial.println("⚠️ Incremental summary mismatch for mode " + String(mode));
+            }
+        }
+        
+        *agg = full;
+        summaryFullRecomputes++;
+    }
+    
+    summary->totalCurrentValue = agg->totalValue;
+    summary->totalPnl = agg->totalPnl;
+    summary->totalPositions = count;
+    summary->longPositions = agg->longCount;
+    summary->shortPositions = agg->shortCount;
+    summary->winningPositions = agg->winningCount;
+    summary->losingPositions = agg->losingCount;
+    summary->worstChangePercent = agg->worstPercent;
+    strncpy(summary->worstSymbol, agg->worstSymbol, sizeof(summary->worstSymbol));
+    
+    summary->totalInvestment = agg->totalValue - agg->totalPnl;
+    
+    if (summary->totalInvestment > 0) {
+        summary->totalPnlPercent = moneyRatio(agg->totalPnl, summary->totalInvestment) * 100;
+    } else {
+        summary->totalPnlPercent = 0.0;
+    }
+    
+    lockData();
+    
+    // drawdown واقعی از قله و Sharpe محلی؛ تا نمونه کافی نباشد Sharpe سرور می‌ماند
+    RiskStats* risk = riskUpdatePortfolio(mode, summary, tsNow());
+    summary->maxDrawdown = risk->maxDrawdown;
+    summary->currentDrawdown = risk->drawdown;
+    summary->volatility = riskVolatility(risk);
+    summary->sortinoRatio = riskSortino(risk);
+    if (risk->samples >= RISK_MIN_SAMPLES) summary->sharpeRatio = riskSharpe(risk);
+    
+    *target = result;
+    updateCombinedTotals();
+    unlockData();
+}
+
+void clearCryptoData(byte mode) {
+    lockData();
+    PortfolioSlot* slot = &portfolios[mode];
+    if (slot->data != NULL) memset(slot->data, 0, sizeof(CryptoPosition) * slot->capacity);
+    slot->count = 0;
+    memset(&slot->aggregate, 0, sizeof(PortfolioAggregate));
+    symbolTableRebuild();
+    dataVersion++;
+    unlockData();
+}
+
+// ===== PRICE TICKER =====
+// بیشتر payload پورتفولیو برای هر پوزیشن ثابت است (entry، quantity، side)؛ فقط قیمت
+// حرکت می‌کند. بین sync های کامل (PRICE_FULL_SYNC_INTERVAL) فقط
+//   GET /api/device/prices/<user>?portfolio_name=..&symbols=A,B  ->  {"prices":{"A":"65000.5",...}}
+// گرفته می‌شود و currentPrice / pnlValue / changePercent از داده entry ذخیره شده محاسبه
+// می‌شوند. changePercent با percentScale (اهرم تخمینی در parse کامل) ضرب می‌شود تا
+// همان معنای pnl_percent سرور را داشته باشد. اگر سرور این endpoint را نداشته باشد (404)
+// همه slot ها تا PRICE_PROBE_INTERVAL به sync کامل برمی‌گردند.
+const char* const fetchTierNames[FETCH_TIER_COUNT] = { "full", "price" };
+unsigned long fetchTierCount[FETCH_TIER_COUNT] = { 0, 0 };
+uint64_t fetchTierBytes[FETCH_TIER_COUNT] = { 0, 0 };
+uint64_t fetchTierParseMicros[FETCH_TIER_COUNT] = { 0, 0 };
+
+bool priceTickerUsable(unsigned long now) {
+    if (priceTickerSupported) return true;
+    if ((long)(now - priceTickerRetryAt) < 0) return false;
+    priceTickerSupported = true;
+    Serial.println("Price ticker: probing the prices endpoint again");
+    return true;
+}
+
+void priceTickerRecord(FetchTier tier, size_t bytes, uint32_t parseMicros) {
+    fetchTierCount[tier]++;
+    fetchTierBytes[tier] += bytes;
+    fetchTierParseMicros[tier] += parseMicros;
+}
+
+String getPriceData(byte mode) {
+    PortfolioSlot* slot = &portfolios[mode];
+    lockData();
+    String portfolioName = String(slot->name);
+    String path = "/api/device/prices/" + String(settings.username) + "?portfolio_name=" + portfolioName;
+    unlockData();
+    
+    // فهرست نمادها فقط برای پورتفوی‌های کوچک؛ در غیر این صورت سرور از نام پورتفوی پیدا می‌کند
+    String symbols;
+    for (int i = 0; i < slot->count && symbols.length() <= PRICE_SYMBOLS_MAX_LENGTH; i++) {
+        if (i > 0 && strcmp(slot->data[i].symbol, slot->data[i - 1].symbol) == 0) continue;
+        if (symbols.length() > 0) symbols += ",";
+        symbols += slot->data[i].symbol;
+    }
+    if (symbols.length() > 0 && symbols.length() <= PRICE_SYMBOLS_MAX_LENGTH) path += "&symbols=" + symbols;
+    
+    String response = apiFetch(path, portfolioName + " prices");
+    if (lastFetchHttpCode == HTTP_CODE_NOT_FOUND) {
+        priceTickerSupported = false;
+        priceTickerRetryAt = millis() + PRICE_PROBE_INTERVAL;
+        Serial.println("Price ticker: server has no prices endpoint, using full syncs only");
+    }
+    return response;
+}
+
+// P/L از داده entry ذخیره شده؛ مشترک با تیک‌های PRICE STREAM
+void positionApplyPrice(CryptoPosition* pos, Money price) {
+    int direction = pos->isLong ? 1 : -1;
+    pos->currentPrice = price;
+    pos->pnlValue = moneyMul(price - pos->entryPrice, pos->quantity) * direction;
+    if (pos->entryPrice > 0) {
+        pos->changePercent = moneyRatio(price - pos->entryPrice, pos->entryPrice) * 100 * direction * pos->percentScale;
+    }
+}
+
+// قیمت‌های جدید روی کپی داده زنده اعمال و مثل parse کامل منتشر می‌شوند؛
+// وضعیت آلرت پوزیشن‌ها (که parse کامل صفر می‌کند) دست نمی‌خورد
+bool applyPriceData(const String& jsonData, byte mode) {
+    PortfolioSlot* slot = &portfolios[mode];
+    if (symbolTable == NULL) return false;   // بدون جدول نمادها فقط sync کامل
+    
+    size_t docCapacity = jsonData.length() * 2;
+    if (docCapacity < 1024) docCapacity = 1024;
+    SpiRamJsonDocument doc(docCapacity);
+    DeserializationError error = deserializeJson(doc, jsonData);
+    if (error) {
+        Serial.println("Price JSON Parse Error for mode " + String(mode) + ": " + String(error.c_str()));
+        return false;
+    }
+    JsonObject prices = doc["prices"];
+    if (prices.isNull()) {
+        Serial.println("No 'prices' field in JSON for mode " + String(mode));
+        return false;
+    }
+    
+    // هر قیمت یک بار در جدول نمادها نوشته می‌شود و به همه slot هایی که آن نماد را دارند می‌رسد
+    unsigned long observedAt = fetchObservedAt();
+    bool sampling = !benchmarkRunning && priceSamplesReserve(slot->count);
+    lockData();
+    int count = slot->count;
+    for (JsonPair kv : prices) {
+        Money price = moneyFromJson(kv.value());
+        if (price > 0) symbolPriceSet(symbolFind(kv.key().c_str()), price, observedAt, -1);
+    }
+    
+    // ردیف‌هایی که همین پاسخ قیمتشان را داد (نه قیمت کهنه‌تر از یک تیک stream)
+    int updated = 0;
+    if (sampling) {
+        for (int i = 0; i < count && updated < priceSampleCapacity; i++) {
+            uint16_t id = slot->hot[i].symbolId;
+            if (id == SYMBOL_NONE || symbolTable[id].updatedAt != observedAt) continue;
+            priceSampleCopy(&priceSamples[updated++], &slot->data[i]);
+        }
+    }
+    dataVersion++;
+    unlockData();
+    
+    priceSamplesRecord(updated, tsNow());
+    // summary سرور فقط در sync کامل می‌آید؛ symbolFlushDirty بقیه را از مجموع‌ها می‌سازد
+    symbolDirtySlots |= 1 << mode;
+    
+    if (!benchmarkRunning && updated < count) {
+        Serial.printf("Mode %d prices: %d of %d positions updated\n", mode, updated, count);
+    }
+    return true;
+}
+
+// ===== PRICE STREAM (WebSocket) =====
+// حالت اختیاری: به جای انتظار برای poll، دستگاه روی WebSocket به یک feed تیک قیمت
+// subscribe می‌کند. هر تیک currentPrice پوزیشن‌های همان نماد را درجا به‌روز می‌کند
+// (مجموع‌ها با aggregateApply) و فقط قانون آلرت همان پوزیشن‌ها اجرا می‌شود، پس
+// یک wick چند صد میلی‌ثانیه‌ای هم بدون دروازه 5 ثانیه‌ای checkAlerts بوق می‌زند.
+//   دستگاه ← {"op":"subscribe","symbols":["BTCUSDT",...]}   (با هر تغییر فهرست نمادها دوباره)
+//   feed   → {"s":"BTCUSDT","p":"64012.5","id":17}  یا  {"ticks":[{...},{...}]}
+// فقط ws:// (WiFiClient ساده، مثل HTTPClient روی host)؛ Sec-WebSocket-Accept بررسی نمی‌شود
+// و frame های تکه‌تکه پشتیبانی نمی‌شوند. تا وقتی stream باز است tier قیمت poll نمی‌شود و
+// فقط sync کامل (PRICE_FULL_SYNC_INTERVAL) برای پوزیشن‌های باز/بسته شده می‌ماند.
+#define STREAM_CONFIG_FILE "/stream.json"
+#define STREAM_RX_BUFFER 2048
+#define STREAM_FRAME_MAX (STREAM_RX_BUFFER - 1)   // بزرگ‌ترین frame قابل قبول؛ بایت آخر برای '\0' handshake
+#define STREAM_JSON_CAPACITY 2048
+#define STREAM_MAX_SYMBOLS 64
+#define STREAM_HANDSHAKE_TIMEOUT 5000UL
+#define STREAM_PING_INTERVAL 20000UL        // بعد از این سکوت ping
+#define STREAM_IDLE_TIMEOUT 45000UL         // بعد از این سکوت اتصال مرده فرض می‌شود
+#define STREAM_BACKOFF_MIN 2000UL
+#define STREAM_BACKOFF_MAX 60000UL
+#define STREAM_SUMMARY_INTERVAL 1000UL      // جمع‌بندی / SSE پورتفوهای تیک خورده و بررسی فهرست نمادها
+
+#define WS_OP_CONTINUATION 0x0
+#define WS_OP_TEXT 0x1
+#define WS_OP_CLOSE 0x8
+#define WS_OP_PING 0x9
+#define WS_OP_PONG 0xA
+
+const char* const streamStateNames[STREAM_STATE_COUNT] = { "off", "handshake", "open", "backoff" };
+
+char streamUrl[128] = "";
+bool streamEnabled = false;
+volatile bool streamConfigChanged = false;  // از تسک وب؛ loop اتصال را از نو می‌سازد
+StreamState streamState = STREAM_OFF;
+StreamStats streamStats;
+WiFiClient streamClient;
+uint8_t streamRx[STREAM_RX_BUFFER];
+size_t streamRxLength = 0;
+unsigned long streamStateSince = 0;
+unsigned long streamLastRx = 0;
+unsigned long streamLastPing = 0;
+unsigned long streamBackoff = STREAM_BACKOFF_MIN;
+unsigned long streamLastSummary = 0;
+uint32_t streamSymbolsHash = 0;
+int streamSymbolCount = 0;
+bool streamTruncated = false;               // نمادها بیش از STREAM_MAX_SYMBOLS؛ poll قیمت ادامه دارد
+
+void streamBegin() {
+    memset(&streamStats, 0, sizeof(streamStats));
+    streamStats.lastAlertTickId = -1;
+    
+    if (alertLogReady && LittleFS.exists(STREAM_CONFIG_FILE)) {
+        File file = LittleFS.open(STREAM_CONFIG_FILE, "r");
+        DynamicJsonDocument doc(384);
+        if (file && !deserializeJson(doc, file)) {
+            streamEnabled = doc["enabled"] | false;
+            strncpy(streamUrl, doc["url"] | "", sizeof(streamUrl) - 1);
+        }
+        if (file) file.close();
+    }
+    
+    Serial.printf("Price stream: %s%s\n", streamEnabled ? "enabled " : "disabled", streamEnabled ? streamUrl : "");
+}
+
+bool streamSave() {
+    if (!alertLogReady) return false;
+    
+    DynamicJsonDocument doc(384);
+    doc["enabled"] = streamEnabled;
+    doc["url"] = streamUrl;
+    
+    File file = LittleFS.open(STREAM_CONFIG_FILE, "w");
+    if (!file) return false;
+    bool ok = serializeJson(doc, file) > 0;
+    file.close();
+    return ok;
+}
+
+bool streamLive() {
+    return streamState == STREAM_OPEN && !streamTruncated;
+}
+
+// ws://host[:port][/path]
+static bool streamParseUrl(const char* url, String& host, uint16_t& port, String& path) {
+    if (strncmp(url, "ws://", 5) != 0) return false;
+    String rest = String(url + 5);
+    int slash = rest.indexOf('/');
+    String authority = slash < 0 ? rest : rest.substring(0, slash);
+    path = slash < 0 ? String("/") : rest.substring(slash);
+    
+    int colon = authority.indexOf(':');
+    port = 80;
+    if (colon >= 0) {
+        long value = authority.substring(colon + 1).toInt();
+        if (value <= 0 || value > 65535) return false;
+        port = (uint16_t)value;
+        authority = authority.substring(0, colon);
+    }
+    host = authority;
+    return host.length() > 0;
+}
+
+static void streamSetState(StreamState state, unsigned long now) {
+    if (state != streamState) {
+        Serial.printf("Price stream: %s\n", streamStateNames[state]);
+    }
+    streamState = state;
+    streamStateSince = now;
+}
+
+static void streamClose(unsigned long now, const char* reason) {
+    if (streamClient.connected()) streamClient.stop();
+    streamRxLength = 0;
+    streamSymbolsHash = 0;
+    
+    if (!streamEnabled || !isConnectedToWiFi) {
+        streamSetState(STREAM_OFF, now);
+        return;
+    }
+    Serial.printf("Price stream closed (%s), retry in %lu ms\n", reason, streamBackoff);
+    streamSetState(STREAM_BACKOFF, now);
+}
+
+// client → server همیشه mask می‌شود (RFC 6455 5.3)
+static void streamSend(uint8_t opcode, const uint8_t* payload, size_t length) {
+    uint8_t header[8];
+    size_t used = 0;
+    header[used++] = 0x80 | opcode;
+    if (length < 126) {
+        header[used++] = 0x80 | (uint8_t)length;
+    } else {
+        header[used++] = 0x80 | 126;
+        header[used++] = (uint8_t)(length >> 8);
+        header[used++] = (uint8_t)length;
+    }
+    uint32_t maskKey = esp_random();
+    uint8_t* mask = &header[used];
+    memcpy(mask, &maskKey, 4);
+    used += 4;
+    streamClient.write(header, used);
+    
+    uint8_t chunk[64];
+    for (size_t offset = 0; offset < length; offset += sizeof(chunk)) {
+        size_t n = min(sizeof(chunk), length - offset);
+        for (size_t i = 0; i < n; i++) chunk[i] = payload[offset + i] ^ mask[(offset + i) & 3];
+        streamClient.write(chunk, n);
+    }
+}
+
+static void streamConnect(unsigned long now) {
+    String host;
+    String path;
+    uint16_t port;
+    if (!streamParseUrl(streamUrl, host, port, path)) {
+        Serial.printf("Price stream: bad url '%s' (only ws:// is supported)\n", streamUrl);
+        streamEnabled = false;
+        streamSetState(STREAM_OFF, now);
+        return;
+    }
+    
+    if (!streamClient.connect(host.c_str(), port)) {
+        streamBackoff = min(streamBackoff * 2, STREAM_BACKOFF_MAX);
+        streamClose(now, "connect failed");
+        return;
+    }
+    streamClient.setNoDelay(true);
+    
+    // کلید: base64 شانزده بایت تصادفی (قابل چاپ تا از String بگذرد)
+    char nonce[17];
+    for (int i = 0; i < 16; i++) nonce[i] = 'A' + (esp_random() % 26);
+    nonce[16] = '\0';
+    
+    String request = "GET " + path + " HTTP/1.1\r\n";
+    request += "Host: " + host + ":" + String(port) + "\r\n";
+    request += "Upgrade: websocket\r\nConnection: Upgrade\r\n";
+    request += "Sec-WebSocket-Key: " + base64Encode(String(nonce)) + "\r\n";
+    request += "Sec-WebSocket-Version: 13\r\n\r\n";
+    streamClient.print(request);
+    
+    streamRxLength = 0;
+    streamLastRx = now;
+    streamSetState(STREAM_HANDSHAKE, now);
+}
+
+// فهرست یکتای نمادهای همه slot های فعال؛ با تغییر hash دوباره subscribe می‌شود
+static void streamSubscribe(bool force) {
+    uint32_t hashes[STREAM_MAX_SYMBOLS];
+    const char* symbols[STREAM_MAX_SYMBOLS];
+    int count = 0;
+    bool truncated = false;
+    uint32_t listHash = 2166136261UL;
+    
+    for (int m = 0; m < portfolioCount; m++) {
+        PortfolioSlot* slot = &portfolios[m];
+        if (!slot->enabled) continue;
+        for (int i = 0; i < slot->count; i++) {
+            const char* symbol = slot->data[i].symbol;
+            uint32_t hash = 2166136261UL;
+            for (int c = 0; c < 16 && symbol[c]; c++) hash = (hash ^ (uint8_t)symbol[c]) * 16777619UL;
+            
+            bool seen = false;
+            for (int j = 0; j < count && !seen; j++) seen = hashes[j] == hash && strcmp(symbols[j], symbol) == 0;
+            if (seen) continue;
+            if (count == STREAM_MAX_SYMBOLS) {
+                truncated = true;
+                continue;
+            }
+            hashes[count] = hash;
+            symbols[count] = symbol;
+            count++;
+            listHash = (listHash ^ hash) * 16777619UL;
+        }
+    }
+    
+    if (!force && listHash == streamSymbolsHash) return;
+    
+    DynamicJsonDocument doc(256 + 24 * STREAM_MAX_SYMBOLS);
+    doc["op"] = "subscribe";
+    JsonArray list = doc.createNestedArray("symbols");
+    for (int i = 0; i < count; i++) list.add(symbols[i]);
+    String message;
+    serializeJson(doc, message);
+    streamSend(WS_OP_TEXT, (const uint8_t*)message.c_str(), message.length());
+    
+    if (truncated && !streamTruncated) {
+        Serial.printf("Price stream: more than %d symbols, the rest stay on price polling\n", STREAM_MAX_SYMBOLS);
+    }
+    streamSymbolsHash = listHash;
+    streamSymbolCount = count;
+    streamTruncated = truncated;
+}
+
+static void streamHandleText(const uint8_t* payload, size_t length, unsigned long rxMicros) {
+    DynamicJsonDocument doc(STREAM_JSON_CAPACITY);
+    if (deserializeJson(doc, (const char*)payload, length)) {
+        streamStats.dropped++;
+        return;
+    }
+    
+    JsonArray ticks = doc["ticks"];
+    if (!ticks.isNull()) {
+        for (JsonObject tick : ticks) {
+            const char* symbol = tick["s"] | "";
+            Money price = moneyFromJson(tick["p"]);
+            if (symbol[0] != '\0' && price > 0) streamApplyTick(symbol, price, tick["id"] | -1L, rxMicros);
+        }
+        return;
+    }
+    
+    const char* symbol = doc["s"] | "";
+    Money price = moneyFromJson(doc["p"]);
+    if (symbol[0] != '\0' && price > 0) streamApplyTick(symbol, price, doc["id"] | -1L, rxMicros);
+}
+
+// frame های کامل بافر را پردازش می‌کند؛ false یعنی اتصال باید بسته شود
+static bool streamProcessFrames(unsigned long now, unsigned long rxMicros) {
+    size_t offset = 0;
+    bool keep = true;
+    
+    while (keep && streamRxLength - offset >= 2) {
+        uint8_t* frame = streamRx + offset;
+        size_t available = streamRxLength - offset;
+        bool fin = frame[0] & 0x80;
+        uint8_t opcode = frame[0] & 0x0F;
+        bool masked = frame[1] & 0x80;
+        uint64_t length = frame[1] & 0x7F;
+        size_t header = 2;
+        
+        if (length == 126) {
+            if (available < 4) break;
+            length = ((uint64_t)frame[2] << 8) | frame[3];
+            header = 4;
+        } else if (length == 127) {
+            if (available < 10) break;
+            length = 0;
+            for (int i = 0; i < 8; i++) length = (length << 8) | frame[2 + i];
+            header = 10;
+            if (length >> 63) {                 // RFC 6455: بیت بالای طول 64 بیتی باید صفر باشد
+                streamClose(now, "bad frame length");
+                return false;
+            }
+        }
+        if (masked) header += 4;
+        // بدون جمع (header + length) تا طول نزدیک 2^64 سرریز نکند و از بررسی رد نشود
+        if (length > STREAM_FRAME_MAX - header) {
+            streamClose(now, "frame too large");
+            return false;
+        }
+        if (available < header + length) break;
+        
+        uint8_t* payload = frame + header;
+        if (masked) {
+            for (size_t i = 0; i < length; i++) payload[i] ^= frame[header - 4 + (i & 3)];
+        }
+        
+        switch (opcode) {
+            case WS_OP_TEXT:
+                if (fin) streamHandleText(payload, (size_t)length, rxMicros);
+                else streamStats.dropped++;
+                break;
+            case WS_OP_PING:
+                streamSend(WS_OP_PONG, payload, (size_t)length);
+                break;
+            case WS_OP_PONG:
+                break;
+            case WS_OP_CLOSE:
+                streamSend(WS_OP_CLOSE, NULL, 0);
+                streamClose(now, "closed by server");
+                return false;
+            default:
+                streamStats.dropped++;     // continuation / binary
+                break;
+        }
+        offset += header + (size_t)length;
+    }
+    
+    if (offset > 0) {
+        memmove(streamRx, streamRx + offset, streamRxLength - offset);
+        streamRxLength -= offset;
+    }
+    return true;
+}
+
+static bool streamReadHandshake(unsigned long now) {
+    streamRx[streamRxLength] = '\0';
+    char* end = strstr((char*)streamRx, "\r\n\r\n");
+    if (end == NULL) {
+        if (streamRxLength >= STREAM_FRAME_MAX || now - streamStateSince > STREAM_HANDSHAKE_TIMEOUT) {
+            streamBackoff = min(streamBackoff * 2, STREAM_BACKOFF_MAX);
+            streamClose(now, "handshake timeout");
+        }
+        return false;
+    }
+    
+    if (strncmp((char*)streamRx, "HTTP/1.1 101", 12) != 0) {
+        streamBackoff = min(streamBackoff * 2, STREAM_BACKOFF_MAX);
+        streamClose(now, "upgrade refused");
+        return false;
+    }
+    
+    // بایت‌های بعد از هدر اولین frame ها هستند
+    size_t used = (end + 4) - (char*)streamRx;
+    memmove(streamRx, streamRx + used, streamRxLength - used);
+    streamRxLength -= used;
+    
+    streamStats.connects++;
+    streamBackoff = STREAM_BACKOFF_MIN;
+    streamLastPing = now;
+    streamSetState(STREAM_OPEN, now);
+    streamSubscribe(true);
+    return true;
+}
+
+// از loop در هر دور؛ بدون داده جدید فقط چند مقایسه است
+void streamService(unsigned long now) {
+    if (streamConfigChanged) {
+        streamConfigChanged = false;
+        streamBackoff = STREAM_BACKOFF_MIN;
+        streamClose(now, "configuration changed");
+        if (streamState == STREAM_BACKOFF) streamStateSince = now - streamBackoff;
+    }
+    
+    if (!streamEnabled || !isConnectedToWiFi || streamUrl[0] == '\0') {
+        if (streamState != STREAM_OFF) streamClose(now, "disabled");
+        return;
+    }
+    
+    if (streamState == STREAM_OFF || (streamState == STREAM_BACKOFF && now - streamStateSince >= streamBackoff)) {
+        streamConnect(now);
+        return;
+    }
+    if (streamState == STREAM_BACKOFF) return;
+    
+    if (!streamClient.connected()) {
+        streamClose(now, "connection lost");
+        return;
+    }
+    
+    bool received = false;
+    while (streamRxLength < STREAM_FRAME_MAX && streamClient.available() > 0) {
+        int c = streamClient.read();
+        if (c < 0) break;
+        streamRx[streamRxLength++] = (uint8_t)c;
+        received = true;
+    }
+    unsigned long rxMicros = micros();
+    if (received) streamLastRx = now;
+    
+    if (streamState == STREAM_HANDSHAKE) {
+        if (!streamReadHandshake(now)) return;
+    }
+    if (streamRxLength > 0 && !streamProcessFrames(now, rxMicros)) return;
+    
+    // keepalive: سکوت طولانی یعنی اتصال مرده (مثلاً NAT)
+    if (now - streamLastRx > STREAM_IDLE_TIMEOUT) {
+        streamClose(now, "idle timeout");
+        return;
+    }
+    if (now - streamLastRx > STREAM_PING_INTERVAL && now - streamLastPing > STREAM_PING_INTERVAL) {
+        streamSend(WS_OP_PING, NULL, 0);
+        streamLastPing = now;
+    }
+    
+    // جمع‌بندی و SSE پورتفوهای تیک خورده با حداکثر نرخ STREAM_SUMMARY_INTERVAL
+    if (now - streamLastSummary >= STREAM_SUMMARY_INTERVAL) {
+        streamLastSummary = now;
+        symbolFlushDirty();
+        streamSubscribe(false);
+    }
+}
+
+// تیک یک نماد: فقط پوزیشن‌های همان نماد (وابسته‌های جدول قیمت نمادها) به‌روز و بررسی می‌شوند
+void streamApplyTick(const char* symbol, Money price, long tickId, unsigned long rxMicros) {
+    streamStats.ticks++;
+    uint16_t id = symbolFind(symbol);
+    if (id == SYMBOL_NONE) return;
+    
+    // حذف slot در تسک وب جدول را از نو می‌سازد، پس وابسته‌ها زیر قفل پیمایش می‌شوند (mutex بازگشتی است)
+    lockData();
+    if (symbolPriceSet(id, price, millis(), -1) == 0) {
+        unlockData();
+        return;
+    }
+    streamStats.matched++;
+    
+    const SymbolPrice* entry = &symbolTable[id];
+    for (int d = 0; d < entry->dependentCount; d++) {
+        const SymbolDependent* dependent = &symbolDependents[entry->firstDependent + d];
+        if (!portfolios[dependent->mode].enabled) continue;
+        unsigned long buzzerBefore = buzzerStartMicros;
+        if (!checkPositionAlert(dependent->mode, dependent->row)) continue;
+        alertDispatchService(millis());
+        
+        // بازر خاموش یا آلرت در صف (بخش ALERT DISPATCHER): تا ثبت آلرت (تاریخچه / SSE)
+        unsigned long firedAt = buzzerStartMicros != buzzerBefore ? buzzerStartMicros : micros();
+        uint32_t latency = (uint32_t)(firedAt - rxMicros);
+        streamStats.latencyUs[streamStats.latencyHead] = latency;
+        streamStats.latencyHead = (streamStats.latencyHead + 1) % STREAM_LATENCY_WINDOW;
+        if (streamStats.latencyCount < STREAM_LATENCY_WINDOW) streamStats.latencyCount++;
+        streamStats.alerts++;
+        streamStats.lastAlertTickId = tickId;
+        Serial.printf("Stream alert %s (tick %ld): %lu us from tick to buzzer\n", symbol, tickId, (unsigned long)latency);
+    }
+    unlockData();
+}
+
+uint32_t streamLatencyPercentile(int percentile) {
+    int count = streamStats.latencyCount;
+    if (count == 0) return 0;
+    uint32_t sorted[STREAM_LATENCY_WINDOW];
+    memcpy(sorted, streamStats.latencyUs, sizeof(uint32_t) * count);
+    for (int i = 1; i < count; i++) {
+        uint32_t value = sorted[i];
+        int j = i - 1;
+        while (j >= 0 && sorted[j] > value) {
+            sorted[j + 1] = sorted[j];
+            j--;
+        }
+        sorted[j + 1] = value;
+    }
+    return sorted[(count * percentile + 99) / 100 - 1];
+}
+
+// GET /api/v1/stream - تنظیمات، وضعیت اتصال و تأخیر تیک تا بازر
+void handleApiStream() {
+    DynamicJsonDocument doc(1024);
+    unsigned long now = millis();
+    
+    doc["enabled"] = streamEnabled;
+    doc["url"] = streamUrl;
+    doc["state"] = streamStateNames[streamState];
+    doc["stateFor"] = now - streamStateSince;
+    doc["symbols"] = streamSymbolCount;
+    doc["truncated"] = streamTruncated;
+    doc["ticks"] = streamStats.ticks;
+    doc["matched"] = streamStats.matched;
+    doc["alerts"] = streamStats.alerts;
+    doc["connects"] = streamStats.connects;
+    doc["dropped"] = streamStats.dropped;
+    doc["lastAlertTickId"] = streamStats.lastAlertTickId;
+    JsonObject latency = doc.createNestedObject("latencyUs");
+    latency["count"] = streamStats.latencyCount;
+    latency["p50"] = streamLatencyPercentile(50);
+    latency["p95"] = streamLatencyPercentile(95);
+    latency["max"] = streamLatencyPercentile(100);
+    
+    String json;
+    serializeJson(doc, json);
+    server.send(200, "application/json", json);
+}
+
+// POST /api/v1/stream?url=ws://host:port/path&enabled=0|1
+void handleApiStreamUpdate() {
+    if (server.hasArg("url")) {
+        String url = server.arg("url");
+        url.trim();
+        String host;
+        String path;
+        uint16_t port;
+        if (url.length() > 0 && (url.length() >= sizeof(streamUrl) || !streamParseUrl(url.c_str(), host, port, path))) {
+            server.send(400, "application/json", "{\"success\":false,\"error\":\"bad url (ws:// only)\"}");
+            return;
+        }
+        strncpy(streamUrl, url.c_str(), sizeof(streamUrl) - 1);
+        streamUrl[sizeof(streamUrl) - 1] = '\0';
+    }
+    if (server.hasArg("enabled")) {
+        streamEnabled = server.arg("enabled") != "0" && server.arg("enabled") != "false";
+    }
+    streamConfigChanged = true;
+    
+    bool saved = streamSave();
+    server.send(saved ? 200 : 500, "application/json", saved ? "{\"success\":true}" : "{\"success\":false,\"error\":\"save failed\"}");
+}
+
+// ===== INCREMENTAL SUMMARY =====
+// هر refresh معمولاً فقط چند ردیف را تغییر می‌دهد؛ به جای اسکن همه پوزیشن‌ها
+// سهم ردیف قدیمی کم و سهم ردیف جدید اضافه می‌شود.
+void aggregateApply(PortfolioAggregate* agg, const CryptoPosition* pos, int sign) {
+    agg->totalValue += sign * moneyMul(pos->currentPrice, pos->quantity);
+    agg->totalPnl += sign * pos->pnlValue;
+    
+    if (pos->isLong) agg->longCount += sign;
+    else agg->shortCount += sign;
+    
+    if (pos->changePercent >= 0) agg->winningCount += sign;
+    else agg->losingCount += sign;
+}
+
+void aggregateFindWorst(PortfolioAggregate* agg, const CryptoPosition* data, int count) {
+    agg->worstPercent = 0;
+    agg->worstSymbol[0] = '\0';
+    agg->worstIsLong = true;
+    
+    for (int i = 0; i < count; i++) {
+        if (data[i].changePercent < agg->worstPercent) {
+            agg->worstPercent = data[i].changePercent;
+            strncpy(agg->worstSymbol, data[i].symbol, sizeof(agg->worstSymbol));
+            agg->worstIsLong = data[i].isLong;
+        }
+    }
+}
+
+void aggregateRebuild(PortfolioAggregate* agg, const CryptoPosition* data, int count) {
+    memset(agg, 0, sizeof(PortfolioAggregate));
+    for (int i = 0; i < count; i++) {
+        aggregateApply(agg, &data[i], 1);
+    }
+    aggregateFindWorst(agg, data, count);
+    agg->valid = true;
+}
+
+bool samePosition(const CryptoPosition* a, const CryptoPosition* b) {
+    return a->isLong == b->isLong && strncmp(a->symbol, b->symbol, 16) == 0;
+}
+
+bool positionChanged(const CryptoPosition* a, const CryptoPosition* b) {
+    return a->currentPrice != b->currentPrice || a->quantity != b->quantity ||
+           a->pnlValue != b->pnlValue || a->changePercent != b->changePercent;
+}
+
+bool isWorstPosition(const PortfolioAggregate* agg, const CryptoPosition* pos) {
+    return agg->worstIsLong == pos->isLong && strncmp(agg->worstSymbol, pos->symbol, 16) == 0;
+}
+
+// قیمت تازه یک ردیف زنده (stream یا جدول قیمت نمادها)، داخل lockData
+void aggregateUpdatePrice(byte mode, int row, Money price) {
+    PortfolioSlot* slot = &portfolios[mode];
+    PortfolioAggregate* agg = &slot->aggregate;
+    CryptoPosition* pos = &slot->data[row];
+    float oldPercent = pos->changePercent;
+    bool wasWorst = agg->valid && isWorstPosition(agg, pos);
+    
+    if (agg->valid) aggregateApply(agg, pos, -1);
+    positionApplyPrice(pos, price);
+    if (agg->valid) {
+        aggregateApply(agg, pos, 1);
+        if (pos->changePercent < agg->worstPercent) {
+            agg->worstPercent = pos->changePercent;
+            strncpy(agg->worstSymbol, pos->symbol, sizeof(agg->worstSymbol));
+            agg->worstIsLong = pos->isLong;
+        } else if (wasWorst && pos->changePercent > oldPercent) {
+            aggregateFindWorst(agg, slot->data, slot->count);
+        }
+    }
+    slot->hot[row].changePercent = pos->changePercent;
+    pos->ruleDirty = true;
+    dataVersion++;
+}
+
+// باید داخل lockData و قبل از کپی newData روی آرایه زنده فراخوانی شود؛ تعداد ردیف‌های تغییر کرده را برمی‌گرداند
+int aggregateMerge(byte mode, CryptoPosition* newData, int newCount) {
+    PortfolioAggregate* agg = &portfolios[mode].aggregate;
+    const CryptoPosition* oldData = portfolios[mode].data;
+    PositionHot* oldHot = portfolios[mode].hot;
+    int oldCount = portfolios[mode].count;
+    
+    if (!agg->valid) {
+        aggregateRebuild(agg, newData, newCount);
+        for (int i = 0; i < newCount; i++) newData[i].ruleDirty = true;
+        agg->lastChangedRows = newCount;
+        return newCount;
+    }
+    
+    for (int j = 0; j < oldCount; j++) oldHot[j].matched = false;
+    
+    int changed = 0;
+    bool rescanWorst = false;
+    
+    for (int i = 0; i < newCount; i++) {
+        CryptoPosition* pos = &newData[i];
+        uint32_t key = positionKey(pos);
+        
+        // ترتیب پوزیشن‌ها معمولاً ثابت است؛ اول همان ایندکس بررسی می‌شود.
+        // کلیدها در RAM داخلی مقایسه می‌شوند و فقط کاندیدها از PSRAM خوانده می‌شوند.
+        int match = -1;
+        if (i < oldCount && !oldHot[i].matched && oldHot[i].key == key && samePosition(&oldData[i], pos)) {
+            match = i;
+        } else {
+            for (int j = 0; j < oldCount; j++) {
+                if (!oldHot[j].matched && oldHot[j].key == key && samePosition(&oldData[j], pos)) {
+                    match = j;
+                    break;
+                }
+            }
+        }
+        
+        // وضعیت قوانین آلرت با پوزیشن می‌ماند؛ فقط ردیف‌های تغییر کرده دوباره ارزیابی می‌شوند
+        pos->ruleDirty = true;
+        if (match >= 0) {
+            oldHot[match].matched = true;
+            pos->ruleLatch = oldData[match].ruleLatch;
+            pos->lossSince = oldData[match].lossSince;
+            if (!positionChanged(&oldData[match], pos)) {
+                pos->ruleDirty = oldData[match].ruleDirty;
+                continue;
+            }
+            aggregateApply(agg, &oldData[match], -1);
+            
+            // بدترین پوزیشن بهتر شد؛ شاید دیگری بدترین باشد
+            if (pos->changePercent > oldData[match].changePercent && isWorstPosition(agg, pos)) {
+                rescanWorst = true;
+            }
+        }
+        
+        aggregateApply(agg, pos, 1);
+        changed++;
+        
+        if (pos->changePercent < agg->worstPercent) {
+            agg->worstPercent = pos->changePercent;
+            strncpy(agg->worstSymbol, pos->symbol, sizeof(agg->worstSymbol));
+            agg->worstIsLong = pos->isLong;
+        }
+    }
+    
+    // پوزیشن‌های بسته شده
+    for (int j = 0; j < oldCount; j++) {
+        if (oldHot[j].matched) continue;
+        aggregateApply(agg, &oldData[j], -1);
+        changed++;
+        if (isWorstPosition(agg, &oldData[j])) rescanWorst = true;
+    }
+    
+    if (rescanWorst) aggregateFindWorst(agg, newData, newCount);
+    
+    agg->updatesSinceFull++;
+    agg->lastChangedRows = changed;
+    return changed;
+}
+
+// جمع دو مود برای نمایشگر؛ داخل lockData
+void updateCombinedTotals() {
+    combinedValue = 0;
+    combinedInvestment = 0;
+    for (int i = 0; i < portfolioCount; i++) {
+        combinedValue += portfolios[i].summary.totalCurrentValue;
+        combinedInvestment += portfolios[i].summary.totalInvestment;
+    }
+    combinedPnlPercent = combinedInvestment > 0 ?
+        moneyRatio(combinedValue - combinedInvestment, combinedInvestment) * 100 : 0;
+}
+
+// ===== RISK STATISTICS =====
+// بازده هر refresh برای هر مود (تغییر P/L نسبت به سرمایه) و هر نماد (تغییر قیمت در جهت پوزیشن).
+// واریانس با Welford از زمان reset، Sharpe/Sortino با میانگین نمایی روی حدود RISK_ROLLING_WINDOW نمونه،
+// و drawdown روی شاخص بازده تجمعی تا ورود/خروج پوزیشن‌ها آن را جابجا نکند.
+SymbolRisk symbolRisk[RISK_MAX_SYMBOLS];
+int symbolRiskCount = 0;
+
+void riskReset(RiskStats* stats, uint32_t time) {
+    memset(stats, 0, sizeof(RiskStats));
+    stats->index = 1.0;
+    stats->peakIndex = 1.0;
+    stats->resetTime = time;
+}
+
+void riskUpdate(RiskStats* stats, float ret, uint32_t time) {
+    float interval = (stats->lastTime > 0 && time > stats->lastTime) ?
+        (float)(time - stats->lastTime) : DATA_UPDATE_INTERVAL / 1000.0;
+    
+    stats->samples++;
+    float delta = ret - stats->mean;
+    stats->mean += delta / stats->samples;
+    stats->m2 += delta * (ret - stats->mean);
+    
+    float downside = ret < 0 ? ret * ret : 0;
+    if (stats->samples == 1) {
+        stats->ewMean = ret;
+        stats->ewVar = 0;
+        stats->ewDownside = downside;
+        stats->ewInterval = interval;
+    } else {
+        float diff = ret - stats->ewMean;
+        stats->ewMean += RISK_EW_ALPHA * diff;
+        stats->ewVar = (1 - RISK_EW_ALPHA) * (stats->ewVar + RISK_EW_ALPHA * diff * diff);
+        stats->ewDownside += RISK_EW_ALPHA * (downside - stats->ewDownside);
+        stats->ewInterval += RISK_EW_ALPHA * (interval - stats->ewInterval);
+    }
+    
+    stats->index *= (1 + ret);
+    if (stats->index > stats->peakIndex) stats->peakIndex = stats->index;
+    stats->drawdown = (stats->index / stats->peakIndex - 1) * 100;
+    if (stats->drawdown < stats->maxDrawdown) stats->maxDrawdown = stats->drawdown;
+}
+
+float riskAnnualize(const RiskStats* stats) {
+    return stats->ewInterval > 0 ? sqrtf(RISK_SECONDS_PER_YEAR / stats->ewInterval) : 0;
+}
+
+float riskVolatility(const RiskStats* stats) {
+    if (stats->samples < 2) return 0;
+    return sqrtf(stats->m2 / (stats->samples - 1)) * riskAnnualize(stats) * 100;
+}
+
+float riskSharpe(const RiskStats* stats) {
+    if (stats->ewVar <= 0) return 0;
+    return stats->ewMean / sqrtf(stats->ewVar) * riskAnnualize(stats);
+}
+
+float riskSortino(const RiskStats* stats) {
+    if (stats->ewDownside <= 0) return 0;
+    return stats->ewMean / sqrtf(stats->ewDownside) * riskAnnualize(stats);
+}
+
+// باید داخل lockData فراخوانی شود
+RiskStats* riskUpdatePortfolio(byte mode, const PortfolioSummary* summary, uint32_t time) {
+    RiskStats* stats = &portfolios[mode].risk;
+    if (stats->resetTime == 0) riskReset(stats, time);
+    
+    // با تغییر تعداد پوزیشن‌ها P/L پرش می‌کند؛ آن نمونه فقط مبنای بعدی است
+    if (stats->lastTime > 0 && time > stats->lastTime &&
+        stats->lastCount == summary->totalPositions && summary->totalInvestment > 0) {
+        riskUpdate(stats, moneyRatio(summary->totalPnl - stats->lastPnl, summary->totalInvestment), time);
+    }
+    
+    stats->lastPnl = summary->totalPnl;
+    stats->lastCount = summary->totalPositions;
+    stats->lastTime = time;
+    return stats;
+}
+
+// باید داخل lockData فراخوانی شود. کلید (نماد، جهت) است: نمادی که در یک slot لانگ و در
+// slot دیگر شورت است دو ردیف جدا دارد و آمار هیچ‌کدام با publish دیگری reset نمی‌شود
+void riskRecordSymbol(const char* symbol, float price, bool isLong, uint32_t time) {
+    if (price <= 0) return;
+    
+    SymbolRisk* entry = NULL;
+    for (int i = 0; i < symbolRiskCount; i++) {
+        if (symbolRisk[i].isLong == isLong && strncmp(symbolRisk[i].symbol, symbol, 15) == 0) {
+            entry = &symbolRisk[i];
+            break;
+        }
+    }
+    
+    if (entry == NULL) {
+        if (symbolRiskCount >= RISK_MAX_SYMBOLS) return;
+        entry = &symbolRisk[symbolRiskCount++];
+        strncpy(entry->symbol, symbol, 15);
+        entry->symbol[15] = '\0';
+        entry->isLong = isLong;
+        riskReset(&entry->stats, time);
+    }
+    
+    RiskStats* stats = &entry->stats;
+    if (stats->lastTime > 0 && time > stats->lastTime && stats->lastValue > 0) {
+        float ret = price / stats->lastValue - 1;
+        riskUpdate(stats, isLong ? ret : -ret, time);
+    }
+    
+    if (time >= stats->lastTime) {
+        stats->lastValue = price;
+        stats->lastTime = time;
+    }
+}
+
+void addRiskFields(JsonObject obj, const RiskStats* stats) {
+    obj["samples"] = stats->samples;
+    obj["since"] = stats->resetTime;
+    obj["drawdown"] = stats->drawdown;
+    obj["maxDrawdown"] = stats->maxDrawdown;
+    obj["volatility"] = riskVolatility(stats);
+    obj["sharpe"] = riskSharpe(stats);
+    obj["sortino"] = riskSortino(stats);
+}
+
+// /api/v1/risk - آمار ریسک هر مود و هر نماد (هر جهت جدا)
+void handleApiRisk() {
+    DynamicJsonDocument doc(1024 + RISK_MAX_SYMBOLS * 192);
+    
+    lockData();
+    for (int i = 0; i < portfolioCount; i++) {
+        addRiskFields(doc.createNestedObject(portfolioKey(i)), &portfolios[i].risk);
+    }
+    
+    JsonArray symbols = doc.createNestedArray("symbols");
+    for (int i = 0; i < symbolRiskCount; i++) {
+        JsonObject obj = symbols.createNestedObject();
+        obj["symbol"] = symbolRisk[i].symbol;
+        obj["side"] = symbolRisk[i].isLong ? "LONG" : "SHORT";
+        addRiskFields(obj, &symbolRisk[i].stats);
+    }
+    unlockData();
+    
+    String json;
+    serializeJson(doc, json);
+    server.send(200, "application/json", json);
+}
+
+// POST /api/v1/risk/reset?mode=entry|exit|p2..|all - نقطه شروع جدید برای drawdown و آمار
+void handleApiRiskReset() {
+    String modeArg = server.arg("mode");
+    bool all = modeArg == "all" || modeArg.length() == 0;
+    uint32_t now = tsNow();
+    
+    lockData();
+    for (int i = 0; i < portfolioCount; i++) {
+        if (all || i == portfolioFromArg(modeArg, -1)) riskReset(&portfolios[i].risk, now);
+    }
+    if (all) {
+        for (int i = 0; i < symbolRiskCount; i++) riskReset(&symbolRisk[i].stats, now);
+    }
+    unlockData();
+    
+    Serial.println("Risk statistics reset (" + (modeArg.length() > 0 ? modeArg : String("all")) + ")");
+    server.send(200, "application/json", "{\"success\":true}");
+}
+
+// ===== PRICE TIME-SERIES STORE =====
+// برای هر نماد: نمونه‌های خام (هر refresh) + کندل‌های OHLC یک دقیقه، 15 دقیقه و یک ساعته.
+// نمونه‌های خام با کدک Gorilla در بلوک‌های 256 بایتی فشرده می‌شوند (~30 بیت به جای 96).
+// همه در ring buffer های PSRAM با اندازه ثابت؛ حافظه هر نماد حدود 44KB است.
+// query کندل آماده را برمی‌گرداند و نیازی به اسکن نمونه‌های خام نیست.
+#define TS_MAX_SYMBOLS 64
+#define TS_RAW_BLOCKS 100      // ~58 نمونه در هر بلوک → ~24h با poll هر 15 ثانیه
+#define TS_M1_BARS 240         // 4h
+#define TS_M15_BARS 192        // 2 days
+#define TS_H1_BARS 336         // 2 weeks
+#define TS_SPARKLINE_MAX 48
+
+const uint16_t tsTierCapacity[TS_TIER_COUNT] = { TS_M1_BARS, TS_M15_BARS, TS_H1_BARS };
+const uint32_t tsTierPeriod[TS_TIER_COUNT] = { 60, 900, 3600 };
+const char* const tsResolutionNames[] = { "raw", "1m", "15m", "1h" };
+
+TSSeries* tsSeries[TS_MAX_SYMBOLS];
+int tsSeriesCount = 0;
+size_t tsMemoryUsed = 0;
+bool tsEnabled = false;
+unsigned long tsLastSparklineMicros = 0;
+
+void setupTimeSeries() {
+    tsEnabled = psramFound();
+    if (tsEnabled) {
+        Serial.println("Price history enabled (PSRAM, up to " + String(TS_MAX_SYMBOLS) + " symbols)");
+    } else {
+        Serial.println("⚠️ No PSRAM - price history disabled");
+    }
+}
+
+// epoch اگر NTP همگام باشد، وگرنه ثانیه uptime
+uint32_t tsNow() {
+    time_t now = time(nullptr);
+    return now > 1600000000 ? (uint32_t)now : millis() / 1000;
+}
+
+TSSeries* tsFindSeries(const char* symbol, bool create) {
+    for (int i = 0; i < tsSeriesCount; i++) {
+        if (strncmp(tsSeries[i]->symbol, symbol, 15) == 0) return tsSeries[i];
+    }
+    
+    if (!create || !tsEnabled || tsSeriesCount >= TS_MAX_SYMBOLS) return NULL;
+    
+    size_t barCount = 0;
+    for (int t = 0; t < TS_TIER_COUNT; t++) barCount += tsTierCapacity[t];
+    size_t bytes = sizeof(TSSeries) + sizeof(TSBlock) * TS_RAW_BLOCKS + sizeof(TSBar) * barCount;
+    
+    // یک بلوک پیوسته برای هر نماد
+    uint8_t* block = (uint8_t*)ps_calloc(1, bytes);
+    if (block == NULL) return NULL;
+    
+    TSSeries* series = (TSSeries*)block;
+    strncpy(series->symbol, symbol, 15);
+    series->symbol[15] = '\0';
+    series->blocks = (TSBlock*)(block + sizeof(TSSeries));
+    
+    TSBar* bars = (TSBar*)(block + sizeof(TSSeries) + sizeof(TSBlock) * TS_RAW_BLOCKS);
+    for (int t = 0; t < TS_TIER_COUNT; t++) {
+        series->tiers[t].bars = bars;
+        series->tiers[t].capacity = tsTierCapacity[t];
+        series->tiers[t].period = tsTierPeriod[t];
+        bars += tsTierCapacity[t];
+    }
+    
+    tsSeries[tsSeriesCount++] = series;
+    tsMemoryUsed += bytes;
+    return series;
+}
+
+void tsPushBar(TSTier* tier, const TSBar* bar) {
+    tier->bars[tier->head] = *bar;
+    tier->head = (tier->head + 1) % tier->capacity;
+    if (tier->count < tier->capacity) tier->count++;
+}
+
+void tsAppendRaw(TSSeries* series, const TSSample* sample) {
+    if (series->blockCount == 0) {
+        series->blockHead = 0;
+        series->blockCount = 1;
+        tsBlockReset(&series->blocks[0]);
+    }
+    
+    if (!tsBlockAppend(&series->blocks[series->blockHead], sample)) {
+        // بلوک پر شد: قدیمی‌ترین بلوک بازنویسی می‌شود
+        series->blockHead = (series->blockHead + 1) % TS_RAW_BLOCKS;
+        if (series->blockCount < TS_RAW_BLOCKS) series->blockCount++;
+        tsBlockReset(&series->blocks[series->blockHead]);
+        tsBlockAppend(&series->blocks[series->blockHead], sample);
+    }
+}
+
+void tsRecord(const char* symbol, float price, float changePercent, uint32_t time) {
+    if (price <= 0) return;
+    
+    TSSeries* series = tsFindSeries(symbol, true);
+    if (series == NULL) return;
+    
+    // یک نماد در هر دو مود: نمونه با همان زمان جایگزین می‌شود،
+    // برای همین آخرین نمونه تا رسیدن زمان بعدی فشرده نمی‌شود
+    if (series->hasPending && series->pending.time == time) {
+        series->pending.price = price;
+        series->pending.changePercent = changePercent;
+    } else {
+        if (series->hasPending) tsAppendRaw(series, &series->pending);
+        series->pending.time = time;
+        series->pending.price = price;
+        series->pending.changePercent = changePercent;
+        series->hasPending = true;
+    }
+    
+    for (int t = 0; t < TS_TIER_COUNT; t++) {
+        TSTier* tier = &series->tiers[t];
+        uint32_t bucket = time - (time % tier->period);
+        
+        if (tier->hasCurrent && tier->current.time != bucket) {
+            tsPushBar(tier, &tier->current);
+            tier->hasCurrent = false;
+        }
+        
+        if (!tier->hasCurrent) {
+            tier->current.time = bucket;
+            tier->current.open = price;
+            tier->current.high = price;
+            tier->current.low = price;
+            tier->current.samples = 0;
+            tier->hasCurrent = true;
+        }
+        
+        if (price > tier->current.high) tier->current.high = price;
+        if (price < tier->current.low) tier->current.low = price;
+        tier->current.close = price;
+        tier->current.samples++;
+    }
+}
+
+void tsReverseBars(TSBar* bars, int first, int last) {
+    while (first < last) {
+        TSBar temp = bars[first];
+        bars[first++] = bars[last];
+        bars[last--] = temp;
+    }
+}
+
+int tsOldestBlock(const TSSeries* series) {
+    return (series->blockHead - series->blockCount + 1 + TS_RAW_BLOCKS) % TS_RAW_BLOCKS;
+}
+
+void tsCollectRawBar(TSBar* out, int maxOut, int* total, const TSSample* sample) {
+    TSBar* bar = &out[*total % maxOut];
+    bar->time = sample->time;
+    bar->open = bar->high = bar->low = bar->close = sample->price;
+    bar->samples = 1;
+    (*total)++;
+}
+
+// نمونه‌های خام در بازه را از بلوک‌ها decode می‌کند؛ out به صورت ring پر می‌شود
+// تا جدیدترین maxOut نمونه بماند. خروجی به ترتیب زمانی است.
+int tsQueryRaw(const TSSeries* series, uint32_t from, uint32_t to, TSBar* out, int maxOut) {
+    int total = 0;
+    TSSample sample;
+    int oldest = tsOldestBlock(series);
+    
+    for (int b = 0; b < series->blockCount; b++) {
+        const TSBlock* block = &series->blocks[(oldest + b) % TS_RAW_BLOCKS];
+        if (block->count == 0 || block->lastTime < from) continue;
+        if (block->startTime > to) break;
+        
+        TSBlockReader reader;
+        tsBlockReaderInit(&reader, block);
+        while (tsBlockNext(&reader, &sample)) {
+            if (sample.time > to) break;
+            if (sample.time >= from) tsCollectRawBar(out, maxOut, &total, &sample);
+        }
+    }
+    
+    if (series->hasPending && series->pending.time >= from && series->pending.time <= to) {
+        tsCollectRawBar(out, maxOut, &total, &series->pending);
+    }
+    
+    if (total <= maxOut) return total;
+    
+    // چرخش ring: قدیمی‌ترین نمونه در out[total % maxOut]
+    int start = total % maxOut;
+    tsReverseBars(out, 0, start - 1);
+    tsReverseBars(out, start, maxOut - 1);
+    tsReverseBars(out, 0, maxOut - 1);
+    return maxOut;
+}
+
+// جدیدترین maxOut کندل در بازه [from, to] به ترتیب زمانی؛ کندل باز فعلی هم شامل می‌شود
+int tsQuery(const char* symbol, byte resolution, uint32_t from, uint32_t to, TSBar* out, int maxOut) {
+    TSSeries* series = tsFindSeries(symbol, false);
+    if (series == NULL || maxOut <= 0) return 0;
+    
+    if (resolution == TS_RES_RAW) return tsQueryRaw(series, from, to, out, maxOut);
+    
+    int n = 0;
+    TSTier* tier = &series->tiers[min((int)resolution, TS_TIER_COUNT) - 1];
+    
+    if (tier->hasCurrent && tier->current.time <= to && tier->current.time + tier->period > from) {
+        out[n++] = tier->current;
+    }
+    for (int i = 0; i < tier->count && n < maxOut; i++) {
+        const TSBar* bar = &tier->bars[(tier->head - 1 - i + tier->capacity) % tier->capacity];
+        if (bar->time > to) continue;
+        if (bar->time + tier->period <= from) break;
+        out[n++] = *bar;
+    }
+    
+    // از جدید→قدیم به قدیم→جدید
+    tsReverseBars(out, 0, n - 1);
+    return n;
+}
+
+// اسپارک‌لاین از نمونه‌های خام: span به points قسمت تقسیم و آخرین قیمت هر قسمت برداشته می‌شود
+int tsRawSparkline(const TSSeries* series, uint32_t from, uint32_t span, float* out, int points) {
+    int first = points;
+    TSSample sample;
+    int oldest = tsOldestBlock(series);
+    
+    for (int i = 0; i < points; i++) out[i] = NAN;
+    
+    for (int b = 0; b <= series->blockCount; b++) {
+        bool isPending = (b == series->blockCount);
+        TSBlockReader reader;
+        
+        if (isPending) {
+            if (!series->hasPending) break;
+            sample = series->pending;
+        } else {
+            const TSBlock* block = &series->blocks[(oldest + b) % TS_RAW_BLOCKS];
+            if (block->count == 0 || block->lastTime < from) continue;
+            tsBlockReaderInit(&reader, block);
+            if (!tsBlockNext(&reader, &sample)) continue;
+        }
+        
+        do {
+            if (sample.time >= from) {
+                int bucket = (int)((uint64_t)(sample.time - from) * points / span);
+                if (bucket >= points) bucket = points - 1;
+                out[bucket] = sample.price;
+                if (bucket < first) first = bucket;
+            }
+        } while (!isPending && tsBlockNext(&reader, &sample));
+    }
+    
+    if (first >= points) return 0;
+    
+    // حذف قسمت‌های خالی ابتدا و پر کردن فاصله‌ها با مقدار قبلی
+    int n = 0;
+    for (int i = first; i < points; i++) {
+        out[n] = isnan(out[i]) ? out[n - 1] : out[i];
+        n++;
+    }
+    return n;
+}
+
+// قیمت‌ها برای اسپارک‌لاین؛ اگر نمونه‌های خام span را پوشش دهند مستقیم decode می‌شوند،
+// وگرنه ریزترین سطح OHLC که span را با حداکثر points کندل پوشش دهد
+int tsSparkline(const char* symbol, uint32_t span, float* out, int points) {
+    TSSeries* series = tsFindSeries(symbol, false);
+    if (series == NULL || points <= 0 || span == 0) return 0;
+    
+    unsigned long startMicros = micros();
+    uint32_t now = tsNow();
+    uint32_t from = now > span ? now - span : 0;
+    int n;
+    
+    if (series->blockCount > 0 && series->blocks[tsOldestBlock(series)].startTime <= from) {
+        n = tsRawSparkline(series, from, span, out, points);
+    } else {
+        byte resolution = TS_RES_1H;
+        for (int t = 0; t < TS_TIER_COUNT; t++) {
+            if (span / tsTierPeriod[t] <= (uint32_t)points &&
+                span <= tsTierPeriod[t] * tsTierCapacity[t]) {
+                resolution = t + 1;
+                break;
+            }
+        }
+        
+        TSBar bars[TS_SPARKLINE_MAX];
+        n = tsQuery(symbol, resolution, from, 0xFFFFFFFF, bars, min(points, TS_SPARKLINE_MAX));
+        for (int i = 0; i < n; i++) out[i] = bars[i].close;
+    }
+    
+    tsLastSparklineMicros = micros() - startMicros;
+    return n;
+}
+
+// ===== UTILITY FUNCTIONS =====
+// نسخه‌های fmt* در بافر ثابت فراخوان می‌نویسند و خود بافر را برمی‌گردانند؛ در مسیرهای
+// تکراری (نمایشگر، هشدار، لاگ) از این‌ها استفاده شود. نسخه‌های String فقط برای HTML هستند.
+const char* fmtShortSymbol(SymbolText& out, const char* symbol) {
+    size_t length = strlen(symbol);
+    
+    if (length > 4 && strcmp(symbol + length - 4, "USDT") == 0) {
+        length -= 4;
+    } else if (length > 5 && strcmp(symbol + length - 5, "_USDT") == 0) {
+        length -= 5;
+    } else if (length > 4 && strcmp(symbol + length - 4, "PERP") == 0) {
+        length -= 4;
+    }
+    
+    if (length > 8) {
+        length = 8;
+    }
+    
+    memcpy(out, symbol, length);
+    out[length] = '\0';
+    return out;
+}
+
+const char* fmtPercent(PercentText& out, float percent) {
+    if (percent > 0) {
+        snprintf(out, sizeof(out), "+%.2f%%", percent);
+    } else if (percent < 0) {
+        snprintf(out, sizeof(out), "%.2f%%", percent);
+    } else {
+        snprintf(out, sizeof(out), "0.00%%");
+    }
+    return out;
+}
+
+const char* fmtNumber(NumberText& out, float number) {
+    float absNumber = fabs(number);
+    
+    if (number == 0) {
+        snprintf(out, sizeof(out), "0");
+    } else if (absNumber >= 1000000) {
+        snprintf(out, sizeof(out), "%.2fM", number / 1000000);
+    } else if (absNumber >= 10000) {
+        snprintf(out, sizeof(out), "%.1fK", number / 1000);
+    } else if (absNumber >= 1000) {
+        snprintf(out, sizeof(out), "%.2fK", number / 1000);
+    } else if (absNumber >= 1) {
+        snprintf(out, sizeof(out), "%.2f", number);
+    } else if (absNumber >= 0.01) {
+        snprintf(out, sizeof(out), "%.4f", number);
+    } else if (absNumber >= 0.0001) {
+        snprintf(out, sizeof(out), "%.6f", number);
+    } else {
+        snprintf(out, sizeof(out), "%.8f", number);
+    }
+    return out;
+}
+
+const char* fmtPrice(NumberText& out, float price) {
+    int decimals;
+    if (price <= 0) {
+        snprintf(out, sizeof(out), "0.00");
+        return out;
+    } else if (price >= 1000) {
+        decimals = 2;
+    } else if (price >= 1) {
+        decimals = 4;
+    } else if (price >= 0.01) {
+        decimals = 6;
+    } else if (price >= 0.0001) {
+        decimals = 8;
+    } else {
+        decimals = 10;
+    }
+    snprintf(out, sizeof(out), "%.*f", decimals, price);
+    return out;
+}
+
+// نسخه‌های دقیق fmtPrice/fmtNumber برای مقادیر Money؛ همان تعداد رقم اعشار
+const char* fmtMoneyPrice(NumberText& out, Money price) {
+    if (price <= 0) {
+        snprintf(out, sizeof(out), "0.00");
+        return out;
+    }
+    
+    int decimals;
+    if (price >= moneyFromInt(1000)) decimals = 2;
+    else if (price >= moneyFromInt(1)) decimals = 4;
+    else if (price >= MONEY_SCALE / 100) decimals = 6;
+    else decimals = 8;
+    
+    moneyFormat(price, decimals, out, sizeof(out));
+    return out;
+}
+
+const char* fmtMoneyNumber(NumberText& out, Money value) {
+    if (value == 0) {
+        snprintf(out, sizeof(out), "0");
+        return out;
+    }
+    
+    Money absValue = llabs(value);
+    int length;
+    
+    if (absValue >= moneyFromInt(1000000)) {
+        length = moneyFormat(moneyDivInt(value, 1000000), 2, out, sizeof(out) - 1);
+        out[length] = 'M';
+        out[length + 1] = '\0';
+        return out;
+    } else if (absValue >= moneyFromInt(10000)) {
+        length = moneyFormat(moneyDivInt(value, 1000), 1, out, sizeof(out) - 1);
+        out[length] = 'K';
+        out[length + 1] = '\0';
+        return out;
+    } else if (absValue >= moneyFromInt(1000)) {
+        length = moneyFormat(moneyDivInt(value, 1000), 2, out, sizeof(out) - 1);
+        out[length] = 'K';
+        out[length + 1] = '\0';
+        return out;
+    }
+    
+    int decimals;
+    if (absValue >= moneyFromInt(1)) decimals = 2;
+    else if (absValue >= MONEY_SCALE / 100) decimals = 4;
+    else if (absValue >= MONEY_SCALE / 10000) decimals = 6;
+    else decimals = 8;
+    
+    moneyFormat(value, decimals, out, sizeof(out));
+    return out;
+}
+
+String getShortSymbol(const char* symbol) {
+    SymbolText text;
+    return String(fmtShortSymbol(text, symbol));
+}
+
+String formatPercent(float percent) {
+    PercentText text;
+    return String(fmtPercent(text, percent));
+}
+
+String formatNumber(float number) {
+    NumberText text;
+    return String(fmtNumber(text, number));
+}
+
+String formatPrice(float price) {
+    NumberText text;
+    return String(fmtPrice(text, price));
+}
+
+String formatMoneyPrice(Money price) {
+    NumberText text;
+    return String(fmtMoneyPrice(text, price));
+}
+
+String formatMoneyNumber(Money value) {
+    NumberText text;
+    return String(fmtMoneyNumber(text, value));
+}
+
+// عدد JSON دقیق (با serialized() بدون تبدیل به double نوشته می‌شود)
+String moneyJson(Money value) {
+    char buffer[24];
+    moneyFormatTrim(value, buffer, sizeof(buffer));
+    return String(buffer);
+}
+
+// سرور ممکن است عدد یا رشته بفرستد؛ رشته دقیق پارس می‌شود
+Money moneyFromJson(JsonVariantConst value) {
+    if (value.is<const char*>()) {
+        Money parsed;
+        return moneyParse(value.as<const char*>(), &parsed) ? parsed : 0;
     }
+    return moneyFromDouble(value.as<double>());
 }
 
-String formatTime(unsigned long timestamp) {
-    unsigned long seconds = timestamp / 1000;
+const char* fmtDuration(DurationText& out, unsigned long milliseconds) {
+    unsigned long seconds = milliseconds / 1000;
     unsigned long minutes = seconds / 60;
     unsigned long hours = minutes / 60;
     unsigned long days = hours / 24;
     
     if (days > 0) {
-        return String(days) + "d " + String(hours % 24) + "h";
+        snprintf(out, sizeof(out), "%lud %luh", days, hours % 24);
     } else if (hours > 0) {
-        return String(hours) + "h " + String(minutes % 60) + "m";
+        snprintf(out, sizeof(out), "%luh %lum", hours, minutes % 60);
     } else if (minutes > 0) {
-        return String(minutes) + "m " + String(seconds % 60) + "s";
+        snprintf(out, sizeof(out), "%lum %lus", minutes, seconds % 60);
     } else {
-        return String(seconds) + "s";
+        snprintf(out, sizeof(out), "%lus", seconds);
     }
+    return out;
+}
+
+String formatTime(unsigned long timestamp) {
+    DurationText text;
+    return String(fmtDuration(text, timestamp));
 }
 
 String formatDateTime(unsigned long timestamp) {
@@ -2435,21 +6915,35 @@ String getWiFiQuality(int rssi) {
     return "Poor";
 }
 
-String getUptimeString() {
+const char* fmtUptime(DurationText& out) {
     unsigned long uptime = millis() - systemStartTime;
     unsigned long seconds = uptime / 1000;
     unsigned long minutes = seconds / 60;
     unsigned long hours = minutes / 60;
     unsigned long days = hours / 24;
     
-    String result = "";
+    int used = 0;
+    out[0] = '\0';
     
-    if (days > 0) result += String(days) + "d ";
-    if (hours % 24 > 0) result += String(hours % 24) + "h ";
-    if (minutes % 60 > 0) result += String(minutes % 60) + "m ";
-    result += String(seconds % 60) + "s";
+    if (days > 0) used += snprintf(out + used, sizeof(out) - used, "%lud ", days);
+    if (hours % 24 > 0) used += snprintf(out + used, sizeof(out) - used, "%luh ", hours % 24);
+    if (minutes % 60 > 0) used += snprintf(out + used, sizeof(out) - used, "%lum ", minutes % 60);
+    snprintf(out + used, sizeof(out) - used, "%lus", seconds % 60);
     
-    return result;
+    return out;
+}
+
+String getUptimeString() {
+    DurationText text;
+    return String(fmtUptime(text));
+}
+
+void updateHeapStats() {
+    heapFreeBytes = ESP.getFreeHeap();
+    heapLargestBlock = ESP.getMaxAllocHeap();
+    heapMinFree = ESP.getMinFreeHeap();
+    heapFragmentation = heapFreeBytes > 0 ? 100.0 * (1.0 - (float)heapLargestBlock / heapFreeBytes) : 0;
+    if (heapFragmentation > heapWorstFragmentation) heapWorstFragmentation = heapFragmentation;
 }
 
 // ===== TIME FUNCTIONS =====
@@ -2618,6 +7112,7 @@ bool loadSettings() {
 
 bool saveSettings() {
     settings.magicNumber = 0xAA;
+    settingsVersion++;
     
     EEPROM.begin(EEPROM_SIZE);
     EEPROM.put(0, settings);
@@ -2913,6 +7408,8 @@ void updateWiFiMode() {
 }
 
 void saveAPState() {
+    settingsVersion++;
+    
     // Save AP state to EEPROM
     int address = EEPROM_SIZE - 10; // Last 10 bytes for AP state
     EEPROM.begin(EEPROM_SIZE);
@@ -3515,256 +8012,1401 @@ void handleRoot() {
         return;
     }
     
-    String html = generateDashboardHTML();
-    server.send(200, "text/html", html);
+    // صفحه ثابت gzip شده (web/dashboard.html)؛ مقادیر از /api/dashboard و /events
+    handleStaticAsset(WEB_ASSET_DASHBOARD_HTML_INDEX);
 }
 
-String generateDashboardHTML() {
-    String html = R"rawliteral(
+// ===== STATIC ASSETS & DASHBOARD DATA =====
+// CSS/JS مشترک و صفحه داشبورد یک بار gzip شده در web_assets.h قرار دارند (tools/gen_web_assets.py).
+// CSS/JS با کش طولانی ارسال می‌شوند؛ hash محتوا در URL است پس بعد از فلش جدید دوباره دریافت می‌شوند.
+// صفحه HTML آدرس ثابت دارد و هر بار با ETag اعتبارسنجی می‌شود
+void handleStaticAsset(int index) {
+    const WebAsset* asset = &webAssets[index];
+    String etag = String("\"") + asset->hash + "\"";
+    
+    if (strcmp(asset->mime, "text/html") == 0) {
+        server.sendHeader("Cache-Control", "no-cache");
+    } else {
+        server.sendHeader("Cache-Control", "public, max-age=31536000, immutable");
+    }
+    server.sendHeader("ETag", etag);
+    
+    if (server.header("If-None-Match") == etag) {
+        server.send(304, asset->mime, "");
+        return;
+    }
+    
+    server.sendHeader("Content-Encoding", "gzip");
+    server.send_P(200, asset->mime, (PGM_P)asset->data, asset->length);
+}
+
+void handleDashboardData() {
+    DynamicJsonDocument doc(1024 + 192 * MAX_PORTFOLIOS);
+    
+    lockData();
+    
+    JsonObject entry = doc.createNestedObject("entry");
+    entry["name"] = settings.entryPortfolio;
+    entry["count"] = portfolios[0].count;
+    entry["pnlPercent"] = portfolios[0].summary.totalPnlPercent;
+    entry["value"] = serialized(moneyJson(portfolios[0].summary.totalCurrentValue));
+    entry["winRate"] = portfolios[0].summary.totalPositions > 0 ?
+        (portfolios[0].summary.winningPositions * 100.0) / portfolios[0].summary.totalPositions : 0.0;
+    
+    JsonObject exitMode = doc.createNestedObject("exit");
+    exitMode["name"] = settings.exitPortfolio;
+    exitMode["count"] = portfolios[1].count;
+    exitMode["pnlPercent"] = portfolios[1].summary.totalPnlPercent;
+    exitMode["value"] = serialized(moneyJson(portfolios[1].summary.totalCurrentValue));
+    exitMode["maxDrawdown"] = portfolios[1].summary.maxDrawdown;
+    
+    // slot های اضافه (p2..) در کارت جداگانه؛ m همان اندیس رویداد summary در SSE است
+    JsonArray slots = doc.createNestedArray("slots");
+    for (int i = 2; i < portfolioCount; i++) {
+        if (portfolios[i].name[0] == '\0') continue;
+        JsonObject obj = slots.createNestedObject();
+        obj["m"] = i;
+        obj["key"] = portfolioKey(i);
+        obj["name"] = portfolios[i].name;
+        obj["count"] = portfolios[i].count;
+        obj["pnlPercent"] = portfolios[i].summary.totalPnlPercent;
+        obj["value"] = serialized(moneyJson(portfolios[i].summary.totalCurrentValue));
+    }
+    
+    if (isConnectedToWiFi) {
+        doc["wifi"] = "Connected";
+    } else if (apModeActive) {
+        doc["wifi"] = "AP Mode";
+    } else {
+        doc["wifi"] = "Disconnected";
+    }
+    DurationText uptimeText;
+    doc["uptime"] = fmtUptime(uptimeText);
+    doc["freeHeap"] = ESP.getFreeHeap();
+    doc["largestBlock"] = heapLargestBlock;
+    doc["fragmentation"] = heapFragmentation;
+    doc["battery"] = (powerSource == POWER_SOURCE_USB) ? String("USB") : String(batteryPercent) + "%";
+    doc["volume"] = settings.buzzerVolume;
+    doc["apEnabled"] = apEnabled;
+    unlockData();
+    
+    String json;
+    serializeJson(doc, json);
+    server.sendHeader("Cache-Control", "no-cache");
+    server.send(200, "application/json", json);
+}
+
+// ===== REST API v1 =====
+// خروجی JSON مستقیم از آرایه‌های موقعیت/آلرت به صورت chunked ساخته می‌شود (بدون سند میانی).
+// پارامترها: mode=entry|exit  fields=a,b,c  offset=N  limit=N
+// ETag از شمارنده نسخه داده ساخته می‌شود تا poll‌های تکراری 304 بگیرند.
+#define API_DEFAULT_LIMIT 50
+#define API_MAX_LIMIT 200
+
+const char* const apiPositionFields[] = {
+    "symbol", "side", "quantity", "entryPrice", "currentPrice",
+    "pnl", "pnlPercent", "alerted", "severe", "exitAlerted"
+};
+const int apiPositionFieldCount = sizeof(apiPositionFields) / sizeof(apiPositionFields[0]);
+
+const char* const apiAlertFields[] = {
+    "symbol", "time", "timeString", "pnlPercent", "price",
+    "side", "severe", "profit", "type", "mode"
+};
+const int apiAlertFieldCount = sizeof(apiAlertFields) / sizeof(apiAlertFields[0]);
+
+// fields=symbol,pnlPercent → bitmask؛ بدون پارامتر همه فیلدها
+uint32_t parseApiFields(const char* const* names, int nameCount) {
+    if (!server.hasArg("fields") || server.arg("fields").length() == 0) {
+        return 0xFFFFFFFF;
+    }
+    
+    String list = server.arg("fields");
+    uint32_t mask = 0;
+    int start = 0;
+    
+    while (start <= (int)list.length()) {
+        int comma = list.indexOf(',', start);
+        if (comma < 0) comma = list.length();
+        String name = list.substring(start, comma);
+        name.trim();
+        
+        for (int i = 0; i < nameCount; i++) {
+            if (name == names[i]) {
+                mask |= (1UL << i);
+                break;
+            }
+        }
+        start = comma + 1;
+    }
+    
+    return mask;
+}
+
+int apiArgInt(const char* name, int defaultValue, int minValue, int maxValue) {
+    if (!server.hasArg(name)) return defaultValue;
+    return constrain((int)server.arg(name).toInt(), minValue, maxValue);
+}
+
+// mode=entry|exit|p2..|<اندیس slot>
+byte apiArgMode() {
+    return portfolioFromArg(server.arg("mode"), 0);
+}
+
+// ETag را می‌فرستد و اگر کلاینت همان نسخه را دارد 304 برمی‌گرداند
+bool apiNotModified(const String& etag) {
+    server.sendHeader("ETag", etag);
+    server.sendHeader("Cache-Control", "no-cache");
+    
+    if (server.header("If-None-Match") == etag) {
+        server.send(304, "application/json", "");
+        return true;
+    }
+    return false;
+}
+
+// کاراکترهای خطرناک JSON از نماد حذف می‌شوند (نمادها فقط حروف و اعداد هستند)
+void apiCopySafe(char* dest, const char* src, size_t size) {
+    size_t j = 0;
+    for (size_t i = 0; src[i] != '\0' && j < size - 1; i++) {
+        if (src[i] == '"' || src[i] == '\\' || (unsigned char)src[i] < 0x20) continue;
+        dest[j++] = src[i];
+    }
+    dest[j] = '\0';
+}
+
+// یک فیلد "name":value به بافر اضافه می‌کند
+int apiAppendField(char* buffer, int used, int size, bool* first, const char* name, const char* valueFormat, ...) {
+    if (used >= size) return used;
+    
+    used += snprintf(buffer + used, size - used, "%s\"%s\":", *first ? "" : ",", name);
+    *first = false;
+    if (used >= size) return size;
+    
+    va_list args;
+    va_start(args, valueFormat);
+    used += vsnprintf(buffer + used, size - used, valueFormat, args);
+    va_end(args);
+    
+    return min(used, size);
+}
+
+void handleApiPositions() {
+    byte mode = apiArgMode();
+    uint32_t mask = parseApiFields(apiPositionFields, apiPositionFieldCount);
+    int offset = apiArgInt("offset", 0, 0, MAX_POSITIONS_PER_MODE);
+    int limit = apiArgInt("limit", API_DEFAULT_LIMIT, 1, API_MAX_LIMIT);
+    
+    String etag = "W/\"p" + String(dataVersion) + "." + String(alertVersion) + "-" + String(mode) +
+                  "-" + String(offset) + "-" + String(limit) + "-" + String(mask, HEX) + "\"";
+    if (apiNotModified(etag)) return;
+    
+    // صفحه درخواستی زیر قفل کپی و بعد از آزاد کردن قفل فرمت و ارسال می‌شود؛
+    // loop پشت یک کلاینت کند منتظر نمی‌ماند
+    lockData();
+    int count = portfolios[mode].count;
+    unsigned long version = dataVersion;
+    int rows = max(0, min(count, offset + limit) - offset);
+    size_t bytes = sizeof(CryptoPosition) * max(rows, 1);
+    CryptoPosition* data = (CryptoPosition*)(psramFound() ? ps_malloc(bytes) : malloc(bytes));
+    if (data != NULL && rows > 0) memcpy(data, portfolios[mode].data + offset, sizeof(CryptoPosition) * rows);
+    unlockData();
+    
+    if (data == NULL) {
+        server.send(503, "application/json", "{\"error\":\"out of memory\"}");
+        return;
+    }
+    
+    char buffer[384];
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server.send(200, "application/json", "");
+    
+    snprintf(buffer, sizeof(buffer), "{\"version\":%lu,\"mode\":\"%s\",\"total\":%d,\"offset\":%d,\"limit\":%d,\"positions\":[",
+             version, portfolioKey(mode), count, offset, limit);
+    server.sendContent(buffer);
+    
+    for (int i = 0; i < rows; i++) {
+        CryptoPosition* pos = &data[i];
+        char symbol[16];
+        apiCopySafe(symbol, pos->symbol, sizeof(symbol));
+        
+        int used = snprintf(buffer, sizeof(buffer), "%s{", i > 0 ? "," : "");
+        bool first = true;
+        char quantity[24], entryPrice[24], currentPrice[24], pnl[24];
+        moneyFormatTrim(pos->quantity, quantity, sizeof(quantity));
+        moneyFormatTrim(pos->entryPrice, entryPrice, sizeof(entryPrice));
+        moneyFormatTrim(pos->currentPrice, currentPrice, sizeof(currentPrice));
+        moneyFormat(pos->pnlValue, 2, pnl, sizeof(pnl));
+        
+        if (mask & (1UL << 0)) used = apiAppendField(buffer, used, sizeof(buffer), &first, "symbol", "\"%s\"", symbol);
+        if (mask & (1UL << 1)) used = apiAppendField(buffer, used, sizeof(buffer), &first, "side", "\"%s\"", pos->isLong ? "LONG" : "SHORT");
+        if (mask & (1UL << 2)) used = apiAppendField(buffer, used, sizeof(buffer), &first, "quantity", "%s", quantity);
+        if (mask & (1UL << 3)) used = apiAppendField(buffer, used, sizeof(buffer), &first, "entryPrice", "%s", entryPrice);
+        if (mask & (1UL << 4)) used = apiAppendField(buffer, used, sizeof(buffer), &first, "currentPrice", "%s", currentPrice);
+        if (mask & (1UL << 5)) used = apiAppendField(buffer, used, sizeof(buffer), &first, "pnl", "%s", pnl);
+        if (mask & (1UL << 6)) used = apiAppendField(buffer, used, sizeof(buffer), &first, "pnlPercent", "%.2f", pos->changePercent);
+        if (mask & (1UL << 7)) used = apiAppendField(buffer, used, sizeof(buffer), &first, "alerted", "%s", pos->alerted ? "true" : "false");
+        if (mask & (1UL << 8)) used = apiAppendField(buffer, used, sizeof(buffer), &first, "severe", "%s", pos->severeAlerted ? "true" : "false");
+        if (mask & (1UL << 9)) used = apiAppendField(buffer, used, sizeof(buffer), &first, "exitAlerted", "%s", pos->exitAlerted ? "true" : "false");
+        
+        if (used < (int)sizeof(buffer) - 1) {
+            buffer[used++] = '}';
+            buffer[used] = '\0';
+        }
+        server.sendContent(buffer);
+    }
+    
+    free(data);
+    
+    server.sendContent("]}");
+    server.sendContent("");
+}
+
+void appendApiSummary(JsonObject obj, const PortfolioSummary* summary, const char* name, int count) {
+    obj["portfolio"] = name;
+    obj["positions"] = count;
+    obj["totalInvestment"] = serialized(moneyJson(summary->totalInvestment));
+    obj["totalValue"] = serialized(moneyJson(summary->totalCurrentValue));
+    obj["totalPnl"] = serialized(moneyJson(summary->totalPnl));
+    obj["totalPnlPercent"] = summary->totalPnlPercent;
+    obj["long"] = summary->longPositions;
+    obj["short"] = summary->shortPositions;
+    obj["winning"] = summary->winningPositions;
+    obj["losing"] = summary->losingPositions;
+    obj["maxDrawdown"] = summary->maxDrawdown;
+    obj["drawdown"] = summary->currentDrawdown;
+    obj["volatility"] = summary->volatility;
+    obj["sharpeRatio"] = summary->sharpeRatio;
+    obj["sortinoRatio"] = summary->sortinoRatio;
+    obj["worstSymbol"] = summary->worstSymbol;
+    obj["worstPercent"] = summary->worstChangePercent;
+}
+
+void handleApiSummary() {
+    String etag = "W/\"s" + String(dataVersion) + "\"";
+    if (apiNotModified(etag)) return;
+    
+    DynamicJsonDocument doc(512 + 768 * MAX_PORTFOLIOS);
+    lockData();
+    doc["version"] = dataVersion;
+    for (int i = 0; i < portfolioCount; i++) {
+        appendApiSummary(doc.createNestedObject(portfolioKey(i)), &portfolios[i].summary, portfolios[i].name, portfolios[i].count);
+    }
+    
+    JsonObject aggregate = doc.createNestedObject("aggregate");
+    for (int i = 0; i < portfolioCount; i++) {
+        aggregate[String(portfolioKey(i)) + "ChangedRows"] = portfolios[i].aggregate.lastChangedRows;
+    }
+    aggregate["fullRecomputes"] = summaryFullRecomputes;
+    aggregate["mismatches"] = summaryMismatches;
+    aggregate["maxDrift"] = summaryMaxDrift;
+    unlockData();
+    
+    String json;
+    serializeJson(doc, json);
+    server.send(200, "application/json", json);
+}
+
+void handleApiAlerts() {
+    byte mode = apiArgMode();
+    uint32_t mask = parseApiFields(apiAlertFields, apiAlertFieldCount);
+    int offset = apiArgInt("offset", 0, 0, MAX_ALERT_HISTORY);
+    int limit = apiArgInt("limit", API_DEFAULT_LIMIT, 1, API_MAX_LIMIT);
+    
+    String etag = "W/\"a" + String(alertVersion) + "-" + String(mode) +
+                  "-" + String(offset) + "-" + String(limit) + "-" + String(mask, HEX) + "\"";
+    if (apiNotModified(etag)) return;
+    
+    // مثل handleApiPositions: رکوردها زیر قفل کپی می‌شوند. جدول نمادها فقط اضافه‌شونده است
+    // و alertSymbolName بعد از آزاد کردن قفل هم امن است.
+    lockData();
+    int count = portfolios[mode].historyCount;
+    unsigned long version = alertVersion;
+    int rows = max(0, min(count, offset + limit) - offset);
+    AlertRecord* records = (AlertRecord*)malloc(sizeof(AlertRecord) * max(rows, 1));
+    if (records != NULL) {
+        // جدیدترین آلرت اول
+        for (int n = 0; n < rows; n++) records[n] = *getAlertRecord(mode, offset + n);
+    }
+    unlockData();
+    
+    if (records == NULL) {
+        server.send(503, "application/json", "{\"error\":\"out of memory\"}");
+        return;
+    }
+    
+    char buffer[384];
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server.send(200, "application/json", "");
+    
+    snprintf(buffer, sizeof(buffer), "{\"version\":%lu,\"mode\":\"%s\",\"total\":%d,\"offset\":%d,\"limit\":%d,\"alerts\":[",
+             version, portfolioKey(mode), count, offset, limit);
+    server.sendContent(buffer);
+    
+    for (int n = 0; n < rows; n++) {
+        const AlertRecord* alert = &records[n];
+        char symbol[16];
+        char timeString[20];
+        apiCopySafe(symbol, alertSymbolName(alert->symbolId), sizeof(symbol));
+        formatAlertTime(alert, timeString, sizeof(timeString));
+        
+        int used = snprintf(buffer, sizeof(buffer), "%s{", n > 0 ? "," : "");
+        bool first = true;
+        
+        if (mask & (1UL << 0)) used = apiAppendField(buffer, used, sizeof(buffer), &first, "symbol", "\"%s\"", symbol);
+        if (mask & (1UL << 1)) used = apiAppendField(buffer, used, sizeof(buffer), &first, "time", "%lu", (unsigned long)alert->timestamp);
+        if (mask & (1UL << 2)) used = apiAppendField(buffer, used, sizeof(buffer), &first, "timeString", "\"%s\"", timeString);
+        if (mask & (1UL << 3)) used = apiAppendField(buffer, used, sizeof(buffer), &first, "pnlPercent", "%.2f", alert->pnlPercent);
+        if (mask & (1UL << 4)) used = apiAppendField(buffer, used, sizeof(buffer), &first, "price", "%.8g", alert->alertPrice);
+        if (mask & (1UL << 5)) used = apiAppendField(buffer, used, sizeof(buffer), &first, "side", "\"%s\"", (alert->flags & ALERT_FLAG_LONG) ? "LONG" : "SHORT");
+        if (mask & (1UL << 6)) used = apiAppendField(buffer, used, sizeof(buffer), &first, "severe", "%s", (alert->flags & ALERT_FLAG_SEVERE) ? "true" : "false");
+        if (mask & (1UL << 7)) used = apiAppendField(buffer, used, sizeof(buffer), &first, "profit", "%s", (alert->flags & ALERT_FLAG_PROFIT) ? "true" : "false");
+        if (mask & (1UL << 8)) used = apiAppendField(buffer, used, sizeof(buffer), &first, "type", "%d", alert->alertType & ALERT_TYPE_MASK);
+        if (mask & (1UL << 9)) used = apiAppendField(buffer, used, sizeof(buffer), &first, "mode", "%d", alertRecordSlot(alert));
+        
+        if (used < (int)sizeof(buffer) - 1) {
+            buffer[used++] = '}';
+            buffer[used] = '\0';
+        }
+        server.sendContent(buffer);
+    }
+    
+    free(records);
+    
+    server.sendContent("]}");
+    server.sendContent("");
+}
+
+// /api/v1/history?symbol=BTCUSDT&res=raw|1m|15m|1h&from=&to=&limit=
+// بدون symbol: فهرست نمادها و حافظه مصرفی
+void handleApiHistory() {
+    if (!server.hasArg("symbol")) {
+        DynamicJsonDocument doc(256 + TS_MAX_SYMBOLS * 24);
+        lockData();
+        doc["enabled"] = tsEnabled;
+        doc["memory"] = tsMemoryUsed;
+        
+        // نسبت فشرده‌سازی نمونه‌های خام
+        uint32_t rawSamples = 0;
+        uint32_t compressedBytes = 0;
+        JsonArray symbols = doc.createNestedArray("symbols");
+        for (int i = 0; i < tsSeriesCount; i++) {
+            symbols.add(tsSeries[i]->symbol);
+            for (int b = 0; b < tsSeries[i]->blockCount; b++) {
+                rawSamples += tsSeries[i]->blocks[b].count;
+                compressedBytes += (tsSeries[i]->blocks[b].bitLength + 7) / 8;
+            }
+        }
+        doc["rawSamples"] = rawSamples;
+        doc["compressedBytes"] = compressedBytes;
+        doc["compressionRatio"] = compressedBytes > 0 ? (float)rawSamples * sizeof(TSSample) / compressedBytes : 0;
+        doc["sparklineMicros"] = tsLastSparklineMicros;
+        unlockData();
+        
+        String json;
+        serializeJson(doc, json);
+        server.send(200, "application/json", json);
+        return;
+    }
+    
+    String symbol = server.arg("symbol");
+    String resArg = server.arg("res");
+    byte resolution = TS_RES_1M;
+    for (int r = 0; r <= TS_TIER_COUNT; r++) {
+        if (resArg == tsResolutionNames[r]) resolution = r;
+    }
+    uint32_t from = server.hasArg("from") ? strtoul(server.arg("from").c_str(), NULL, 10) : 0;
+    uint32_t to = server.hasArg("to") ? strtoul(server.arg("to").c_str(), NULL, 10) : 0xFFFFFFFF;
+    int limit = apiArgInt("limit", 120, 1, TS_H1_BARS);
+    
+    TSBar* bars = (TSBar*)malloc(sizeof(TSBar) * limit);
+    if (bars == NULL) {
+        server.send(503, "text/plain", "Out of memory");
+        return;
+    }
+    
+    lockData();
+    int count = tsQuery(symbol.c_str(), resolution, from, to, bars, limit);
+    unlockData();
+    
+    char safeSymbol[16];
+    apiCopySafe(safeSymbol, symbol.c_str(), sizeof(safeSymbol));
+    
+    char buffer[96];
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server.send(200, "application/json", "");
+    snprintf(buffer, sizeof(buffer), "{\"symbol\":\"%s\",\"res\":\"%s\",\"bars\":[", safeSymbol, tsResolutionNames[resolution]);
+    server.sendContent(buffer);
+    
+    String rows = "";
+    for (int i = 0; i < count; i++) {
+        snprintf(buffer, sizeof(buffer), "%s[%lu,%.8g,%.8g,%.8g,%.8g]", i > 0 ? "," : "",
+                 (unsigned long)bars[i].time, bars[i].open, bars[i].high, bars[i].low, bars[i].close);
+        rows += buffer;
+        if (rows.length() > 1024) {
+            server.sendContent(rows);
+            rows = "";
+        }
+    }
+    rows += "]}";
+    server.sendContent(rows);
+    server.sendContent("");
+    free(bars);
+}
+
+// ===== RUNTIME METRICS =====
+// خروجی متنی Prometheus. هر هیستوگرام فقط از یک تسک نوشته می‌شود (وب یا loop) و
+// بدون قفل خوانده می‌شود؛ خواندن ناهمزمان حداکثر یک نمونه را جا می‌اندازد.
+const uint32_t metricBucketBounds[METRIC_BUCKET_COUNT] = {
+    50, 100, 250, 500, 1000, 2500, 5000, 10000,
+    25000, 50000, 100000, 250000, 500000, 1000000, 2500000, 5000000
+};
+const char* const loopStageNames[STAGE_COUNT] = {
+    "web", "sse", "wifi", "fetch", "parse", "alerts", "display", "leds"
+};
+LatencyHistogram stageHistograms[STAGE_COUNT];
+
+void metricsObserve(LoopStage stage, uint32_t elapsedMicros) {
+    LatencyHistogram* h = &stageHistograms[stage];
+    int bucket = 0;
+    while (bucket < METRIC_BUCKET_COUNT && elapsedMicros > metricBucketBounds[bucket]) bucket++;
+    h->buckets[bucket]++;
+    h->count++;
+    h->sumMicros += elapsedMicros;
+    if (elapsedMicros > h->maxMicros) h->maxMicros = elapsedMicros;
+}
+
+void metricsHeader(String& out, const char* name, const char* type, const char* help) {
+    char line[160];
+    snprintf(line, sizeof(line), "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+    out += line;
+}
+
+void metricsValue(String& out, const char* name, const char* labels, double value) {
+    char line[128];
+    if (labels != NULL) {
+        snprintf(line, sizeof(line), "%s{%s} %.6g\n", name, labels, value);
+    } else {
+        snprintf(line, sizeof(line), "%s %.6g\n", name, value);
+    }
+    out += line;
+}
+
+void metricsGauge(String& out, const char* name, const char* help, double value) {
+    metricsHeader(out, name, "gauge", help);
+    metricsValue(out, name, NULL, value);
+}
+
+void handleMetrics() {
+    char line[128];
+    String out;
+    out.reserve(8192);
+    
+    // هیستوگرام مراحل (ثانیه، تجمعی)
+    metricsHeader(out, "portfolio_stage_duration_seconds", "histogram", "Time spent in each main loop / web task stage");
+    for (int stage = 0; stage < STAGE_COUNT; stage++) {
+        const LatencyHistogram* h = &stageHistograms[stage];
+        uint64_t cumulative = 0;
+        for (int b = 0; b < METRIC_BUCKET_COUNT; b++) {
+            cumulative += h->buckets[b];
+            snprintf(line, sizeof(line), "portfolio_stage_duration_seconds_bucket{stage=\"%s\",le=\"%g\"} %llu\n",
+                     loopStageNames[stage], metricBucketBounds[b] / 1e6, (unsigned long long)cumulative);
+            out += line;
+        }
+        cumulative += h->buckets[METRIC_BUCKET_COUNT];
+        snprintf(line, sizeof(line), "portfolio_stage_duration_seconds_bucket{stage=\"%s\",le=\"+Inf\"} %llu\n",
+                 loopStageNames[stage], (unsigned long long)cumulative);
+        out += line;
+        snprintf(line, sizeof(line), "portfolio_stage_duration_seconds_sum{stage=\"%s\"} %.6f\n",
+                 loopStageNames[stage], h->sumMicros / 1e6);
+        out += line;
+        snprintf(line, sizeof(line), "portfolio_stage_duration_seconds_count{stage=\"%s\"} %llu\n",
+                 loopStageNames[stage], (unsigned long long)cumulative);
+        out += line;
+    }
+    
+    metricsHeader(out, "portfolio_stage_duration_max_seconds", "gauge", "Slowest observed run of each stage since boot");
+    for (int stage = 0; stage < STAGE_COUNT; stage++) {
+        snprintf(line, sizeof(line), "stage=\"%s\"", loopStageNames[stage]);
+        metricsValue(out, "portfolio_stage_duration_max_seconds", line, stageHistograms[stage].maxMicros / 1e6);
+    }
+    
+    // حافظه
+    metricsGauge(out, "portfolio_heap_free_bytes", "Free internal heap", ESP.getFreeHeap());
+    metricsGauge(out, "portfolio_heap_min_free_bytes", "Lowest free internal heap since boot", ESP.getMinFreeHeap());
+    metricsGauge(out, "portfolio_heap_largest_block_bytes", "Largest allocatable internal heap block", ESP.getMaxAllocHeap());
+    metricsGauge(out, "portfolio_heap_fragmentation_ratio", "1 - largest block / free heap (last sample)", heapFragmentation / 100.0);
+    metricsGauge(out, "portfolio_psram_size_bytes", "Total PSRAM", ESP.getPsramSize());
+    metricsGauge(out, "portfolio_psram_free_bytes", "Free PSRAM", ESP.getFreePsram());
+    
+    metricsHeader(out, "portfolio_task_stack_free_bytes", "gauge", "Task stack high-water mark (minimum free stack)");
+    if (loopTaskHandle != NULL) {
+        metricsValue(out, "portfolio_task_stack_free_bytes", "task=\"loop\"", uxTaskGetStackHighWaterMark(loopTaskHandle));
+    }
+    if (webTaskHandle != NULL) {
+        metricsValue(out, "portfolio_task_stack_free_bytes", "task=\"web\"", uxTaskGetStackHighWaterMark(webTaskHandle));
+    }
+    
+    // شبکه و API
+    metricsGauge(out, "portfolio_wifi_connected", "1 when connected to a WiFi network", isConnectedToWiFi ? 1 : 0);
+    if (isConnectedToWiFi) {
+        metricsGauge(out, "portfolio_wifi_rssi_dbm", "WiFi signal strength", WiFi.RSSI());
+    }
+    metricsHeader(out, "portfolio_api_requests_total", "counter", "Portfolio API fetches by result");
+    metricsValue(out, "portfolio_api_requests_total", "result=\"success\"", apiSuccessCount);
+    metricsValue(out, "portfolio_api_requests_total", "result=\"error\"", apiErrorCount);
+    metricsGauge(out, "portfolio_api_response_time_ms", "Exponential average of API response time", apiAverageResponseTime);
+    
+    // سرورهای API (بخش API ENDPOINTS)
+    metricsHeader(out, "portfolio_api_endpoint_breaker", "gauge", "Circuit breaker state per endpoint (0 closed, 1 open, 2 half-open)");
+    for (int i = 0; i < API_MAX_ENDPOINTS; i++) {
+        if (apiEndpoints[i].url[0] == '\0') continue;
+        snprintf(line, sizeof(line), "endpoint=\"%d\"", i);
+        metricsValue(out, "portfolio_api_endpoint_breaker", line, apiEndpoints[i].breaker);
+    }
+    metricsHeader(out, "portfolio_api_endpoint_p95_seconds", "gauge", "p95 response time of the last successful fetches per endpoint");
+    for (int i = 0; i < API_MAX_ENDPOINTS; i++) {
+        if (apiEndpoints[i].url[0] == '\0') continue;
+        snprintf(line, sizeof(line), "endpoint=\"%d\"", i);
+        metricsValue(out, "portfolio_api_endpoint_p95_seconds", line, apiEndpointP95(&apiEndpoints[i]) / 1000.0);
+    }
+    metricsHeader(out, "portfolio_api_endpoint_hedges_total", "counter", "Fetches moved to the next endpoint after the p95 deadline");
+    for (int i = 0; i < API_MAX_ENDPOINTS; i++) {
+        if (apiEndpoints[i].url[0] == '\0') continue;
+        snprintf(line, sizeof(line), "endpoint=\"%d\"", i);
+        metricsValue(out, "portfolio_api_endpoint_hedges_total", line, apiEndpoints[i].hedges);
+    }
+    
+    // وضعیت برنامه
+    metricsGauge(out, "portfolio_uptime_seconds", "Seconds since boot", (millis() - systemStartTime) / 1000.0);
+    metricsGauge(out, "portfolio_sse_clients", "Connected /events clients", sseActiveClients());
+    lockData();
+    metricsHeader(out, "portfolio_positions", "gauge", "Open positions per mode");
+    for (int i = 0; i < portfolioCount; i++) {
+        metricsValue(out, "portfolio_positions", (String("mode=\"") + portfolioKey(i) + "\"").c_str(), portfolios[i].count);
+    }
+    
+    // زمان‌بند تطبیقی (بخش ADAPTIVE POLLING): فقط دلیل فعلی هر slot مقدار 1 دارد
+    metricsHeader(out, "portfolio_poll_interval_seconds", "gauge", "Effective fetch interval per portfolio");
+    for (int i = 0; i < portfolioCount; i++) {
+        snprintf(line, sizeof(line), "mode=\"%s\",reason=\"%s\"", portfolioKey(i), pollReasonNames[portfolios[i].pollReason]);
+        metricsValue(out, "portfolio_poll_interval_seconds", line, portfolios[i].effectiveInterval / 1000.0);
+    }
+    metricsHeader(out, "portfolio_poll_reason", "gauge", "Why the fetch interval is what it is (1 = current reason)");
+    for (int i = 0; i < portfolioCount; i++) {
+        for (int r = 0; r < POLL_REASON_COUNT; r++) {
+            snprintf(line, sizeof(line), "mode=\"%s\",reason=\"%s\"", portfolioKey(i), pollReasonNames[r]);
+            metricsValue(out, "portfolio_poll_reason", line, portfolios[i].pollReason == r ? 1 : 0);
+        }
+    }
+    metricsHeader(out, "portfolio_poll_error_streak", "gauge", "Consecutive failed fetches per portfolio");
+    for (int i = 0; i < portfolioCount; i++) {
+        snprintf(line, sizeof(line), "mode=\"%s\"", portfolioKey(i));
+        metricsValue(out, "portfolio_poll_error_streak", line, portfolios[i].errorStreak);
+    }
+    unlockData();
+    
+    metricsHeader(out, "portfolio_fetch_tier_total", "counter", "Parsed fetches by tier (full portfolio / prices only)");
+    for (int t = 0; t < FETCH_TIER_COUNT; t++) {
+        snprintf(line, sizeof(line), "tier=\"%s\"", fetchTierNames[t]);
+        metricsValue(out, "portfolio_fetch_tier_total", line, fetchTierCount[t]);
+    }
+    metricsHeader(out, "portfolio_fetch_tier_bytes_total", "counter", "Payload bytes by fetch tier");
+    for (int t = 0; t < FETCH_TIER_COUNT; t++) {
+        snprintf(line, sizeof(line), "tier=\"%s\"", fetchTierNames[t]);
+        metricsValue(out, "portfolio_fetch_tier_bytes_total", line, (double)fetchTierBytes[t]);
+    }
+    metricsHeader(out, "portfolio_fetch_tier_parse_seconds_total", "counter", "Parse time by fetch tier");
+    for (int t = 0; t < FETCH_TIER_COUNT; t++) {
+        snprintf(line, sizeof(line), "tier=\"%s\"", fetchTierNames[t]);
+        metricsValue(out, "portfolio_fetch_tier_parse_seconds_total", line, fetchTierParseMicros[t] / 1e6);
+    }
+    metricsGauge(out, "portfolio_price_ticker_supported", "1 while the server answers the prices endpoint", priceTickerSupported ? 1 : 0);
+    metricsGauge(out, "portfolio_symbol_table_symbols", "Distinct symbols in the shared price table", symbolCount);
+    metricsHeader(out, "portfolio_symbol_fanout_total", "counter", "Positions repriced from another portfolio's fetch");
+    metricsValue(out, "portfolio_symbol_fanout_total", NULL, symbolFanouts);
+    metricsGauge(out, "portfolio_alert_rules", "Compiled alert rules", ruleCompiledCount);
+    metricsHeader(out, "portfolio_alert_rule_evaluations_total", "counter", "Positions checked against the alert rules");
+    metricsValue(out, "portfolio_alert_rule_evaluations_total", NULL, ruleEvaluated);
+    metricsHeader(out, "portfolio_alert_rule_alerts_total", "counter", "Alerts raised by alert rules");
+    metricsValue(out, "portfolio_alert_rule_alerts_total", NULL, ruleFired);
+    metricsGauge(out, "portfolio_alert_queue_depth", "Alerts waiting for the display", alertQueueCount);
+    metricsHeader(out, "portfolio_alert_events_total", "counter", "Alerts queued for presentation");
+    metricsValue(out, "portfolio_alert_events_total", NULL, alertEventsTotal);
+    metricsHeader(out, "portfolio_alert_presented_total", "counter", "Alert screens shown, summaries included");
+    metricsValue(out, "portfolio_alert_presented_total", NULL, alertPresentedTotal);
+    metricsHeader(out, "portfolio_alert_summaries_total", "counter", "Summary alerts built from queued bursts");
+    metricsValue(out, "portfolio_alert_summaries_total", NULL, alertSummariesTotal);
+    metricsHeader(out, "portfolio_alert_coalesced_total", "counter", "Alerts merged into summary alerts");
+    metricsValue(out, "portfolio_alert_coalesced_total", NULL, alertCoalescedTotal);
+    metricsHeader(out, "portfolio_alert_dropped_total", "counter", "Alerts evicted from a full queue (still counted in the next summary)");
+    metricsValue(out, "portfolio_alert_dropped_total", NULL, alertDroppedTotal);
+    metricsHeader(out, "portfolio_alert_muted_total", "counter", "Alerts shown without sound because of the buzzer rate limit");
+    metricsValue(out, "portfolio_alert_muted_total", NULL, alertMutedTotal);
+    
+    metricsGauge(out, "portfolio_stream_open", "1 while the WebSocket price stream is open", streamState == STREAM_OPEN ? 1 : 0);
+    metricsHeader(out, "portfolio_stream_ticks_total", "counter", "Price stream ticks received");
+    metricsValue(out, "portfolio_stream_ticks_total", NULL, streamStats.ticks);
+    metricsHeader(out, "portfolio_stream_alerts_total", "counter", "Alerts raised directly by price stream ticks");
+    metricsValue(out, "portfolio_stream_alerts_total", NULL, streamStats.alerts);
+    metricsGauge(out, "portfolio_stream_tick_to_buzzer_p95_seconds", "p95 latency from tick receipt to buzzer start (last 32 alerts)",
+                 streamLatencyPercentile(95) / 1e6);
+    
+    server.sendHeader("Cache-Control", "no-cache");
+    server.send(200, "text/plain; version=0.0.4", out);
+}
+
+// ===== BENCHMARKS =====
+// micro-benchmark مسیرهای داغ (parse، مرتب‌سازی، آلرت، رندر، قوانین آلرت) با پورتفوی مصنوعی 10/100/1000 پوزیشن.
+// روی دستگاه با دستور سریال "bench" / "bench save" و روی host با --bench اجرا می‌شود؛ خروجی هر دو یکسان است.
+// داده واقعی در طول اجرا کنار گذاشته و سپس بازگردانده می‌شود و قفل داده تا پایان نگه داشته می‌شود
+// (درخواست‌های وب منتظر می‌مانند). آلرت‌ها فقط شمرده می‌شوند: بدون بازر، تاریخچه و لاگ.
+#define BENCH_BASELINE_FILE "/bench_baseline.txt"
+#define BENCH_MIN_MICROS 200000UL       // هر مورد حداقل این مدت تکرار می‌شود
+#define BENCH_MAX_ITERATIONS 100000UL
+#define BENCH_MAX_RESULTS 24
+#define BENCH_TOLERANCE_PERCENT 25      // کندتر از baseline به این اندازه = regression
+#define BENCH_BYTES_SLACK 64            // نوسان مجاز allocation به ازای هر عملیات
+#define BENCH_RULES 1000                // قوانین آلرت مصنوعی در همه اندازه‌ها
+#define BENCH_RULES_CHANGED_STEP 100    // rules_changed: یک ردیف از هر 100 تغییر کرده
+
+volatile uint32_t benchAllocatedBytes = 0;
+
+static const int benchSizes[] = { 10, 100, 1000 };
+
+static String benchPayload;
+static CryptoPosition* benchSource = NULL;      // پوزیشن‌های parse شده، ورودی ثابت هر تکرار
+static CryptoPosition* benchExitSource = NULL;  // همان پوزیشن‌ها با قیمت مرجع جابجا شده برای آلرت خروج
+static CryptoPosition* benchScratch = NULL;
+static int benchCount = 0;
+static AlertRule* benchRules = NULL;
+static int benchRuleRound = 0;
+
+#ifdef CONFIG_HEAP_USE_HOOKS
+// ESP-IDF این hook را برای هر allocation صدا می‌زند (در host، malloc شبیه‌سازی شده همین کار را می‌کند)
+extern "C" IRAM_ATTR void esp_heap_trace_alloc_hook(void* ptr, size_t size, uint32_t caps) {
+    (void)ptr;
+    (void)caps;
+    benchAllocatedBytes += size;
+}
+#define BENCH_COUNTS_ALLOCATIONS true
+#else
+#define BENCH_COUNTS_ALLOCATIONS false
+#endif
+
+static uint32_t benchRandom(uint32_t* state) {
+    *state = *state * 1664525u + 1013904223u;
+    return *state >> 8;
+}
+
+// payload قطعی با همان فیلدهای API؛ حدود 40% پوزیشن‌ها زیر آستانه آلرت هستند
+static void benchBuildPayload(int count) {
+    uint32_t seed = 20240601u + count;
+    char item[192];
+    
+    benchPayload = "";
+    benchPayload.reserve(count * 150 + 64);
+    benchPayload += "{\"portfolio\":[";
+    for (int i = 0; i < count; i++) {
+        long entryCents = 100 + benchRandom(&seed) % 5000000;        // 1.00 .. 50000.00
+        int pnlBasis = (int)(benchRandom(&seed) % 3000) - 1800;      // -18.00% .. +11.99%
+        long currentCents = entryCents + entryCents * pnlBasis / 10000;
+        long quantityMilli = 1 + benchRandom(&seed) % 100000;
+        long pnlCents = (currentCents - entryCents) * quantityMilli / 1000;
+        
+        // علامت جدا نوشته می‌شود تا "-0.xx" درست بماند
+        snprintf(item, sizeof(item),
+                 "%s{\"symbol\":\"B%04dUSDT\",\"pnl_percent\":%s%d.%02d,\"current_price\":%ld.%02ld,"
+                 "\"entry_price\":%ld.%02ld,\"quantity\":%ld.%03ld,\"pnl\":%s%ld.%02ld,\"position\":\"%s\"}",
+                 i > 0 ? "," : "", i, pnlBasis < 0 ? "-" : "", abs(pnlBasis) / 100, abs(pnlBasis) % 100,
+                 currentCents / 100, currentCents % 100, entryCents / 100, entryCents % 100,
+                 quantityMilli / 1000, quantityMilli % 1000,
+                 pnlCents < 0 ? "-" : "", labs(pnlCents) / 100, labs(pnlCents) % 100,
+                 (i % 4 == 3) ? "short" : "long");
+        benchPayload += item;
+    }
+    benchPayload += "],\"summary\":{\"total_investment\":100000.00,\"total_current_value\":97000.00,\"total_pnl\":-3000.00}}";
+}
+
+static void benchOpParse() {
+    parseCryptoData(benchPayload, 0);
+}
+
+static void benchOpSort() {
+    memcpy(benchScratch, benchSource, sizeof(CryptoPosition) * benchCount);
+    sortPositionsByLoss(benchScratch, benchCount);
+}
+
+static void benchOpEntryAlerts() {
+    memcpy(portfolios[0].data, benchSource, sizeof(CryptoPosition) * benchCount);
+    portfolios[0].count = benchCount;
+    processEntryAlerts(0);
+}
+
+static void benchOpExitAlerts() {
+    memcpy(portfolios[1].data, benchExitSource, sizeof(CryptoPosition) * benchCount);
+    portfolios[1].count = benchCount;
+    processExitAlerts(1);
+}
+
+static void benchOpRender() {
+    showMainDisplay();
+}
+
+// 4 قانون برای همه نمادها و بقیه روی نمادهای B0000.. با metric و آستانه‌های متفاوت
+static void benchBuildRules() {
+    static const struct { uint8_t metric; uint8_t flags; float value; } wildcard[] = {
+        { RULE_METRIC_PNL_PERCENT, RULE_FLAG_SEVERE, -15.0f },
+        { RULE_METRIC_LOSS_MINUTES, RULE_FLAG_ABOVE, 30.0f },
+        { RULE_METRIC_MOVE_PERCENT, RULE_FLAG_ABOVE, 10.0f },
+        { RULE_METRIC_PNL_VALUE, 0, -5000.0f },
+    };
+    const int wildcardCount = sizeof(wildcard) / sizeof(wildcard[0]);
+    
+    memset(benchRules, 0, sizeof(AlertRule) * BENCH_RULES);
+    for (int k = 0; k < BENCH_RULES; k++) {
+        AlertRule* rule = &benchRules[k];
+        rule->slotMask = RULE_SLOT_ANY;
+        if (k < wildcardCount) {
+            rule->metric = wildcard[k].metric;
+            rule->flags = wildcard[k].flags;
+            rule->value = wildcard[k].value;
+        } else {
+            int n = k - wildcardCount;
+            snprintf(rule->symbol, sizeof(rule->symbol), "B%04dUSDT", n % MAX_POSITIONS_PER_MODE);
+            switch (n % 4) {
+                case 0: rule->metric = RULE_METRIC_PNL_PERCENT; rule->value = -(float)(n % 15); break;
+                case 1: rule->metric = RULE_METRIC_MOVE_PERCENT; rule->flags = RULE_FLAG_ABOVE; rule->value = n % 10; break;
+                case 2: rule->metric = RULE_METRIC_PRICE; rule->flags = RULE_FLAG_ABOVE; rule->value = 1000.0f * (n % 50); break;
+                default: rule->metric = RULE_METRIC_PNL_VALUE; rule->value = -10.0f * (n % 100); break;
+            }
+        }
+        rule->rearm = rule->metric == RULE_METRIC_PRICE ? rule->value * RULE_DEFAULT_REARM_FRACTION : RULE_DEFAULT_REARM_PERCENT;
+    }
+}
+
+// همه ردیف‌ها تازه (مثل parse اول)
+static void benchOpRulesAll() {
+    memcpy(portfolios[0].data, benchSource, sizeof(CryptoPosition) * benchCount);
+    portfolios[0].count = benchCount;
+    rulesEvaluate(0);
+}
+
+// حالت پایدار: بعد از rules_all فقط یک ردیف از هر BENCH_RULES_CHANGED_STEP تغییر کرده
+static void benchOpRulesChanged() {
+    CryptoPosition* data = portfolios[0].data;
+    for (int i = benchRuleRound++ % BENCH_RULES_CHANGED_STEP; i < benchCount; i += BENCH_RULES_CHANGED_STEP) {
+        data[i].ruleDirty = true;
+    }
+    rulesEvaluate(0);
+}
+
+static void benchMeasure(BenchResult* result, const char* name, void (*op)()) {
+    uint32_t iterations = 0;
+    uint32_t allocStart = benchAllocatedBytes;
+    unsigned long start = micros();
+    unsigned long elapsed;
+    
+    do {
+        op();
+        iterations++;
+        elapsed = micros() - start;
+    } while (elapsed < BENCH_MIN_MICROS && iterations < BENCH_MAX_ITERATIONS);
+    
+    uint32_t allocated = benchAllocatedBytes - allocStart;
+    snprintf(result->name, sizeof(result->name), "%s", name);
+    result->size = benchCount;
+    result->iterations = iterations;
+    result->nsPerOp = elapsed * 1000.0f / iterations;
+    result->bytesPerOp = BENCH_COUNTS_ALLOCATIONS ? (float)allocated / iterations : -1;
+}
+
+static void benchPrintResult(const BenchResult* result, Print& out) {
+    char line[96];
+    char bytes[16];
+    if (result->bytesPerOp >= 0) {
+        snprintf(bytes, sizeof(bytes), "%.0f", result->bytesPerOp);
+    } else {
+        snprintf(bytes, sizeof(bytes), "-");
+    }
+    snprintf(line, sizeof(line), "%-14s %5d %9lu %14.0f %10s",
+             result->name, result->size, (unsigned long)result->iterations, result->nsPerOp, bytes);
+    out.print(line);
+}
+
+// نتایج را پر می‌کند و تعدادشان را برمی‌گرداند؛ داده و تنظیمات واقعی در پایان بازگردانده می‌شوند
+int runBenchmarks(BenchResult* results, int maxResults, Print& out) {
+    lockData();
+    size_t arrayBytes = sizeof(CryptoPosition) * MAX_POSITIONS_PER_MODE;
+    size_t savedBytes1 = sizeof(CryptoPosition) * (portfolios[0].count + 1);
+    size_t savedBytes2 = sizeof(CryptoPosition) * (portfolios[1].count + 1);
+    CryptoPosition* saved1 = (CryptoPosition*)(psramFound() ? ps_malloc(savedBytes1) : malloc(savedBytes1));
+    CryptoPosition* saved2 = (CryptoPosition*)(psramFound() ? ps_malloc(savedBytes2) : malloc(savedBytes2));
+    benchSource = (CryptoPosition*)(psramFound() ? ps_malloc(arrayBytes) : malloc(arrayBytes));
+    benchExitSource = (CryptoPosition*)(psramFound() ? ps_malloc(arrayBytes) : malloc(arrayBytes));
+    benchScratch = (CryptoPosition*)(psramFound() ? ps_malloc(arrayBytes) : malloc(arrayBytes));
+    benchRules = (AlertRule*)(psramFound() ? ps_malloc(sizeof(AlertRule) * BENCH_RULES) : malloc(sizeof(AlertRule) * BENCH_RULES));
+    int count = 0;
+    
+    if (saved1 == NULL || saved2 == NULL || benchSource == NULL || benchExitSource == NULL || benchScratch == NULL ||
+        benchRules == NULL) {
+        out.println("bench: out of memory");
+    } else {
+        memcpy(saved1, portfolios[0].data, sizeof(CryptoPosition) * portfolios[0].count);
+        memcpy(saved2, portfolios[1].data, sizeof(CryptoPosition) * portfolios[1].count);
+        int savedCount1 = portfolios[0].count;
+        int savedCount2 = portfolios[1].count;
+        PortfolioSummary savedSummary1 = portfolios[0].summary;
+        PortfolioSummary savedSummary2 = portfolios[1].summary;
+        PortfolioAggregate savedAggregate1 = portfolios[0].aggregate;
+        PortfolioAggregate savedAggregate2 = portfolios[1].aggregate;
+        SystemSettings savedSettings = settings;
+        bool savedShowingAlert = showingAlert;
+        
+        settings.exitAlertEnabled = true;
+        showingAlert = false;
+        benchmarkRunning = true;
+        benchmarkAlerts = 0;
+        benchBuildRules();
+        rulesCompile(benchRules, BENCH_RULES);
+        
+        out.printf("%-14s %5s %9s %14s %10s\n", "benchmark", "size", "iters", "ns/op", "B/op");
+        for (size_t s = 0; s < sizeof(benchSizes) / sizeof(benchSizes[0]); s++) {
+            int requested = benchSizes[s];
+            if (requested > MAX_POSITIONS_PER_MODE) {
+                out.printf("(size %d skipped: MAX_POSITIONS_PER_MODE is %d)\n", requested, MAX_POSITIONS_PER_MODE);
+                continue;
+            }
+            
+            benchBuildPayload(requested);
+            parseCryptoData(benchPayload, 0);
+            benchCount = portfolios[0].count;
+            if (benchCount < requested) {
+                out.printf("(size %d: only %d positions parsed)\n", requested, benchCount);
+            }
+            positionStoreReserve(1, benchCount);
+            // همه ردیف‌ها تغییر کرده علامت می‌خورند تا آلرت‌ها مثل parse اول همه را بررسی کنند
+            for (int i = 0; i < benchCount; i++) portfolios[0].data[i].ruleDirty = true;
+            memcpy(benchSource, portfolios[0].data, sizeof(CryptoPosition) * benchCount);
+            memcpy(benchExitSource, benchSource, sizeof(CryptoPosition) * benchCount);
+            for (int i = 0; i < benchCount; i++) {
+                benchExitSource[i].exitAlertLastPrice = benchSource[i].currentPrice * (100 - i % 7) / 100;
+            }
+            
+            struct { const char* name; void (*op)(); } ops[] = {
+                { "parse", benchOpParse },
+                { "sort", benchOpSort },
+                { "entry_alerts", benchOpEntryAlerts },
+                { "exit_alerts", benchOpExitAlerts },
+                { "render", benchOpRender },
+                { "rules_all", benchOpRulesAll },
+                { "rules_changed", benchOpRulesChanged },
+            };
+            for (size_t o = 0; o < sizeof(ops) / sizeof(ops[0]) && count < maxResults; o++) {
+                benchMeasure(&results[count], ops[o].name, ops[o].op);
+                benchPrintResult(&results[count], out);
+                out.println();
+                count++;
+            }
+        }
+        
+        benchmarkRunning = false;
+        benchPayload = String();
+        memcpy(portfolios[0].data, saved1, sizeof(CryptoPosition) * savedCount1);
+        memcpy(portfolios[1].data, saved2, sizeof(CryptoPosition) * savedCount2);
+        portfolios[0].count = savedCount1;
+        portfolios[1].count = savedCount2;
+        positionHotRebuild(0);
+        positionHotRebuild(1);
+        symbolTableRebuild();
+        rulesCompile(alertRules, alertRuleCount);
+        portfolios[0].summary = savedSummary1;
+        portfolios[1].summary = savedSummary2;
+        portfolios[0].aggregate = savedAggregate1;
+        portfolios[1].aggregate = savedAggregate2;
+        settings = savedSettings;
+        showingAlert = savedShowingAlert;
+        dataVersion++;
+        
+        lastDisplayUpdate = 0;   // صفحه در loop بعدی با داده واقعی دوباره رسم می‌شود
+        out.printf("alerts suppressed: %lu\n", benchmarkAlerts);
+    }
+    unlockData();
+    
+    free(saved1);
+    free(saved2);
+    free(benchSource);
+    free(benchExitSource);
+    free(benchScratch);
+    free(benchRules);
+    benchSource = benchExitSource = benchScratch = NULL;
+    benchRules = NULL;
+    return count;
+}
+
+// baseline: هر خط "name size nsPerOp bytesPerOp"
+String benchBaselineText(const BenchResult* results, int count) {
+    String text;
+    char line[64];
+    for (int i = 0; i < count; i++) {
+        snprintf(line, sizeof(line), "%s %d %.0f %.0f\n",
+                 results[i].name, results[i].size, results[i].nsPerOp, results[i].bytesPerOp);
+        text += line;
+    }
+    return text;
+}
+
+// تعداد regression ها را برمی‌گرداند؛ موردی که در baseline نیست مقایسه نمی‌شود
+int benchCompare(const BenchResult* results, int count, const String& baseline, int tolerancePercent, Print& out) {
+    int regressions = 0;
+    
+    for (int i = 0; i < count; i++) {
+        const char* line = baseline.c_str();
+        while (line != NULL && *line != '\0') {
+            char name[16];
+            int size;
+            float baseNs, baseBytes;
+            if (sscanf(line, "%15s %d %f %f", name, &size, &baseNs, &baseBytes) == 4 &&
+                strcmp(name, results[i].name) == 0 && size == results[i].size) {
+                bool slower = results[i].nsPerOp > baseNs * (100 + tolerancePercent) / 100.0f;
+                bool heavier = baseBytes >= 0 && results[i].bytesPerOp >= 0 &&
+                               results[i].bytesPerOp > baseBytes * (100 + tolerancePercent) / 100.0f + BENCH_BYTES_SLACK;
+                if (slower || heavier) {
+                    regressions++;
+                    out.printf("REGRESSION %s/%d: %.0f ns/op (baseline %.0f), %.0f B/op (baseline %.0f)\n",
+                               name, size, results[i].nsPerOp, baseNs, results[i].bytesPerOp, baseBytes);
+                }
+                break;
+            }
+            line = strchr(line, '\n');
+            if (line != NULL) line++;
+        }
+    }
+    
+    if (regressions == 0) {
+        out.printf("no regressions (tolerance %d%%)\n", tolerancePercent);
+    }
+    return regressions;
+}
+
+// دستور سریال "bench" (مقایسه با baseline ذخیره شده) یا "bench save" (ذخیره baseline جدید)
+void runSerialBenchmark(bool saveBaseline) {
+    BenchResult results[BENCH_MAX_RESULTS];
+    int count = runBenchmarks(results, BENCH_MAX_RESULTS, Serial);
+    if (count == 0) return;
+    
+    if (saveBaseline) {
+        File file = LittleFS.open(BENCH_BASELINE_FILE, "w");
+        if (file) {
+            String text = benchBaselineText(results, count);
+            file.write((const uint8_t*)text.c_str(), text.length());
+            file.close();
+            Serial.println("Baseline saved to " BENCH_BASELINE_FILE);
+        }
+        return;
+    }
+    
+    File file = LittleFS.open(BENCH_BASELINE_FILE, "r");
+    if (!file) {
+        Serial.println("No baseline yet; run \"bench save\" to store one");
+        return;
+    }
+    String baseline;
+    while (file.available()) baseline += (char)file.read();
+    file.close();
+    
+    if (benchCompare(results, count, baseline, BENCH_TOLERANCE_PERCENT, Serial) > 0) {
+        Serial.println("!!! BENCHMARK REGRESSION !!!");
+    }
+}
+
+void handleSerialCommands() {
+    static char line[32];
+    static size_t length = 0;
+    
+    while (Serial.available() > 0) {
+        char c = (char)Serial.read();
+        if (c != '\n' && c != '\r') {
+            if (length < sizeof(line) - 1) line[length++] = c;
+            continue;
+        }
+        if (length == 0) continue;
+        line[length] = '\0';
+        length = 0;
+        
+        if (strcmp(line, "bench") == 0) {
+            runSerialBenchmark(false);
+        } else if (strcmp(line, "bench save") == 0) {
+            runSerialBenchmark(true);
+        } else {
+            Serial.printf("Unknown command: %s (try \"bench\" or \"bench save\")\n", line);
+        }
+    }
+}
+
+// ===== ALERT HISTORY PAGE =====
+// /alerthistory?mode=all|entry|exit&from=<epoch>&to=<epoch>&limit=N
+// رکوردها مستقیم و تکه‌تکه از فایل لاگ خوانده و ارسال می‌شوند؛ کل لاگ در RAM بارگذاری نمی‌شود.
+// فقط خواندن هر تکه زیر قفل است (appendAlertLog / compactAlertLog در loop)؛ ارسال بیرون از قفل.
+#define ALERT_HISTORY_PAGE_LIMIT 500
+
+void handleAlertHistory() {
+    String modeArg = server.arg("mode");
+    int modeFilter = portfolioFromArg(modeArg, -1);
+    uint32_t from = server.hasArg("from") ? strtoul(server.arg("from").c_str(), NULL, 10) : 0;
+    uint32_t to = server.hasArg("to") ? strtoul(server.arg("to").c_str(), NULL, 10) : 0xFFFFFFFF;
+    int limit = apiArgInt("limit", 200, 1, ALERT_HISTORY_PAGE_LIMIT);
+    
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server.send(200, "text/html", "");
+    server.sendContent(R"rawliteral(
 <!DOCTYPE html>
 <html>
 <head>
     <meta charset="UTF-8">
-    <meta name="viewport" content="width=device-width, initial=1.0">
-    <title>Portfolio Monitor Dashboard</title>
-    <style>
-        body { font-family: Arial, sans-serif; margin: 20px; background: #1a1a1a; color: #fff; }
-        .container { max-width: 1200px; margin: 0 auto; }
-        .dashboard-grid { display: grid; grid-template-columns: repeat(auto-fit, minmax(300px, 1fr)); gap: 20px; }
-        .card { background: #2d2d2d; padding: 20px; border-radius: 10px; }
-        .card-header { font-size: 18px; font-weight: bold; margin-bottom: 15px; color: #0088ff; }
-        .stats-grid { display: grid; grid-template-columns: repeat(2, 1fr); gap: 10px; }
-        .stat-item { background: #3a3a3a; padding: 10px; border-radius: 5px; }
-        .stat-label { font-size: 12px; color: #aaa; }
-        .stat-value { font-size: 18px; font-weight: bold; }
-        .positive { color: #00ff00; }
-        .negative { color: #ff3333; }
-        .btn { 
-            background: #0088ff; 
-            color: white; 
-            padding: 10px 20px; 
-            border: none; 
-            border-radius: 5px; 
-            cursor: pointer;
-            text-decoration: none;
-            display: inline-block;
-            margin: 5px;
-        }
-        .btn:hover { background: #0066cc; }
-        .btn-success { background: #00cc00; }
-        .btn-danger { background: #ff3333; }
-        .btn-warning { background: #ff9900; }
-        .ap-status { display: inline-block; padding: 5px 10px; border-radius: 20px; font-size: 14px; font-weight: bold; margin-left: 10px; }
-        .ap-on { background-color: #28a745; color: white; }
-        .ap-off { background-color: #dc3545; color: white; }
-    </style>
+    <meta name="viewport" content="width=device-width, initial-scale=1.0">
+    <title>Alert History</title>
+    <link rel="stylesheet" href="/static/common.css?v=)rawliteral" WEB_ASSET_COMMON_CSS_HASH R"rawliteral(">
 </head>
 <body>
     <div class="container">
-        <h1>📊 Portfolio Monitor Dashboard 
-            <span class="ap-status )rawliteral";
-    html += apEnabled ? "ap-on" : "ap-off";
-    html += R"rawliteral(">AP: )rawliteral";
-    html += apEnabled ? "ON" : "OFF";
-    html += R"rawliteral(</span>
-        </h1>
-        
-        <div style="margin-bottom: 20px;">
-            <a href="/refresh" class="btn">🔄 Refresh Data</a>
-            <a href="/setup" class="btn">⚙️ Setup</a>
-            <a href="/systeminfo" class="btn">📊 System Info</a>
-            <a href="/testalert" class="btn btn-warning">🔊 Test Alert</a>
-            <a href="/resetalerts" class="btn btn-danger">🔄 Reset Alerts</a>
-            <a href="/toggleap" class="btn )rawliteral";
-    html += apEnabled ? "btn-warning" : "btn-success";
-    html += R"rawliteral(">)rawliteral";
-    html += apEnabled ? "🔴 Disable AP" : "🟢 Enable AP";
-    html += R"rawliteral(</a>
-        </div>
-        
-        <div class="dashboard-grid">
-            <!-- Entry Mode Card -->
-            <div class="card">
-                <div class="card-header">📈 Entry Mode: )rawliteral";
-    html += String(settings.entryPortfolio);
-    html += R"rawliteral(</div>
-                <div class="stats-grid">
-                    <div class="stat-item">
-                        <div class="stat-label">Positions</div>
-                        <div class="stat-value">)rawliteral";
-    html += String(cryptoCountMode1);
-    html += R"rawliteral(</div>
-                    </div>
-                    <div class="stat-item">
-                        <div class="stat-label">Total P/L</div>
-                        <div class="stat-value )rawliteral";
-    html += (portfolioMode1.totalPnlPercent >= 0 ? "positive" : "negative");
-    html += R"rawliteral(">)rawliteral";
-    html += formatPercent(portfolioMode1.totalPnlPercent);
-    html += R"rawliteral(</div>
-                    </div>
-                    <div class="stat-item">
-                        <div class="stat-label">Total Value</div>
-                        <div class="stat-value">$)rawliteral";
-    html += formatNumber(portfolioMode1.totalCurrentValue);
-    html += R"rawliteral(</div>
-                    </div>
-                    <div class="stat-item">
-                        <div class="stat-label">Win Rate</div>
-                        <div class="stat-value">)rawliteral";
-    if (portfolioMode1.totalPositions > 0) {
-        float winRate = (portfolioMode1.winningPositions * 100.0) / portfolioMode1.totalPositions;
-        html += String(winRate, 1) + "%";
-    } else {
-        html += "0%";
+        <h1>🔔 Alert History</h1>
+        <form class="card" onsubmit="var f=this;['from','to'].forEach(function(k){var v=f[k+'_local'].value;f[k].value=v?Math.floor(new Date(v).getTime()/1000):'';});">
+            <select name="mode">
+                <option value="all">All modes</option>
+                <option value="entry">Entry</option>
+                <option value="exit">Exit</option>
+            </select>
+            From <input type="datetime-local" name="from_local">
+            To <input type="datetime-local" name="to_local">
+            <input type="hidden" name="from">
+            <input type="hidden" name="to">
+            <button class="btn" type="submit">Search</button>
+        </form>
+        <table>
+            <thead>
+                <tr><th>Time</th><th>Mode</th><th>Symbol</th><th>Side</th><th>P/L %</th><th>Price</th><th>Type</th></tr>
+            </thead>
+            <tbody>
+)rawliteral");
+    
+    int matched = 0;
+    int scanned = 0;
+    
+    if (alertLogReady) {
+        AlertRecord chunk[ALERT_LOG_CHUNK];
+        size_t position = 0;
+        size_t bytes = 1;
+        
+        while (matched < limit && bytes > 0) {
+            bytes = 0;
+            lockData();
+            File log = LittleFS.open(ALERT_LOG_FILE, "r");
+            if (log) {
+                if (log.seek(position)) bytes = log.read((uint8_t*)chunk, sizeof(chunk));
+                log.close();
+            }
+            unlockData();
+            position += bytes;
+            
+            int n = bytes / sizeof(AlertRecord);
+            String rows = "";
+            
+            for (int i = 0; i < n && matched < limit; i++) {
+                const AlertRecord* r = &chunk[i];
+                scanned++;
+                
+                byte mode = alertRecordSlot(r);
+                if (modeFilter >= 0 && mode != modeFilter) continue;
+                // رکوردهای بدون زمان واقعی فقط وقتی بازه زمانی داده نشده نمایش داده می‌شوند
+                if (!(r->flags & ALERT_FLAG_EPOCH) && (from > 0 || to != 0xFFFFFFFF)) continue;
+                if ((r->flags & ALERT_FLAG_EPOCH) && (r->timestamp < from || r->timestamp > to)) continue;
+                
+                char timeString[20];
+                char row[256];
+                formatAlertTime(r, timeString, sizeof(timeString));
+                snprintf(row, sizeof(row),
+                         "<tr class='%s'><td>%s</td><td>%s</td><td><strong>%s</strong></td><td class='%s'>%s</td>"
+                         "<td class='%s'>%+.2f%%</td><td>$%.8g</td><td>%d</td></tr>\n",
+                         (r->flags & ALERT_FLAG_SEVERE) ? "severe-alert" : "",
+                         timeString, portfolioLabel(mode), alertSymbolName(r->symbolId),
+                         (r->flags & ALERT_FLAG_LONG) ? "long" : "short", (r->flags & ALERT_FLAG_LONG) ? "LONG" : "SHORT",
+                         r->pnlPercent >= 0 ? "positive" : "negative", r->pnlPercent, r->alertPrice, r->alertType & ALERT_TYPE_MASK);
+                rows += row;
+                matched++;
+            }
+            
+            if (rows.length() > 0) server.sendContent(rows);
+        }
+    }
+    
+    String footer = "</tbody></table><p>" + String(matched) + " alerts shown (" + String(scanned) +
+                    " records scanned)</p><a href='/' class='btn'>← Back to Dashboard</a></div></body></html>";
+    server.sendContent(footer);
+    server.sendContent("");
+}
+
+// ===== SERVER-SENT EVENTS =====
+// /events: کلاینت‌های مرورگر یک اتصال باز نگه می‌دارند و تغییرات به صورت delta ارسال می‌شود.
+// رویدادها در یک صف حلقوی مشترک هستند و هر کلاینت فقط یک نشانگر (nextEventId) دارد؛
+// کلاینت کند در هر دور حداکثر SSE_MAX_EVENTS_PER_PUMP رویداد می‌گیرد و اگر از صف عقب
+// بیفتد رویدادهای قدیمی برایش drop شده و یک resync دریافت می‌کند.
+#define SSE_MAX_CLIENTS 10
+#define SSE_EVENT_QUEUE 24     // یک snapshot کامل دو مود با 100 موقعیت جا می‌شود
+#define SSE_MAX_EVENTS_PER_PUMP 4
+#define SSE_KEEPALIVE_INTERVAL 15000
+#define SSE_MAX_WRITE_FAILURES 3
+
+SSEEvent sseEvents[SSE_EVENT_QUEUE];
+SSEClient sseClients[SSE_MAX_CLIENTS];
+unsigned long sseNextEventId = 1;
+unsigned long sseTotalPublished = 0;
+unsigned long sseRejectedClients = 0;
+
+int sseActiveClients() {
+    int active = 0;
+    for (int i = 0; i < SSE_MAX_CLIENTS; i++) {
+        if (sseClients[i].active) active++;
+    }
+    return active;
+}
+
+void ssePublish(const char* type, const char* json) {
+    if (sseActiveClients() == 0) return;
+    
+    lockData();
+    SSEEvent* event = &sseEvents[sseNextEventId % SSE_EVENT_QUEUE];
+    event->id = sseNextEventId;
+    strncpy(event->type, type, sizeof(event->type) - 1);
+    event->type[sizeof(event->type) - 1] = '\0';
+    strncpy(event->data, json, SSE_EVENT_SIZE - 1);
+    event->data[SSE_EVENT_SIZE - 1] = '\0';
+    
+    sseNextEventId++;
+    sseTotalPublished++;
+    unlockData();
+}
+
+uint32_t ssePositionHash(const CryptoPosition* pos) {
+    // FNV-1a روی نماد + قیمت + درصد
+    uint32_t hash = 2166136261UL;
+    for (const char* c = pos->symbol; *c; c++) {
+        hash = (hash ^ (uint8_t)*c) * 16777619UL;
+    }
+    uint32_t bits[3];
+    memcpy(&bits[0], &pos->currentPrice, sizeof(Money));
+    memcpy(&bits[2], &pos->changePercent, sizeof(float));
+    for (int i = 0; i < 3; i++) {
+        hash = (hash ^ bits[i]) * 16777619UL;
+    }
+    return hash;
+}
+
+void ssePublishPortfolio(byte mode) {
+    if (sseActiveClients() == 0) return;
+    
+    lockData();
+    PortfolioSummary* summary = &portfolios[mode].summary;
+    CryptoPosition* data = portfolios[mode].data;
+    PositionHot* hot = portfolios[mode].hot;
+    int count = portfolios[mode].count;
+    
+    char buffer[SSE_EVENT_SIZE];
+    snprintf(buffer, sizeof(buffer),
+             "{\"m\":%d,\"v\":%lu,\"n\":%d,\"pnl\":%.2f,\"value\":%.2f,\"win\":%d,\"lose\":%d,\"dd\":%.2f}",
+             mode, dataVersion, count, summary->totalPnlPercent, moneyToDouble(summary->totalCurrentValue),
+             summary->winningPositions, summary->losingPositions, summary->maxDrawdown);
+    ssePublish("summary", buffer);
+    
+    // فقط موقعیت‌های تغییر کرده (hash آخرین ارسال در شاخص داغ): [["BTC",65000.1,-1.23],...]
+    int header = snprintf(buffer, sizeof(buffer), "{\"m\":%d,\"p\":[", mode);
+    int used = header;
+    
+    for (int i = 0; i < count; i++) {
+        uint32_t hash = ssePositionHash(&data[i]);
+        if (hash == hot[i].sseHash) continue;
+        hot[i].sseHash = hash;
+        
+        char row[72];
+        char symbol[16];
+        char price[24];
+        apiCopySafe(symbol, data[i].symbol, sizeof(symbol));
+        moneyFormatTrim(data[i].currentPrice, price, sizeof(price));
+        int rowLen = snprintf(row, sizeof(row), "%s[\"%s\",%s,%.2f]",
+                              used > header ? "," : "", symbol, price, data[i].changePercent);
+        
+        if (used + rowLen + 3 >= (int)sizeof(buffer)) {
+            strcpy(buffer + used, "]}");
+            ssePublish("positions", buffer);
+            used = header;
+            rowLen = snprintf(row, sizeof(row), "[\"%s\",%s,%.2f]",
+                              symbol, price, data[i].changePercent);
+        }
+        
+        memcpy(buffer + used, row, rowLen);
+        used += rowLen;
     }
-    html += R"rawliteral(</div>
-                    </div>
-                </div>
-                <div style="margin-top: 15px;">
-                    <a href="/positions?mode=entry" class="btn">View Positions</a>
-                </div>
-            </div>
-            
-            <!-- Exit Mode Card -->
-            <div class="card">
-                <div class="card-header">📉 Exit Mode: )rawliteral";
-    html += String(settings.exitPortfolio);
-    html += R"rawliteral(</div>
-                <div class="stats-grid">
-                    <div class="stat-item">
-                        <div class="stat-label">Positions</div>
-                        <div class="stat-value">)rawliteral";
-    html += String(cryptoCountMode2);
-    html += R"rawliteral(</div>
-                    </div>
-                    <div class="stat-item">
-                        <div class="stat-label">Total P/L</div>
-                        <div class="stat-value )rawliteral";
-    html += (portfolioMode2.totalPnlPercent >= 0 ? "positive" : "negative");
-    html += R"rawliteral(">)rawliteral";
-    html += formatPercent(portfolioMode2.totalPnlPercent);
-    html += R"rawliteral(</div>
-                    </div>
-                    <div class="stat-item">
-                        <div class="stat-label">Total Value</div>
-                        <div class="stat-value">$)rawliteral";
-    html += formatNumber(portfolioMode2.totalCurrentValue);
-    html += R"rawliteral(</div>
-                    </div>
-                    <div class="stat-item">
-                        <div class="stat-label">Max Drawdown</div>
-                        <div class="stat-value negative">)rawliteral";
-    html += formatPercent(portfolioMode2.maxDrawdown);
-    html += R"rawliteral(</div>
-                    </div>
-                </div>
-                <div style="margin-top: 15px;">
-                    <a href="/positions?mode=exit" class="btn">View Positions</a>
-                </div>
-            </div>
-            
-            <!-- System Status Card -->
-            <div class="card">
-                <div class="card-header">⚡ System Status</div>
-                <div class="stats-grid">
-                    <div class="stat-item">
-                        <div class="stat-label">WiFi Status</div>
-                        <div class="stat-value )rawliteral";
-    html += (isConnectedToWiFi ? "positive" : "negative");
-    html += R"rawliteral(">)rawliteral";
-    if (isConnectedToWiFi) {
-        html += "Connected";
-    } else if (apModeActive) {
-        html += "AP Mode";
-    } else {
-        html += "Disconnected";
+    
+    if (used > header) {
+        strcpy(buffer + used, "]}");
+        ssePublish("positions", buffer);
     }
-    html += R"rawliteral(</div>
-                    </div>
-                    <div class="stat-item">
-                        <div class="stat-label">Uptime</div>
-                        <div class="stat-value">)rawliteral";
-    html += getUptimeString();
-    html += R"rawliteral(</div>
-                    </div>
-                    <div class="stat-item">
-                        <div class="stat-label">Memory Free</div>
-                        <div class="stat-value">)rawliteral";
-    html += String(ESP.getFreeHeap() / 1024) + " KB";
-    html += R"rawliteral(</div>
-                    </div>
-                    <div class="stat-item">
-                        <div class="stat-label">Battery</div>
-                        <div class="stat-value">)rawliteral";
-    if (powerSource == POWER_SOURCE_USB) {
-        html += "USB";
-    } else {
-        html += String(batteryPercent) + "%";
+    unlockData();
+}
+
+void ssePublishAlert(const char* title, const char* symbol, const char* message, float price, bool isSevere, byte mode) {
+    if (sseActiveClients() == 0) return;
+    
+    char safeTitle[32], safeSymbol[16], safeMessage[64];
+    apiCopySafe(safeTitle, title, sizeof(safeTitle));
+    apiCopySafe(safeSymbol, symbol, sizeof(safeSymbol));
+    apiCopySafe(safeMessage, message, sizeof(safeMessage));
+    
+    char buffer[SSE_EVENT_SIZE];
+    snprintf(buffer, sizeof(buffer),
+             "{\"m\":%d,\"title\":\"%s\",\"s\":\"%s\",\"msg\":\"%s\",\"price\":%.8g,\"severe\":%s}",
+             mode, safeTitle, safeSymbol, safeMessage, price, isSevere ? "true" : "false");
+    ssePublish("alert", buffer);
+}
+
+void sseCloseClient(SSEClient* c) {
+    c->client.stop();
+    c->active = false;
+}
+
+bool sseWrite(SSEClient* c, const char* text, size_t length) {
+    size_t written = c->client.write((const uint8_t*)text, length);
+    if (written != length) {
+        c->writeFailures++;
+        return false;
+    }
+    c->writeFailures = 0;
+    c->bytesSent += written;
+    c->lastWrite = millis();
+    return true;
+}
+
+void handleEvents() {
+    int slot = -1;
+    for (int i = 0; i < SSE_MAX_CLIENTS; i++) {
+        if (!sseClients[i].active) {
+            slot = i;
+            break;
+        }
     }
-    html += R"rawliteral(</div>
-                    </div>
-                </div>
-            </div>
-            
-            <!-- Quick Actions Card -->
-            <div class="card">
-                <div class="card-header">🚀 Quick Actions</div>
-                <div style="display: flex; flex-wrap: wrap; gap: 10px; margin-top: 15px;">
-                    <a href="/ledcontrol?action=test" class="btn btn-warning">Test LEDs</a>
-                    <a href="/rgbcontrol?action=test" class="btn btn-warning">Test RGB</a>
-                    <a href="/displaycontrol?action=test" class="btn btn-warning">Test Display</a>
-                    <a href="/wifimanage" class="btn">WiFi Manager</a>
-                    <a href="/apistatus" class="btn">API Status</a>
-                    <a href="/factoryreset" class="btn btn-danger">Factory Reset</a>
-                    <a href="/restart" class="btn">Restart</a>
-                </div>
-                <div style="margin-top: 15px;">
-                    <h4>🎚️ Volume Control</h4>
-                    <div>
-                        <button onclick="setVolume(0)" class="btn">🔇 Mute</button>
-                        <button onclick="setVolume(25)" class="btn">Quiet</button>
-                        <button onclick="setVolume(50)" class="btn">Medium</button>
-                        <button onclick="setVolume(75)" class="btn">Loud</button>
-                        <button onclick="setVolume(100)" class="btn">🔊 Max</button>
-                        <button onclick="testCurrentVolume()" class="btn btn-warning">Test</button>
-                    </div>
-                    <div style="margin-top: 10px;">
-                        <span id="currentVolume">Current: )rawliteral";
-    html += String(settings.buzzerVolume);
-    html += R"rawliteral(%</span>
-                    </div>
-                </div>
-            </div>
-        </div>
-    </div>
     
-    <script>
-        function setVolume(volume) {
-            fetch('/setvolume?volume=' + volume)
-                .then(response => response.text())
-                .then(text => {
-                    document.getElementById('currentVolume').textContent = 'Current: ' + volume + '%';
-                    alert(text);
-                });
+    if (slot < 0) {
+        sseRejectedClients++;
+        server.send(503, "text/plain", "Too many event clients");
+        return;
+    }
+    
+    SSEClient* c = &sseClients[slot];
+    c->client = server.client();
+    c->active = true;
+    c->nextEventId = sseNextEventId;
+    c->connectedAt = millis();
+    c->sentCount = 0;
+    c->droppedCount = 0;
+    c->bytesSent = 0;
+    c->maxQueueDepth = 0;
+    c->writeFailures = 0;
+    
+    const char* headers = "HTTP/1.1 200 OK\r\n"
+                          "Content-Type: text/event-stream\r\n"
+                          "Cache-Control: no-cache\r\n"
+                          "Connection: keep-alive\r\n"
+                          "Access-Control-Allow-Origin: *\r\n\r\n"
+                          "retry: 3000\n\n";
+    if (!sseWrite(c, headers, strlen(headers))) {
+        sseCloseClient(c);
+        return;
+    }
+    
+    // کلاینت جدید باید همه ردیف‌ها را یک بار بگیرد
+    lockData();
+    for (int m = 0; m < portfolioCount; m++) {
+        for (int i = 0; i < portfolios[m].capacity; i++) portfolios[m].hot[i].sseHash = 0;
+        if (portfolios[m].count > 0) ssePublishPortfolio(m);
+    }
+    unlockData();
+    
+    Serial.println("SSE client connected (slot " + String(slot) + ", " + String(sseActiveClients()) + " active)");
+}
+
+void ssePump() {
+    unsigned long now = millis();
+    unsigned long oldestId = (sseNextEventId > SSE_EVENT_QUEUE) ? sseNextEventId - SSE_EVENT_QUEUE : 1;
+    
+    for (int i = 0; i < SSE_MAX_CLIENTS; i++) {
+        SSEClient* c = &sseClients[i];
+        if (!c->active) continue;
+        
+        if (!c->client.connected() || c->writeFailures >= SSE_MAX_WRITE_FAILURES) {
+            Serial.println("SSE client disconnected (slot " + String(i) + ")");
+            sseCloseClient(c);
+            continue;
         }
         
-        function testCurrentVolume() {
-            fetch('/testvolume')
-                .then(response => response.text())
-                .then(text => {
-                    alert(text);
-                });
+        // عقب افتادن بیش از ظرفیت صف → رویدادهای قدیمی drop و resync
+        if (c->nextEventId < oldestId) {
+            c->droppedCount += oldestId - c->nextEventId;
+            c->nextEventId = oldestId;
+            const char* resync = "event: resync\ndata: {}\n\n";
+            sseWrite(c, resync, strlen(resync));
         }
         
-        setTimeout(function() {
-            location.reload();
-        }, 30000);
-    </script>
-</body>
-</html>)rawliteral";
+        int depth = sseNextEventId - c->nextEventId;
+        if (depth > c->maxQueueDepth) c->maxQueueDepth = depth;
+        
+        for (int n = 0; n < SSE_MAX_EVENTS_PER_PUMP && c->nextEventId < sseNextEventId; n++) {
+            // فریم زیر قفل کپی و بدون قفل نوشته می‌شود (نوشتن روی سوکت ممکن است کند باشد)
+            char frame[SSE_EVENT_SIZE + 48];
+            lockData();
+            SSEEvent* event = &sseEvents[c->nextEventId % SSE_EVENT_QUEUE];
+            int length = snprintf(frame, sizeof(frame), "id: %lu\nevent: %s\ndata: %s\n\n",
+                                  event->id, event->type, event->data);
+            unlockData();
+            
+            if (!sseWrite(c, frame, min(length, (int)sizeof(frame) - 1))) break;
+            c->nextEventId++;
+            c->sentCount++;
+        }
+        
+        if (now - c->lastWrite > SSE_KEEPALIVE_INTERVAL) {
+            sseWrite(c, ": ping\n\n", 8);
+        }
+    }
+}
+
+void handleEventStats() {
+    DynamicJsonDocument doc(2048);
+    doc["published"] = sseTotalPublished;
+    doc["nextId"] = sseNextEventId;
+    doc["queueSize"] = SSE_EVENT_QUEUE;
+    doc["rejected"] = sseRejectedClients;
+    doc["active"] = sseActiveClients();
     
-    return html;
+    JsonArray clients = doc.createNestedArray("clients");
+    for (int i = 0; i < SSE_MAX_CLIENTS; i++) {
+        SSEClient* c = &sseClients[i];
+        if (!c->active) continue;
+        
+        JsonObject obj = clients.createNestedObject();
+        obj["slot"] = i;
+        obj["ip"] = c->client.remoteIP().toString();
+        obj["connectedSec"] = (millis() - c->connectedAt) / 1000;
+        obj["sent"] = c->sentCount;
+        obj["dropped"] = c->droppedCount;
+        obj["bytes"] = c->bytesSent;
+        obj["queueDepth"] = sseNextEventId - c->nextEventId;
+        obj["maxQueueDepth"] = c->maxQueueDepth;
+    }
+    
+    String json;
+    serializeJson(doc, json);
+    server.sendHeader("Cache-Control", "no-cache");
+    server.send(200, "application/json", json);
 }
 
 void handleSetup() {
@@ -4260,13 +9902,16 @@ void handleSaveAPI() {
         String entryPortfolio = server.arg("entryportfolio");
         String exitPortfolio = server.arg("exitportfolio");
         
+        // apiFetch همین فیلدها را زیر قفل کپی می‌کند؛ endpoint و نام slotها در loop به‌روز می‌شوند
+        lockData();
         strncpy(settings.server, serverUrl.c_str(), 127);
         strncpy(settings.username, username.c_str(), 31);
         strncpy(settings.userpass, userpass.c_str(), 63);
         strncpy(settings.entryPortfolio, entryPortfolio.c_str(), 31);
         strncpy(settings.exitPortfolio, exitPortfolio.c_str(), 31);
-        
         settings.configured = true;
+        unlockData();
+        apiConfigChanged = true;
         
         if (saveSettings()) {
             playSuccessTone();
@@ -4288,6 +9933,7 @@ void handleSaveAlert() {
     settings.separateLongShortAlerts = server.hasArg("separatealerts");
     settings.autoResetAlerts = server.hasArg("autoreset");
     settings.alertCooldown = server.arg("cooldown").toInt();
+    ruleConfigChanged = true;   // آستانه‌های پوزیشن‌های زنده در loop دوباره محاسبه می‌شوند
     
     if (saveSettings()) {
         playSuccessTone();
@@ -4320,9 +9966,7 @@ void handleSaveDisplay() {
     settings.showDetails = server.hasArg("showdetails");
     settings.invertDisplay = server.hasArg("invertdisplay");
     settings.displayRotation = constrain(server.arg("rotation").toInt(), 0, 3);
-    
-    setDisplayBrightness(settings.displayBrightness);
-    tft.setRotation(settings.displayRotation);
+    displayConfigChanged = true;   // نمایشگر فقط از loop لمس می‌شود
     
     if (saveSettings()) {
         playSuccessTone();
@@ -4369,7 +10013,7 @@ void handleSaveEmergency() {
 
 void handleRefresh() {
     if (isConnectedToWiFi) {
-        lastDataUpdate = millis() - DATA_UPDATE_INTERVAL;
+        refreshRequested = true;
         playSuccessTone();
     } else {
         playErrorTone();
@@ -4380,12 +10024,12 @@ void handleRefresh() {
 }
 
 void handleTestAlert() {
-    playTestAlertSequence();
-    server.send(200, "text/plain", "Test alert sequence played");
+    testAlertRequested = true;
+    server.send(200, "text/plain", "Test alert sequence started");
 }
 
 void handleResetAlerts() {
-    resetAllAlerts();
+    resetAlertsRequested = true;
     server.send(200, "text/plain", "All alerts reset");
 }
 
@@ -4397,36 +10041,10 @@ void handleSystemInfo() {
     <meta charset="UTF-8">
     <meta name="viewport" content="width=device-width, initial=1.0">
     <title>System Information</title>
-    <style>
-        body { font-family: Arial, sans-serif; margin: 20px; background: #1a1a1a; color: #fff; }
-        .container { max-width: 800px; margin: 0 auto; }
-        .card { background: #2d2d2d; padding: 20px; border-radius: 10px; margin-bottom: 20px; }
-        .card-header { font-size: 18px; font-weight: bold; margin-bottom: 15px; color: #0088ff; }
-        .info-grid { display: grid; grid-template-columns: repeat(2, 1fr); gap: 10px; }
-        .info-item { background: #3a3a3a; padding: 10px; border-radius: 5px; }
-        .info-label { font-size: 12px; color: #aaa; }
-        .info-value { font-size: 14px; }
-        .btn { 
-            background: #0088ff; 
-            color: white; 
-            padding: 10px 20px; 
-            border: none; 
-            border-radius: 5px; 
-            cursor: pointer;
-            text-decoration: none;
-            display: inline-block;
-            margin: 5px;
-        }
-        .btn:hover { background: #0066cc; }
-        .positive { color: #00ff00; }
-        .negative { color: #ff3333; }
-        .ap-status { display: inline-block; padding: 5px 10px; border-radius: 20px; font-size: 14px; font-weight: bold; }
-        .ap-on { background-color: #28a745; color: white; }
-        .ap-off { background-color: #dc3545; color: white; }
-    </style>
+    <link rel="stylesheet" href="/static/common.css?v=)rawliteral" WEB_ASSET_COMMON_CSS_HASH R"rawliteral(">
 </head>
 <body>
-    <div class="container">
+    <div class="container narrow">
         <h1>📊 System Information 
             <span class="ap-status )rawliteral";
     html += apEnabled ? "ap-on" : "ap-off";
@@ -4480,12 +10098,47 @@ void handleSystemInfo() {
                     <div class="info-label">Free Heap</div>
                     <div class="info-value">)rawliteral";
     html += String(ESP.getFreeHeap() / 1024) + " KB";
+    html += R"rawliteral(</div>
+                </div>
+                <div class="info-item">
+                    <div class="info-label">Heap Fragmentation</div>
+                    <div class="info-value">)rawliteral";
+    html += String(heapFragmentation, 1) + "% (worst " + String(heapWorstFragmentation, 1) + "%)";
+    html += R"rawliteral(</div>
+                </div>
+                <div class="info-item">
+                    <div class="info-label">Largest Block / Min Free</div>
+                    <div class="info-value">)rawliteral";
+    html += String(heapLargestBlock / 1024) + " KB / " + String(heapMinFree / 1024) + " KB";
     html += R"rawliteral(</div>
                 </div>
                 <div class="info-item">
                     <div class="info-label">Buzzer Volume</div>
                     <div class="info-value">)rawliteral";
     html += String(settings.buzzerVolume) + "%";
+    html += R"rawliteral(</div>
+                </div>
+                <div class="info-item">
+                    <div class="info-label">Position Store</div>
+                    <div class="info-value">)rawliteral";
+    html += String(positionStoreBytes(false) / 1024.0, 1) + " KB " + String(psramFound() ? "PSRAM" : "heap") +
+            " + " + String(positionStoreBytes(true) / 1024.0, 1) + " KB index";
+    html += R"rawliteral(</div>
+                </div>
+                <div class="info-item">
+                    <div class="info-label">DRAM Freed</div>
+                    <div class="info-value">)rawliteral";
+    html += String(positionStoreDramFreed() / 1024.0, 1) + " KB";
+    html += R"rawliteral(</div>
+                </div>
+                <div class="info-item">
+                    <div class="info-label">Max Portfolio Size</div>
+                    <div class="info-value">)rawliteral";
+    html += String(MAX_POSITIONS_PER_MODE) + " positions/portfolio, " + String(POSITION_POOL_CAPACITY) + " total (now";
+    for (int i = 0; i < portfolioCount; i++) {
+        html += String(i > 0 ? " / " : " ") + String(portfolios[i].capacity);
+    }
+    html += ")";
     html += R"rawliteral(</div>
                 </div>
             </div>
@@ -4539,6 +10192,36 @@ void handleSystemInfo() {
             </div>
         </div>
         
+        <div class="card">
+            <div class="card-header">Page Cache</div>
+            <div class="info-grid">
+                <div class="info-item">
+                    <div class="info-label">Hit Ratio</div>
+                    <div class="info-value">)rawliteral";
+    html += String(pageCacheHitRatio(), 1) + "%";
+    html += R"rawliteral(</div>
+                </div>
+                <div class="info-item">
+                    <div class="info-label">Hits / Misses</div>
+                    <div class="info-value">)rawliteral";
+    html += String(pageCacheHits) + " / " + String(pageCacheMisses);
+    html += R"rawliteral(</div>
+                </div>
+                <div class="info-item">
+                    <div class="info-label">Cache Memory</div>
+                    <div class="info-value">)rawliteral";
+    html += String(pageCacheMemory() / 1024.0, 1) + " KB (" + String(psramFound() ? "PSRAM" : "Heap") + ")";
+    html += R"rawliteral(</div>
+                </div>
+                <div class="info-item">
+                    <div class="info-label">Data / Settings Version</div>
+                    <div class="info-value">)rawliteral";
+    html += String(dataVersion) + " / " + String(settingsVersion);
+    html += R"rawliteral(</div>
+                </div>
+            </div>
+        </div>
+        
         <div style="margin-top: 30px;">
             <a href="/" class="btn">← Back to Dashboard</a>
             <a href="/setup" class="btn">← Back to Setup</a>
@@ -4565,13 +10248,11 @@ void handleLEDControl() {
     String action = server.arg("action");
     
     if (action == "test") {
-        setAllLEDs(true);
-        delay(1000);
-        setAllLEDs(false);
+        hardwareTestRequested = HW_TEST_LEDS;
     } else if (action == "on") {
-        setAllLEDs(true);
+        ledStateRequested = 1;
     } else if (action == "off") {
-        setAllLEDs(false);
+        ledStateRequested = 0;
     }
     
     server.sendHeader("Location", "/setup", true);
@@ -4582,17 +10263,9 @@ void handleRGBControl() {
     String action = server.arg("action");
     
     if (action == "test") {
-        setRGB1Color(255, 0, 0);
-        setRGB2Color(0, 255, 0);
-        delay(1000);
-        setRGB1Color(0, 255, 0);
-        setRGB2Color(0, 0, 255);
-        delay(1000);
-        turnOffRGB1();
-        turnOffRGB2();
+        hardwareTestRequested = HW_TEST_RGB;
     } else if (action == "off") {
-        turnOffRGB1();
-        turnOffRGB2();
+        rgbOffRequested = true;
     }
     
     server.sendHeader("Location", "/setup", true);
@@ -4603,12 +10276,11 @@ void handleDisplayControl() {
     String action = server.arg("action");
     
     if (action == "test") {
-        showDisplayMessage("Test Message", "Line 2", "Line 3", "Line 4");
-        delay(3000);
+        hardwareTestRequested = HW_TEST_DISPLAY;
     } else if (action == "off") {
-        setDisplayBacklight(false);
+        backlightRequested = 0;
     } else if (action == "on") {
-        setDisplayBacklight(true);
+        backlightRequested = 1;
     }
     
     server.sendHeader("Location", "/setup", true);
@@ -4629,10 +10301,19 @@ void handleRestart() {
 }
 
 void handlePositions() {
-    String modeStr = server.arg("mode");
-    byte mode = (modeStr == "exit") ? 1 : 0;
+    int mode = portfolioFromArg(server.arg("mode"), 0);
+    if (mode >= portfolioCount) mode = 0;
+    
+    char route[32];
+    snprintf(route, sizeof(route), "/positions?mode=%s", portfolioKey(mode));
+    if (pageCacheServe(route, 0)) return;
     
+    PageVersions versions;
+    lockData();
+    pageCacheVersions(&versions);
     String html = generatePositionListHTML(mode);
+    unlockData();
+    pageCacheStore(route, 0, html, &versions);
     server.send(200, "text/html", html);
 }
 
@@ -4647,55 +10328,31 @@ String generatePositionListHTML(byte mode) {
     
     if (mode == 0) {
         html += "Entry Mode Positions";
-    } else {
+    } else if (mode == 1) {
         html += "Exit Mode Positions";
+    } else {
+        html += "Portfolio " + String(portfolioLabel(mode)) + " Positions";
     }
     
     html += R"rawliteral(</title>
-    <style>
-        body { font-family: Arial, sans-serif; margin: 20px; background: #1a1a1a; color: #fff; }
-        .container { max-width: 1200px; margin: 0 auto; }
-        table { width: 100%; border-collapse: collapse; margin: 15px 0; }
-        th, td { padding: 12px; text-align: left; border-bottom: 1px solid #444; }
-        th { background: #1a1a1a; color: #0088ff; }
-        .positive { color: #00ff00; }
-        .negative { color: #ff3333; }
-        .long { color: #00ff00; background: rgba(0, 255, 0, 0.1); }
-        .short { color: #ff3333; background: rgba(255, 0, 0, 0.1); }
-        .btn { 
-            background: #0088ff; 
-            color: white; 
-            padding: 10px 20px; 
-            border: none; 
-            border-radius: 5px; 
-            cursor: pointer;
-            text-decoration: none;
-            display: inline-block;
-            margin: 5px;
-        }
-        .btn:hover { background: #0066cc; }
-        .alert-active { background: rgba(255, 165, 0, 0.2); }
-        .severe-alert { background: rgba(255, 0, 0, 0.2); }
-    </style>
+    <link rel="stylesheet" href="/static/common.css?v=)rawliteral" WEB_ASSET_COMMON_CSS_HASH R"rawliteral(">
 </head>
 <body>
     <div class="container">
         <h1>)rawliteral";
     
     if (mode == 0) {
-        html += "📈 Entry Mode Positions: " + String(settings.entryPortfolio);
+        html += "📈 Entry Mode Positions: " + String(portfolios[0].name);
+    } else if (mode == 1) {
+        html += "📉 Exit Mode Positions: " + String(portfolios[1].name);
     } else {
-        html += "📉 Exit Mode Positions: " + String(settings.exitPortfolio);
+        html += (portfolioIsExitStyle(mode) ? "📉 " : "📈 ") + String(portfolioLabel(mode)) + " Positions: " + String(portfolios[mode].name);
     }
     
     html += R"rawliteral(</h1>
         <p>Total Positions: )rawliteral";
     
-    if (mode == 0) {
-        html += String(cryptoCountMode1);
-    } else {
-        html += String(cryptoCountMode2);
-    }
+    html += String(portfolios[mode].count);
     
     html += R"rawliteral(</p>
         
@@ -4715,16 +10372,8 @@ String generatePositionListHTML(byte mode) {
             <tbody>
     )rawliteral";
     
-    CryptoPosition* data;
-    int count;
-    
-    if (mode == 0) {
-        data = cryptoDataMode1;
-        count = cryptoCountMode1;
-    } else {
-        data = cryptoDataMode2;
-        count = cryptoCountMode2;
-    }
+    CryptoPosition* data = portfolios[mode].data;
+    int count = portfolios[mode].count;
     
     for (int i = 0; i < count; i++) {
         CryptoPosition* pos = &data[i];
@@ -4749,17 +10398,17 @@ String generatePositionListHTML(byte mode) {
         html += "</td>";
         
         // Quantity
-        html += "<td>" + formatNumber(pos->quantity) + "</td>";
+        html += "<td>" + formatMoneyNumber(pos->quantity) + "</td>";
         
         // Entry Price
-        html += "<td>$" + formatPrice(pos->entryPrice) + "</td>";
+        html += "<td>$" + formatMoneyPrice(pos->entryPrice) + "</td>";
         
         // Current Price
-        html += "<td>$" + formatPrice(pos->currentPrice) + "</td>";
+        html += "<td>$" + formatMoneyPrice(pos->currentPrice) + "</td>";
         
         // P/L Value
         html += "<td class='" + String(pos->pnlValue >= 0 ? "positive" : "negative") + "'>";
-        html += "$" + formatNumber(pos->pnlValue);
+        html += "$" + formatMoneyNumber(pos->pnlValue);
         html += "</td>";
         
         // P/L %
@@ -4769,7 +10418,7 @@ String generatePositionListHTML(byte mode) {
         
         // Alert Status
         html += "<td>";
-        if (mode == 0) {
+        if (!portfolioIsExitStyle(mode)) {
             if (pos->alerted) {
                 html += "⚠️ ";
                 if (pos->severeAlerted) {
@@ -4807,6 +10456,10 @@ String generatePositionListHTML(byte mode) {
     } else {
         html += "<a href=\"/positions?mode=entry\" class=\"btn\">View Entry Mode Positions →</a>";
     }
+    for (int i = 2; i < portfolioCount; i++) {
+        if (i == mode || portfolios[i].name[0] == '\0') continue;
+        html += "<a href=\"/positions?mode=" + String(portfolioKey(i)) + "\" class=\"btn\">" + String(portfolioLabel(i)) + ": " + String(portfolios[i].name) + " →</a>";
+    }
     
     html += R"rawliteral(
         </div>
@@ -4819,96 +10472,46 @@ String generatePositionListHTML(byte mode) {
 
 void handleSetVolume() {
     if (server.hasArg("volume")) {
-        int newVolume = server.arg("volume").toInt();
-        setBuzzerVolume(newVolume);
-        
-        if (saveSettings()) {
-            server.send(200, "text/plain", "Volume set to " + String(settings.buzzerVolume) + "%");
-        } else {
-            server.send(500, "text/plain", "Failed to save volume");
-        }
-    } else {
-        server.send(400, "text/plain", "Missing volume parameter");
-    }
-}
-
-void handleTestVolume() {
-    String volStr = server.arg("v");
-    int testVol = volStr.toInt();
-    if (testVol == 0) testVol = settings.buzzerVolume;
-    
-    int savedVol = settings.buzzerVolume;
-    settings.buzzerVolume = testVol;
-    
-    playLongPositionAlert(false);
-    delay(500);
-    playShortPositionAlert(false);
-    
-    settings.buzzerVolume = savedVol;
-    server.send(200, "text/plain", "Test completed with volume " + String(testVol) + "%");
-}
-
-void handleToggleAP() {
-    apEnabled = !apEnabled;
-    saveAPState();
-    updateWiFiMode();
-    
-    Serial.print("AP toggled: ");
-    Serial.println(apEnabled ? "ENABLED" : "DISABLED");
-    
-    server.sendHeader("Location", "/", true);
-    server.send(302, "text/plain", "");
-}
-
-// ===== WEB SERVER HANDLERS FOR WiFi Management =====
-void handleWiFiManage() {
-    String action = server.arg("action");
-    String ssid = server.arg("ssid");
-    
-    if (action == "connect" && ssid.length() > 0) {
-        for (int i = 0; i < settings.networkCount; i++) {
-            if (strcmp(settings.networks[i].ssid, ssid.c_str()) == 0) {
-                connectToSpecificWiFi(i);
-                break;
-            }
-        }
-        server.sendHeader("Location", "/wifimanage", true);
-        server.send(302, "text/plain", "");
-        return;
-    }
-    
-    if (action == "remove" && ssid.length() > 0) {
-        for (int i = 0; i < settings.networkCount; i++) {
-            if (strcmp(settings.networks[i].ssid, ssid.c_str()) == 0) {
-                removeWiFiNetwork(i);
-                break;
-            }
-        }
-        server.sendHeader("Location", "/wifimanage", true);
-        server.send(302, "text/plain", "");
-        return;
-    }
-    
-    if (action == "rescan") {
-        scanWiFiNetworks(true);
-        server.sendHeader("Location", "/wifimanage", true);
-        server.send(302, "text/plain", "");
-        return;
+        int newVolume = constrain(server.arg("volume").toInt(), VOLUME_MIN, VOLUME_MAX);
+        volumeRequested = newVolume;    // بازخورد صوتی و ذخیره در loop
+        server.send(200, "text/plain", "Volume set to " + String(newVolume) + "%");
+    } else {
+        server.send(400, "text/plain", "Missing volume parameter");
     }
+}
+
+void handleTestVolume() {
+    String volStr = server.arg("v");
+    int testVol = volStr.toInt();
+    if (testVol == 0) testVol = settings.buzzerVolume;
+    testVol = constrain(testVol, VOLUME_MIN, VOLUME_MAX);
     
-    if (action == "disconnect") {
-        WiFi.disconnect(true);
-        isConnectedToWiFi = false;
-        if (apEnabled) {
-            startAPMode();
-        }
-        server.sendHeader("Location", "/wifimanage", true);
-        server.send(302, "text/plain", "");
-        return;
-    }
+    // بازر فقط از loop پخش می‌شود (webRequestsService)
+    if (testVol > 0) testVolumeRequested = testVol;
+    server.send(200, "text/plain", "Test started with volume " + String(testVol) + "%");
+}
+
+void handleToggleAP() {
+    apToggleRequested = true;
+    server.sendHeader("Location", "/", true);
+    server.send(302, "text/plain", "");
+}
+
+// ===== WEB SERVER HANDLERS FOR WiFi Management =====
+void handleWiFiManage() {
+    String action = server.arg("action");
+    String ssid = server.arg("ssid");
+    
+    // اتصال / حذف / اسکن از loop اجرا می‌شوند (webRequestsService)
+    uint8_t wifiAction = WIFI_ACTION_NONE;
+    if (action == "connect" && ssid.length() > 0) wifiAction = WIFI_ACTION_CONNECT;
+    else if (action == "remove" && ssid.length() > 0) wifiAction = WIFI_ACTION_REMOVE;
+    else if (action == "rescan") wifiAction = WIFI_ACTION_RESCAN;
+    else if (action == "disconnect") wifiAction = WIFI_ACTION_DISCONNECT;
+    else if (action == "reconnect") wifiAction = WIFI_ACTION_RECONNECT;
     
-    if (action == "reconnect") {
-        connectToBestWiFi();
+    if (wifiAction != WIFI_ACTION_NONE) {
+        webQueueWiFiAction(wifiAction, ssid.c_str());
         server.sendHeader("Location", "/wifimanage", true);
         server.send(302, "text/plain", "");
         return;
@@ -4921,363 +10524,9 @@ void handleWiFiManage() {
     <meta charset="UTF-8">
     <meta name="viewport" content="width=device-width, initial-scale=1.0">
     <title>WiFi Manager - Enhanced</title>
-    <style>
-        body { 
-            font-family: Arial, sans-serif; 
-            margin: 20px; 
-            background: #1a1a1a; 
-            color: #fff; 
-        }
-        .container { 
-            max-width: 1200px; 
-            margin: 0 auto; 
-        }
-        .section { 
-            background: #2d2d2d; 
-            padding: 20px; 
-            border-radius: 10px; 
-            margin-bottom: 20px; 
-            box-shadow: 0 4px 6px rgba(0,0,0,0.3);
-        }
-        .btn { 
-            background: #0088ff; 
-            color: white; 
-            padding: 10px 20px; 
-            border: none; 
-            border-radius: 5px; 
-            cursor: pointer;
-            text-decoration: none;
-            display: inline-block;
-            margin: 5px;
-            font-size: 14px;
-            transition: background 0.3s;
-        }
-        .btn:hover { 
-            background: #0066cc; 
-            transform: translateY(-2px);
-        }
-        .btn-scan { 
-            background: #ff9900; 
-        }
-        .btn-success { 
-            background: #00cc00; 
-        }
-        .btn-danger { 
-            background: #ff3333; 
-        }
-        .btn-warning { 
-            background: #ff9900; 
-        }
-        .btn-info { 
-            background: #17a2b8; 
-        }
-        table { 
-            width: 100%; 
-            border-collapse: collapse; 
-            margin: 15px 0; 
-        }
-        th, td { 
-            padding: 12px 15px; 
-            text-align: left; 
-            border-bottom: 1px solid #444; 
-        }
-        th { 
-            background: #1a1a1a; 
-            color: #0088ff;
-            font-weight: bold;
-        }
-        tr:hover { 
-            background: #3a3a3a; 
-        }
-        .signal-good { 
-            color: #00ff00; 
-        }
-        .signal-fair { 
-            color: #ff9900; 
-        }
-        .signal-weak { 
-            color: #ff3333; 
-        }
-        .priority-high { 
-            background: rgba(0, 255, 0, 0.15); 
-            border-left: 4px solid #00ff00;
-        }
-        .priority-medium { 
-            background: rgba(255, 165, 0, 0.15); 
-            border-left: 4px solid #ff9900;
-        }
-        .priority-low { 
-            background: rgba(255, 0, 0, 0.15); 
-            border-left: 4px solid #ff3333;
-        }
-        .ap-status { 
-            display: inline-block; 
-            padding: 5px 15px; 
-            border-radius: 20px; 
-            font-size: 14px; 
-            font-weight: bold; 
-            margin-left: 10px; 
-        }
-        .ap-on { 
-            background: linear-gradient(135deg, #28a745, #20c997); 
-            color: white; 
-        }
-        .ap-off { 
-            background: linear-gradient(135deg, #dc3545, #fd7e14); 
-            color: white; 
-        }
-        .signal-indicator {
-            display: inline-block;
-            width: 100px;
-            height: 20px;
-            background: #333;
-            border-radius: 3px;
-            overflow: hidden;
-            position: relative;
-        }
-        .signal-level {
-            height: 100%;
-            background: linear-gradient(90deg, #ff3333, #ff9900, #00ff00);
-            border-radius: 3px;
-        }
-        .status-badge {
-            display: inline-block;
-            padding: 3px 8px;
-            border-radius: 12px;
-            font-size: 12px;
-            font-weight: bold;
-            margin-left: 5px;
-        }
-        .connected-badge {
-            background: #28a745;
-            color: white;
-        }
-        .saved-badge {
-            background: #17a2b8;
-            color: white;
-        }
-        .available-badge {
-            background: #6c757d;
-            color: white;
-        }
-        .form-group {
-            margin-bottom: 15px;
-        }
-        .form-group label {
-            display: block;
-            margin-bottom: 5px;
-            color: #ccc;
-            font-weight: bold;
-        }
-        .form-group input,
-        .form-group select {
-            width: 100%;
-            max-width: 400px;
-            padding: 10px;
-            background: #3a3a3a;
-            border: 1px solid #555;
-            border-radius: 5px;
-            color: white;
-            font-size: 14px;
-        }
-        .form-group input:focus,
-        .form-group select:focus {
-            outline: none;
-            border-color: #0088ff;
-            box-shadow: 0 0 0 2px rgba(0, 136, 255, 0.3);
-        }
-        .tab-container {
-            margin-bottom: 20px;
-        }
-        .tab-buttons {
-            display: flex;
-            flex-wrap: wrap;
-            margin-bottom: 20px;
-            border-bottom: 2px solid #444;
-        }
-        .tab-button {
-            background: #2d2d2d;
-            color: #ccc;
-            padding: 12px 24px;
-            border: none;
-            border-right: 1px solid #444;
-            cursor: pointer;
-            font-size: 14px;
-            font-weight: bold;
-            transition: all 0.3s;
-        }
-        .tab-button:hover {
-            background: #3a3a3a;
-            color: white;
-        }
-        .tab-button.active {
-            background: #0088ff;
-            color: white;
-            border-bottom: 3px solid #00ff00;
-        }
-        .tab-content {
-            display: none;
-            background: #2d2d2d;
-            padding: 25px;
-            border-radius: 0 10px 10px 10px;
-            animation: fadeIn 0.5s ease;
-        }
-        .tab-content.active {
-            display: block;
-        }
-        @keyframes fadeIn {
-            from { opacity: 0; transform: translateY(10px); }
-            to { opacity: 1; transform: translateY(0); }
-        }
-        .alert {
-            padding: 15px;
-            border-radius: 5px;
-            margin: 15px 0;
-            background: rgba(255, 193, 7, 0.2);
-            border-left: 4px solid #ffc107;
-            color: #ffc107;
-        }
-        .alert-success {
-            background: rgba(40, 167, 69, 0.2);
-            border-left-color: #28a745;
-            color: #28a745;
-        }
-        .alert-info {
-            background: rgba(23, 162, 184, 0.2);
-            border-left-color: #17a2b8;
-            color: #17a2b8;
-        }
-        .stats-grid {
-            display: grid;
-            grid-template-columns: repeat(auto-fit, minmax(200px, 1fr));
-            gap: 15px;
-            margin: 20px 0;
-        }
-        .stat-card {
-            background: #3a3a3a;
-            padding: 15px;
-            border-radius: 8px;
-            text-align: center;
-        }
-        .stat-value {
-            font-size: 24px;
-            font-weight: bold;
-            color: #0088ff;
-        }
-        .stat-label {
-            font-size: 12px;
-            color: #aaa;
-            margin-top: 5px;
-        }
-        .action-buttons {
-            display: flex;
-            flex-wrap: wrap;
-            gap: 10px;
-            margin: 20px 0;
-        }
-    </style>
-    <script>
-        function openTab(evt, tabName) {
-            var i, tabcontent, tabbuttons;
-            tabcontent = document.getElementsByClassName("tab-content");
-            for (i = 0; i < tabcontent.length; i++) {
-                tabcontent[i].classList.remove("active");
-            }
-            tabbuttons = document.getElementsByClassName("tab-button");
-            for (i = 0; i < tabbuttons.length; i++) {
-                tabbuttons[i].classList.remove("active");
-            }
-            document.getElementById(tabName).classList.add("active");
-            evt.currentTarget.classList.add("active");
-            return false;
-        }
-        
-        function confirmRemove(ssid) {
-            if (confirm("Are you sure you want to remove '" + ssid + "' from saved networks?")) {
-                window.location.href = "/wifimanage?action=remove&ssid=" + encodeURIComponent(ssid);
-            }
-            return false;
-        }
-        
-        function connectNetwork(ssid) {
-            if (confirm("Connect to '" + ssid + "' now?")) {
-                window.location.href = "/wifimanage?action=connect&ssid=" + encodeURIComponent(ssid);
-            }
-            return false;
-        }
-        
-        function toggleAutoConnect(ssid, currentState) {
-            var newState = !currentState;
-            var form = document.createElement('form');
-            form.method = 'POST';
-            form.action = '/updatewifi';
-            
-            var ssidInput = document.createElement('input');
-            ssidInput.type = 'hidden';
-            ssidInput.name = 'ssid';
-            ssidInput.value = ssid;
-            form.appendChild(ssidInput);
-            
-            var autoconnectInput = document.createElement('input');
-            autoconnectInput.type = 'hidden';
-            autoconnectInput.name = 'autoconnect';
-            autoconnectInput.value = newState ? '1' : '0';
-            form.appendChild(autoconnectInput);
-            
-            document.body.appendChild(form);
-            form.submit();
-        }
-        
-        function updatePriority(ssid, priority) {
-            var form = document.createElement('form');
-            form.method = 'POST';
-            form.action = '/updatewifi';
-            
-            var ssidInput = document.createElement('input');
-            ssidInput.type = 'hidden';
-            ssidInput.name = 'ssid';
-            ssidInput.value = ssid;
-            form.appendChild(ssidInput);
-            
-            var priorityInput = document.createElement('input');
-            priorityInput.type = 'hidden';
-            priorityInput.name = 'priority';
-            priorityInput.value = priority;
-            form.appendChild(priorityInput);
-            
-            document.body.appendChild(form);
-            form.submit();
-        }
-        
-        function showPassword(id) {
-            var input = document.getElementById(id);
-            if (input.type === "password") {
-                input.type = "text";
-            } else {
-                input.type = "password";
-            }
-        }
-        
-        function testConnection(ssid) {
-            var btn = event.target;
-            var originalText = btn.innerHTML;
-            btn.innerHTML = 'Testing...';
-            btn.disabled = true;
-            
-            fetch('/testwifi?ssid=' + encodeURIComponent(ssid))
-                .then(response => response.text())
-                .then(text => {
-                    alert(text);
-                    btn.innerHTML = originalText;
-                    btn.disabled = false;
-                })
-                .catch(error => {
-                    alert('Connection test failed: ' + error);
-                    btn.innerHTML = originalText;
-                    btn.disabled = false;
-                });
-        }
-    </script>
+    <link rel="stylesheet" href="/static/common.css?v=)rawliteral" WEB_ASSET_COMMON_CSS_HASH R"rawliteral(">
+    <link rel="stylesheet" href="/static/wifi.css?v=)rawliteral" WEB_ASSET_WIFI_CSS_HASH R"rawliteral(">
+    <script src="/static/wifi.js?v=)rawliteral" WEB_ASSET_WIFI_JS_HASH R"rawliteral("></script>
 </head>
 <body>
     <div class="container">
@@ -5887,49 +11136,10 @@ void handleWiFiScan() {
     <meta charset="UTF-8">
     <meta name="viewport" content="width=device-width, initial=1.0">
     <title>WiFi Scan Results</title>
-    <style>
-        body { font-family: Arial, sans-serif; margin: 20px; background: #1a1a1a; color: #fff; }
-        .container { max-width: 800px; margin: 0 auto; }
-        .network-list { margin-top: 20px; }
-        .network-item { 
-            background: #2d2d2d; 
-            padding: 15px; 
-            margin: 10px 0; 
-            border-radius: 8px;
-            border-left: 4px solid #0088ff;
-        }
-        .network-saved { border-left-color: #00cc00; }
-        .network-new { border-left-color: #ff9900; }
-        .btn { 
-            background: #0088ff; 
-            color: white; 
-            padding: 8px 16px; 
-            border: none; 
-            border-radius: 5px; 
-            cursor: pointer;
-            text-decoration: none;
-            display: inline-block;
-            margin: 5px;
-        }
-        .btn:hover { background: #0066cc; }
-        .btn-save { background: #00cc00; }
-        .signal-bar { 
-            display: inline-block; 
-            width: 100px; 
-            height: 20px; 
-            background: #333; 
-            border-radius: 3px;
-            overflow: hidden;
-            margin: 0 10px;
-        }
-        .signal-fill { 
-            height: 100%; 
-            background: linear-gradient(90deg, #00cc00, #ff9900, #ff3333);
-        }
-    </style>
+    <link rel="stylesheet" href="/static/common.css?v=)rawliteral" WEB_ASSET_COMMON_CSS_HASH R"rawliteral(">
 </head>
 <body>
-    <div class="container">
+    <div class="container narrow">
         <h1>📡 WiFi Scan Results</h1>
         <p>Found: )rawliteral";
     
@@ -5998,12 +11208,7 @@ void handleSaveWiFiFromScan() {
         bool autoConnect = server.hasArg("autoconnect");
         
         if (addOrUpdateWiFiNetwork(ssid.c_str(), password.c_str(), priority, autoConnect)) {
-            for (int i = 0; i < settings.networkCount; i++) {
-                if (strcmp(settings.networks[i].ssid, ssid.c_str()) == 0) {
-                    connectToSpecificWiFi(i);
-                    break;
-                }
-            }
+            webQueueWiFiAction(WIFI_ACTION_CONNECT, ssid.c_str());
             
             String html = "<h1>✅ WiFi Network Saved!</h1>";
             html += "<p>Network: " + ssid + "</p>";
@@ -6280,6 +11485,7 @@ void setup() {
     Serial.println("========================================");
     
     systemStartTime = millis();
+    loopTaskHandle = xTaskGetCurrentTaskHandle();
     
     // 1. ابتدا فقط تنظیمات ضروری را بارگذاری کنید
     EEPROM.begin(EEPROM_SIZE);
@@ -6292,6 +11498,17 @@ void setup() {
     // Load AP state
     loadAPState();
     
+    // مخزن پوزیشن و تاریخچه آلرت در PSRAM (باید قبل از بازیابی تاریخچه باشد)
+    positionStoreBegin();
+    
+    // تاریخچه آلرت ذخیره شده در LittleFS
+    setupAlertLog();
+    setupTimeSeries();
+    portfolioRegistryBegin();
+    apiEndpointsBegin();
+    streamBegin();
+    rulesBegin();
+    
     settings.bootCount++;
     settings.totalUptime += (millis() - settings.firstBoot);
     saveSettings();
@@ -6340,8 +11557,10 @@ void setup() {
         startAPMode();
     }
     
-    // 8. راه‌اندازی وب سرور
+    // 8. راه‌اندازی وب سرور (در تسک جداگانه)
+    dataMutex = xSemaphoreCreateRecursiveMutex();
     setupWebServer();
+    startWebServerTask();
     
     // 9. تست اولیه
     if (settings.buzzerEnabled) {
@@ -6350,6 +11569,7 @@ void setup() {
     
     Serial.println("\n✅ System initialized successfully!");
     Serial.println("Free memory: " + String(ESP.getFreeHeap()) + " bytes");
+    updateHeapStats();
     Serial.println("WiFi Status: " + String(isConnectedToWiFi ? "Connected" : "Disconnected"));
     Serial.println("AP Mode: " + String(apModeActive ? "Active" : "Inactive"));
     Serial.println("AP Enabled: " + String(apEnabled ? "Yes" : "No"));
@@ -6363,7 +11583,7 @@ void setup() {
     }
     
     // 10. مقداردهی اولیه متغیرهای زمانی
-    lastDataUpdate = millis() - DATA_UPDATE_INTERVAL;
+    portfolioSpread(millis());
     lastAlertCheck = millis();
     lastDisplayUpdate = millis();
     lastWiFiCheck = millis();
@@ -6371,11 +11591,16 @@ void setup() {
 }
 
 void loop() {
-    // 1. هندل کردن کلاینت‌های وب سرور
-    server.handleClient();
+    // 1. وب سرور در تسک جداگانه اجرا می‌شود (webServerTask)
     
     // NEW: مدیریت حالت WiFi
-    manageWiFiMode();
+    {
+        TIME_STAGE(STAGE_WIFI);
+        manageWiFiMode();
+    }
+    
+    handleSerialCommands();
+    webRequestsService();
     
     unsigned long now = millis();
     
@@ -6405,39 +11630,33 @@ void loop() {
         checkConnectionStatus();
     }
     
-    // 5. به‌روزرسانی داده‌ها از API (اگر متصل باشد)
+    // 5. به‌روزرسانی داده‌ها از API (اگر متصل باشد) - هر slot با زمان‌بندی خودش
     if (isConnectedToWiFi) {
-        if (now - lastDataUpdate > DATA_UPDATE_INTERVAL) {
-            lastDataUpdate = now;
-            
-            // دریافت داده برای Entry Mode
-            if (strlen(settings.entryPortfolio) > 0) {
-                String data1 = getPortfolioData(0);
-                if (data1 != "{}") {
-                    parseCryptoData(data1, 0);
-                    calculatePortfolioSummary(0);
-                }
-            }
-            
-            // دریافت داده برای Exit Mode
-            if (strlen(settings.exitPortfolio) > 0) {
-                String data2 = getPortfolioData(1);
-                if (data2 != "{}") {
-                    parseCryptoData(data2, 1);
-                    calculatePortfolioSummary(1);
-                }
-            }
-        }
+        portfolioSchedule(now);
         
         // به‌روزرسانی زمان
         updateDateTime();
     }
     
-    // 6. بررسی آلرت‌ها
+    // جریان قیمت WebSocket (اختیاری) - تیک‌ها بدون انتظار برای poll آلرت می‌دهند
+    streamService(now);
+    
+    // 6. بررسی آلرت‌ها (قوانین تغییر کرده از وب اول در همین تسک کامپایل می‌شوند)
+    rulesService();
     if (now - lastAlertCheck > 5000) {
         lastAlertCheck = now;
-        if (cryptoCountMode1 > 0) checkAlerts(0);
-        if (cryptoCountMode2 > 0) checkAlerts(1);
+        TIME_STAGE(STAGE_ALERTS);
+        for (int i = 0; i < portfolioCount; i++) {
+            if (portfolios[i].count > 0) checkAlerts(i);
+        }
+    }
+    
+    // نمایش / بازر / LED آلرت‌های صف با نرخ محدود، و نت‌های بعدی الگوی بازر
+    alertDispatchService(millis());
+    
+    // فشرده‌سازی دوره‌ای لاگ آلرت
+    if (now - lastAlertLogCompact > ALERT_LOG_COMPACT_INTERVAL) {
+        compactAlertLog(false);
     }
     
     // 7. بررسی باتری
@@ -6449,16 +11668,26 @@ void loop() {
     // 8. به‌روزرسانی نمایشگر
     if (now - lastDisplayUpdate > DISPLAY_UPDATE_INTERVAL) {
         lastDisplayUpdate = now;
-        updateDisplay();
+        TIME_STAGE(STAGE_DISPLAY);
+        if (hardwareTestActive != HW_TEST_DISPLAY) updateDisplay();
     }
     
     // 9. به‌روزرسانی LEDها
-    updateLEDs();
-    updateRGBLEDs();
+    {
+        TIME_STAGE(STAGE_LEDS);
+        if (hardwareTestActive != HW_TEST_LEDS) updateLEDs();
+        if (hardwareTestActive != HW_TEST_RGB) updateRGBLEDs();
+    }
     
     // 10. بررسی دکمه ریست
     checkResetButton();
     
+    // آمار heap (تکه‌تکه شدن) برای /systeminfo و داشبورد
+    if (now - lastHeapStats > HEAP_STATS_INTERVAL) {
+        lastHeapStats = now;
+        updateHeapStats();
+    }
+    
     // 11. تنظیم backlight بر اساس timeout
     if (settings.displayTimeout > 0) {
         static unsigned long lastInteraction = millis();
@@ -6480,6 +11709,320 @@ void loop() {
 
 
 
+// ===== RENDERED PAGE CACHE =====
+// بین دو poll خروجی صفحه موقعیت‌ها تغییر نمی‌کند؛ HTML رندر شده در PSRAM نگه داشته
+// و تا وقتی نسخه داده/آلرت/تنظیمات عوض نشده مستقیم ارسال می‌شود.
+// parse → dataVersion، resetAllAlerts/آلرت جدید → alertVersion، handleSave* → settingsVersion
+#define PAGE_CACHE_SLOTS 4
+
+PageCacheEntry pageCache[PAGE_CACHE_SLOTS];
+
+bool pageCacheValid(const PageCacheEntry* entry) {
+    return entry->html != NULL &&
+           entry->dataVer == dataVersion &&
+           entry->alertVer == alertVersion &&
+           entry->settingsVer == settingsVersion;
+}
+
+PageCacheEntry* pageCacheFind(const char* route, byte variant) {
+    for (int i = 0; i < PAGE_CACHE_SLOTS; i++) {
+        if (pageCache[i].html != NULL && pageCache[i].variant == variant &&
+            strcmp(pageCache[i].route, route) == 0) {
+            return &pageCache[i];
+        }
+    }
+    return NULL;
+}
+
+bool pageCacheServe(const char* route, byte variant) {
+    PageCacheEntry* entry = pageCacheFind(route, variant);
+    
+    if (entry == NULL || !pageCacheValid(entry)) {
+        pageCacheMisses++;
+        return false;
+    }
+    
+    pageCacheHits++;
+    entry->lastUsed = millis();
+    server.send_P(200, "text/html", entry->html, entry->length);
+    return true;
+}
+
+// باید زیر همان lockData رندر صفحه صدا زده شود؛ loop ممکن است بلافاصله بعد از آن نسخه‌ها را بالا ببرد
+void pageCacheVersions(PageVersions* versions) {
+    versions->dataVer = dataVersion;
+    versions->alertVer = alertVersion;
+    versions->settingsVer = settingsVersion;
+}
+
+void pageCacheStore(const char* route, byte variant, const String& html, const PageVersions* versions) {
+    PageCacheEntry* entry = pageCacheFind(route, variant);
+    
+    if (entry == NULL) {
+        // اسلات خالی یا قدیمی‌ترین
+        entry = &pageCache[0];
+        for (int i = 0; i < PAGE_CACHE_SLOTS; i++) {
+            if (pageCache[i].html == NULL) {
+                entry = &pageCache[i];
+                break;
+            }
+            if (pageCache[i].lastUsed < entry->lastUsed) {
+                entry = &pageCache[i];
+            }
+        }
+    }
+    
+    size_t needed = html.length() + 1;
+    if (entry->capacity < needed) {
+        free(entry->html);
+        size_t capacity = needed + 512;   // جا برای رشد کوچک صفحه بدون realloc
+        entry->html = (char*)(psramFound() ? ps_malloc(capacity) : malloc(capacity));
+        entry->capacity = entry->html != NULL ? capacity : 0;
+        if (entry->html == NULL) {
+            entry->length = 0;
+            return;
+        }
+    }
+    
+    memcpy(entry->html, html.c_str(), needed);
+    entry->length = html.length();
+    strncpy(entry->route, route, sizeof(entry->route) - 1);
+    entry->route[sizeof(entry->route) - 1] = '\0';
+    entry->variant = variant;
+    entry->dataVer = versions->dataVer;
+    entry->alertVer = versions->alertVer;
+    entry->settingsVer = versions->settingsVer;
+    entry->lastUsed = millis();
+}
+
+float pageCacheHitRatio() {
+    unsigned long total = pageCacheHits + pageCacheMisses;
+    return total > 0 ? (pageCacheHits * 100.0) / total : 0.0;
+}
+
+size_t pageCacheMemory() {
+    size_t total = 0;
+    for (int i = 0; i < PAGE_CACHE_SLOTS; i++) {
+        total += pageCache[i].capacity;
+    }
+    return total;
+}
+
+// ===== WEB SERVER TASK =====
+void lockData() {
+    if (dataMutex != NULL) {
+        xSemaphoreTakeRecursive(dataMutex, portMAX_DELAY);
+    }
+}
+
+void unlockData() {
+    if (dataMutex != NULL) {
+        xSemaphoreGiveRecursive(dataMutex);
+    }
+}
+
+// از تسک وب؛ درخواست جدید جای درخواست قبلیِ هنوز اجرا نشده را می‌گیرد
+void webQueueWiFiAction(uint8_t action, const char* ssid) {
+    lockData();
+    strncpy(wifiActionSsid, ssid, sizeof(wifiActionSsid) - 1);
+    wifiActionSsid[sizeof(wifiActionSsid) - 1] = '\0';
+    wifiActionRequested = action;
+    unlockData();
+}
+
+// SSID در loop به index تبدیل می‌شود تا حذف شبکه‌ها index صف را جابه‌جا نکند
+static void webApplyWiFiAction(uint8_t action, const char* ssid) {
+    int index = -1;
+    for (int i = 0; i < settings.networkCount; i++) {
+        if (strcmp(settings.networks[i].ssid, ssid) == 0) {
+            index = i;
+            break;
+        }
+    }
+    
+    switch (action) {
+        case WIFI_ACTION_CONNECT:
+            if (index >= 0) connectToSpecificWiFi(index);
+            break;
+        case WIFI_ACTION_REMOVE:
+            if (index >= 0) removeWiFiNetwork(index);
+            break;
+        case WIFI_ACTION_RESCAN:
+            scanWiFiNetworks(true);
+            break;
+        case WIFI_ACTION_DISCONNECT:
+            WiFi.disconnect(true);
+            isConnectedToWiFi = false;
+            if (apEnabled) startAPMode();
+            break;
+        case WIFI_ACTION_RECONNECT:
+            connectToBestWiFi();
+            break;
+    }
+}
+
+// تست LED / RGB / نمایشگر بدون delay: هر مرحله یک بار اعمال می‌شود و loop در این مدت
+// updateLEDs / updateRGBLEDs / updateDisplay همان بخش را اجرا نمی‌کند
+static void hardwareTestService(unsigned long now) {
+    if (hardwareTestRequested != HW_TEST_NONE) {
+        hardwareTestActive = hardwareTestRequested;
+        hardwareTestRequested = HW_TEST_NONE;
+        hardwareTestStep = 0;
+        hardwareTestStart = now;
+    }
+    if (hardwareTestActive == HW_TEST_NONE) return;
+    
+    unsigned long elapsed = now - hardwareTestStart;
+    switch (hardwareTestActive) {
+        case HW_TEST_LEDS:
+            if (hardwareTestStep == 0) {
+                setAllLEDs(true);
+                hardwareTestStep = 1;
+            } else if (elapsed >= 1000) {
+                setAllLEDs(false);
+                hardwareTestActive = HW_TEST_NONE;
+            }
+            break;
+        case HW_TEST_RGB:
+            if (hardwareTestStep == 0) {
+                setRGB1Color(255, 0, 0);
+                setRGB2Color(0, 255, 0);
+                hardwareTestStep = 1;
+            } else if (hardwareTestStep == 1 && elapsed >= 1000) {
+                setRGB1Color(0, 255, 0);
+                setRGB2Color(0, 0, 255);
+                hardwareTestStep = 2;
+            } else if (elapsed >= 2000) {
+                turnOffRGB1();
+                turnOffRGB2();
+                hardwareTestActive = HW_TEST_NONE;
+            }
+            break;
+        case HW_TEST_DISPLAY:
+            if (hardwareTestStep == 0) {
+                showDisplayMessage("Test Message", "Line 2", "Line 3", "Line 4");
+                hardwareTestStep = 1;
+            } else if (elapsed >= 3000) {
+                hardwareTestActive = HW_TEST_NONE;
+                displayNeedsUpdate = true;
+            }
+            break;
+        default:
+            hardwareTestActive = HW_TEST_NONE;
+            break;
+    }
+}
+
+// از loop: کارهایی که handlerهای وب درخواست کرده‌اند و به داده/نمایشگر/بازر/WiFi دست می‌زنند
+void webRequestsService() {
+    if (apiConfigChanged) {
+        apiConfigChanged = false;
+        lockData();
+        apiEndpointsSync();
+        portfolioSyncNames();
+        settingsVersion++;
+        unlockData();
+    }
+    
+    if (displayConfigChanged) {
+        displayConfigChanged = false;
+        setDisplayBrightness(settings.displayBrightness);
+        tft.setRotation(settings.displayRotation);
+        displayNeedsUpdate = true;
+    }
+    
+    if (refreshRequested) {
+        refreshRequested = false;
+        if (isConnectedToWiFi) portfolioSpread(millis());
+    }
+    
+    portfolioApplyChanges();
+    
+    if (resetAlertsRequested) {
+        resetAlertsRequested = false;
+        resetAllAlerts();
+    }
+    
+    if (testAlertRequested) {
+        testAlertRequested = false;
+        playTestAlertSequence();
+    }
+    
+    if (testVolumeRequested > 0) {
+        playVolumeTest(testVolumeRequested);
+        testVolumeRequested = 0;
+    }
+    
+    if (volumeRequested >= 0) {
+        int volume = volumeRequested;
+        volumeRequested = -1;
+        setBuzzerVolume(volume);
+    }
+    
+    if (ledStateRequested >= 0) {
+        setAllLEDs(ledStateRequested == 1);
+        ledStateRequested = -1;
+    }
+    
+    if (rgbOffRequested) {
+        rgbOffRequested = false;
+        turnOffRGB1();
+        turnOffRGB2();
+    }
+    
+    if (backlightRequested >= 0) {
+        setDisplayBacklight(backlightRequested == 1);
+        backlightRequested = -1;
+    }
+    
+    hardwareTestService(millis());
+    
+    if (apToggleRequested) {
+        apToggleRequested = false;
+        apEnabled = !apEnabled;
+        saveAPState();
+        updateWiFiMode();
+        
+        Serial.print("AP toggled: ");
+        Serial.println(apEnabled ? "ENABLED" : "DISABLED");
+    }
+    
+    if (wifiActionRequested != WIFI_ACTION_NONE) {
+        char ssid[sizeof(wifiActionSsid)];
+        lockData();
+        uint8_t action = wifiActionRequested;
+        wifiActionRequested = WIFI_ACTION_NONE;
+        memcpy(ssid, wifiActionSsid, sizeof(ssid));
+        unlockData();
+        webApplyWiFiAction(action, ssid);
+    }
+}
+
+void webServerTask(void* parameter) {
+    (void)parameter;
+    for (;;) {
+        {
+            TIME_STAGE(STAGE_WEB);
+            server.handleClient();
+        }
+        {
+            TIME_STAGE(STAGE_SSE);
+            ssePump();
+        }
+        vTaskDelay(1);
+    }
+}
+
+void startWebServerTask() {
+    BaseType_t result = xTaskCreatePinnedToCore(webServerTask, "webServer", WEB_TASK_STACK_SIZE,
+                                                NULL, WEB_TASK_PRIORITY, &webTaskHandle, WEB_TASK_CORE);
+    if (result == pdPASS) {
+        Serial.println("✅ Web server task started on core " + String(WEB_TASK_CORE));
+    } else {
+        Serial.println("❌ Failed to start web server task");
+    }
+}
+
 void setupWebServer() {
     Serial.println("Setting up web server...");
     
@@ -6521,6 +12064,43 @@ void setupWebServer() {
     server.on("/setvolume", handleSetVolume);
     server.on("/testvolume", handleTestVolume);
     
+    // Static assets (gzip) + dashboard data
+    for (int i = 0; i < webAssetCount; i++) {
+        server.on(webAssets[i].path, HTTP_GET, [i]() { handleStaticAsset(i); });
+    }
+    server.on("/api/dashboard", HTTP_GET, handleDashboardData);
+    
+    // REST API v1
+    server.on("/api/v1/positions", HTTP_GET, handleApiPositions);
+    server.on("/api/v1/summary", HTTP_GET, handleApiSummary);
+    server.on("/api/v1/alerts", HTTP_GET, handleApiAlerts);
+    
+    server.on("/alerthistory", HTTP_GET, handleAlertHistory);
+    server.on("/api/v1/history", HTTP_GET, handleApiHistory);
+    server.on("/api/v1/risk", HTTP_GET, handleApiRisk);
+    server.on("/api/v1/risk/reset", HTTP_POST, handleApiRiskReset);
+    server.on("/api/v1/recording", HTTP_GET, handleApiRecording);
+    server.on("/api/v1/recording", HTTP_POST, handleApiRecordingControl);
+    server.on("/api/v1/recording/download", HTTP_GET, handleApiRecordingDownload);
+    server.on("/api/v1/portfolios", HTTP_GET, handleApiPortfolios);
+    server.on("/api/v1/portfolios", HTTP_POST, handleApiPortfoliosUpdate);
+    server.on("/api/v1/servers", HTTP_GET, handleApiServers);
+    server.on("/api/v1/servers", HTTP_POST, handleApiServersUpdate);
+    server.on("/api/v1/stream", HTTP_GET, handleApiStream);
+    server.on("/api/v1/stream", HTTP_POST, handleApiStreamUpdate);
+    server.on("/api/v1/rules", HTTP_GET, handleApiRules);
+    server.on("/api/v1/rules", HTTP_POST, handleApiRulesUpdate);
+    
+    // Server-Sent Events
+    server.on("/events", HTTP_GET, handleEvents);
+    server.on("/events/stats", HTTP_GET, handleEventStats);
+    
+    // Prometheus
+    server.on("/metrics", HTTP_GET, handleMetrics);
+    
+    const char* headerKeys[] = { "If-None-Match" };
+    server.collectHeaders(headerKeys, 1);
+    
     // 404 Handler
     server.onNotFound([]() {
         String message = "404: Not Found\n\n";
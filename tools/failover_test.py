@@ -0,0 +1,209 @@
+#!/usr/bin/env python3
+"""
+Local failover test for the API endpoint list (API ENDPOINTS section of the sketch).
+
+Starts two stand-in portfolio servers on localhost, one fast and one deliberately
+slow, runs the Linux host build against them and checks that:
+
+  1. once both have been measured, fetches go to the fast server;
+  2. when the fast server stalls, the fetch gives up at its p95 deadline and is
+     answered by the slow server (hedge) instead of burning the full timeout, and
+     the failure penalty keeps later fetches away from the stalled server;
+  3. when every server fails, the circuit breakers open after repeated errors
+     and the open endpoints are no longer contacted.
+
+Build the host binary first (see host/host_main.cpp), then:
+
+    python3 tools/failover_test.py --binary ./portfolio_host
+"""
+
+import argparse
+import http.client
+import http.server
+import json
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+import urllib.parse
+
+PORTFOLIO = {
+    "portfolio": [
+        {"symbol": "BTCUSDT", "pnl_percent": 1.5, "current_price": "65000.5", "entry_price": "64000",
+         "quantity": "0.01", "pnl": "10.05", "side": "BUY"},
+        {"symbol": "ETHUSDT", "pnl_percent": -0.8, "current_price": "3100.2", "entry_price": "3125",
+         "quantity": "0.5", "pnl": "-12.4", "side": "BUY"},
+    ]
+}
+PRICES = {"prices": {"BTCUSDT": "65010.0", "ETHUSDT": "3099.8"}}
+
+
+class StandIn:
+    """Portfolio API stand-in; delay is applied before the response headers are sent."""
+
+    def __init__(self, name, delay):
+        self.name = name
+        self.delay = delay
+        self.status = 200
+        self.hits = 0
+        self.lock = threading.Lock()
+        stand_in = self
+
+        class Handler(http.server.BaseHTTPRequestHandler):
+            def do_GET(self):
+                with stand_in.lock:
+                    stand_in.hits += 1
+                    delay = stand_in.delay
+                    status = stand_in.status
+                time.sleep(delay)
+                payload = PRICES if self.path.startswith("/api/device/prices/") else PORTFOLIO
+                body = json.dumps(payload).encode() if status == 200 else b"{}"
+                try:
+                    self.send_response(status)
+                    self.send_header("Content-Type", "application/json")
+                    self.send_header("Content-Length", str(len(body)))
+                    self.end_headers()
+                    self.wfile.write(body)
+                except (BrokenPipeError, ConnectionResetError):
+                    pass   # the device gave up on us, which is the point of the stall
+
+            def log_message(self, fmt, *args):
+                pass
+
+        self.server = http.server.ThreadingHTTPServer(("127.0.0.1", 0), Handler)
+        self.server.daemon_threads = True
+        self.url = "http://127.0.0.1:%d" % self.server.server_address[1]
+        threading.Thread(target=self.server.serve_forever, daemon=True).start()
+
+
+class Device:
+    def __init__(self, port):
+        self.port = port
+
+    def request(self, method, path, params=None):
+        body = urllib.parse.urlencode(params) if params else None
+        conn = http.client.HTTPConnection("127.0.0.1", self.port, timeout=30)
+        headers = {"Content-Type": "application/x-www-form-urlencoded"} if body else {}
+        conn.request(method, path, body=body, headers=headers)
+        response = conn.getresponse()
+        data = response.read()
+        conn.close()
+        return response.status, data
+
+    def servers(self):
+        status, data = self.request("GET", "/api/v1/servers")
+        if status != 200:
+            raise RuntimeError("GET /api/v1/servers returned %d" % status)
+        return {s["url"]: s for s in json.loads(data)["servers"]}
+
+    def wifi_connected(self):
+        status, data = self.request("GET", "/metrics")
+        return status == 200 and b"portfolio_wifi_connected 1" in data
+
+
+def wait_for(predicate, timeout, what):
+    deadline = time.time() + timeout
+    while time.time() < deadline:
+        try:
+            if predicate():
+                return
+        except (OSError, RuntimeError):
+            pass
+        time.sleep(0.2)
+    raise AssertionError("timed out waiting for " + what)
+
+
+def total(device, field):
+    return sum(s[field] for s in device.servers().values())
+
+
+def fetch_once(device, field="successes"):
+    """Trigger /refresh and wait until the given per-endpoint counter grows; returns wall time in seconds."""
+    before = total(device, field)
+    start = time.time()
+    device.request("GET", "/refresh")
+    wait_for(lambda: total(device, field) > before, 20, "a fetch (%s)" % field)
+    return time.time() - start
+
+
+def check(condition, message):
+    print("  %s %s" % ("ok  " if condition else "FAIL", message))
+    return condition
+
+
+def main():
+    parser = argparse.ArgumentParser(description="API endpoint failover test against the host build")
+    parser.add_argument("--binary", default="./portfolio_host")
+    parser.add_argument("--port", type=int, default=18080)
+    parser.add_argument("--slow-delay", type=float, default=0.8, help="seconds the slow server waits")
+    parser.add_argument("--stall", type=float, default=5.0, help="seconds the fast server stalls in phase 2")
+    parser.add_argument("--verbose", action="store_true", help="show the device's serial output")
+    args = parser.parse_args()
+
+    slow = StandIn("slow", args.slow_delay)
+    fast = StandIn("fast", 0.0)
+    data_dir = tempfile.mkdtemp(prefix="portfolio_failover_")
+    device_args = [args.binary, "--port", str(args.port), "--data", data_dir]
+    if not args.verbose:
+        device_args.append("--quiet")
+    process = subprocess.Popen(device_args)
+    device = Device(args.port)
+    ok = True
+
+    try:
+        wait_for(lambda: device.request("GET", "/api/v1/servers")[0] == 200, 20, "the device web server")
+        device.request("POST", "/saveapi", {"server": slow.url, "username": "test", "userpass": "test",
+                                            "entryportfolio": "Main", "exitportfolio": ""})
+        device.request("POST", "/api/v1/servers", {"servers": fast.url, "hedge": "1"})
+        device.request("POST", "/savewifi", {"ssid": "host-network", "password": "x", "autoconnect": "1"})
+        print("waiting for the device to join the (host) network...")
+        wait_for(device.wifi_connected, 60, "WiFi connection")
+
+        print("phase 1: both servers healthy")
+        for _ in range(8):
+            fetch_once(device)
+        stats = device.servers()
+        ok &= check(stats[fast.url]["successes"] >= 6, "fast server preferred (%d fast / %d slow)" % (
+            stats[fast.url]["successes"], stats[slow.url]["successes"]))
+
+        print("phase 2: fast server stalls for %.1f s" % args.stall)
+        fast.delay = args.stall
+        slow_before = stats[slow.url]["successes"]
+        fast_hits = fast.hits
+        elapsed = [fetch_once(device) for _ in range(3)]
+        stats = device.servers()
+        ok &= check(stats[slow.url]["successes"] - slow_before >= 3, "every fetch answered by the slow server")
+        ok &= check(stats[fast.url]["hedges"] >= 1, "fetch hedged after the fast server's p95 (%d hedges)" %
+                    stats[fast.url]["hedges"])
+        ok &= check(max(elapsed) < args.stall, "no fetch waited for the stall (worst %.1f s)" % max(elapsed))
+        ok &= check(fast.hits - fast_hits == 1, "stalled server tried once, then skipped (%d tries)" %
+                    (fast.hits - fast_hits))
+
+        print("phase 3: both servers fail")
+        fast.delay = 0.0
+        slow.delay = 0.0
+        fast.status = 503
+        slow.status = 503
+        for _ in range(3):
+            fetch_once(device, "failures")
+        stats = device.servers()
+        ok &= check(all(s["breaker"] == "open" for s in stats.values()),
+                    "breakers open (%s)" % ", ".join(s["breaker"] for s in stats.values()))
+        hits_before = fast.hits + slow.hits
+        device.request("GET", "/refresh")
+        time.sleep(2)
+        ok &= check(fast.hits + slow.hits == hits_before, "open endpoints not contacted")
+    except AssertionError as error:
+        print("FAIL " + str(error))
+        ok = False
+    finally:
+        process.terminate()
+        process.wait(timeout=10)
+
+    print("PASS" if ok else "FAILED")
+    sys.exit(0 if ok else 1)
+
+
+if __name__ == "__main__":
+    main()
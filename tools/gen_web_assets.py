@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+"""
+Build step for the web UI static assets.
+
+Reads the CSS/JS/HTML sources in ../web, gzip-compresses each one and writes
+../web_assets.h with one PROGMEM byte array per asset plus a short content
+hash. The sketch serves these with Content-Encoding: gzip; CSS/JS get a long
+Cache-Control and the hash goes into the URL (?v=...) so a changed asset is
+fetched again after reflashing. HTML pages are served at fixed routes and
+revalidated by ETag; a {{name.ext}} placeholder in a page is replaced by that
+asset's hash here, so pages always link the current CSS/JS.
+
+Run after editing anything in web/:
+    python3 tools/gen_web_assets.py
+"""
+
+import gzip
+import hashlib
+import os
+import re
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+WEB_DIR = os.path.join(ROOT, "web")
+OUT_FILE = os.path.join(ROOT, "web_assets.h")
+
+MIME_TYPES = {
+    ".css": "text/css",
+    ".js": "application/javascript",
+    ".html": "text/html",
+}
+
+
+def ident(name):
+    return re.sub(r"[^A-Za-z0-9]", "_", name).upper()
+
+
+def main():
+    sources = {}
+    for name in sorted(os.listdir(WEB_DIR)):
+        if os.path.splitext(name)[1] in MIME_TYPES:
+            with open(os.path.join(WEB_DIR, name), "rb") as f:
+                sources[name] = f.read()
+
+    # pages link CSS/JS by hash, so those are hashed first
+    hashes = {name: hashlib.sha1(raw).hexdigest()[:8] for name, raw in sources.items()
+              if not name.endswith(".html")}
+
+    def substitute(match):
+        name = match.group(1).decode()
+        if name not in hashes:
+            raise SystemExit("unknown asset placeholder {{%s}}" % name)
+        return hashes[name].encode()
+
+    assets = []
+    for name in sorted(sources):
+        ext = os.path.splitext(name)[1]
+        raw = sources[name]
+        if ext == ".html":
+            raw = re.sub(rb"\{\{([A-Za-z0-9_.-]+)\}\}", substitute, raw)
+        # mtime=0 keeps the output byte-identical between runs
+        packed = gzip.compress(raw, compresslevel=9, mtime=0)
+        digest = hashlib.sha1(raw).hexdigest()[:8]
+        assets.append((name, ident(name), MIME_TYPES[ext], raw, packed, digest))
+
+    lines = [
+        "// Generated by tools/gen_web_assets.py - do not edit by hand.",
+        "// Sources: web/*.css, web/*.js, web/*.html",
+        "#pragma once",
+        "",
+        "#include <Arduino.h>",
+        "",
+    ]
+    for index, (name, sym, mime, raw, packed, digest) in enumerate(assets):
+        lines.append("// %s: %d bytes -> %d bytes gzip" % (name, len(raw), len(packed)))
+        lines.append("#define WEB_ASSET_%s_INDEX %d" % (sym, index))
+        lines.append('#define WEB_ASSET_%s_HASH "%s"' % (sym, digest))
+        lines.append("const uint8_t WEB_ASSET_%s[] PROGMEM = {" % sym)
+        for i in range(0, len(packed), 16):
+            chunk = ", ".join("0x%02x" % b for b in packed[i:i + 16])
+            lines.append("    " + chunk + ",")
+        lines.append("};")
+        lines.append("")
+
+    lines.append("typedef struct {")
+    lines.append("    const char* path;")
+    lines.append("    const char* mime;")
+    lines.append("    const char* hash;")
+    lines.append("    const uint8_t* data;")
+    lines.append("    size_t length;")
+    lines.append("} WebAsset;")
+    lines.append("")
+    lines.append("const WebAsset webAssets[] = {")
+    for name, sym, mime, raw, packed, digest in assets:
+        lines.append('    { "/static/%s", "%s", WEB_ASSET_%s_HASH, WEB_ASSET_%s, sizeof(WEB_ASSET_%s) },'
+                     % (name, mime, sym, sym, sym))
+    lines.append("};")
+    lines.append("const int webAssetCount = sizeof(webAssets) / sizeof(webAssets[0]);")
+    lines.append("")
+
+    with open(OUT_FILE, "w") as f:
+        f.write("\n".join(lines))
+
+    for name, sym, mime, raw, packed, digest in assets:
+        print("%-16s %6d -> %5d bytes  (%s)" % (name, len(raw), len(packed), digest))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+"""
+Simple concurrent load test for the device web UI.
+
+Opens N worker threads that hit the given routes in a loop for a fixed
+duration and reports request count, errors and p50/p90/p99/max latency per
+route. Run it from a laptop joined to the device AP or the same LAN:
+
+    python3 tools/load_test.py --host 192.168.4.1 --clients 8 --seconds 30
+    python3 tools/load_test.py --host 192.168.1.50 --routes / /api/v1/summary
+"""
+
+import argparse
+import http.client
+import threading
+import time
+from collections import defaultdict
+
+DEFAULT_ROUTES = ["/", "/positions?mode=entry", "/api/dashboard", "/api/v1/summary"]
+
+
+def percentile(values, pct):
+    if not values:
+        return 0.0
+    ordered = sorted(values)
+    index = min(len(ordered) - 1, int(round(pct / 100.0 * (len(ordered) - 1))))
+    return ordered[index]
+
+
+def worker(host, port, routes, deadline, results, errors, lock):
+    conn = None
+    i = 0
+    while time.time() < deadline:
+        route = routes[i % len(routes)]
+        i += 1
+        start = time.perf_counter()
+        try:
+            if conn is None:
+                conn = http.client.HTTPConnection(host, port, timeout=15)
+            conn.request("GET", route)
+            response = conn.getresponse()
+            response.read()
+            elapsed = (time.perf_counter() - start) * 1000.0
+            with lock:
+                results[route].append(elapsed)
+                if response.status >= 400:
+                    errors[route] += 1
+            if response.getheader("Connection", "").lower() == "close":
+                conn.close()
+                conn = None
+        except Exception:
+            with lock:
+                errors[route] += 1
+            if conn is not None:
+                conn.close()
+            conn = None
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Portfolio monitor web load test")
+    parser.add_argument("--host", default="192.168.4.1")
+    parser.add_argument("--port", type=int, default=80)
+    parser.add_argument("--clients", type=int, default=8)
+    parser.add_argument("--seconds", type=float, default=20.0)
+    parser.add_argument("--routes", nargs="+", default=DEFAULT_ROUTES)
+    args = parser.parse_args()
+
+    results = defaultdict(list)
+    errors = defaultdict(int)
+    lock = threading.Lock()
+    deadline = time.time() + args.seconds
+
+    threads = [
+        threading.Thread(target=worker,
+                         args=(args.host, args.port, args.routes, deadline, results, errors, lock))
+        for _ in range(args.clients)
+    ]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+
+    print("%-28s %7s %6s %8s %8s %8s %8s" % ("route", "count", "errors", "p50 ms", "p90 ms", "p99 ms", "max ms"))
+    everything = []
+    for route in args.routes:
+        values = results[route]
+        everything.extend(values)
+        print("%-28s %7d %6d %8.1f %8.1f %8.1f %8.1f" % (
+            route, len(values), errors[route], percentile(values, 50), percentile(values, 90),
+            percentile(values, 99), max(values) if values else 0.0))
+    print("%-28s %7d %6d %8.1f %8.1f %8.1f %8.1f" % (
+        "ALL", len(everything), sum(errors.values()), percentile(everything, 50),
+        percentile(everything, 90), percentile(everything, 99), max(everything) if everything else 0.0))
+    print("throughput: %.1f req/s with %d clients" % (len(everything) / args.seconds, args.clients))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,213 @@
+// Host benchmark and property checks for money.h (fixed-point money).
+//
+// Build:  g++ -O2 -std=c++11 -I. tools/money_bench.cpp -o money_bench
+// Usage:  ./money_bench [iterations]
+//
+// The reference implementation is exact decimal arithmetic on __int128
+// (host only). Parse, multiply, divide and format are checked against it
+// on random values, then timed against the float code they replace.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "money.h"
+
+typedef __int128 Wide;
+
+static std::mt19937_64 rng(20240601);
+static int failures = 0;
+
+static void fail(const char* what, const std::string& detail) {
+    if (failures < 20) printf("FAIL %s: %s\n", what, detail.c_str());
+    failures++;
+}
+
+static std::string wideToString(Wide v) {
+    bool negative = v < 0;
+    if (negative) v = -v;
+    std::string s;
+    do {
+        s.insert(s.begin(), (char)('0' + (int)(v % 10)));
+        v /= 10;
+    } while (v > 0);
+    return negative ? "-" + s : s;
+}
+
+// reference: exact fixed-point text with 8 decimals
+static std::string refFormat(Money v) {
+    bool negative = v < 0;
+    Wide m = negative ? -(Wide)v : (Wide)v;
+    std::string digits = wideToString(m);
+    while (digits.size() < 9) digits.insert(digits.begin(), '0');
+    std::string text = digits.substr(0, digits.size() - 8) + "." + digits.substr(digits.size() - 8);
+    return (negative && v != 0) ? "-" + text : text;
+}
+
+// reference: round half away from zero of num/den
+static Wide refDivRound(Wide num, Wide den) {
+    bool negative = (num < 0) != (den < 0);
+    if (num < 0) num = -num;
+    if (den < 0) den = -den;
+    Wide q = (num + den / 2) / den;
+    return negative ? -q : q;
+}
+
+static Money randomMoney(int maxIntDigits) {
+    int64_t intLimit = 1;
+    for (int i = 0; i < maxIntDigits; i++) intLimit *= 10;
+    Money v = (Money)(rng() % (uint64_t)intLimit) * MONEY_SCALE + (Money)(rng() % MONEY_SCALE);
+    return (rng() & 1) ? -v : v;
+}
+
+static void checkParse(int iterations) {
+    char buffer[64];
+    for (int i = 0; i < iterations; i++) {
+        Money v = randomMoney(10);
+        std::string text = refFormat(v);
+
+        // exact round trip
+        Money parsed;
+        if (!moneyParse(text.c_str(), &parsed) || parsed != v) fail("parse exact", text);
+
+        // extra digits beyond 8 decimals round half away from zero
+        int extra = (int)(rng() % 10);
+        std::string longer = text + (char)('0' + extra) + "7";
+        Money expected = v + (extra >= 5 ? (text[0] == '-' ? -1 : 1) : 0);
+        if (!moneyParse(longer.c_str(), &parsed) || parsed != expected) fail("parse round", longer);
+
+        // scientific notation: mantissa * 10^-k
+        int k = (int)(rng() % 8);
+        int64_t mantissa = (int64_t)(rng() % 1000000000ULL);
+        snprintf(buffer, sizeof(buffer), "%llde-%d", (long long)mantissa, k);
+        Wide want = (Wide)mantissa * MONEY_SCALE;
+        for (int j = 0; j < k; j++) want /= 10;
+        if (!moneyParse(buffer, &parsed) || parsed != (Money)want) fail("parse exponent", buffer);
+
+        // format matches reference
+        moneyFormat(v, 8, buffer, sizeof(buffer));
+        if (text != buffer) fail("format", text + " vs " + buffer);
+
+        // format with fewer decimals rounds like the reference
+        int decimals = (int)(rng() % 9);
+        Wide unit = 1;
+        for (int j = decimals; j < 8; j++) unit *= 10;
+        Money roundedRef = (Money)(refDivRound(v, unit) * unit);
+        moneyFormat(v, decimals, buffer, sizeof(buffer));
+        Money reparsed;
+        if (!moneyParse(buffer, &reparsed) || reparsed != roundedRef) fail("format decimals", refFormat(v) + " -> " + buffer);
+    }
+
+    const char* invalid[] = { "", "-", ".", "abc", "1.2.3", "1e", "12x", "99999999999999999999" };
+    Money dummy;
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        if (moneyParse(invalid[i], &dummy)) fail("parse invalid", invalid[i]);
+    }
+}
+
+static void checkArithmetic(int iterations) {
+    for (int i = 0; i < iterations; i++) {
+        // prices up to 1e6, quantities up to 1e4: products stay in range
+        Money price = randomMoney(6);
+        Money quantity = randomMoney(4);
+        Wide want = refDivRound((Wide)price * quantity, MONEY_SCALE);
+        Money got = moneyMul(price, quantity);
+        if ((Wide)got != want) fail("mul", refFormat(price) + " * " + refFormat(quantity));
+
+        int64_t divisor = (int64_t)(rng() % 1000000) + 1;
+        Money value = randomMoney(10);
+        if ((Wide)moneyDivInt(value, divisor) != refDivRound(value, divisor)) fail("divInt", refFormat(value));
+    }
+}
+
+template <class F>
+static double timeNs(int iterations, F body) {
+    auto t0 = std::chrono::steady_clock::now();
+    body();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / iterations;
+}
+
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? atoi(argv[1]) : 200000;
+
+    checkParse(iterations);
+    checkArithmetic(iterations);
+    printf("property checks:   %d iterations, %s\n", iterations, failures == 0 ? "OK" : "FAILED");
+
+    // inputs shaped like the portfolio payload
+    std::vector<std::string> prices, quantities;
+    std::vector<Money> mp, mq;
+    std::vector<float> fp, fq;
+    char buffer[64];
+    for (int i = 0; i < 1000; i++) {
+        Money p = llabs(randomMoney(5));
+        Money q = llabs(randomMoney(2)) / 1000;
+        prices.push_back(refFormat(p));
+        quantities.push_back(refFormat(q));
+        mp.push_back(p);
+        mq.push_back(q);
+        fp.push_back(strtof(prices.back().c_str(), NULL));
+        fq.push_back(strtof(quantities.back().c_str(), NULL));
+    }
+
+    volatile int64_t sink = 0;
+    volatile float fsink = 0;
+    int n = (int)prices.size();
+    int rounds = 200;
+
+    double parseMoney = timeNs(n * rounds, [&]() {
+        Money v;
+        for (int r = 0; r < rounds; r++)
+            for (int i = 0; i < n; i++) { moneyParse(prices[i].c_str(), &v); sink += v; }
+    });
+    double parseFloat = timeNs(n * rounds, [&]() {
+        for (int r = 0; r < rounds; r++)
+            for (int i = 0; i < n; i++) fsink += strtof(prices[i].c_str(), NULL);
+    });
+    double mulMoney = timeNs(n * rounds, [&]() {
+        Money total = 0;
+        for (int r = 0; r < rounds; r++)
+            for (int i = 0; i < n; i++) total += moneyMul(mp[i], mq[i]);
+        sink += total;
+    });
+    double mulFloat = timeNs(n * rounds, [&]() {
+        float total = 0;
+        for (int r = 0; r < rounds; r++)
+            for (int i = 0; i < n; i++) total += fp[i] * fq[i];
+        fsink += total;
+    });
+    double formatMoney = timeNs(n * rounds, [&]() {
+        for (int r = 0; r < rounds; r++)
+            for (int i = 0; i < n; i++) sink += moneyFormat(mp[i], 2, buffer, sizeof(buffer));
+    });
+    double formatFloat = timeNs(n * rounds, [&]() {
+        for (int r = 0; r < rounds; r++)
+            for (int i = 0; i < n; i++) sink += snprintf(buffer, sizeof(buffer), "%.2f", fp[i]);
+    });
+
+    printf("parse:             %.1f ns (money)  %.1f ns (strtof)\n", parseMoney, parseFloat);
+    printf("price * quantity:  %.1f ns (money)  %.1f ns (float)\n", mulMoney, mulFloat);
+    printf("format 2dp:        %.1f ns (money)  %.1f ns (snprintf float)\n", formatMoney, formatFloat);
+
+    // accuracy of the portfolio total the device used to compute in float
+    Wide exact = 0;
+    Money totalMoney = 0;
+    float totalFloat = 0;
+    for (int i = 0; i < n; i++) {
+        exact += refDivRound((Wide)mp[i] * mq[i], MONEY_SCALE);
+        totalMoney += moneyMul(mp[i], mq[i]);
+        totalFloat += fp[i] * fq[i];
+    }
+    double floatError = fabs((double)totalFloat - (double)exact / MONEY_SCALE);
+    printf("total of %d rows:  exact %s, money error %s, float error %.4f\n",
+           n, refFormat((Money)exact).c_str(), totalMoney == (Money)exact ? "0" : "NONZERO", floatError);
+    if (totalMoney != (Money)exact) failures++;
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,246 @@
+#!/usr/bin/env python3
+"""
+Concurrent Server-Sent Events test for /events (SERVER-SENT EVENTS section of the sketch).
+
+Serves a drifting portfolio from a local stand-in API, runs the Linux host build
+against it and holds --clients event streams open at once (the device limit,
+SSE_MAX_CLIENTS, is 10). Some of them (--stalled) never read, so their socket
+buffers fill and the device has to apply backpressure. Checks that:
+
+  1. every client gets the stream headers and the initial snapshot;
+  2. one more client beyond the limit is turned away with 503;
+  3. after each /refresh every reading client receives new events, however far
+     the stalled clients fall behind (their drops/resyncs are reported);
+  4. /events/stats lists every client with its queue metrics, and the slots are
+     released once the clients disconnect.
+
+Build the host binary first (see host/host_main.cpp), then:
+
+    python3 tools/sse_clients_test.py --binary ./portfolio_host
+"""
+
+import argparse
+import http.client
+import http.server
+import json
+import random
+import socket
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+import urllib.parse
+
+SYMBOLS = ["BTCUSDT", "ETHUSDT", "SOLUSDT", "BNBUSDT", "XRPUSDT", "ADAUSDT", "DOGEUSDT", "AVAXUSDT"]
+
+
+class DriftingPortfolio:
+    """GET /api/device/portfolio/... returns the portfolio with every price moved a little."""
+
+    def __init__(self):
+        self.prices = {s: 10.0 * (i + 1) ** 3 for i, s in enumerate(SYMBOLS)}
+        self.lock = threading.Lock()
+        portfolio = self
+
+        class Handler(http.server.BaseHTTPRequestHandler):
+            def do_GET(self):
+                ok = self.path.startswith("/api/device/portfolio/")
+                body = json.dumps(portfolio.payload()).encode() if ok else b"{}"
+                self.send_response(200 if ok else 404)
+                self.send_header("Content-Type", "application/json")
+                self.send_header("Content-Length", str(len(body)))
+                self.end_headers()
+                self.wfile.write(body)
+
+            def log_message(self, fmt, *args):
+                pass
+
+        self.server = http.server.ThreadingHTTPServer(("127.0.0.1", 0), Handler)
+        self.server.daemon_threads = True
+        self.url = "http://127.0.0.1:%d" % self.server.server_address[1]
+        threading.Thread(target=self.server.serve_forever, daemon=True).start()
+
+    def payload(self):
+        rows = []
+        with self.lock:
+            for i, symbol in enumerate(SYMBOLS):
+                self.prices[symbol] *= 1 + random.uniform(-0.01, 0.01)
+                entry = 10.0 * (i + 1) ** 3
+                price = self.prices[symbol]
+                rows.append({"symbol": symbol, "side": "BUY", "quantity": "1", "entry_price": "%.4f" % entry,
+                             "current_price": "%.4f" % price, "pnl": "%.4f" % (price - entry),
+                             "pnl_percent": round((price - entry) / entry * 100, 2)})
+        return {"portfolio": rows}
+
+
+class EventClient:
+    """One /events stream on a raw socket; a stalled client connects but never reads."""
+
+    def __init__(self, host, port, stalled):
+        self.stalled = stalled
+        self.status = None
+        self.events = {}
+        self.total = 0
+        self.lock = threading.Lock()
+        self.sock = socket.create_connection((host, port), timeout=30)
+        if stalled:
+            self.sock.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 4096)
+        self.sock.sendall(b"GET /events HTTP/1.1\r\nHost: device\r\nAccept: text/event-stream\r\n\r\n")
+        if not stalled:
+            threading.Thread(target=self._run, daemon=True).start()
+
+    def _run(self):
+        stream = self.sock.makefile("rb")
+        try:
+            status_line = stream.readline()
+            parts = status_line.split()
+            self.status = int(parts[1]) if len(parts) > 1 else 0
+            while True:
+                line = stream.readline()
+                if not line:
+                    return
+                if line.startswith(b"event: "):
+                    name = line[7:].strip().decode()
+                    with self.lock:
+                        self.events[name] = self.events.get(name, 0) + 1
+                        self.total += 1
+        except (OSError, ValueError):
+            pass
+
+    def count(self):
+        with self.lock:
+            return self.total
+
+    def close(self):
+        try:
+            self.sock.close()
+        except OSError:
+            pass
+
+
+def request(host, port, method, path, params=None):
+    body = urllib.parse.urlencode(params) if params else None
+    conn = http.client.HTTPConnection(host, port, timeout=30)
+    headers = {"Content-Type": "application/x-www-form-urlencoded"} if body else {}
+    conn.request(method, path, body=body, headers=headers)
+    response = conn.getresponse()
+    data = response.read()
+    conn.close()
+    return response.status, data
+
+
+def wait_for(predicate, timeout, what):
+    deadline = time.time() + timeout
+    while time.time() < deadline:
+        try:
+            if predicate():
+                return
+        except (OSError, ValueError):
+            pass
+        time.sleep(0.2)
+    raise AssertionError("timed out waiting for " + what)
+
+
+def check(condition, message):
+    print("  %s %s" % ("ok  " if condition else "FAIL", message))
+    return condition
+
+
+def event_stats(host, port):
+    status, data = request(host, port, "GET", "/events/stats")
+    if status != 200:
+        raise ValueError("GET /events/stats returned %d" % status)
+    return json.loads(data)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Concurrent SSE clients against the host build")
+    parser.add_argument("--binary", help="start this host build (otherwise --device must point at a running one)")
+    parser.add_argument("--device", default="http://127.0.0.1:18082")
+    parser.add_argument("--clients", type=int, default=10, help="event streams held open at once")
+    parser.add_argument("--stalled", type=int, default=2, help="how many of them never read")
+    parser.add_argument("--refreshes", type=int, default=5)
+    parser.add_argument("--verbose", action="store_true", help="show the host build's serial output")
+    args = parser.parse_args()
+
+    device = urllib.parse.urlparse(args.device)
+    host, port = device.hostname, device.port or 80
+    api = DriftingPortfolio()
+    process = None
+    clients = []
+    ok = True
+
+    try:
+        if args.binary:
+            device_args = [args.binary, "--port", str(port), "--data", tempfile.mkdtemp(prefix="portfolio_sse_")]
+            if not args.verbose:
+                device_args.append("--quiet")
+            process = subprocess.Popen(device_args)
+        wait_for(lambda: request(host, port, "GET", "/events/stats")[0] == 200, 20, "the device web server")
+
+        request(host, port, "POST", "/saveapi", {"server": api.url, "username": "test", "userpass": "test",
+                                                 "entryportfolio": "Main", "exitportfolio": ""})
+        if args.binary:
+            request(host, port, "POST", "/savewifi", {"ssid": "host-network", "password": "x", "autoconnect": "1"})
+        print("waiting for the device to load the portfolio...")
+        wait_for(lambda: b"portfolio_wifi_connected 1" in request(host, port, "GET", "/metrics")[1], 60,
+                 "WiFi connection")
+        wait_for(lambda: json.loads(request(host, port, "GET", "/api/v1/summary")[1])["entry"]["positions"] > 0,
+                 60, "the first portfolio sync")
+
+        print("phase 1: %d clients (%d stalled)" % (args.clients, args.stalled))
+        for i in range(args.clients):
+            clients.append(EventClient(host, port, i < args.stalled))
+        readers = [c for c in clients if not c.stalled]
+        wait_for(lambda: event_stats(host, port)["active"] == args.clients, 20, "all clients to be accepted")
+        wait_for(lambda: all(c.count() > 0 for c in readers), 20, "the initial snapshot on every reader")
+        ok &= check(all(c.status == 200 for c in readers), "every reader got 200 text/event-stream")
+
+        extra = EventClient(host, port, False)
+        wait_for(lambda: extra.status is not None, 10, "the extra client's response")
+        ok &= check(extra.status == 503, "client %d turned away (status %s)" % (args.clients + 1, extra.status))
+        extra.close()
+
+        print("phase 2: %d refreshes" % args.refreshes)
+        for n in range(args.refreshes):
+            before = [c.count() for c in readers]
+            request(host, port, "GET", "/refresh")
+            try:
+                wait_for(lambda: all(c.count() > b for c, b in zip(readers, before)), 20, "events after refresh")
+            except AssertionError:
+                ok &= check(False, "refresh %d reached every reader" % (n + 1))
+                break
+        else:
+            ok &= check(True, "every refresh reached all %d readers" % len(readers))
+
+        stats = event_stats(host, port)
+        ok &= check(stats["active"] == args.clients, "stats list %d active clients" % stats["active"])
+        for c in stats["clients"]:
+            print("    slot %-2d sent %-5d dropped %-5d queue %-3d max queue %-3d bytes %d" % (
+                c["slot"], c["sent"], c["dropped"], c["queueDepth"], c["maxQueueDepth"], c["bytes"]))
+        print("  published %d events, queue size %d, rejected %d" % (stats["published"], stats["queueSize"],
+                                                                    stats["rejected"]))
+
+        print("phase 3: disconnect")
+        for c in clients:
+            c.close()
+        clients = []
+        wait_for(lambda: event_stats(host, port)["active"] == 0, 30, "the slots to be released")
+        ok &= check(True, "all slots released")
+    except (AssertionError, OSError, ValueError, KeyError) as error:
+        print("FAIL " + str(error))
+        ok = False
+    finally:
+        for c in clients:
+            c.close()
+        if process is not None:
+            process.terminate()
+            process.wait(timeout=10)
+
+    print("PASS" if ok else "FAILED")
+    sys.exit(0 if ok else 1)
+
+
+if __name__ == "__main__":
+    main()
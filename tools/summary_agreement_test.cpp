@@ -0,0 +1,311 @@
+// Host check for the INCREMENTAL SUMMARY section of the sketch.
+//
+// Build like the host binary, with this file in place of host_main.cpp:
+//   g++ -std=gnu++17 -O2 -Ihost -I. -I<ArduinoJson>/src tools/summary_agreement_test.cpp $(ls host/*.cpp | grep -v host_main) -o summary_agreement_test -lpthread
+// Usage:  ./summary_agreement_test [--steps 2000] [--positions 100] [--seed N] [payload.json ...]
+//
+// Payload files are recorded responses from the portfolio API; they are parsed
+// into the entry slot in the order given, before the synthetic run. The synthetic
+// run moves prices, opens, closes and reorders positions in two slots that share
+// symbols, and sends stream ticks. Every update goes through the device path
+// (parseCryptoData / streamApplyTick), and the running aggregate is compared with
+// the full scan calculatePortfolioSummary did before summaries became incremental.
+
+#define ARDUINOJSON_ENABLE_ARDUINO_STRING 1
+#define ARDUINOJSON_ENABLE_ARDUINO_STREAM 1
+#define ARDUINOJSON_ENABLE_ARDUINO_PRINT 1
+
+#include "../portfolio_WROVER_patch_13.ino"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+static std::mt19937_64 rng(20240715);
+static int failures = 0;
+static int checks = 0;
+
+static void fail(const char* what, const std::string& detail) {
+    if (failures < 20) printf("FAIL %s: %s\n", what, detail.c_str());
+    failures++;
+}
+
+// ----- Reference: the full scan from before the incremental summary -----
+typedef struct {
+    Money totalValue;
+    Money totalPnl;
+    int longCount;
+    int shortCount;
+    int winningCount;
+    int losingCount;
+    float worstPercent;
+} ReferenceSummary;
+
+static void referenceSummary(const CryptoPosition* data, int count, ReferenceSummary* out) {
+    memset(out, 0, sizeof(ReferenceSummary));
+    for (int i = 0; i < count; i++) {
+        out->totalValue += moneyMul(data[i].currentPrice, data[i].quantity);
+        out->totalPnl += data[i].pnlValue;
+
+        if (data[i].isLong) out->longCount++;
+        else out->shortCount++;
+
+        if (data[i].changePercent >= 0) out->winningCount++;
+        else out->losingCount++;
+
+        if (data[i].changePercent < out->worstPercent) out->worstPercent = data[i].changePercent;
+    }
+}
+
+static std::string moneyText(Money value) {
+    char buffer[32];
+    moneyFormat(value, 8, buffer, sizeof(buffer));
+    return buffer;
+}
+
+static void compareSlot(byte mode, const char* step) {
+    PortfolioSlot* slot = &portfolios[mode];
+    const PortfolioAggregate* agg = &slot->aggregate;
+    ReferenceSummary ref;
+    referenceSummary(slot->data, slot->count, &ref);
+    checks++;
+
+    std::string where = std::string(step) + " slot " + std::to_string(mode);
+    if (slot->count == 0) return;
+    if (!agg->valid) {
+        fail("aggregate", where + ": not valid with " + std::to_string(slot->count) + " positions");
+        return;
+    }
+    if (agg->totalValue != ref.totalValue) {
+        fail("totalValue", where + ": " + moneyText(agg->totalValue) + " vs " + moneyText(ref.totalValue));
+    }
+    if (agg->totalPnl != ref.totalPnl) {
+        fail("totalPnl", where + ": " + moneyText(agg->totalPnl) + " vs " + moneyText(ref.totalPnl));
+    }
+    if (agg->longCount != ref.longCount || agg->shortCount != ref.shortCount ||
+        agg->winningCount != ref.winningCount || agg->losingCount != ref.losingCount) {
+        char detail[128];
+        snprintf(detail, sizeof(detail), "long/short/win/lose %d/%d/%d/%d vs %d/%d/%d/%d",
+                 agg->longCount, agg->shortCount, agg->winningCount, agg->losingCount,
+                 ref.longCount, ref.shortCount, ref.winningCount, ref.losingCount);
+        fail("counts", where + ": " + detail);
+    }
+    if (agg->worstPercent != ref.worstPercent) {
+        fail("worstPercent", where + ": " + std::to_string(agg->worstPercent) + " vs " + std::to_string(ref.worstPercent));
+    } else if (ref.worstPercent < 0) {
+        // ties may pick a different row; the named row must still hold the worst percent
+        bool found = false;
+        for (int i = 0; i < slot->count && !found; i++) {
+            found = slot->data[i].isLong == agg->worstIsLong && slot->data[i].changePercent == agg->worstPercent &&
+                    strncmp(slot->data[i].symbol, agg->worstSymbol, 16) == 0;
+        }
+        if (!found) fail("worstSymbol", where + ": " + agg->worstSymbol + " is not a worst row");
+    }
+}
+
+// calculatePortfolioSummary publishes the aggregate (and rebuilds it every SUMMARY_FULL_RECOMPUTE_EVERY)
+static void compareSummary(byte mode, const char* step) {
+    calculatePortfolioSummary(mode);
+    const PortfolioSlot* slot = &portfolios[mode];
+    if (slot->count == 0) return;
+    ReferenceSummary ref;
+    referenceSummary(slot->data, slot->count, &ref);
+    std::string where = std::string(step) + " slot " + std::to_string(mode);
+    if (slot->summary.totalCurrentValue != ref.totalValue || slot->summary.totalPnl != ref.totalPnl) {
+        fail("summary totals", where + ": " + moneyText(slot->summary.totalCurrentValue) + " vs " + moneyText(ref.totalValue));
+    }
+    if (slot->summary.worstChangePercent != ref.worstPercent) {
+        fail("summary worst", where + ": " + std::to_string(slot->summary.worstChangePercent));
+    }
+}
+
+// ----- Synthetic fixtures -----
+typedef struct {
+    std::string symbol;
+    bool isLong;
+    double quantity;
+    double entryPrice;
+} FixturePosition;
+
+static const int FIXTURE_SYMBOLS = 40;
+static double symbolPrices[FIXTURE_SYMBOLS];
+
+static std::string fixtureSymbol(int index) {
+    char name[16];
+    snprintf(name, sizeof(name), "SYM%02dUSDT", index);
+    return name;
+}
+
+static int fixtureSymbolIndex(const std::string& symbol) {
+    return atoi(symbol.c_str() + 3);
+}
+
+static double uniform(double low, double high) {
+    return std::uniform_real_distribution<double>(low, high)(rng);
+}
+
+static int pick(int count) {
+    return (int)(rng() % (uint64_t)count);
+}
+
+static bool hasPosition(const std::vector<FixturePosition>& positions, const std::string& symbol, bool isLong) {
+    for (const FixturePosition& p : positions) {
+        if (p.symbol == symbol && p.isLong == isLong) return true;
+    }
+    return false;
+}
+
+static void openPosition(std::vector<FixturePosition>& positions) {
+    for (int attempt = 0; attempt < 16; attempt++) {
+        std::string symbol = fixtureSymbol(pick(FIXTURE_SYMBOLS));
+        bool isLong = pick(3) != 0;
+        if (hasPosition(positions, symbol, isLong)) continue;
+        double price = symbolPrices[fixtureSymbolIndex(symbol)];
+        positions.push_back({ symbol, isLong, uniform(0.01, 50.0), price * uniform(0.9, 1.1) });
+        return;
+    }
+}
+
+// the API's JSON for one portfolio; percentages are rounded like the server's so ties happen
+static String fixturePayload(const std::vector<FixturePosition>& positions) {
+    std::string json = "{\"portfolio\":[";
+    char row[320];
+    for (size_t i = 0; i < positions.size(); i++) {
+        const FixturePosition& p = positions[i];
+        double price = symbolPrices[fixtureSymbolIndex(p.symbol)];
+        double pnl = (price - p.entryPrice) * p.quantity * (p.isLong ? 1 : -1);
+        double percent = (price - p.entryPrice) / p.entryPrice * 100 * (p.isLong ? 1 : -1);
+        snprintf(row, sizeof(row),
+                 "%s{\"symbol\":\"%s\",\"side\":\"%s\",\"quantity\":\"%.6f\",\"entry_price\":\"%.6f\","
+                 "\"current_price\":\"%.6f\",\"pnl\":\"%.6f\",\"pnl_percent\":%.2f}",
+                 i > 0 ? "," : "", p.symbol.c_str(), p.isLong ? "BUY" : "SELL", p.quantity, p.entryPrice,
+                 price, pnl, percent);
+        json += row;
+    }
+    json += "]}";
+    return String(json.c_str());
+}
+
+static bool readFile(const char* path, std::string* out) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    char buffer[4096];
+    size_t n;
+    out->clear();
+    while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) out->append(buffer, n);
+    fclose(f);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    int steps = 2000;
+    int positionCount = 100;
+    std::vector<const char*> files;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--steps" && i + 1 < argc) {
+            steps = atoi(argv[++i]);
+        } else if (arg == "--positions" && i + 1 < argc) {
+            positionCount = atoi(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            rng.seed(strtoull(argv[++i], NULL, 10));
+        } else if (arg.size() > 2 && arg.compare(0, 2, "--") == 0) {
+            fprintf(stderr, "usage: %s [--steps N] [--positions N] [--seed N] [payload.json ...]\n", argv[0]);
+            return 2;
+        } else {
+            files.push_back(argv[i]);
+        }
+    }
+
+    char dir[] = "/tmp/portfolio_summary_XXXXXX";
+    if (mkdtemp(dir) == NULL) {
+        perror("mkdtemp");
+        return 2;
+    }
+    hostSetDataDir(dir);
+    hostUseFakeClock(true);
+    hostSetSerialEcho(false);
+    setup();
+
+    for (const char* path : files) {
+        std::string payload;
+        if (!readFile(path, &payload)) {
+            fprintf(stderr, "cannot read %s\n", path);
+            return 2;
+        }
+        parseCryptoData(String(payload.c_str()), 0);
+        compareSlot(0, path);
+        compareSummary(0, path);
+    }
+
+    for (int i = 0; i < FIXTURE_SYMBOLS; i++) symbolPrices[i] = 10.0 * (i + 1) * (i + 1);
+
+    // entry and exit share most symbols, so a parse of one moves prices in the other (SYMBOL PRICE TABLE)
+    std::vector<FixturePosition> slots[2];
+    for (int m = 0; m < 2; m++) {
+        while ((int)slots[m].size() < positionCount / (m + 1)) openPosition(slots[m]);
+        parseCryptoData(fixturePayload(slots[m]), m);
+    }
+
+    unsigned long parses = 0;
+    unsigned long ticks = 0;
+    unsigned long changedRows = 0;
+    long tickId = 0;
+
+    for (int step = 0; step < steps; step++) {
+        char name[32];
+        snprintf(name, sizeof(name), "step %d", step);
+        byte mode = pick(2);
+        std::vector<FixturePosition>& positions = slots[mode];
+        int action = pick(20);
+
+        if (action < 3) {
+            // stream ticks on a few symbols
+            for (int n = 0; n < 5; n++) {
+                int index = pick(FIXTURE_SYMBOLS);
+                symbolPrices[index] *= 1 + uniform(-0.02, 0.02);
+                streamApplyTick(fixtureSymbol(index).c_str(), moneyFromDouble(symbolPrices[index]), ++tickId, micros());
+                ticks++;
+            }
+        } else {
+            if (action < 13) {
+                for (int index = 0; index < FIXTURE_SYMBOLS; index++) {
+                    if (pick(10) == 0) symbolPrices[index] *= 1 + uniform(-0.02, 0.02);
+                }
+            } else if (action < 15 && !positions.empty()) {
+                positions.erase(positions.begin() + pick((int)positions.size()));
+            } else if (action < 17) {
+                openPosition(positions);
+            } else if (action < 18) {
+                std::shuffle(positions.begin(), positions.end(), rng);
+            } else if (action < 19 && !positions.empty()) {
+                // worst row recovers; the aggregate has to find the next worst
+                int worst = 0;
+                for (int i = 1; i < (int)positions.size(); i++) {
+                    if (symbolPrices[fixtureSymbolIndex(positions[i].symbol)] / positions[i].entryPrice <
+                        symbolPrices[fixtureSymbolIndex(positions[worst].symbol)] / positions[worst].entryPrice) worst = i;
+                }
+                symbolPrices[fixtureSymbolIndex(positions[worst].symbol)] *= 1.05;
+            }
+            parseCryptoData(fixturePayload(positions), mode);
+            changedRows += portfolios[mode].aggregate.lastChangedRows;
+            parses++;
+        }
+
+        compareSlot(0, name);
+        compareSlot(1, name);
+        compareSummary(mode, name);
+        hostAdvanceMillis(1000);
+    }
+
+    if (summaryMismatches != 0) {
+        fail("cross-check", std::to_string(summaryMismatches) + " mismatches counted by calculatePortfolioSummary");
+    }
+
+    printf("%d comparisons: %lu parses (%.1f changed rows each), %lu ticks, %lu full recomputes\n",
+           checks, parses, parses > 0 ? (double)changedRows / parses : 0.0, ticks, summaryFullRecomputes);
+    printf("%s\n", failures == 0 ? "PASS" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,329 @@
+#!/usr/bin/env python3
+"""
+Stand-in WebSocket tick feed for the price stream (PRICE STREAM section of the sketch).
+
+Serves a portfolio over a stand-in portfolio API, points the device's price stream
+at a local ws:// feed, waits for the device to subscribe and then replays ticks.
+Reports the device's own tick-to-buzzer latency (GET /api/v1/stream) and the
+end-to-end time from sending a tick to the alert arriving on the SSE stream
+(/events; on the device the buzzer tone plays before the SSE event, so this is an
+upper bound).
+
+Tick sources:
+  (default)         a built-in -12 % wick on BTCUSDT over ~300 ms
+  --ticks FILE      JSON lines: {"t": ms_offset, "s": "BTCUSDT", "p": "64000.5"}
+                    the first price of each symbol becomes a long entry price
+  --ticks FILE.rec  a payload recording (GET /api/v1/recording/download): the first
+                    record is served as the portfolio, later records become ticks at
+                    their recorded spacing
+
+Against the host build:
+
+    python3 tools/tick_feed.py --binary ./portfolio_host
+
+Against a device on the LAN (the feed must be reachable from it):
+
+    python3 tools/tick_feed.py --device http://192.168.1.50 --bind 0.0.0.0 --advertise 192.168.1.20
+"""
+
+import argparse
+import base64
+import hashlib
+import http.client
+import http.server
+import json
+import re
+import socket
+import struct
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+import urllib.parse
+
+WS_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+
+
+def builtin_ticks():
+    ticks = []
+    price = 64000.0
+    for i in range(20):                                  # drift
+        price *= 1.0005 if i % 3 else 0.9995
+        ticks.append({"t": i * 100, "s": "BTCUSDT", "p": "%.2f" % price})
+    start = ticks[-1]["t"] + 100
+    for i in range(1, 7):                                # wick: -12 % in 300 ms
+        ticks.append({"t": start + i * 50, "s": "BTCUSDT", "p": "%.2f" % (price * (1 - 0.02 * i))})
+    for i in range(1, 7):                                # recovery
+        ticks.append({"t": start + 300 + i * 100, "s": "BTCUSDT", "p": "%.2f" % (price * (0.88 + 0.02 * i))})
+    return ticks
+
+
+def portfolio_from_ticks(ticks):
+    first = {}
+    for tick in ticks:
+        first.setdefault(tick["s"], tick["p"])
+    return {"portfolio": [{"symbol": s, "pnl_percent": 0.0, "current_price": p, "entry_price": p,
+                           "quantity": "1", "pnl": "0", "side": "BUY"} for s, p in first.items()]}
+
+
+def load_recording(path):
+    """Payload recording -> (first payload, ticks from the following records)."""
+    records = []
+    with open(path, "rb") as f:
+        while True:
+            header = f.readline()
+            if not header:
+                break
+            match = re.match(rb"#REC (\d+) (\d+) (\d+) (\d+)", header)
+            if not match:
+                raise ValueError("bad record header: %r" % header)
+            body = f.read(int(match.group(4)))
+            f.readline()
+            records.append((int(match.group(2)), json.loads(body)))
+    if not records:
+        raise ValueError("empty recording")
+    base = records[0][0]
+    ticks = []
+    for millis, payload in records[1:]:
+        for item in payload.get("portfolio", []):
+            ticks.append({"t": millis - base, "s": item["symbol"], "p": str(item["current_price"])})
+    return records[0][1], ticks
+
+
+def load_ticks(path):
+    if path is None:
+        ticks = builtin_ticks()
+        return portfolio_from_ticks(ticks), ticks
+    with open(path, "rb") as f:
+        is_recording = f.read(4) == b"#REC"
+    if is_recording:
+        return load_recording(path)
+    with open(path) as f:
+        ticks = [json.loads(line) for line in f if line.strip()]
+    return portfolio_from_ticks(ticks), ticks
+
+
+class PortfolioStandIn:
+    """GET /api/device/portfolio/... returns the portfolio; the prices endpoint is left out (404)."""
+
+    def __init__(self, host, payload):
+        body = json.dumps(payload).encode()
+
+        class Handler(http.server.BaseHTTPRequestHandler):
+            def do_GET(self):
+                ok = self.path.startswith("/api/device/portfolio/")
+                self.send_response(200 if ok else 404)
+                self.send_header("Content-Type", "application/json")
+                self.send_header("Content-Length", str(len(body) if ok else 2))
+                self.end_headers()
+                self.wfile.write(body if ok else b"{}")
+
+            def log_message(self, fmt, *args):
+                pass
+
+        self.server = http.server.ThreadingHTTPServer((host, 0), Handler)
+        self.server.daemon_threads = True
+        self.port = self.server.server_address[1]
+        threading.Thread(target=self.server.serve_forever, daemon=True).start()
+
+
+class TickFeed:
+    """Single-client WebSocket server: handshake, read the subscribe message, send text frames."""
+
+    def __init__(self, host):
+        self.listener = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        self.listener.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        self.listener.bind((host, 0))
+        self.listener.listen(1)
+        self.port = self.listener.getsockname()[1]
+        self.conn = None
+        self.subscribed = []
+
+    def accept(self, timeout):
+        self.listener.settimeout(timeout)
+        conn, _ = self.listener.accept()
+        conn.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        request = b""
+        while b"\r\n\r\n" not in request:
+            chunk = conn.recv(1024)
+            if not chunk:
+                raise ConnectionError("client closed during handshake")
+            request += chunk
+        key = re.search(rb"Sec-WebSocket-Key:\s*(\S+)", request, re.I).group(1)
+        accept = base64.b64encode(hashlib.sha1(key + WS_GUID.encode()).digest())
+        conn.sendall(b"HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                     b"Sec-WebSocket-Accept: " + accept + b"\r\n\r\n")
+        self.conn = conn
+
+    def read_frame(self, timeout):
+        self.conn.settimeout(timeout)
+        head = self._read(2)
+        opcode = head[0] & 0x0F
+        length = head[1] & 0x7F
+        if length == 126:
+            length = struct.unpack(">H", self._read(2))[0]
+        elif length == 127:
+            length = struct.unpack(">Q", self._read(8))[0]
+        mask = self._read(4) if head[1] & 0x80 else b"\0\0\0\0"
+        payload = bytes(b ^ mask[i % 4] for i, b in enumerate(self._read(length)))
+        return opcode, payload
+
+    def _read(self, n):
+        data = b""
+        while len(data) < n:
+            chunk = self.conn.recv(n - len(data))
+            if not chunk:
+                raise ConnectionError("client closed")
+            data += chunk
+        return data
+
+    def wait_subscribe(self, timeout):
+        deadline = time.time() + timeout
+        while time.time() < deadline:
+            opcode, payload = self.read_frame(deadline - time.time())
+            if opcode == 0x1:
+                message = json.loads(payload)
+                if message.get("op") == "subscribe":
+                    self.subscribed = message.get("symbols", [])
+                    return
+        raise TimeoutError("no subscribe message")
+
+    def send(self, message):
+        payload = json.dumps(message).encode()
+        if len(payload) < 126:
+            header = struct.pack("BB", 0x81, len(payload))
+        else:
+            header = struct.pack(">BBH", 0x81, 126, len(payload))
+        self.conn.sendall(header + payload)
+
+
+class AlertWatcher:
+    """Timestamps "alert" events from the device's SSE stream."""
+
+    def __init__(self, host, port):
+        self.times = []
+        self.conn = http.client.HTTPConnection(host, port, timeout=600)
+        self.conn.request("GET", "/events")
+        self.response = self.conn.getresponse()
+        threading.Thread(target=self._run, daemon=True).start()
+
+    def _run(self):
+        try:
+            while True:
+                line = self.response.fp.readline()
+                if not line:
+                    return
+                if line.strip() == b"event: alert":
+                    self.times.append(time.time())
+        except (OSError, ValueError):
+            pass
+
+
+def request(host, port, method, path, params=None):
+    body = urllib.parse.urlencode(params) if params else None
+    conn = http.client.HTTPConnection(host, port, timeout=30)
+    headers = {"Content-Type": "application/x-www-form-urlencoded"} if body else {}
+    conn.request(method, path, body=body, headers=headers)
+    response = conn.getresponse()
+    data = response.read()
+    conn.close()
+    return response.status, data
+
+
+def wait_for(predicate, timeout, what):
+    deadline = time.time() + timeout
+    while time.time() < deadline:
+        try:
+            if predicate():
+                return
+        except (OSError, ValueError):
+            pass
+        time.sleep(0.2)
+    raise AssertionError("timed out waiting for " + what)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="WebSocket tick feed and tick-to-alert latency check")
+    parser.add_argument("--binary", help="start this host build (otherwise --device must point at a running one)")
+    parser.add_argument("--device", default="http://127.0.0.1:18081")
+    parser.add_argument("--bind", default="127.0.0.1", help="address the feed and stand-in API listen on")
+    parser.add_argument("--advertise", help="address the device uses to reach the feed (default: --bind)")
+    parser.add_argument("--ticks", help="tick file (JSON lines) or payload recording")
+    parser.add_argument("--speed", type=float, default=1.0, help="replay at N x recorded speed")
+    parser.add_argument("--verbose", action="store_true", help="show the host build's serial output")
+    args = parser.parse_args()
+
+    payload, ticks = load_ticks(args.ticks)
+    device = urllib.parse.urlparse(args.device)
+    host, port = device.hostname, device.port or 80
+    advertise = args.advertise or args.bind
+
+    api = PortfolioStandIn(args.bind, payload)
+    feed = TickFeed(args.bind)
+    process = None
+    ok = True
+
+    try:
+        if args.binary:
+            device_args = [args.binary, "--port", str(port), "--data", tempfile.mkdtemp(prefix="portfolio_ticks_")]
+            if not args.verbose:
+                device_args.append("--quiet")
+            process = subprocess.Popen(device_args)
+        wait_for(lambda: request(host, port, "GET", "/api/v1/stream")[0] == 200, 20, "the device web server")
+
+        request(host, port, "POST", "/saveapi", {"server": "http://%s:%d" % (advertise, api.port), "username": "test",
+                                                 "userpass": "test", "entryportfolio": "Main", "exitportfolio": ""})
+        request(host, port, "POST", "/api/v1/stream", {"url": "ws://%s:%d/ticks" % (advertise, feed.port), "enabled": "1"})
+        if args.binary:
+            request(host, port, "POST", "/savewifi", {"ssid": "host-network", "password": "x", "autoconnect": "1"})
+
+        print("waiting for the device to load the portfolio and subscribe...")
+        symbols = {item["symbol"] for item in payload["portfolio"]}
+        feed.accept(90)
+        feed.wait_subscribe(30)
+        while not symbols.issubset(feed.subscribed):   # the first subscribe may predate the first full sync
+            feed.wait_subscribe(60)
+        print("subscribed: %s" % ", ".join(feed.subscribed))
+
+        watcher = AlertWatcher(host, port)
+        time.sleep(0.5)
+        sent = {}
+        start = time.time()
+        for tick_id, tick in enumerate(ticks):
+            due = start + tick["t"] / 1000.0 / args.speed
+            if due > time.time():
+                time.sleep(due - time.time())
+            sent[tick_id] = time.time()
+            feed.send({"s": tick["s"], "p": tick["p"], "id": tick_id})
+        time.sleep(2)
+
+        status, data = request(host, port, "GET", "/api/v1/stream")
+        stats = json.loads(data)
+        latency = stats["latencyUs"]
+        print("ticks sent %d, received %d, matched %d, alerts %d" % (len(ticks), stats["ticks"], stats["matched"],
+                                                                     stats["alerts"]))
+        if stats["alerts"] == 0:
+            print("no alert was raised by the ticks")
+            ok = args.ticks is not None     # the built-in wick must alert
+        else:
+            print("tick -> buzzer on the device: p50 %.2f ms  p95 %.2f ms  max %.2f ms  (%d alerts)" % (
+                latency["p50"] / 1000.0, latency["p95"] / 1000.0, latency["max"] / 1000.0, latency["count"]))
+            tick_id = stats["lastAlertTickId"]
+            if watcher.times and tick_id in sent:
+                print("tick %d sent -> SSE alert: %.1f ms (includes the buzzer tone)" % (
+                    tick_id, (watcher.times[-1] - sent[tick_id]) * 1000.0))
+    except (AssertionError, OSError, TimeoutError, ValueError) as error:
+        print("FAIL " + str(error))
+        ok = False
+    finally:
+        if process is not None:
+            process.terminate()
+            process.wait(timeout=10)
+
+    print("PASS" if ok else "FAILED")
+    sys.exit(0 if ok else 1)
+
+
+if __name__ == "__main__":
+    main()
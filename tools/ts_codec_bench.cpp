@@ -0,0 +1,203 @@
+// Host benchmark for ts_codec.h (price history compression).
+//
+// Build:  g++ -O2 -std=c++11 -I. tools/ts_codec_bench.cpp -o ts_codec_bench
+// Usage:  ./ts_codec_bench [--interval 15] [payload.json ...]
+//
+// Each payload file is one recorded response from the portfolio API
+// (the JSON the device polls). Files are taken in the order given and
+// spaced --interval seconds apart. Without files a synthetic 24h random
+// walk is used. Every series is decoded again and checked bit-for-bit.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ts_codec.h"
+
+typedef std::map<std::string, std::vector<TSSample> > SeriesMap;
+
+static bool readFile(const char* path, std::string* out) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    char buffer[4096];
+    size_t n;
+    out->clear();
+    while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) out->append(buffer, n);
+    fclose(f);
+    return true;
+}
+
+// finds "key": <number> inside [begin, end)
+static bool findNumber(const std::string& text, size_t begin, size_t end, const char* key, float* value) {
+    std::string pattern = std::string("\"") + key + "\"";
+    size_t pos = text.find(pattern, begin);
+    if (pos == std::string::npos || pos >= end) return false;
+    pos = text.find(':', pos + pattern.size());
+    if (pos == std::string::npos || pos >= end) return false;
+    *value = strtof(text.c_str() + pos + 1, NULL);
+    return true;
+}
+
+// position objects are flat, so the enclosing {...} of each "symbol" is the record
+static int parsePayload(const std::string& text, uint32_t time, SeriesMap* series) {
+    int found = 0;
+    size_t pos = 0;
+    while ((pos = text.find("\"symbol\"", pos)) != std::string::npos) {
+        size_t begin = text.rfind('{', pos);
+        size_t end = text.find('}', pos);
+        size_t colon = text.find(':', pos);
+        size_t quote1 = text.find('"', colon + 1);
+        size_t quote2 = text.find('"', quote1 + 1);
+        pos += 8;
+        if (begin == std::string::npos || end == std::string::npos || quote2 == std::string::npos || quote2 > end) continue;
+
+        TSSample sample;
+        sample.time = time;
+        sample.price = 0;
+        sample.changePercent = 0;
+        if (!findNumber(text, begin, end, "current_price", &sample.price)) continue;
+        findNumber(text, begin, end, "pnl_percent", &sample.changePercent);
+
+        std::vector<TSSample>& samples = (*series)[text.substr(quote1 + 1, quote2 - quote1 - 1)];
+        if (!samples.empty() && samples.back().time == time) {
+            samples.back() = sample;   // same symbol in both modes
+        } else {
+            samples.push_back(sample);
+        }
+        found++;
+    }
+    return found;
+}
+
+// 24h at the given interval, prices rounded to an exchange-like tick
+static void synthesize(int symbols, uint32_t interval, SeriesMap* series) {
+    srand(42);
+    int samplesPerDay = 86400 / interval;
+    for (int s = 0; s < symbols; s++) {
+        char name[16];
+        snprintf(name, sizeof(name), "SYM%02dUSDT", s);
+        double entry = pow(10.0, (rand() % 600) / 100.0 - 1.0);
+        double tick = entry > 100 ? 0.1 : entry > 1 ? 0.001 : 0.000001;
+        double price = entry;
+        std::vector<TSSample>& samples = (*series)[name];
+        for (int i = 0; i < samplesPerDay; i++) {
+            // ~40% of polls see no trade-price change
+            if (rand() % 10 >= 4) {
+                double step = ((rand() % 2001) - 1000) / 1000.0 * 0.0015;
+                price = price * (1.0 + step);
+            }
+            double rounded = floor(price / tick + 0.5) * tick;
+            TSSample sample;
+            sample.time = 1700000000u + i * interval;
+            sample.price = (float)rounded;
+            sample.changePercent = (float)(floor((rounded - entry) / entry * 10000.0 + 0.5) / 100.0);
+            samples.push_back(sample);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    uint32_t interval = 15;
+    std::vector<const char*> files;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--interval" && i + 1 < argc) {
+            interval = (uint32_t)atoi(argv[++i]);
+        } else {
+            files.push_back(argv[i]);
+        }
+    }
+
+    SeriesMap series;
+    if (files.empty()) {
+        synthesize(50, interval, &series);
+        printf("input: synthetic, %d symbols x 24h @ %us\n", (int)series.size(), interval);
+    } else {
+        std::string text;
+        for (size_t i = 0; i < files.size(); i++) {
+            if (!readFile(files[i], &text)) {
+                fprintf(stderr, "cannot read %s\n", files[i]);
+                return 1;
+            }
+            parsePayload(text, 1700000000u + (uint32_t)i * interval, &series);
+        }
+        printf("input: %d payloads, %d symbols @ %us\n", (int)files.size(), (int)series.size(), interval);
+    }
+
+    size_t totalSamples = 0;
+    size_t usedBytes = 0;
+    size_t blockCount = 0;
+    size_t maxSeriesSamples = 0;
+    double encodeNs = 0;
+    double decodeNs = 0;
+    int mismatches = 0;
+
+    for (SeriesMap::iterator it = series.begin(); it != series.end(); ++it) {
+        const std::vector<TSSample>& samples = it->second;
+        std::vector<TSBlock> blocks(1);
+        tsBlockReset(&blocks[0]);
+
+        auto t0 = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < samples.size(); i++) {
+            if (!tsBlockAppend(&blocks.back(), &samples[i])) {
+                blocks.push_back(TSBlock());
+                tsBlockReset(&blocks.back());
+                tsBlockAppend(&blocks.back(), &samples[i]);
+            }
+        }
+        auto t1 = std::chrono::steady_clock::now();
+
+        size_t index = 0;
+        TSSample decoded;
+        for (size_t b = 0; b < blocks.size(); b++) {
+            TSBlockReader reader;
+            tsBlockReaderInit(&reader, &blocks[b]);
+            while (tsBlockNext(&reader, &decoded)) {
+                if (index >= samples.size() ||
+                    decoded.time != samples[index].time ||
+                    tsFloatBits(decoded.price) != tsFloatBits(samples[index].price) ||
+                    tsFloatBits(decoded.changePercent) != tsFloatBits(samples[index].changePercent)) {
+                    mismatches++;
+                }
+                index++;
+            }
+        }
+        auto t2 = std::chrono::steady_clock::now();
+        if (index != samples.size()) mismatches++;
+
+        encodeNs += std::chrono::duration<double, std::nano>(t1 - t0).count();
+        decodeNs += std::chrono::duration<double, std::nano>(t2 - t1).count();
+        totalSamples += samples.size();
+        blockCount += blocks.size();
+        for (size_t b = 0; b < blocks.size(); b++) usedBytes += (blocks[b].bitLength + 7) / 8;
+        if (samples.size() > maxSeriesSamples) maxSeriesSamples = samples.size();
+    }
+
+    if (totalSamples == 0) {
+        fprintf(stderr, "no samples found\n");
+        return 1;
+    }
+
+    size_t rawBytes = totalSamples * sizeof(TSSample);
+    size_t blockBytes = blockCount * sizeof(TSBlock);
+    double perSampleDecode = decodeNs / totalSamples;
+
+    printf("samples:            %zu\n", totalSamples);
+    printf("raw bytes:          %zu (%zu per sample)\n", rawBytes, sizeof(TSSample));
+    printf("payload bytes:      %zu (%.1f bits/sample)\n", usedBytes, usedBytes * 8.0 / totalSamples);
+    printf("block bytes:        %zu in %zu blocks of %zu\n", blockBytes, blockCount, sizeof(TSBlock));
+    printf("compression ratio:  %.2fx (payload) / %.2fx (blocks)\n",
+           (double)rawBytes / usedBytes, (double)rawBytes / blockBytes);
+    printf("samples per block:  %.1f\n", (double)totalSamples / blockCount);
+    printf("encode:             %.1f ns/sample\n", encodeNs / totalSamples);
+    printf("decode:             %.1f ns/sample\n", perSampleDecode);
+    printf("decode 24h series:  %.3f ms (%u samples, host)\n",
+           perSampleDecode * (86400 / interval) / 1e6, 86400 / interval);
+    printf("round-trip:         %s\n", mismatches == 0 ? "OK" : "MISMATCH");
+
+    return mismatches == 0 ? 0 : 2;
+}
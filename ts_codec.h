@@ -0,0 +1,234 @@
+// ===== PRICE HISTORY CODEC =====
+// فشرده‌سازی به سبک Gorilla برای نمونه‌های قیمت:
+// زمان با delta-of-delta و مقادیر float با XOR نسبت به نمونه قبلی ذخیره می‌شوند.
+// هر بلوک 256 بایت است و فقط append می‌شود؛ وابستگی به Arduino ندارد تا
+// tools/ts_codec_bench.cpp هم روی PC از همین کد استفاده کند.
+#ifndef TS_CODEC_H
+#define TS_CODEC_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define TS_BLOCK_DATA 228
+#define TS_BLOCK_BITS (TS_BLOCK_DATA * 8)
+#define TS_SAMPLE_MAX_BITS 124   // بدترین حالت: 4+32 برای زمان + 2 × (2+5+5+32)
+
+typedef struct {
+    uint32_t time;
+    float price;
+    float changePercent;
+} TSSample;
+
+typedef struct {
+    uint32_t startTime;
+    uint32_t lastTime;
+    int32_t lastDelta;
+    uint32_t lastValue[2];       // price, changePercent (بیت‌های float)
+    uint16_t count;
+    uint16_t bitLength;
+    uint8_t lastLeading[2];
+    uint8_t lastTrailing[2];
+    uint8_t data[TS_BLOCK_DATA];
+} TSBlock;
+
+typedef struct {
+    const TSBlock* block;
+    uint16_t bitPos;
+    uint16_t index;
+    uint32_t time;
+    int32_t delta;
+    uint32_t value[2];
+    uint8_t leading[2];
+    uint8_t trailing[2];
+} TSBlockReader;
+
+static inline uint32_t tsFloatBits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static inline float tsBitsFloat(uint32_t bits) {
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static inline uint8_t tsLeadingZeros(uint32_t x) {
+    return x == 0 ? 32 : (uint8_t)__builtin_clz(x);
+}
+
+static inline uint8_t tsTrailingZeros(uint32_t x) {
+    return x == 0 ? 32 : (uint8_t)__builtin_ctz(x);
+}
+
+// ----- Bit I/O (MSB first) -----
+static inline void tsWriteBits(TSBlock* block, uint32_t value, uint8_t bits) {
+    while (bits > 0) {
+        uint16_t pos = block->bitLength;
+        uint8_t room = 8 - (pos & 7);
+        uint8_t take = bits < room ? bits : room;
+        uint8_t chunk = (uint8_t)((value >> (bits - take)) & ((1u << take) - 1));
+        block->data[pos >> 3] |= (uint8_t)(chunk << (room - take));
+        block->bitLength += take;
+        bits -= take;
+    }
+}
+
+static inline uint32_t tsReadBits(TSBlockReader* reader, uint8_t bits) {
+    uint32_t value = 0;
+    while (bits > 0) {
+        uint16_t pos = reader->bitPos;
+        uint8_t room = 8 - (pos & 7);
+        uint8_t take = bits < room ? bits : room;
+        uint8_t chunk = (uint8_t)((reader->block->data[pos >> 3] >> (room - take)) & ((1u << take) - 1));
+        value = (value << take) | chunk;
+        reader->bitPos += take;
+        bits -= take;
+    }
+    return value;
+}
+
+// ----- Encoder -----
+static inline void tsBlockReset(TSBlock* block) {
+    memset(block, 0, sizeof(TSBlock));
+}
+
+static inline void tsWriteValue(TSBlock* block, int column, uint32_t value) {
+    uint32_t x = value ^ block->lastValue[column];
+    block->lastValue[column] = value;
+
+    if (x == 0) {
+        tsWriteBits(block, 0, 1);
+        return;
+    }
+
+    uint8_t leading = tsLeadingZeros(x);
+    uint8_t trailing = tsTrailingZeros(x);
+    if (leading > 31) leading = 31;
+
+    uint8_t prevLeading = block->lastLeading[column];
+    uint8_t prevTrailing = block->lastTrailing[column];
+
+    if (prevLeading + prevTrailing < 32 && leading >= prevLeading && trailing >= prevTrailing) {
+        // همان پنجره بیت‌های معنی‌دار قبلی
+        uint8_t meaningful = 32 - prevLeading - prevTrailing;
+        tsWriteBits(block, 0b10, 2);
+        tsWriteBits(block, x >> prevTrailing, meaningful);
+    } else {
+        uint8_t meaningful = 32 - leading - trailing;
+        tsWriteBits(block, 0b11, 2);
+        tsWriteBits(block, leading, 5);
+        tsWriteBits(block, meaningful - 1, 5);
+        tsWriteBits(block, x >> trailing, meaningful);
+        block->lastLeading[column] = leading;
+        block->lastTrailing[column] = trailing;
+    }
+}
+
+// false یعنی بلوک پر است (یا زمان به عقب برگشته) و باید بلوک جدید شروع شود
+static inline bool tsBlockAppend(TSBlock* block, const TSSample* sample) {
+    if (block->bitLength + TS_SAMPLE_MAX_BITS > TS_BLOCK_BITS) return false;
+    if (block->count > 0 && sample->time < block->lastTime) return false;
+
+    uint32_t priceBits = tsFloatBits(sample->price);
+    uint32_t pctBits = tsFloatBits(sample->changePercent);
+
+    if (block->count == 0) {
+        block->startTime = sample->time;
+        block->lastTime = sample->time;
+        block->lastDelta = 0;
+        block->lastValue[0] = priceBits;
+        block->lastValue[1] = pctBits;
+        block->lastLeading[0] = block->lastLeading[1] = 32;
+        block->lastTrailing[0] = block->lastTrailing[1] = 0;
+        tsWriteBits(block, priceBits, 32);
+        tsWriteBits(block, pctBits, 32);
+        block->count = 1;
+        return true;
+    }
+
+    int32_t delta = (int32_t)(sample->time - block->lastTime);
+    int32_t dod = delta - block->lastDelta;
+
+    if (dod == 0) {
+        tsWriteBits(block, 0, 1);
+    } else if (dod >= -63 && dod <= 64) {
+        tsWriteBits(block, 0b10, 2);
+        tsWriteBits(block, (uint32_t)(dod + 63), 7);
+    } else if (dod >= -255 && dod <= 256) {
+        tsWriteBits(block, 0b110, 3);
+        tsWriteBits(block, (uint32_t)(dod + 255), 9);
+    } else if (dod >= -2047 && dod <= 2048) {
+        tsWriteBits(block, 0b1110, 4);
+        tsWriteBits(block, (uint32_t)(dod + 2047), 12);
+    } else {
+        tsWriteBits(block, 0b1111, 4);
+        tsWriteBits(block, (uint32_t)dod, 32);
+    }
+
+    block->lastTime = sample->time;
+    block->lastDelta = delta;
+    tsWriteValue(block, 0, priceBits);
+    tsWriteValue(block, 1, pctBits);
+    block->count++;
+    return true;
+}
+
+// ----- Decoder -----
+static inline void tsBlockReaderInit(TSBlockReader* reader, const TSBlock* block) {
+    memset(reader, 0, sizeof(TSBlockReader));
+    reader->block = block;
+}
+
+static inline uint32_t tsReadValue(TSBlockReader* reader, int column) {
+    if (tsReadBits(reader, 1) == 0) return reader->value[column];
+
+    if (tsReadBits(reader, 1) == 1) {
+        reader->leading[column] = (uint8_t)tsReadBits(reader, 5);
+        uint8_t meaningful = (uint8_t)tsReadBits(reader, 5) + 1;
+        reader->trailing[column] = 32 - reader->leading[column] - meaningful;
+    }
+
+    uint8_t meaningful = 32 - reader->leading[column] - reader->trailing[column];
+    uint32_t x = tsReadBits(reader, meaningful) << reader->trailing[column];
+    reader->value[column] ^= x;
+    return reader->value[column];
+}
+
+static inline bool tsBlockNext(TSBlockReader* reader, TSSample* sample) {
+    const TSBlock* block = reader->block;
+    if (reader->index >= block->count) return false;
+
+    if (reader->index == 0) {
+        reader->time = block->startTime;
+        reader->delta = 0;
+        reader->value[0] = tsReadBits(reader, 32);
+        reader->value[1] = tsReadBits(reader, 32);
+    } else {
+        int32_t dod;
+        if (tsReadBits(reader, 1) == 0) {
+            dod = 0;
+        } else if (tsReadBits(reader, 1) == 0) {
+            dod = (int32_t)tsReadBits(reader, 7) - 63;
+        } else if (tsReadBits(reader, 1) == 0) {
+            dod = (int32_t)tsReadBits(reader, 9) - 255;
+        } else if (tsReadBits(reader, 1) == 0) {
+            dod = (int32_t)tsReadBits(reader, 12) - 2047;
+        } else {
+            dod = (int32_t)tsReadBits(reader, 32);
+        }
+        reader->delta += dod;
+        reader->time += reader->delta;
+        tsReadValue(reader, 0);
+        tsReadValue(reader, 1);
+    }
+
+    sample->time = reader->time;
+    sample->price = tsBitsFloat(reader->value[0]);
+    sample->changePercent = tsBitsFloat(reader->value[1]);
+    reader->index++;
+    return true;
+}
+
+#endif
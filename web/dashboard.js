@@ -0,0 +1,125 @@
+function setVolume(volume) {
+    fetch('/setvolume?volume=' + volume)
+        .then(response => response.text())
+        .then(text => {
+            document.getElementById('currentVolume').textContent = 'Current: ' + volume + '%';
+            alert(text);
+        });
+}
+
+function testCurrentVolume() {
+    fetch('/testvolume')
+        .then(response => response.text())
+        .then(text => {
+            alert(text);
+        });
+}
+
+// صفحه ثابت است (web/dashboard.html)؛ همه مقادیر پویا از /api/dashboard خوانده می‌شوند
+function setField(key, value, signed) {
+    var el = document.querySelector('[data-k="' + key + '"]');
+    if (!el) return;
+    el.textContent = value;
+    if (signed !== undefined) {
+        el.classList.toggle('positive', signed >= 0);
+        el.classList.toggle('negative', signed < 0);
+    }
+}
+
+function fmtPercent(p) {
+    return (p > 0 ? '+' : '') + p.toFixed(2) + '%';
+}
+
+function fmtNumber(n) {
+    var a = Math.abs(n);
+    if (a >= 1000000) return (n / 1000000).toFixed(2) + 'M';
+    if (a >= 10000) return (n / 1000).toFixed(1) + 'K';
+    if (a >= 1000) return (n / 1000).toFixed(2) + 'K';
+    return n.toFixed(2);
+}
+
+function refreshDashboard() {
+    fetch('/api/dashboard')
+        .then(response => response.json())
+        .then(d => {
+            setField('m1count', d.entry.count);
+            setField('m1pnl', fmtPercent(d.entry.pnlPercent), d.entry.pnlPercent);
+            setField('m1value', '$' + fmtNumber(d.entry.value));
+            setField('m1winrate', d.entry.winRate.toFixed(1) + '%');
+            setField('m2count', d.exit.count);
+            setField('m2pnl', fmtPercent(d.exit.pnlPercent), d.exit.pnlPercent);
+            setField('m2value', '$' + fmtNumber(d.exit.value));
+            setField('m2drawdown', fmtPercent(d.exit.maxDrawdown));
+            setField('wifi', d.wifi);
+            setField('uptime', d.uptime);
+            setField('heap', Math.floor(d.freeHeap / 1024) + ' KB (' + d.fragmentation.toFixed(0) + '% frag)');
+            setField('battery', d.battery);
+            setField('m1name', d.entry.name);
+            setField('m2name', d.exit.name);
+            renderSlots(d.slots || []);
+            applyAccessPoint(d.apEnabled);
+            document.getElementById('currentVolume').textContent = 'Current: ' + d.volume + '%';
+        })
+        .catch(() => {});
+}
+
+function applyAccessPoint(enabled) {
+    var status = document.querySelector('[data-k="apstatus"]');
+    status.textContent = 'AP: ' + (enabled ? 'ON' : 'OFF');
+    status.classList.toggle('ap-on', enabled);
+    status.classList.toggle('ap-off', !enabled);
+    var toggle = document.querySelector('[data-k="aptoggle"]');
+    toggle.textContent = enabled ? '🔴 Disable AP' : '🟢 Enable AP';
+    toggle.classList.toggle('btn-warning', enabled);
+    toggle.classList.toggle('btn-success', !enabled);
+}
+
+// slot های اضافه (p2..)؛ هر ردیف کلیدهای s<m>count / s<m>pnl / s<m>value دارد تا applySummary آن را پیدا کند
+function renderSlots(slots) {
+    var body = document.getElementById('extraSlotRows');
+    body.textContent = '';
+    slots.forEach(s => {
+        var row = document.createElement('tr');
+        var nameCell = document.createElement('td');
+        var link = document.createElement('a');
+        link.href = '/positions?mode=' + s.key;
+        link.textContent = s.name;
+        nameCell.appendChild(link);
+        row.appendChild(nameCell);
+        ['count', 'pnl', 'value'].forEach(k => {
+            var cell = document.createElement('td');
+            cell.setAttribute('data-k', 's' + s.m + k);
+            row.appendChild(cell);
+        });
+        body.appendChild(row);
+        setField('s' + s.m + 'count', s.count);
+        setField('s' + s.m + 'pnl', fmtPercent(s.pnlPercent), s.pnlPercent);
+        setField('s' + s.m + 'value', '$' + fmtNumber(s.value));
+    });
+    document.getElementById('extraSlots').style.display = slots.length > 0 ? '' : 'none';
+}
+
+// به‌روزرسانی لحظه‌ای از /events؛ polling فقط برای وضعیت سیستم باقی می‌ماند
+function applySummary(d) {
+    var prefix = d.m === 0 ? 'm1' : d.m === 1 ? 'm2' : 's' + d.m;
+    setField(prefix + 'count', d.n);
+    setField(prefix + 'pnl', fmtPercent(d.pnl), d.pnl);
+    setField(prefix + 'value', '$' + fmtNumber(d.value));
+    if (d.m === 0 && d.n > 0) setField('m1winrate', (d.win * 100 / d.n).toFixed(1) + '%');
+    if (d.m === 1) setField('m2drawdown', fmtPercent(d.dd));
+}
+
+if (window.EventSource) {
+    var events = new EventSource('/events');
+    events.addEventListener('summary', e => applySummary(JSON.parse(e.data)));
+    events.addEventListener('resync', () => refreshDashboard());
+    events.addEventListener('alert', e => {
+        var a = JSON.parse(e.data);
+        document.title = '⚠ ' + a.s + ' ' + a.msg;
+    });
+    setInterval(refreshDashboard, 60000);
+} else {
+    setInterval(refreshDashboard, 15000);
+}
+
+refreshDashboard();
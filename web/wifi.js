@@ -0,0 +1,100 @@
+function openTab(evt, tabName) {
+    var i, tabcontent, tabbuttons;
+    tabcontent = document.getElementsByClassName("tab-content");
+    for (i = 0; i < tabcontent.length; i++) {
+        tabcontent[i].classList.remove("active");
+    }
+    tabbuttons = document.getElementsByClassName("tab-button");
+    for (i = 0; i < tabbuttons.length; i++) {
+        tabbuttons[i].classList.remove("active");
+    }
+    document.getElementById(tabName).classList.add("active");
+    evt.currentTarget.classList.add("active");
+    return false;
+}
+
+function confirmRemove(ssid) {
+    if (confirm("Are you sure you want to remove '" + ssid + "' from saved networks?")) {
+        window.location.href = "/wifimanage?action=remove&ssid=" + encodeURIComponent(ssid);
+    }
+    return false;
+}
+
+function connectNetwork(ssid) {
+    if (confirm("Connect to '" + ssid + "' now?")) {
+        window.location.href = "/wifimanage?action=connect&ssid=" + encodeURIComponent(ssid);
+    }
+    return false;
+}
+
+function toggleAutoConnect(ssid, currentState) {
+    var newState = !currentState;
+    var form = document.createElement('form');
+    form.method = 'POST';
+    form.action = '/updatewifi';
+    
+    var ssidInput = document.createElement('input');
+    ssidInput.type = 'hidden';
+    ssidInput.name = 'ssid';
+    ssidInput.value = ssid;
+    form.appendChild(ssidInput);
+    
+    var autoconnectInput = document.createElement('input');
+    autoconnectInput.type = 'hidden';
+    autoconnectInput.name = 'autoconnect';
+    autoconnectInput.value = newState ? '1' : '0';
+    form.appendChild(autoconnectInput);
+    
+    document.body.appendChild(form);
+    form.submit();
+}
+
+function updatePriority(ssid, priority) {
+    var form = document.createElement('form');
+    form.method = 'POST';
+    form.action = '/updatewifi';
+    
+    var ssidInput = document.createElement('input');
+    ssidInput.type = 'hidden';
+    ssidInput.name = 'ssid';
+    ssidInput.value = ssid;
+    form.appendChild(ssidInput);
+    
+    var priorityInput = document.createElement('input');
+    priorityInput.type = 'hidden';
+    priorityInput.name = 'priority';
+    priorityInput.value = priority;
+    form.appendChild(priorityInput);
+    
+    document.body.appendChild(form);
+    form.submit();
+}
+
+function showPassword(id) {
+    var input = document.getElementById(id);
+    if (input.type === "password") {
+        input.type = "text";
+    } else {
+        input.type = "password";
+    }
+}
+
+function testConnection(ssid) {
+    var btn = event.target;
+    var originalText = btn.innerHTML;
+    btn.innerHTML = 'Testing...';
+    btn.disabled = true;
+    
+    fetch('/testwifi?ssid=' + encodeURIComponent(ssid))
+        .then(response => response.text())
+        .then(text => {
+            alert(text);
+            btn.innerHTML = originalText;
+            btn.disabled = false;
+        })
+        .catch(error => {
+            alert('Connection test failed: ' + error);
+            btn.innerHTML = originalText;
+            btn.disabled = false;
+        });
+}
@@ -0,0 +1,431 @@
+// Generated by tools/gen_web_assets.py - do not edit by hand.
+// Sources: web/*.css, web/*.js, web/*.html
+#pragma once
+
+#include <Arduino.h>
+
+// common.css: 2403 bytes -> 850 bytes gzip
+#define WEB_ASSET_COMMON_CSS_INDEX 0
+#define WEB_ASSET_COMMON_CSS_HASH "1af0c332"
+const uint8_t WEB_ASSET_COMMON_CSS[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x9d, 0x55, 0x6d, 0x6f, 0xdb, 0x20,
+    0x10, 0xfe, 0xde, 0x5f, 0x81, 0x34, 0x4d, 0x6a, 0x25, 0x13, 0x39, 0x6f, 0x5d, 0x9a, 0x7c, 0xda,
+    0x4f, 0x39, 0x1b, 0xb0, 0x51, 0x09, 0x58, 0x40, 0x9a, 0x76, 0xd5, 0xfe, 0xfb, 0x0e, 0x6c, 0x6c,
+    0x9c, 0xb8, 0xd3, 0xb4, 0x58, 0x4a, 0x62, 0xb8, 0xe7, 0xb9, 0xe3, 0xee, 0xb9, 0xa3, 0x32, 0xec,
+    0x83, 0x7c, 0x12, 0x61, 0xb4, 0xa7, 0x02, 0xce, 0x52, 0x7d, 0x1c, 0xc9, 0x4f, 0x2b, 0x41, 0x15,
+    0xc4, 0x81, 0x76, 0xd4, 0x71, 0x2b, 0xc5, 0x89, 0x9c, 0xc1, 0x36, 0x52, 0x1f, 0xc9, 0xa6, 0xec,
+    0xde, 0x4f, 0xa4, 0x82, 0xfa, 0xb5, 0xb1, 0xe6, 0xa2, 0xd9, 0x91, 0x7c, 0x5b, 0x43, 0x78, 0x4e,
+    0xa4, 0x36, 0xca, 0x58, 0x7c, 0x17, 0x02, 0xed, 0x7f, 0x3f, 0xac, 0x6a, 0xa4, 0x04, 0xa9, 0xb9,
+    0x45, 0xfa, 0x33, 0xbc, 0xd3, 0xab, 0x64, 0xbe, 0x3d, 0x92, 0xf5, 0xa6, 0x8c, 0x1c, 0x89, 0xb1,
+    0x24, 0x70, 0xf1, 0x66, 0x8e, 0x58, 0x69, 0xb0, 0xd6, 0x5c, 0xe7, 0xc0, 0x43, 0x8f, 0x0b, 0x76,
+    0x60, 0x19, 0xee, 0xcd, 0xa2, 0xd8, 0xb0, 0xf0, 0x9c, 0x48, 0x07, 0x8c, 0x49, 0xdd, 0x8c, 0x91,
+    0x1a, 0xcb, 0xb8, 0xa5, 0x16, 0x98, 0xbc, 0x38, 0x74, 0x9e, 0xb9, 0xa6, 0x95, 0xf1, 0xde, 0x9c,
+    0x93, 0xe5, 0xc0, 0x4b, 0x5b, 0x0e, 0x2c, 0xc6, 0x1c, 0x53, 0xe2, 0xe4, 0x2f, 0x8e, 0xb0, 0x43,
+    0xb0, 0x88, 0x0b, 0x57, 0x2e, 0x9b, 0xd6, 0x1f, 0x91, 0x58, 0xb1, 0x3b, 0xa6, 0xf5, 0x3e, 0xd8,
+    0xa5, 0x44, 0x94, 0xe5, 0xe1, 0x30, 0xe4, 0x82, 0x81, 0x6b, 0x2b, 0x13, 0xe8, 0x1b, 0x2b, 0x43,
+    0xec, 0x4c, 0xba, 0x4e, 0x01, 0xe6, 0x3a, 0xbc, 0x9f, 0xe2, 0x37, 0xf5, 0xfc, 0x8c, 0x6b, 0x9e,
+    0x53, 0x24, 0xb8, 0x9c, 0x35, 0x86, 0x6b, 0x79, 0xc7, 0xc1, 0x3f, 0x86, 0x04, 0x51, 0x21, 0x7d,
+    0x41, 0xce, 0x52, 0x63, 0x46, 0x1e, 0xb7, 0x21, 0x15, 0x05, 0x59, 0x0b, 0xfb, 0xf4, 0x84, 0x60,
+    0xe8, 0xb2, 0x43, 0x38, 0x0f, 0xde, 0x45, 0x37, 0x05, 0x59, 0x49, 0x2d, 0xcc, 0x7f, 0xb9, 0xdc,
+    0xf4, 0xec, 0x03, 0xf9, 0x3a, 0x27, 0xa7, 0x12, 0x51, 0x89, 0x3b, 0xfc, 0xbf, 0x2d, 0xc5, 0x16,
+    0xc2, 0x93, 0x95, 0x62, 0xbd, 0x54, 0x8a, 0x7d, 0x4e, 0xa9, 0xa0, 0xe2, 0x2a, 0x71, 0xc6, 0x97,
+    0x9b, 0x02, 0x6c, 0xf2, 0xc4, 0x02, 0xc0, 0x04, 0x7d, 0x03, 0x75, 0xe1, 0xff, 0x58, 0x2e, 0xc4,
+    0x44, 0x0f, 0x4b, 0x98, 0xdd, 0x10, 0x4f, 0x67, 0x9c, 0xf4, 0xf2, 0x2d, 0x6c, 0x4f, 0x85, 0x14,
+    0xa2, 0x2c, 0xe3, 0xae, 0xe6, 0x0d, 0xdc, 0xec, 0x0a, 0xb1, 0xc5, 0x4f, 0xdc, 0x55, 0x46, 0x37,
+    0x0b, 0xb8, 0x3c, 0x3b, 0xb6, 0xa9, 0xe0, 0xb1, 0x2c, 0xc8, 0x66, 0xbf, 0x2f, 0x08, 0xfe, 0x96,
+    0xab, 0xf5, 0x53, 0x7f, 0x98, 0xd6, 0x58, 0xbf, 0x40, 0x7b, 0x07, 0x1e, 0x91, 0x19, 0x18, 0x14,
+    0xb7, 0x9e, 0x42, 0x3d, 0x84, 0xb6, 0x8c, 0x59, 0x3f, 0x27, 0x97, 0x9b, 0xc1, 0x25, 0x7f, 0xe3,
+    0x96, 0xd3, 0x08, 0xfe, 0x12, 0x55, 0xce, 0x30, 0x1e, 0x2a, 0x15, 0x3c, 0xa4, 0x66, 0x2e, 0xcb,
+    0xef, 0x63, 0x65, 0x31, 0x72, 0x05, 0x9d, 0xc3, 0x64, 0xa6, 0x7f, 0x53, 0x97, 0x87, 0xce, 0x20,
+    0x31, 0x85, 0xbe, 0x2d, 0x88, 0x0f, 0x7a, 0x9c, 0xe4, 0x11, 0x8b, 0xeb, 0xf9, 0x3b, 0x9e, 0x40,
+    0xc9, 0x06, 0xad, 0x15, 0x17, 0x7e, 0xa4, 0x1d, 0x9b, 0x0b, 0x19, 0x9c, 0x51, 0xa8, 0xe5, 0x6f,
+    0xbb, 0xdd, 0xae, 0xa7, 0xba, 0x95, 0xde, 0xed, 0x2c, 0xca, 0x5a, 0xb0, 0xf2, 0x9a, 0x7c, 0x3e,
+    0x10, 0xfc, 0xcc, 0x10, 0x83, 0x45, 0xdc, 0x18, 0x50, 0xd7, 0x16, 0x55, 0xdd, 0xaf, 0xcc, 0x24,
+    0xdc, 0xf7, 0x58, 0x4f, 0x11, 0x43, 0x3b, 0x12, 0x6d, 0x34, 0xcf, 0x57, 0x66, 0xea, 0xee, 0x39,
+    0x2f, 0xd6, 0x05, 0xd2, 0xce, 0x48, 0xed, 0xb9, 0xed, 0x17, 0xe3, 0x59, 0x19, 0xaf, 0x8d, 0x45,
+    0x31, 0x19, 0x9d, 0xf3, 0x8c, 0x5d, 0x2a, 0xb5, 0xc2, 0x51, 0x48, 0x2b, 0x65, 0xea, 0xd7, 0x7e,
+    0x2b, 0xe5, 0x32, 0x72, 0xf7, 0x27, 0x3a, 0xb6, 0xe6, 0x2d, 0x0e, 0xab, 0x9b, 0x33, 0x3d, 0x3f,
+    0xd7, 0x75, 0x3a, 0x35, 0x75, 0x97, 0xba, 0xe6, 0xce, 0x61, 0x7b, 0xc5, 0x37, 0xb8, 0x93, 0x08,
+    0x02, 0xea, 0x7a, 0x10, 0x78, 0x30, 0x61, 0xa0, 0x9b, 0x7b, 0xd6, 0x4c, 0xe7, 0xc1, 0xe8, 0x0a,
+    0x56, 0xcb, 0x28, 0xf7, 0x1b, 0xab, 0x97, 0x97, 0x81, 0x0a, 0x3a, 0x1a, 0x3a, 0xf4, 0xe2, 0xf2,
+    0xe1, 0x33, 0x3b, 0xd6, 0x94, 0xdf, 0x20, 0x8f, 0xc5, 0x31, 0xd1, 0xcf, 0xb5, 0xbb, 0x46, 0xfd,
+    0x7a, 0x16, 0x07, 0xed, 0x64, 0x13, 0x0b, 0x83, 0x30, 0x7a, 0x16, 0x24, 0x4d, 0xe2, 0xd8, 0x1c,
+    0xe0, 0xc7, 0x6e, 0x7f, 0x9a, 0x97, 0x3d, 0x61, 0x84, 0x58, 0x06, 0xb1, 0x7a, 0xbb, 0x5f, 0x04,
+    0x69, 0xee, 0xaf, 0xc6, 0xbe, 0x52, 0x25, 0x9d, 0x8f, 0x17, 0x57, 0x8c, 0xc6, 0x9b, 0x7c, 0x36,
+    0x27, 0x9b, 0x7e, 0x6a, 0xde, 0x8b, 0x71, 0xb8, 0xc4, 0x6e, 0xa4, 0x37, 0x6a, 0x69, 0x6c, 0xa6,
+    0x32, 0x36, 0xd3, 0x92, 0xee, 0x0e, 0x73, 0x85, 0x0e, 0xd9, 0xd8, 0x4d, 0xad, 0x93, 0xf4, 0x9e,
+    0x45, 0x13, 0x14, 0x11, 0xef, 0xd3, 0x09, 0x42, 0xa7, 0x06, 0x1a, 0x95, 0x91, 0xcc, 0x35, 0xbf,
+    0x7e, 0x61, 0x9c, 0xd5, 0xde, 0x61, 0x1f, 0x83, 0xa2, 0x15, 0xd8, 0xe1, 0x9c, 0x7f, 0xd1, 0xf5,
+    0x34, 0x4b, 0x52, 0xf0, 0xed, 0x50, 0xd8, 0xac, 0xe1, 0x66, 0x17, 0x0c, 0xca, 0x70, 0xe9, 0xf0,
+    0xdb, 0x64, 0x1d, 0x9a, 0x42, 0x28, 0x73, 0x3d, 0x92, 0x56, 0x32, 0xc6, 0xf5, 0x3c, 0x7d, 0x65,
+    0xaf, 0x8e, 0x87, 0x29, 0x4c, 0x21, 0x95, 0x1a, 0xe2, 0x4c, 0xae, 0xe3, 0x64, 0xbb, 0x73, 0x1d,
+    0x42, 0x07, 0x8b, 0x37, 0x2a, 0x7a, 0xe4, 0xda, 0x3f, 0xbe, 0x94, 0x8c, 0x37, 0x45, 0x4a, 0x53,
+    0x91, 0x52, 0x50, 0xa4, 0x6e, 0x79, 0x0a, 0x5e, 0xfe, 0x00, 0x65, 0x5a, 0x1d, 0x72, 0x63, 0x09,
+    0x00, 0x00,
+};
+
+// dashboard.html: 6789 bytes -> 1299 bytes gzip
+#define WEB_ASSET_DASHBOARD_HTML_INDEX 1
+#define WEB_ASSET_DASHBOARD_HTML_HASH "e5d93eb1"
+const uint8_t WEB_ASSET_DASHBOARD_HTML[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xdd, 0x59, 0xcd, 0x6e, 0xe3, 0x36,
+    0x10, 0xbe, 0xe7, 0x29, 0xb8, 0x3a, 0x6d, 0x80, 0x2a, 0xfe, 0x49, 0x83, 0x14, 0x8e, 0xe4, 0x20,
+    0x9b, 0x9f, 0xee, 0x02, 0x31, 0x36, 0x4d, 0xb2, 0x59, 0xf4, 0x48, 0x4b, 0xb4, 0xc5, 0x46, 0x22,
+    0x05, 0x92, 0xf2, 0xcf, 0x6d, 0x0b, 0x14, 0x68, 0x9b, 0x43, 0x7b, 0xd8, 0xbd, 0x34, 0x97, 0xa2,
+    0x97, 0x3e, 0x43, 0x9f, 0x27, 0x2f, 0xd0, 0x3e, 0x42, 0x87, 0xfa, 0xb1, 0x65, 0xd9, 0x52, 0x9c,
+    0x38, 0x41, 0x82, 0x04, 0x88, 0x13, 0x73, 0x86, 0x1f, 0x67, 0xa8, 0x99, 0x6f, 0xc8, 0x91, 0xf5,
+    0xea, 0xe0, 0xfd, 0xfe, 0xf9, 0xf7, 0x27, 0x87, 0xc8, 0x53, 0x81, 0xdf, 0x5e, 0xb3, 0xb2, 0x3f,
+    0x04, 0xbb, 0xed, 0x35, 0x04, 0x3f, 0x56, 0x40, 0x14, 0x46, 0x8e, 0x87, 0x85, 0x24, 0xca, 0x36,
+    0x3e, 0x9c, 0x1f, 0x99, 0xdf, 0x18, 0x79, 0x11, 0xc3, 0x01, 0xb1, 0x8d, 0x01, 0x25, 0xc3, 0x90,
+    0x0b, 0x65, 0x20, 0x87, 0x33, 0x45, 0x18, 0xa8, 0x0e, 0xa9, 0xab, 0x3c, 0xdb, 0x25, 0x03, 0xea,
+    0x10, 0x33, 0xfe, 0xf2, 0x15, 0xa2, 0x8c, 0x2a, 0x8a, 0x7d, 0x53, 0x3a, 0xd8, 0x27, 0x76, 0x63,
+    0xa3, 0x9e, 0x41, 0x29, 0xaa, 0x7c, 0xd2, 0x3e, 0x01, 0x84, 0x1e, 0xf7, 0x29, 0x47, 0x1d, 0x0e,
+    0x9a, 0x5c, 0xa0, 0x03, 0x2c, 0xbd, 0x2e, 0xc7, 0xc2, 0xb5, 0x6a, 0x89, 0x4a, 0xa2, 0xee, 0x53,
+    0x76, 0x89, 0x04, 0xf1, 0x6d, 0x43, 0xaa, 0xb1, 0x4f, 0xa4, 0x47, 0x08, 0x2c, 0xed, 0x09, 0xd2,
+    0xb3, 0x8d, 0x9a, 0x54, 0x58, 0x51, 0xa7, 0xe6, 0xf0, 0x20, 0xe0, 0x6c, 0xc3, 0x91, 0x72, 0x77,
+    0x60, 0x37, 0x70, 0xaf, 0xee, 0x6c, 0x6e, 0x36, 0x61, 0x3d, 0xab, 0x96, 0x78, 0x67, 0x75, 0xb9,
+    0x3b, 0x4e, 0xf1, 0x5c, 0x3a, 0x40, 0x8e, 0x8f, 0xa5, 0xb4, 0x0d, 0x6d, 0x3f, 0xa6, 0x8c, 0x88,
+    0xd4, 0xb4, 0x58, 0xee, 0x35, 0xda, 0xff, 0xfd, 0xf9, 0xf9, 0x0a, 0x55, 0x18, 0x38, 0x51, 0x8e,
+    0x27, 0xc8, 0x10, 0xb3, 0x0c, 0x11, 0x87, 0xa6, 0x36, 0x29, 0x92, 0x06, 0x72, 0xb1, 0xc2, 0xe6,
+    0xa5, 0x1e, 0x4a, 0x47, 0xda, 0x7b, 0x27, 0x2d, 0x74, 0xf3, 0xe9, 0x6f, 0xab, 0xa6, 0x67, 0xe4,
+    0x56, 0xac, 0xc1, 0x92, 0x6b, 0xd3, 0xaf, 0xda, 0xc0, 0xd8, 0x55, 0xdb, 0x08, 0xb0, 0xe8, 0x53,
+    0x66, 0x76, 0xb9, 0x52, 0x3c, 0x68, 0xa1, 0x66, 0x3d, 0x1c, 0xed, 0xe4, 0x6c, 0x8d, 0xd5, 0x71,
+    0xb6, 0x17, 0xf0, 0x29, 0x60, 0x7b, 0x8c, 0xcc, 0x96, 0xae, 0x62, 0x06, 0xb8, 0xf2, 0xe5, 0x27,
+    0x74, 0x9a, 0x48, 0xc0, 0x01, 0x85, 0xad, 0x1a, 0x2e, 0x03, 0x80, 0xa7, 0x1e, 0x85, 0xb3, 0xd3,
+    0x6f, 0xae, 0xff, 0xf8, 0xf7, 0x9f, 0xdf, 0xd1, 0x99, 0x96, 0x54, 0xcd, 0x1c, 0x4b, 0x45, 0x02,
+    0xca, 0x7a, 0xbc, 0xb8, 0x3a, 0x6c, 0xe4, 0x59, 0x2c, 0x44, 0xef, 0x40, 0x5a, 0x01, 0xa1, 0x08,
+    0x6c, 0x93, 0x4f, 0xe2, 0xb0, 0x9a, 0x20, 0x20, 0xf8, 0x35, 0x87, 0x58, 0x30, 0xca, 0xfa, 0xb1,
+    0x2f, 0x57, 0xe8, 0x1c, 0xf4, 0xd0, 0x9e, 0x56, 0xac, 0x00, 0x8b, 0x81, 0x3c, 0x2a, 0xe1, 0xa9,
+    0x8d, 0xe7, 0xf6, 0xe3, 0x4b, 0x32, 0x1d, 0xbd, 0x4d, 0xe4, 0x15, 0x30, 0xb0, 0x69, 0x24, 0x31,
+    0x4a, 0xce, 0x59, 0xe5, 0x62, 0xd6, 0xd7, 0x81, 0x93, 0x6e, 0x30, 0x28, 0x26, 0xb0, 0xb2, 0xca,
+    0x47, 0xde, 0xef, 0xfb, 0x04, 0xcf, 0xee, 0x71, 0x2e, 0x50, 0x12, 0xb9, 0x0e, 0x94, 0x19, 0x10,
+    0xab, 0x06, 0x21, 0x51, 0x8c, 0x90, 0x14, 0xc1, 0xcd, 0x62, 0xd2, 0xec, 0x0b, 0xea, 0x16, 0x63,
+    0xe3, 0x95, 0x69, 0xa2, 0x43, 0xa6, 0xc4, 0x18, 0x62, 0xd8, 0x25, 0x68, 0x1f, 0xf4, 0x90, 0x69,
+    0x16, 0x94, 0xf2, 0x09, 0x01, 0x0a, 0x05, 0x8c, 0x45, 0x2a, 0xa6, 0xce, 0xaa, 0xc4, 0xf9, 0xcf,
+    0xbf, 0xe4, 0x16, 0x68, 0xa5, 0xc9, 0x90, 0x79, 0x14, 0x34, 0x34, 0x63, 0x18, 0xed, 0x34, 0xe2,
+    0x53, 0x3f, 0xaa, 0xd0, 0x75, 0xaa, 0xc8, 0x45, 0xae, 0x94, 0x29, 0x9b, 0x14, 0x62, 0xab, 0x44,
+    0x77, 0xa1, 0xbe, 0x8f, 0xbb, 0xc4, 0x37, 0x80, 0x7e, 0x24, 0xd0, 0x13, 0x67, 0xb2, 0xc4, 0xa8,
+    0xd2, 0xf9, 0x03, 0xec, 0x47, 0xc4, 0xc8, 0xb9, 0xe8, 0xf0, 0x88, 0x29, 0xa3, 0x6d, 0x56, 0x00,
+    0x55, 0x89, 0x1e, 0xc8, 0x9f, 0x73, 0x0e, 0x81, 0x8a, 0x4e, 0x6a, 0xc7, 0x2b, 0xfb, 0x13, 0x32,
+    0xff, 0x99, 0x78, 0x73, 0xa1, 0x4d, 0x5b, 0xd9, 0x9f, 0x64, 0xe0, 0xa9, 0x3d, 0xfa, 0x48, 0x19,
+    0x3a, 0xc5, 0x6a, 0x75, 0x77, 0x86, 0x94, 0x09, 0xc0, 0xb9, 0x97, 0x43, 0x55, 0x09, 0x38, 0x5b,
+    0x71, 0x14, 0x0f, 0x5b, 0xa8, 0xb1, 0x35, 0x5f, 0x6e, 0xe6, 0x49, 0x2d, 0xcc, 0x32, 0x69, 0x37,
+    0x00, 0x0a, 0xb0, 0x89, 0x66, 0x83, 0x59, 0xce, 0xbd, 0x80, 0x03, 0x03, 0xca, 0x25, 0x1c, 0x5e,
+    0xca, 0xb2, 0x22, 0xeb, 0x4d, 0x09, 0x6d, 0x44, 0xd5, 0xe3, 0xf1, 0xd9, 0xaf, 0x53, 0xfc, 0x39,
+    0x3a, 0x6b, 0xbe, 0x7c, 0x3a, 0x6b, 0xbe, 0x30, 0x3a, 0x6b, 0xbe, 0x30, 0x3a, 0x6b, 0x3e, 0x0f,
+    0x3a, 0xeb, 0xe0, 0x11, 0x3a, 0x10, 0x78, 0xe8, 0xf2, 0x21, 0xbb, 0x97, 0x4b, 0x88, 0x91, 0x3e,
+    0x1c, 0xdd, 0x07, 0x33, 0xbe, 0xb9, 0x29, 0xe2, 0xf3, 0x25, 0x37, 0xa0, 0x86, 0x47, 0xe5, 0xb6,
+    0x3d, 0xd7, 0x8d, 0x91, 0x74, 0xf0, 0x4f, 0xee, 0x1f, 0x67, 0x3e, 0x57, 0x12, 0xbd, 0x0e, 0x9b,
+    0x1b, 0x1b, 0xeb, 0xb7, 0xd3, 0x1d, 0xa2, 0xae, 0x6d, 0x90, 0x91, 0x12, 0x38, 0x9e, 0x67, 0x64,
+    0xce, 0xbb, 0x54, 0x86, 0x3e, 0x1e, 0xb7, 0x10, 0xe3, 0x8c, 0xec, 0xdc, 0x91, 0x15, 0x7f, 0x44,
+    0xef, 0x95, 0x47, 0xc4, 0xd4, 0xa8, 0x32, 0xa2, 0xb1, 0x14, 0xee, 0x66, 0x57, 0xb7, 0x79, 0xd9,
+    0xf4, 0xae, 0xb9, 0x58, 0x2e, 0xda, 0xa0, 0x33, 0xbd, 0x1a, 0xc2, 0x45, 0xd0, 0x4b, 0x47, 0x26,
+    0x1b, 0x9c, 0x8e, 0xe4, 0x08, 0x62, 0x66, 0x24, 0x4d, 0x32, 0x3d, 0x56, 0x03, 0xb8, 0x92, 0x00,
+    0xaa, 0x30, 0xc4, 0x52, 0xfa, 0xae, 0x38, 0xbb, 0x89, 0xa7, 0x7c, 0x28, 0x35, 0xed, 0xab, 0xe9,
+    0x35, 0xb2, 0x80, 0x37, 0xef, 0x74, 0xe9, 0x23, 0x4e, 0xaf, 0x43, 0x67, 0xf1, 0xa5, 0xf0, 0xe1,
+    0x4b, 0xd8, 0xcd, 0xf5, 0x5f, 0xb3, 0x4b, 0x3c, 0xa7, 0x32, 0xf5, 0x91, 0x1e, 0xd1, 0x6a, 0xb3,
+    0x96, 0x25, 0xc2, 0x21, 0xed, 0xd1, 0x27, 0x67, 0xc1, 0x0f, 0xa1, 0xa2, 0xc1, 0xaa, 0x94, 0x1e,
+    0xc5, 0x20, 0x4f, 0xcf, 0xe8, 0x24, 0x80, 0xcb, 0x30, 0x3a, 0x12, 0x64, 0x55, 0x87, 0x3c, 0x7d,
+    0xc3, 0x7d, 0x6a, 0x77, 0xde, 0x60, 0xa5, 0x88, 0xbe, 0xdc, 0xaf, 0xe4, 0x4a, 0x37, 0x41, 0x79,
+    0xa8, 0x7a, 0x54, 0xca, 0x09, 0xdf, 0x45, 0xd4, 0xb9, 0x44, 0x7b, 0x4e, 0xcc, 0x71, 0x8f, 0x71,
+    0xac, 0xbd, 0xfe, 0x34, 0xbb, 0xc6, 0x12, 0xc5, 0x72, 0x52, 0x2f, 0x7a, 0x3e, 0x19, 0xed, 0xc4,
+    0x9f, 0xe6, 0x50, 0x60, 0x28, 0x9d, 0xfa, 0x73, 0x07, 0xf5, 0xf5, 0xbf, 0x0d, 0xdd, 0x91, 0x42,
+    0x77, 0xaf, 0xab, 0x3e, 0x71, 0x75, 0xf3, 0x4d, 0x70, 0x7f, 0x17, 0xc7, 0x16, 0xd9, 0xba, 0xff,
+    0x53, 0xde, 0xfa, 0x89, 0xbb, 0x3e, 0xc7, 0x87, 0x07, 0x8b, 0x2b, 0x6c, 0xa1, 0x6b, 0xd3, 0xef,
+    0xde, 0x1d, 0xfb, 0xf4, 0xdb, 0x37, 0x4b, 0x40, 0xa7, 0x7b, 0x72, 0x77, 0xf8, 0x83, 0x64, 0xe2,
+    0x12, 0x4b, 0x68, 0x62, 0x0b, 0x30, 0xc3, 0x7d, 0x32, 0x7b, 0xd0, 0x88, 0xa9, 0xb3, 0x13, 0x0b,
+    0xc4, 0x12, 0x30, 0x38, 0xa4, 0x59, 0x23, 0x32, 0x8f, 0xb2, 0x77, 0xf2, 0x6e, 0xc2, 0xbf, 0xb7,
+    0x62, 0xf4, 0xc0, 0x3f, 0xe0, 0x84, 0xb8, 0x0b, 0x56, 0xda, 0xff, 0x3a, 0x4a, 0x94, 0x92, 0x16,
+    0xd8, 0x32, 0x4f, 0x47, 0xf7, 0xf9, 0x44, 0xe1, 0x14, 0x75, 0x9a, 0x0c, 0x2e, 0x7b, 0x7c, 0xba,
+    0xf7, 0xb9, 0xce, 0xfb, 0x1a, 0x72, 0xe1, 0xb7, 0x6b, 0xdd, 0xd2, 0xbc, 0xe0, 0x7e, 0x14, 0xc0,
+    0x15, 0x32, 0x79, 0x94, 0x56, 0x0d, 0x44, 0xa5, 0x84, 0x54, 0x41, 0x20, 0xdd, 0x48, 0x29, 0xce,
+    0x10, 0x67, 0x8e, 0x0f, 0xe9, 0x05, 0x2c, 0x42, 0x54, 0x82, 0xfc, 0xba, 0xbe, 0x3e, 0xd7, 0x79,
+    0xfc, 0x19, 0x75, 0x22, 0xdd, 0x02, 0x48, 0x26, 0xdd, 0x0b, 0xb5, 0xb9, 0x55, 0x80, 0x85, 0xb4,
+    0xd6, 0xfb, 0xbe, 0x02, 0xe4, 0x56, 0xd1, 0xd2, 0x0e, 0x71, 0x69, 0x14, 0xac, 0x84, 0xb9, 0x5d,
+    0x34, 0xf3, 0x98, 0x47, 0xee, 0x4a, 0x88, 0x8d, 0xfa, 0x82, 0x0d, 0xbd, 0x82, 0x8c, 0x18, 0xdd,
+    0x03, 0x56, 0x67, 0xec, 0x7e, 0x24, 0x04, 0x61, 0x19, 0xfc, 0x7a, 0x75, 0x02, 0x57, 0xaf, 0x71,
+    0x5b, 0x3d, 0x5b, 0x14, 0xa6, 0xf5, 0xf2, 0x30, 0x9d, 0xbe, 0x55, 0xd0, 0xa7, 0x50, 0x27, 0x6f,
+    0xa7, 0xd1, 0x4e, 0xcd, 0x6e, 0x21, 0xb3, 0xf8, 0x1e, 0x61, 0xa5, 0x9a, 0xb4, 0xe0, 0x6b, 0xbe,
+    0x5a, 0x59, 0xd2, 0x11, 0x34, 0x54, 0x48, 0x0a, 0x67, 0xfa, 0xd6, 0x65, 0xd2, 0x7b, 0xde, 0xf8,
+    0x41, 0xbf, 0x77, 0xd9, 0xde, 0x24, 0x8d, 0x86, 0xdb, 0xd8, 0x8e, 0x1b, 0x24, 0xb1, 0xba, 0x7e,
+    0x01, 0x93, 0x1c, 0x99, 0x21, 0xbf, 0xe2, 0xb7, 0x4d, 0xff, 0x03, 0x1b, 0x0e, 0x8d, 0xf9, 0x85,
+    0x1a, 0x00, 0x00,
+};
+
+// dashboard.js: 5009 bytes -> 1704 bytes gzip
+#define WEB_ASSET_DASHBOARD_JS_INDEX 2
+#define WEB_ASSET_DASHBOARD_JS_HASH "73e11d17"
+const uint8_t WEB_ASSET_DASHBOARD_JS[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xad, 0x18, 0xc9, 0x72, 0xd4, 0x46,
+    0xf4, 0xee, 0xaf, 0x68, 0xa8, 0x80, 0xa4, 0x00, 0xb2, 0x67, 0x2a, 0xc9, 0x21, 0x66, 0x4c, 0x39,
+    0xc6, 0xae, 0x10, 0x02, 0xb8, 0x70, 0x55, 0x2e, 0x14, 0x87, 0x1e, 0xa9, 0x67, 0x46, 0xb1, 0xd4,
+    0x52, 0xd4, 0x2d, 0x8f, 0xa7, 0xc0, 0x55, 0x81, 0x62, 0xf1, 0xc1, 0xc7, 0x9c, 0x92, 0x03, 0x29,
+    0x2e, 0x26, 0xa4, 0x88, 0x8b, 0x25, 0xdb, 0x25, 0xdf, 0x21, 0x85, 0x1b, 0x5f, 0xc0, 0x27, 0xe4,
+    0xbd, 0x6e, 0x69, 0xb4, 0xcc, 0x62, 0xa7, 0x0a, 0x1d, 0x46, 0xad, 0xee, 0xf7, 0x5e, 0xbf, 0x7d,
+    0x99, 0x5e, 0xc2, 0x1d, 0xe9, 0x85, 0x9c, 0x08, 0x26, 0xbf, 0x09, 0xfd, 0x24, 0x60, 0xe6, 0x8e,
+    0x7a, 0x59, 0xe4, 0xce, 0x02, 0x81, 0xa7, 0xc7, 0xa4, 0x33, 0x30, 0x8d, 0x45, 0x38, 0xd7, 0x07,
+    0x97, 0xf4, 0xab, 0x63, 0x90, 0x73, 0x24, 0x07, 0x55, 0x80, 0xf8, 0xd8, 0x72, 0xc0, 0xb8, 0x19,
+    0x33, 0x11, 0x85, 0x5c, 0x30, 0xd2, 0x59, 0x21, 0xc5, 0xda, 0x96, 0x6c, 0x57, 0x9a, 0x56, 0x13,
+    0x14, 0x77, 0x11, 0xec, 0xce, 0x78, 0x1f, 0x1f, 0x37, 0x74, 0x80, 0x2c, 0x97, 0x76, 0x9f, 0xc9,
+    0x75, 0x9f, 0xe1, 0xf2, 0x8b, 0xd1, 0x15, 0xd7, 0x34, 0x9c, 0x24, 0x8e, 0xe1, 0x43, 0x33, 0x6a,
+    0x58, 0x8a, 0xe8, 0x5a, 0xc8, 0x25, 0xec, 0x91, 0x0e, 0x31, 0xd6, 0xf4, 0xf1, 0xe7, 0xa4, 0xe4,
+    0x0d, 0x16, 0xc6, 0x19, 0x63, 0xb9, 0x46, 0x9e, 0xfa, 0x2c, 0x96, 0xea, 0x6a, 0xab, 0x3c, 0xd8,
+    0x83, 0xf5, 0xde, 0xc2, 0x42, 0xaf, 0xd0, 0x87, 0x64, 0x42, 0xae, 0x55, 0xaf, 0x33, 0x9b, 0x1a,
+    0x41, 0x88, 0x9d, 0x9c, 0x93, 0x0f, 0xad, 0x81, 0x79, 0x2c, 0x2e, 0x2e, 0x92, 0xf4, 0xf7, 0xec,
+    0x5e, 0xfa, 0x22, 0x7b, 0x4c, 0xd2, 0x5f, 0xd3, 0xc3, 0xf4, 0x59, 0xfa, 0x9c, 0xc0, 0xeb, 0x35,
+    0xbc, 0xcc, 0x21, 0xeb, 0x2e, 0xba, 0x54, 0x0c, 0xba, 0x21, 0x8d, 0x5d, 0x7b, 0x20, 0x03, 0xdf,
+    0x4a, 0x7f, 0x22, 0xd9, 0xe3, 0xec, 0x21, 0x40, 0xc3, 0xcf, 0x7d, 0x00, 0x3c, 0x7a, 0x7b, 0x90,
+    0xbe, 0x24, 0xd9, 0x3f, 0xd9, 0x3e, 0x2c, 0x0e, 0x11, 0xf5, 0x15, 0x59, 0xa4, 0x91, 0x57, 0x22,
+    0x92, 0xf4, 0xb7, 0x6c, 0x3f, 0x3d, 0xcc, 0x1e, 0xa5, 0x47, 0x0a, 0xed, 0xed, 0xc1, 0xbb, 0xef,
+    0x0f, 0xd2, 0x37, 0xd9, 0x3e, 0xee, 0x94, 0x3a, 0x02, 0x9f, 0xd8, 0xf0, 0x98, 0xef, 0x9a, 0xdb,
+    0x6c, 0x74, 0x9e, 0xec, 0x50, 0x3f, 0x61, 0xe7, 0x89, 0xf0, 0xfa, 0x9c, 0xb9, 0x85, 0xb2, 0x76,
+    0x68, 0x4c, 0x98, 0x0f, 0xc6, 0x19, 0xdb, 0xf4, 0xbb, 0x84, 0xc5, 0xa3, 0x2d, 0xe6, 0x33, 0x47,
+    0x86, 0xb1, 0x69, 0xdc, 0x72, 0xa9, 0xa4, 0x17, 0xb6, 0x3b, 0xa7, 0xd1, 0x66, 0x40, 0x07, 0x0d,
+    0x76, 0xfa, 0xb6, 0x91, 0x8b, 0xed, 0xf5, 0x88, 0x79, 0x8a, 0xf9, 0x16, 0x68, 0x51, 0x26, 0x31,
+    0xd7, 0x9b, 0xcc, 0x6f, 0x18, 0x5e, 0xdd, 0x5c, 0x22, 0x68, 0x0e, 0xc8, 0xa9, 0x4e, 0x87, 0x24,
+    0xdc, 0x65, 0x3d, 0xaf, 0xc2, 0x4f, 0x8e, 0xef, 0xf8, 0x54, 0x88, 0xaf, 0x3d, 0x21, 0x6d, 0x19,
+    0xf6, 0xfb, 0x3e, 0x33, 0x8d, 0x28, 0x14, 0x9e, 0xf4, 0x76, 0x98, 0x51, 0x48, 0x40, 0x56, 0x3a,
+    0x64, 0xa9, 0xa2, 0xfd, 0xa9, 0x58, 0x9c, 0xf5, 0x69, 0x1d, 0xeb, 0xe2, 0x18, 0x69, 0xaf, 0xe6,
+    0x4f, 0xbd, 0x40, 0x6e, 0xb2, 0xd8, 0x01, 0x86, 0xcd, 0xa8, 0x60, 0x46, 0x0b, 0x45, 0xcc, 0x88,
+    0xac, 0x90, 0x25, 0x72, 0x89, 0x18, 0xe7, 0x0c, 0x02, 0xce, 0x6b, 0x58, 0xa0, 0x84, 0x08, 0xee,
+    0xd8, 0xf0, 0x76, 0x99, 0x6b, 0xb6, 0xad, 0xc2, 0x89, 0x1b, 0xf4, 0xae, 0x27, 0x41, 0x97, 0xc5,
+    0x26, 0xaf, 0xea, 0x9a, 0x82, 0x3a, 0xae, 0x51, 0x39, 0xb0, 0x69, 0x57, 0xc0, 0x49, 0xa9, 0x14,
+    0x8a, 0xf2, 0xb4, 0x96, 0xd4, 0x63, 0x8d, 0x6f, 0xe6, 0x64, 0x71, 0xbc, 0xd9, 0xb8, 0xf0, 0x9a,
+    0x31, 0x0d, 0x79, 0x12, 0xb5, 0xc4, 0x6b, 0x29, 0xbc, 0xab, 0xd3, 0xf0, 0xe6, 0xa1, 0xb5, 0x6b,
+    0x68, 0x39, 0x1c, 0xaf, 0x1c, 0xd7, 0x05, 0x8f, 0x59, 0x0f, 0x42, 0x6a, 0x70, 0xb9, 0xf0, 0xd5,
+    0x89, 0xb8, 0xac, 0x79, 0xf2, 0xc9, 0x42, 0xf3, 0x5b, 0x11, 0xf2, 0xc9, 0xd0, 0x74, 0x27, 0xe3,
+    0x72, 0xec, 0xf1, 0x46, 0xd0, 0x72, 0xc2, 0x84, 0x4b, 0x30, 0xbc, 0x6b, 0x83, 0x51, 0xe3, 0x91,
+    0xad, 0xbe, 0xad, 0xe5, 0x99, 0xf0, 0x11, 0xf7, 0x01, 0xba, 0xe2, 0x07, 0x05, 0x22, 0x1c, 0xe4,
+    0x5b, 0x56, 0x49, 0xad, 0xb2, 0x39, 0x9b, 0xa4, 0x72, 0x7c, 0x20, 0x6a, 0x7c, 0x84, 0xd1, 0x53,
+    0xba, 0x44, 0x41, 0x44, 0x9d, 0x5b, 0x73, 0x08, 0x0c, 0x3d, 0x1e, 0x53, 0xc9, 0x2a, 0x52, 0xc0,
+    0xce, 0x4d, 0xd8, 0x69, 0x18, 0xf5, 0x8c, 0x31, 0x9b, 0x48, 0xbb, 0xa2, 0x88, 0x5d, 0x4f, 0x1e,
+    0xa7, 0x87, 0xf6, 0x34, 0x3d, 0x20, 0x5e, 0x53, 0x0d, 0x8d, 0xbd, 0xd9, 0x04, 0xe7, 0x68, 0x01,
+    0x69, 0x1c, 0xa7, 0x84, 0xb6, 0x1b, 0xd3, 0xa1, 0x1b, 0x0e, 0xf9, 0x54, 0xae, 0x02, 0xba, 0x7b,
+    0x39, 0x3f, 0x9f, 0x4d, 0x63, 0xe8, 0xf5, 0x3c, 0xa5, 0x00, 0x5c, 0xcc, 0x84, 0x4a, 0x22, 0xe9,
+    0x05, 0x5a, 0xd7, 0x7a, 0x39, 0x13, 0x72, 0xc0, 0x68, 0x04, 0x70, 0x2a, 0x90, 0x7b, 0x7e, 0x18,
+    0xa2, 0x2c, 0xe0, 0xf5, 0xec, 0x4b, 0xd8, 0x57, 0xf1, 0xd3, 0xfe, 0x44, 0x99, 0x85, 0x5c, 0xfd,
+    0x82, 0x98, 0x28, 0x34, 0x1e, 0xd3, 0x3e, 0xe6, 0x57, 0x8a, 0x41, 0x32, 0xb6, 0xde, 0x92, 0xb6,
+    0x1e, 0xc1, 0x53, 0x6b, 0xb6, 0x0d, 0xbb, 0x54, 0x4a, 0xc8, 0xca, 0x8a, 0xb5, 0x7c, 0x3d, 0xc7,
+    0x69, 0x38, 0x0d, 0xaa, 0x1e, 0x83, 0x9f, 0x73, 0xb4, 0x5b, 0x42, 0xa3, 0x3a, 0xa7, 0x00, 0x43,
+    0x89, 0x75, 0x59, 0xbc, 0xe5, 0x87, 0x52, 0x80, 0x98, 0x02, 0xdf, 0xe4, 0xee, 0x5d, 0x72, 0xeb,
+    0x76, 0x03, 0x8e, 0x46, 0x91, 0x3f, 0x5a, 0x75, 0x1c, 0x26, 0xc4, 0x66, 0xe8, 0x29, 0x0b, 0xd1,
+    0x68, 0x9d, 0xd3, 0xae, 0x0f, 0xe9, 0x7d, 0xf9, 0xc3, 0x37, 0x10, 0xae, 0x3d, 0xbd, 0x85, 0xd8,
+    0xab, 0xe4, 0x09, 0x87, 0x62, 0xce, 0x81, 0x14, 0x84, 0x99, 0xa2, 0xd9, 0x42, 0x4c, 0x30, 0xcc,
+    0x72, 0x66, 0x2b, 0xf9, 0x5a, 0x80, 0xc1, 0x12, 0x71, 0x92, 0xfa, 0x48, 0x23, 0x0d, 0x5b, 0x16,
+    0x47, 0xfd, 0xdd, 0x94, 0x61, 0x75, 0x53, 0xb3, 0x5f, 0xdc, 0x86, 0x75, 0xe5, 0xc6, 0x75, 0x55,
+    0x58, 0x6e, 0x6c, 0x6c, 0x34, 0x70, 0x27, 0x2b, 0x1a, 0x8d, 0x2e, 0x84, 0x18, 0x09, 0xac, 0xa6,
+    0xd8, 0xb9, 0xe0, 0xbd, 0x1e, 0xc0, 0x9f, 0xaa, 0x23, 0xa0, 0x6c, 0x1a, 0xe6, 0x64, 0xb2, 0x69,
+    0xd8, 0x52, 0x36, 0xfd, 0xdd, 0x90, 0xad, 0x22, 0xd1, 0xfb, 0x27, 0x3f, 0xbc, 0x21, 0x97, 0x3d,
+    0x81, 0x1b, 0x64, 0x75, 0x53, 0x89, 0xf7, 0xfe, 0xc9, 0x93, 0xa7, 0x44, 0x3b, 0x04, 0x6e, 0xd5,
+    0x08, 0x4d, 0x72, 0xde, 0x95, 0xfc, 0xc2, 0x90, 0xc6, 0xdc, 0xe3, 0xfd, 0x09, 0x71, 0xe7, 0x22,
+    0x89, 0x44, 0x99, 0xb4, 0x2e, 0xb3, 0xee, 0xcb, 0xd0, 0x79, 0xa1, 0xd9, 0x4a, 0x0f, 0xdf, 0x1e,
+    0x60, 0x5b, 0xf5, 0x07, 0xb4, 0x50, 0xf7, 0xa0, 0x81, 0x32, 0xa3, 0xb6, 0x6d, 0xeb, 0x3e, 0x0c,
+    0x1a, 0xaf, 0xf4, 0x25, 0x76, 0x60, 0xd9, 0x3d, 0xf2, 0xef, 0x2f, 0xd9, 0x03, 0xe8, 0xc0, 0x8e,
+    0x72, 0x04, 0x71, 0x31, 0x58, 0x51, 0xb9, 0x13, 0x22, 0x1c, 0xd7, 0x90, 0xfb, 0xf2, 0x95, 0xca,
+    0x60, 0x24, 0x3d, 0x02, 0x92, 0x80, 0x4b, 0xd2, 0xe7, 0xd0, 0xb5, 0x29, 0xe7, 0xda, 0x4a, 0x82,
+    0x80, 0xc6, 0x23, 0x92, 0x3e, 0xcd, 0x1e, 0x21, 0xdd, 0x43, 0xe8, 0xea, 0x90, 0x22, 0x2c, 0x80,
+    0x78, 0xad, 0x57, 0xab, 0x46, 0x99, 0x8a, 0xb1, 0xaa, 0x17, 0x76, 0x43, 0x77, 0x54, 0xb5, 0x53,
+    0x33, 0x6c, 0xc0, 0x0a, 0x31, 0x45, 0xdc, 0x9b, 0xe1, 0x50, 0x14, 0x26, 0x42, 0xa4, 0xa6, 0xf3,
+    0xe5, 0x4a, 0x57, 0x17, 0xd8, 0xbd, 0x30, 0x5e, 0xa7, 0x10, 0x1e, 0xa2, 0x5e, 0x47, 0xf1, 0xc2,
+    0x38, 0x1c, 0x56, 0xef, 0x73, 0x62, 0x06, 0x35, 0x27, 0xbf, 0xd2, 0x34, 0x64, 0x5c, 0x4d, 0x55,
+    0x08, 0x8f, 0x69, 0x63, 0x8d, 0xf9, 0xfe, 0x3c, 0x24, 0xb7, 0x89, 0xe4, 0x7b, 0x7c, 0x7b, 0x0e,
+    0x02, 0xad, 0xc2, 0x23, 0xac, 0x3d, 0x80, 0xde, 0x02, 0xa5, 0x58, 0xd4, 0xcd, 0x20, 0xb4, 0x06,
+    0x97, 0x82, 0xd0, 0xd5, 0xa3, 0x8e, 0xb0, 0xa1, 0x39, 0x6d, 0xc0, 0xd7, 0x85, 0x17, 0x2a, 0xb9,
+    0x95, 0x20, 0x05, 0xcf, 0x90, 0xa5, 0x22, 0x50, 0xfe, 0xda, 0xc0, 0x83, 0x84, 0x88, 0x78, 0x95,
+    0x6b, 0x41, 0x0f, 0xb5, 0xe3, 0x02, 0xa7, 0x02, 0x72, 0xcb, 0x28, 0xea, 0xab, 0xa1, 0x2b, 0xa7,
+    0xa1, 0xeb, 0xdd, 0xed, 0xb1, 0x7e, 0xb7, 0x27, 0xfb, 0x14, 0x14, 0xdf, 0xf9, 0x3f, 0xfa, 0xc2,
+    0x07, 0x11, 0x6c, 0x48, 0xdd, 0xab, 0x52, 0xc6, 0x5e, 0x37, 0x91, 0xe0, 0xef, 0x3a, 0x40, 0xf1,
+    0x52, 0xa1, 0x95, 0x10, 0x60, 0x97, 0xde, 0x4c, 0xe0, 0x0d, 0x21, 0x9c, 0xba, 0x00, 0x7b, 0x95,
+    0xb5, 0xf2, 0x99, 0x2a, 0x2c, 0xe0, 0x56, 0x8e, 0xcb, 0xba, 0x51, 0xb9, 0x6e, 0x2c, 0xbf, 0x98,
+    0x68, 0x2d, 0xa6, 0xc3, 0x4f, 0x34, 0x18, 0xa2, 0xde, 0x5b, 0x88, 0xe9, 0x6d, 0xc5, 0x74, 0x62,
+    0xb3, 0x9a, 0x0b, 0x51, 0xef, 0x2b, 0x0a, 0x21, 0x8f, 0x0f, 0x21, 0x88, 0x1f, 0x5b, 0xc8, 0x11,
+    0xa4, 0x17, 0xd7, 0x13, 0x91, 0x4f, 0x31, 0xf0, 0x74, 0xbc, 0xf8, 0x8c, 0xf7, 0xe5, 0xa0, 0x98,
+    0x05, 0x54, 0x4a, 0xe3, 0x21, 0x67, 0xc6, 0x78, 0xea, 0x7b, 0x96, 0x3d, 0xc6, 0x39, 0xec, 0x25,
+    0xcc, 0x66, 0xaf, 0x20, 0xda, 0x5f, 0xe3, 0x84, 0x06, 0x89, 0x23, 0x7b, 0x90, 0xbe, 0x48, 0xff,
+    0xd2, 0x67, 0x79, 0xe6, 0x81, 0x81, 0x8e, 0xed, 0xc0, 0xdd, 0x02, 0x92, 0x4e, 0x14, 0xfa, 0xe0,
+    0x75, 0x7d, 0x02, 0xa9, 0xe8, 0x7e, 0xfa, 0x27, 0x50, 0xc1, 0x44, 0x81, 0x68, 0xfb, 0x90, 0xa0,
+    0xfe, 0x86, 0x74, 0x01, 0xd3, 0xe3, 0x6b, 0x78, 0xc1, 0xfc, 0x98, 0x3d, 0xc4, 0xe3, 0xc3, 0xec,
+    0x3e, 0x1e, 0xeb, 0xa9, 0x2f, 0x7b, 0xa8, 0xe7, 0xc0, 0x46, 0x59, 0xcb, 0x33, 0x8f, 0x59, 0x2b,
+    0x66, 0x11, 0xc4, 0x8f, 0xb7, 0x8b, 0x3e, 0x07, 0xba, 0xeb, 0xc0, 0xf8, 0xa5, 0x04, 0x09, 0x5a,
+    0x28, 0x4a, 0xb1, 0xd5, 0x52, 0x5b, 0x6d, 0x25, 0x9d, 0xd0, 0x65, 0x36, 0xc8, 0x93, 0x46, 0xa1,
+    0xff, 0x9c, 0x4c, 0xc5, 0xf2, 0xae, 0x5d, 0x8c, 0x32, 0x53, 0x80, 0xa6, 0xf4, 0x93, 0xb0, 0xa5,
+    0x7a, 0x48, 0x7c, 0xcf, 0xc4, 0x9b, 0xdd, 0x36, 0xd6, 0x2c, 0x8b, 0x73, 0x4c, 0x29, 0xcf, 0xd9,
+    0xb3, 0xc8, 0x0c, 0xda, 0xc8, 0x9a, 0xd1, 0x48, 0x9b, 0xd8, 0x05, 0x72, 0xf2, 0x31, 0x4e, 0x39,
+    0x90, 0xbf, 0x91, 0xf5, 0x59, 0xcd, 0x74, 0x95, 0x74, 0xcb, 0x3a, 0x51, 0x4f, 0xea, 0xba, 0x96,
+    0xae, 0x36, 0x88, 0x0b, 0xf7, 0x00, 0x8c, 0xbd, 0x8e, 0x96, 0xde, 0x0a, 0x13, 0x80, 0xa9, 0x8d,
+    0xdd, 0xca, 0x01, 0xc0, 0x1a, 0x9c, 0x0d, 0x49, 0x05, 0x06, 0x46, 0x24, 0x7d, 0x54, 0xb0, 0xa1,
+    0xbf, 0x6c, 0xea, 0xba, 0x0a, 0x0a, 0x0b, 0x1e, 0xe3, 0xa0, 0x08, 0x43, 0x68, 0x23, 0x63, 0x79,
+    0xc4, 0x14, 0x53, 0x33, 0xfc, 0x57, 0x5b, 0x37, 0xae, 0xdb, 0x11, 0x8d, 0x05, 0x33, 0xc1, 0x93,
+    0x21, 0x4d, 0x58, 0xd6, 0x71, 0xe4, 0x60, 0xdc, 0x1a, 0x71, 0x07, 0x55, 0x64, 0xe9, 0xe9, 0xab,
+    0x39, 0xc8, 0x1d, 0x47, 0x40, 0xfd, 0x2b, 0x52, 0x70, 0x53, 0x2f, 0x28, 0x38, 0xf7, 0x4e, 0xb2,
+    0x54, 0x06, 0xf7, 0x38, 0x2e, 0xa5, 0x27, 0x55, 0x4f, 0x62, 0xbc, 0xfb, 0xf1, 0x67, 0xd5, 0x27,
+    0x51, 0x5b, 0xa8, 0x56, 0x5a, 0xaf, 0x03, 0xd1, 0xaf, 0x07, 0x34, 0x18, 0xe5, 0x0a, 0x64, 0xf8,
+    0x18, 0x7c, 0xc2, 0x6c, 0x72, 0x7c, 0x9e, 0x7c, 0xa6, 0x66, 0x62, 0x30, 0x08, 0x61, 0x3e, 0xcc,
+    0x94, 0x77, 0x4e, 0x80, 0xd2, 0xfa, 0x34, 0x47, 0x59, 0x58, 0x98, 0xd4, 0xc0, 0xf2, 0xc2, 0x7f,
+    0x5e, 0xae, 0xa1, 0x7e, 0x91, 0x13, 0x00, 0x00,
+};
+
+// wifi.css: 4682 bytes -> 1306 bytes gzip
+#define WEB_ASSET_WIFI_CSS_INDEX 3
+#define WEB_ASSET_WIFI_CSS_HASH "37513911"
+const uint8_t WEB_ASSET_WIFI_CSS[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x9d, 0x58, 0x5b, 0x6f, 0xab, 0x38,
+    0x10, 0x7e, 0xef, 0xaf, 0xb0, 0x74, 0xb4, 0x52, 0x2b, 0x85, 0x0a, 0x48, 0xc8, 0xf5, 0x65, 0x5f,
+    0xf7, 0x27, 0xec, 0xe3, 0xc4, 0x17, 0x62, 0x95, 0xd8, 0xc8, 0x98, 0xa4, 0xdd, 0xd5, 0xf9, 0xef,
+    0x6b, 0x83, 0x0d, 0x98, 0x98, 0xe6, 0x9c, 0x2d, 0x6a, 0x8a, 0x9c, 0xb9, 0xf9, 0x9b, 0xf1, 0xcc,
+    0xe7, 0xbe, 0x37, 0x14, 0x6b, 0x2e, 0x05, 0xfa, 0x17, 0xbd, 0x20, 0xf3, 0x73, 0x06, 0xfc, 0x51,
+    0x2a, 0xd9, 0x0a, 0x72, 0x44, 0x3f, 0x72, 0x62, 0x9f, 0x53, 0xff, 0x4d, 0x0d, 0x84, 0x70, 0x51,
+    0x1e, 0x51, 0x9e, 0xd6, 0x9f, 0x6e, 0xed, 0x2c, 0x15, 0xa1, 0x2a, 0x51, 0x40, 0x78, 0xdb, 0x1c,
+    0x51, 0x36, 0x7e, 0x73, 0x05, 0x55, 0x72, 0x91, 0x9c, 0xa5, 0xd6, 0xf2, 0x3a, 0xd3, 0xf9, 0x4c,
+    0x9a, 0x0b, 0x10, 0x79, 0x3f, 0xa2, 0x14, 0x6d, 0xea, 0x4f, 0xb4, 0x35, 0xbf, 0xaa, 0x3c, 0xc3,
+    0x6b, 0xba, 0xea, 0x9e, 0xf7, 0xf5, 0xdb, 0xe9, 0xe5, 0xe7, 0xcb, 0xfb, 0x59, 0xc7, 0xc3, 0x4a,
+    0xd3, 0xfd, 0x9e, 0x31, 0x67, 0x0e, 0xcb, 0x4a, 0xaa, 0x23, 0xba, 0x5f, 0xb8, 0xa6, 0xf3, 0x48,
+    0x6d, 0x3c, 0x8f, 0xe1, 0x1e, 0x91, 0x90, 0x82, 0xc6, 0x77, 0x50, 0x0c, 0xb2, 0xb8, 0x55, 0x8d,
+    0x35, 0x5c, 0x4b, 0x2e, 0x34, 0x55, 0xa7, 0x6e, 0x51, 0xd3, 0x4f, 0x9d, 0x10, 0x8a, 0xa5, 0x02,
+    0x0b, 0x9a, 0xb3, 0xd4, 0x7d, 0x45, 0x78, 0x53, 0x57, 0xf0, 0x75, 0x44, 0x5c, 0x54, 0x5c, 0xd0,
+    0xe4, 0x5c, 0x49, 0xfc, 0x71, 0x9a, 0x60, 0xd1, 0x1b, 0xef, 0x16, 0x98, 0x14, 0x3a, 0x69, 0xf8,
+    0x3f, 0xd4, 0x84, 0xb8, 0xf1, 0x8b, 0x5a, 0x81, 0x68, 0x78, 0x6f, 0x76, 0xdc, 0x2e, 0x32, 0x68,
+    0x34, 0x1e, 0x8d, 0xe3, 0x45, 0xde, 0xa8, 0x5a, 0xc0, 0x64, 0xbb, 0xc5, 0xd8, 0xc5, 0xde, 0x99,
+    0x62, 0x52, 0x19, 0xe0, 0xbb, 0xd7, 0x0a, 0x34, 0xfd, 0xfb, 0x35, 0xc9, 0xeb, 0xcf, 0x01, 0xd8,
+    0xa4, 0xc1, 0x10, 0x47, 0x97, 0xb1, 0xc3, 0x21, 0x4d, 0x8d, 0x25, 0x2f, 0xd8, 0x62, 0x4c, 0x9b,
+    0x66, 0xc1, 0x2b, 0xc6, 0x53, 0x59, 0x02, 0xa2, 0x5c, 0x08, 0x90, 0xb1, 0xb5, 0xf9, 0x19, 0x45,
+    0xef, 0xa0, 0x84, 0x49, 0xd2, 0x2f, 0x85, 0xc0, 0x05, 0x93, 0x51, 0xc1, 0x6c, 0x07, 0xf9, 0x79,
+    0xdf, 0x09, 0x6a, 0x38, 0x57, 0xd4, 0x0b, 0xdd, 0x39, 0xd1, 0x17, 0x9b, 0xff, 0xf4, 0x8f, 0x30,
+    0xcf, 0xa6, 0x5a, 0x2a, 0xa8, 0x1b, 0x03, 0xbc, 0x7f, 0x0b, 0xea, 0xd5, 0xa8, 0x98, 0x24, 0xa1,
+    0xde, 0xb5, 0xbe, 0xac, 0x90, 0x26, 0xde, 0xe4, 0x58, 0x54, 0x06, 0xc6, 0x4e, 0xcc, 0x83, 0x6d,
+    0x6b, 0x02, 0x2a, 0x5e, 0x1a, 0xed, 0x8a, 0x32, 0x1d, 0x3a, 0xf4, 0x07, 0x20, 0x33, 0x4a, 0x8d,
+    0xac, 0x38, 0x41, 0x3f, 0x36, 0x9b, 0x8d, 0xb3, 0x1f, 0xdf, 0x13, 0xd8, 0x27, 0xac, 0x6e, 0x5f,
+    0xf2, 0x63, 0xf5, 0xdc, 0x29, 0x2f, 0x2f, 0xda, 0x54, 0x8a, 0xac, 0x88, 0xcd, 0xa9, 0x56, 0xdf,
+    0x14, 0xc7, 0x1a, 0xec, 0xd3, 0xe3, 0xd9, 0x98, 0x40, 0xa1, 0x4a, 0x4a, 0x29, 0x87, 0xad, 0x8d,
+    0x4e, 0x18, 0xf3, 0xb0, 0x3b, 0x31, 0x06, 0x5c, 0xcd, 0xc5, 0xa6, 0xd9, 0x71, 0x62, 0x77, 0x0a,
+    0x1f, 0x8f, 0x62, 0x63, 0xc2, 0x6b, 0xc5, 0xa5, 0xe2, 0xfa, 0x2b, 0xb9, 0x98, 0xa8, 0x63, 0x21,
+    0xba, 0xe3, 0x8f, 0xf2, 0xa2, 0x58, 0x21, 0xf3, 0x37, 0x7d, 0xcf, 0x8a, 0xb7, 0x10, 0x49, 0x8b,
+    0xed, 0xb1, 0xeb, 0x17, 0x0e, 0x47, 0x17, 0x6e, 0x60, 0xff, 0x4a, 0xcd, 0x39, 0xbe, 0x2e, 0x7a,
+    0xe8, 0xcc, 0x67, 0xdb, 0x5f, 0xf7, 0xe1, 0xf6, 0x1a, 0xf8, 0xa8, 0xe4, 0xfd, 0x7b, 0x07, 0xe9,
+    0x6f, 0x98, 0xef, 0x30, 0xb2, 0xe6, 0xa1, 0x4e, 0x1a, 0x0d, 0xba, 0x1d, 0x0e, 0x5a, 0xbc, 0xa1,
+    0xcc, 0x8a, 0xb1, 0x08, 0x6b, 0x71, 0xd6, 0xcd, 0x26, 0xad, 0x6f, 0xde, 0x72, 0xd0, 0x42, 0x29,
+    0x05, 0xdd, 0xbb, 0x8f, 0xd7, 0x75, 0xf5, 0x3e, 0xc6, 0xf8, 0xa4, 0xb0, 0x01, 0x82, 0x4a, 0x4a,
+    0xeb, 0x98, 0x0a, 0xfd, 0x9a, 0xad, 0x0b, 0x42, 0xcb, 0x95, 0x99, 0x20, 0x7b, 0xd8, 0x6d, 0x0a,
+    0xfb, 0x92, 0xe2, 0xc3, 0x61, 0xf7, 0x16, 0x6f, 0xda, 0xce, 0x34, 0x63, 0xbf, 0x65, 0x9b, 0xe0,
+    0x75, 0xd1, 0xd9, 0x66, 0x64, 0x47, 0xb3, 0xcd, 0xb2, 0x6d, 0x57, 0xa4, 0x5c, 0x10, 0x8e, 0x41,
+    0x4b, 0x53, 0xd0, 0xcf, 0x3a, 0xf6, 0xd8, 0x3f, 0x7c, 0x77, 0xbe, 0x38, 0x90, 0xf2, 0x61, 0x25,
+    0x3c, 0x61, 0x36, 0x8b, 0x91, 0x0c, 0xac, 0xbd, 0xb4, 0x3d, 0x9b, 0xac, 0xb2, 0x33, 0xef, 0xc2,
+    0x09, 0xa1, 0xa2, 0x5f, 0xad, 0xa5, 0xef, 0xf8, 0x8a, 0x9a, 0x26, 0xcd, 0x6f, 0xf4, 0x34, 0x09,
+    0xb8, 0xa2, 0x37, 0x5a, 0xb9, 0x60, 0xbd, 0xff, 0xae, 0xa5, 0x3d, 0xc5, 0xe8, 0x90, 0xf6, 0x10,
+    0xf5, 0xf5, 0xb5, 0xf2, 0x75, 0xbc, 0xf2, 0x87, 0xe6, 0x6d, 0x39, 0x58, 0xeb, 0xbe, 0xab, 0xc3,
+    0xe4, 0x0c, 0xa4, 0xa4, 0xcf, 0xb1, 0x1a, 0x6a, 0xd1, 0xa8, 0xa3, 0xfd, 0x80, 0xce, 0x8c, 0x19,
+    0xe4, 0xb1, 0xd9, 0x17, 0x2e, 0x86, 0x2d, 0xed, 0xa1, 0x0c, 0x0b, 0x17, 0x1d, 0x96, 0x42, 0x18,
+    0xce, 0x42, 0x49, 0x10, 0x60, 0xc8, 0x5b, 0xba, 0xaa, 0x3b, 0x3d, 0x96, 0x43, 0xb7, 0x3b, 0xb8,
+    0x7d, 0xa7, 0xeb, 0x46, 0x4a, 0x5c, 0x17, 0x6e, 0xc0, 0x2b, 0x3b, 0x68, 0x96, 0xf5, 0xb7, 0x78,
+    0x57, 0xec, 0xc8, 0x82, 0xbe, 0x9d, 0xc9, 0x89, 0x15, 0xad, 0x9d, 0xea, 0x8c, 0x26, 0x65, 0x7e,
+    0x93, 0x13, 0x41, 0xe3, 0x6f, 0xa8, 0x82, 0x21, 0x0d, 0x0f, 0xec, 0x62, 0x30, 0x31, 0x90, 0x0c,
+    0xdf, 0x87, 0xb1, 0xa1, 0x05, 0xcb, 0x73, 0x63, 0xea, 0x89, 0x8b, 0xba, 0xd5, 0xab, 0x60, 0xa9,
+    0xa1, 0x95, 0xc1, 0xda, 0x79, 0x9f, 0x4e, 0x55, 0xe7, 0xfa, 0x33, 0x71, 0x8b, 0x9b, 0xf1, 0xa8,
+    0x04, 0xf4, 0xeb, 0xb4, 0x38, 0x8d, 0x02, 0x46, 0x36, 0x19, 0x8f, 0x45, 0x51, 0x9c, 0x96, 0xa8,
+    0x59, 0x04, 0xd5, 0x28, 0x9f, 0x8a, 0xec, 0xeb, 0xc8, 0x24, 0x6e, 0x9b, 0xd8, 0xee, 0xfa, 0x6f,
+    0xdc, 0x1e, 0x65, 0xab, 0x6d, 0x81, 0x4f, 0x99, 0xdd, 0x48, 0x1d, 0x1e, 0x46, 0x71, 0xc8, 0x65,
+    0xed, 0x93, 0x8f, 0x5c, 0x16, 0x65, 0xeb, 0xad, 0x9f, 0x68, 0x9e, 0xd2, 0x1a, 0x96, 0x62, 0x0c,
+    0x09, 0x0d, 0xc6, 0x87, 0x8a, 0xd7, 0x40, 0xdf, 0x61, 0x9c, 0xec, 0xb9, 0x35, 0x8b, 0xa2, 0x99,
+    0xa7, 0x9f, 0x55, 0xd4, 0x9f, 0x1c, 0xf3, 0x96, 0xdc, 0x15, 0xd4, 0x06, 0x10, 0xf3, 0x79, 0x5a,
+    0xb6, 0x18, 0x21, 0x25, 0x79, 0x48, 0x4a, 0x42, 0xa7, 0xd1, 0x83, 0xd5, 0x5f, 0x08, 0xe2, 0xf5,
+    0x15, 0x32, 0xa4, 0x7c, 0x13, 0x3a, 0x8d, 0x20, 0xaa, 0x5c, 0x4b, 0x9b, 0x45, 0xb1, 0xc8, 0xbe,
+    0xa3, 0xb4, 0x79, 0xa1, 0x75, 0x4c, 0xd9, 0x34, 0x54, 0xd5, 0x48, 0xa3, 0xc7, 0x0d, 0x7a, 0xc2,
+    0xf4, 0x7d, 0x85, 0x3e, 0x9c, 0xe1, 0xd1, 0xc0, 0x3b, 0x60, 0xdb, 0xb2, 0x63, 0x16, 0xa6, 0x45,
+    0xf2, 0x58, 0xaf, 0xb3, 0x34, 0xac, 0xa3, 0x9c, 0xc6, 0x97, 0x8a, 0xe9, 0xe7, 0xf3, 0xf4, 0x4f,
+    0x90, 0x5c, 0xca, 0xce, 0x78, 0x5b, 0x2b, 0x16, 0x5a, 0x72, 0xda, 0x5f, 0x8f, 0x86, 0x8f, 0x5e,
+    0x08, 0x04, 0xbf, 0xba, 0xbb, 0x0d, 0x03, 0x42, 0xff, 0x12, 0x06, 0xb9, 0xa2, 0x41, 0x14, 0x1a,
+    0x3a, 0x8f, 0x2a, 0xdc, 0xfe, 0xbc, 0x35, 0xfd, 0x7c, 0xf9, 0xf3, 0x83, 0x7e, 0x31, 0x05, 0x57,
+    0xda, 0x78, 0x53, 0xbd, 0x24, 0x53, 0xd2, 0x32, 0x34, 0x59, 0x03, 0x36, 0x74, 0xea, 0x68, 0xd9,
+    0x76, 0xfc, 0xc2, 0x62, 0xa3, 0x32, 0x53, 0xfd, 0x67, 0x9f, 0x50, 0x39, 0xd5, 0xc9, 0x96, 0x74,
+    0xd2, 0x4e, 0xc1, 0xb6, 0xea, 0x8a, 0x2a, 0x0f, 0xdc, 0x58, 0x99, 0x4b, 0x60, 0x0c, 0xeb, 0xb3,
+    0x7b, 0xc0, 0x77, 0x34, 0xf2, 0x60, 0x06, 0xeb, 0xce, 0x9e, 0xed, 0x3c, 0x1c, 0xa7, 0x11, 0x96,
+    0x87, 0xb3, 0x74, 0x77, 0x9a, 0xb1, 0xe3, 0x7e, 0xcd, 0x47, 0x3a, 0x5e, 0xb3, 0xe2, 0x2e, 0x37,
+    0xb6, 0x9f, 0x6c, 0x8d, 0xbb, 0xed, 0x61, 0xc1, 0xe5, 0xd0, 0xa0, 0x22, 0xd3, 0x6f, 0x58, 0x1b,
+    0xdc, 0xf5, 0x57, 0xaa, 0x85, 0xed, 0xad, 0xad, 0xaf, 0xdc, 0x7c, 0xec, 0x37, 0xcf, 0x9c, 0x45,
+    0xc6, 0xe5, 0xb0, 0xe6, 0xa8, 0x44, 0x63, 0xba, 0xad, 0x81, 0x61, 0x56, 0x26, 0x76, 0xad, 0x57,
+    0xb3, 0x6f, 0x89, 0xa6, 0xd7, 0xda, 0x66, 0xd0, 0x1a, 0x6e, 0xaf, 0xa2, 0xb1, 0x8c, 0xa8, 0xa6,
+    0xa0, 0x5f, 0xa1, 0xd5, 0x32, 0x61, 0x5c, 0xaf, 0xd0, 0x95, 0x0b, 0x33, 0x70, 0x5e, 0x73, 0x3b,
+    0x69, 0x4c, 0x6c, 0x4c, 0xbd, 0xb9, 0xb8, 0x4a, 0xdb, 0xfd, 0xb2, 0x87, 0x14, 0xda, 0xb6, 0x87,
+    0xd2, 0x21, 0x8c, 0x04, 0x83, 0x22, 0xcf, 0x4e, 0xfb, 0xf3, 0x4a, 0x19, 0x18, 0xce, 0xf4, 0xde,
+    0x87, 0x69, 0xdf, 0xa5, 0xbc, 0xab, 0x1b, 0x54, 0xad, 0x3f, 0x18, 0x93, 0xae, 0x95, 0x3f, 0xeb,
+    0x5a, 0xf3, 0x19, 0xe3, 0xed, 0x4d, 0x39, 0x40, 0x94, 0x40, 0x79, 0x45, 0x00, 0x08, 0x46, 0x80,
+    0x96, 0xf5, 0xc8, 0x9c, 0xa0, 0xfb, 0x4f, 0xcf, 0xff, 0x9c, 0x29, 0x3d, 0xc8, 0xe9, 0x32, 0xc8,
+    0xff, 0x01, 0xfb, 0x35, 0x03, 0x6f, 0x4a, 0x12, 0x00, 0x00,
+};
+
+// wifi.js: 3007 bytes -> 857 bytes gzip
+#define WEB_ASSET_WIFI_JS_INDEX 4
+#define WEB_ASSET_WIFI_JS_HASH "052df87a"
+const uint8_t WEB_ASSET_WIFI_JS[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xed, 0x56, 0x4d, 0x6f, 0xdb, 0x30,
+    0x0c, 0xbd, 0xf7, 0x57, 0x68, 0x3e, 0xcc, 0x0e, 0xda, 0xb9, 0xdd, 0x75, 0x59, 0x1a, 0xb4, 0xc1,
+    0x80, 0x15, 0xe8, 0xb6, 0xa2, 0xcd, 0x4e, 0xc3, 0x0e, 0x8a, 0x45, 0xc7, 0xc2, 0x6c, 0xc9, 0x90,
+    0xe5, 0x64, 0xc1, 0xd0, 0xff, 0x3e, 0xca, 0x96, 0x1c, 0xd9, 0xf9, 0x58, 0x3b, 0x74, 0xb7, 0xe5,
+    0x12, 0x5b, 0x7c, 0xa4, 0xde, 0x23, 0x29, 0xca, 0x69, 0x2d, 0x12, 0xcd, 0xa5, 0x20, 0xb2, 0x04,
+    0x31, 0xa7, 0x8b, 0x08, 0x56, 0xfa, 0x8c, 0x68, 0xba, 0xf8, 0x4c, 0x0b, 0x18, 0x91, 0x5f, 0x27,
+    0x04, 0x7f, 0x2b, 0xaa, 0x08, 0x6f, 0x56, 0x13, 0x29, 0x34, 0x88, 0x16, 0xb1, 0xa8, 0xb5, 0x96,
+    0xa2, 0x1a, 0x37, 0x90, 0xad, 0x8d, 0x4c, 0x08, 0x93, 0x49, 0x5d, 0xe0, 0x63, 0xbc, 0x04, 0xfd,
+    0x21, 0x07, 0xf3, 0x58, 0x5d, 0x6f, 0x66, 0x39, 0xad, 0x2a, 0x13, 0x36, 0x0a, 0x10, 0xfd, 0xc6,
+    0xc2, 0x83, 0x51, 0x1b, 0x20, 0x95, 0x8a, 0x44, 0x1c, 0x9d, 0x2f, 0xc6, 0x84, 0x93, 0xf7, 0x5e,
+    0xc0, 0x38, 0x07, 0xb1, 0xd4, 0x19, 0x2e, 0x9f, 0x9e, 0x3a, 0x46, 0xfd, 0x2d, 0xbf, 0xf1, 0xef,
+    0x71, 0x62, 0xa2, 0xdf, 0xf2, 0x4a, 0xc7, 0x0a, 0x0a, 0xb9, 0xc2, 0x4d, 0x28, 0x0a, 0x5b, 0x81,
+    0x8b, 0xff, 0xe8, 0x68, 0x5a, 0xda, 0x4f, 0xa5, 0xd9, 0xc2, 0x8f, 0xb0, 0xb4, 0xf1, 0x8e, 0xb0,
+    0xb4, 0x88, 0xa7, 0xb3, 0xdc, 0x43, 0xec, 0x7a, 0x73, 0xc3, 0x22, 0x57, 0x16, 0x2f, 0x0c, 0x65,
+    0x6c, 0x18, 0x03, 0x2b, 0x18, 0x27, 0xb5, 0x52, 0xe8, 0x35, 0xa7, 0x0a, 0x43, 0x1c, 0x87, 0x2b,
+    0xd0, 0xb5, 0x12, 0x24, 0xa5, 0x79, 0x05, 0xe3, 0x93, 0xc7, 0x93, 0x93, 0xd4, 0xb5, 0x04, 0x66,
+    0x37, 0xe5, 0xaa, 0xb8, 0x6f, 0x99, 0x56, 0x15, 0x67, 0x4e, 0x18, 0x4f, 0x49, 0x64, 0xad, 0x51,
+    0x70, 0xa5, 0x80, 0x6c, 0x64, 0x4d, 0xaa, 0xda, 0x3e, 0xac, 0x29, 0x76, 0x81, 0x96, 0xa4, 0x95,
+    0x48, 0xc2, 0x80, 0x9c, 0x12, 0xe3, 0x8d, 0x7f, 0x41, 0x48, 0x52, 0x25, 0x0b, 0x52, 0xd1, 0x15,
+    0x30, 0x22, 0x40, 0xaf, 0xa5, 0xfa, 0x51, 0x4d, 0x83, 0x91, 0x9f, 0xb2, 0x35, 0x17, 0x4c, 0xae,
+    0xe3, 0x5c, 0x26, 0xd4, 0xf0, 0x88, 0x33, 0x05, 0x29, 0xa6, 0x3c, 0x38, 0x5f, 0xf3, 0x94, 0x17,
+    0x54, 0xd0, 0x25, 0x4c, 0x69, 0x43, 0x71, 0xd2, 0x6e, 0xf1, 0xda, 0x44, 0x9f, 0x98, 0x6d, 0x40,
+    0x24, 0x92, 0xc1, 0xd7, 0xfb, 0x9b, 0x99, 0x2c, 0x4a, 0x29, 0x30, 0x05, 0x2d, 0x6f, 0x3f, 0xbb,
+    0x47, 0x05, 0x0b, 0x48, 0xf4, 0xe7, 0x96, 0xd6, 0x61, 0xc5, 0xb3, 0x16, 0x67, 0x34, 0x0e, 0xc4,
+    0x09, 0xb9, 0xfe, 0x7b, 0x31, 0x76, 0xfb, 0x97, 0x52, 0xa3, 0xe5, 0x72, 0x99, 0xc3, 0x55, 0xad,
+    0xa5, 0xe5, 0xdb, 0x38, 0x9f, 0x11, 0xdb, 0x1b, 0x0f, 0x9a, 0xea, 0xde, 0x09, 0x17, 0xb0, 0x6e,
+    0xd6, 0x90, 0xdd, 0x2b, 0x1f, 0x33, 0xee, 0x10, 0xd8, 0xfd, 0x85, 0x7f, 0x6e, 0x12, 0x05, 0x68,
+    0xb7, 0x1d, 0x1a, 0x85, 0xc6, 0x1c, 0x6e, 0x0f, 0x4a, 0x11, 0x17, 0xa0, 0x33, 0xc9, 0xd0, 0x23,
+    0xbc, 0xfb, 0xf2, 0x30, 0x0f, 0x3d, 0x4b, 0xab, 0xd8, 0x58, 0xce, 0xeb, 0x92, 0x61, 0x10, 0x93,
+    0x0d, 0x0b, 0xe8, 0xb6, 0x33, 0x74, 0x6f, 0x44, 0x59, 0xeb, 0x23, 0x7b, 0x72, 0x63, 0x77, 0x9b,
+    0x76, 0x0e, 0xb1, 0xde, 0x94, 0x46, 0x47, 0x98, 0x71, 0xc6, 0x40, 0x84, 0x43, 0xb3, 0xc0, 0x53,
+    0x64, 0xcc, 0x66, 0x65, 0xc7, 0xb8, 0xa2, 0x79, 0x6d, 0xac, 0x66, 0xc5, 0xa7, 0x5c, 0xe2, 0x84,
+    0x64, 0xb3, 0x8c, 0xe7, 0x2c, 0xea, 0xc0, 0xa3, 0x01, 0x65, 0x8a, 0xd9, 0xb6, 0x65, 0x7c, 0x16,
+    0xf3, 0xa1, 0xdf, 0x7e, 0x01, 0x3b, 0x28, 0xa7, 0xc3, 0x33, 0x1c, 0x82, 0x3a, 0x55, 0x5d, 0x95,
+    0xa7, 0x24, 0x7c, 0x1b, 0x92, 0x77, 0x24, 0xbc, 0x08, 0x0f, 0xa8, 0x1c, 0xc6, 0xf0, 0xc5, 0x76,
+    0xaa, 0x16, 0x92, 0x6d, 0x7a, 0x5e, 0x26, 0x8c, 0xdf, 0x04, 0x55, 0xbd, 0x28, 0xb8, 0x8e, 0x46,
+    0xfd, 0xe6, 0x6c, 0xab, 0x7e, 0xa7, 0xb8, 0x54, 0x5c, 0x6f, 0x6c, 0x67, 0x96, 0xf6, 0xd5, 0xef,
+    0xca, 0xff, 0x3d, 0xf7, 0xa7, 0x9e, 0x73, 0x59, 0x7b, 0x16, 0xed, 0x9e, 0xd3, 0x7e, 0xea, 0x7d,
+    0x88, 0xa3, 0xef, 0x56, 0xf7, 0x82, 0x9c, 0x0c, 0xb7, 0x7a, 0x40, 0x4a, 0xcf, 0xe9, 0x25, 0xbb,
+    0xaa, 0xca, 0xe4, 0xfa, 0x0e, 0xef, 0x3a, 0x1c, 0xdf, 0x2c, 0xda, 0x0e, 0xef, 0xe6, 0xfb, 0x65,
+    0x98, 0x9d, 0xc1, 0xdd, 0xda, 0x8d, 0x55, 0x33, 0xe9, 0xb9, 0x97, 0x95, 0x09, 0x0e, 0xeb, 0xd2,
+    0xc6, 0x0c, 0xfc, 0xc9, 0xee, 0x83, 0x48, 0xa0, 0xe1, 0xa7, 0x0e, 0xec, 0x60, 0x26, 0x80, 0xc3,
+    0xf8, 0x20, 0xb2, 0x0b, 0xe6, 0xc6, 0x78, 0x6f, 0x68, 0x43, 0xa5, 0xed, 0xb8, 0xc6, 0xd7, 0xde,
+    0x15, 0x64, 0x54, 0x2c, 0xb4, 0x69, 0x60, 0x58, 0x19, 0x01, 0xba, 0xb9, 0xdc, 0xb7, 0xd3, 0x19,
+    0x53, 0xba, 0xe4, 0x82, 0xe6, 0x73, 0x64, 0x82, 0x20, 0x84, 0xc6, 0x1c, 0x03, 0xa9, 0x8f, 0xf3,
+    0x4f, 0xb7, 0x2d, 0xaa, 0xb7, 0x64, 0x8a, 0x39, 0xc7, 0xdd, 0xb8, 0x58, 0xc6, 0x71, 0x1c, 0x6e,
+    0x11, 0x8c, 0x57, 0x74, 0x91, 0x83, 0x39, 0x43, 0x5a, 0xd5, 0xe0, 0x95, 0x27, 0x05, 0x9d, 0x64,
+    0x51, 0x78, 0x6e, 0x48, 0x9a, 0xc3, 0x33, 0x6d, 0x6e, 0xaa, 0xf0, 0xc8, 0x4d, 0x35, 0xea, 0x72,
+    0x10, 0xeb, 0x0c, 0x44, 0xa4, 0xa0, 0x42, 0x33, 0x26, 0x67, 0x72, 0x49, 0xdc, 0x73, 0x6c, 0x52,
+    0x17, 0xed, 0x40, 0x75, 0x23, 0xe3, 0xd2, 0x4b, 0x63, 0x33, 0xd7, 0x72, 0x50, 0xba, 0xb1, 0xd9,
+    0x72, 0xb9, 0xdf, 0x50, 0x9b, 0x9f, 0x8d, 0x5d, 0xa4, 0xa7, 0xd1, 0xde, 0x9c, 0xce, 0xfa, 0xe8,
+    0xf1, 0xc0, 0x2b, 0x1b, 0xf5, 0x82, 0x52, 0xf8, 0xd5, 0x77, 0x80, 0x49, 0xb8, 0x2d, 0x56, 0x53,
+    0x3b, 0x0c, 0xc7, 0x31, 0x2e, 0x8e, 0x55, 0x93, 0x15, 0xe3, 0xf9, 0xcf, 0x78, 0x9a, 0xd6, 0xff,
+    0x0d, 0x2d, 0x46, 0x48, 0xe6, 0xbf, 0x0b, 0x00, 0x00,
+};
+
+typedef struct {
+    const char* path;
+    const char* mime;
+    const char* hash;
+    const uint8_t* data;
+    size_t length;
+} WebAsset;
+
+const WebAsset webAssets[] = {
+    { "/static/common.css", "text/css", WEB_ASSET_COMMON_CSS_HASH, WEB_ASSET_COMMON_CSS, sizeof(WEB_ASSET_COMMON_CSS) },
+    { "/static/dashboard.html", "text/html", WEB_ASSET_DASHBOARD_HTML_HASH, WEB_ASSET_DASHBOARD_HTML, sizeof(WEB_ASSET_DASHBOARD_HTML) },
+    { "/static/dashboard.js", "application/javascript", WEB_ASSET_DASHBOARD_JS_HASH, WEB_ASSET_DASHBOARD_JS, sizeof(WEB_ASSET_DASHBOARD_JS) },
+    { "/static/wifi.css", "text/css", WEB_ASSET_WIFI_CSS_HASH, WEB_ASSET_WIFI_CSS, sizeof(WEB_ASSET_WIFI_CSS) },
+    { "/static/wifi.js", "application/javascript", WEB_ASSET_WIFI_JS_HASH, WEB_ASSET_WIFI_JS, sizeof(WEB_ASSET_WIFI_JS) },
+};
+const int webAssetCount = sizeof(webAssets) / sizeof(webAssets[0]);